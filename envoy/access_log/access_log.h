@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/pure.h"
 #include "envoy/filesystem/filesystem.h"
 #include "envoy/http/header_map.h"
@@ -22,6 +23,11 @@ public:
    */
   virtual void write(absl::string_view) PURE;
 
+  /**
+   * Write the content of a buffer to the file, draining the buffer.
+   */
+  virtual void write(Buffer::Instance& data) PURE;
+
   /**
    * Reopen the file.
    */
@@ -42,6 +42,11 @@ public:
 
   virtual IoErrorCode getErrorCode() const PURE;
   virtual std::string getErrorDetails() const PURE;
+  /**
+   * @return int the platform error code behind the error, for callers that need to tell apart
+   *         errors getErrorCode() does not distinguish.
+   */
+  virtual int getSystemErrorCode() const PURE;
 };
 
 using IoErrorDeleterType = void (*)(IoError*);
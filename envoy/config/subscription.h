@@ -75,6 +75,25 @@ public:
    */
   virtual ProtobufTypes::MessagePtr decodeResource(const ProtobufWkt::Any& resource) PURE;
 
+  /**
+   * Like decodeResource(), but without the checks for unknown and deprecated fields, which depend
+   * on state owned by the main thread. Unlike decodeResource(), this may be called from any
+   * thread. The returned message must be passed to checkUnexpectedFields() on the main thread
+   * before it is used.
+   * @param resource some opaque resource (ProtobufWkt::Any).
+   * @return ProtobufTypes::MessagePtr decoded protobuf message in the opaque resource, or nullptr
+   *         if the resource can only be decoded by decodeResource() on the main thread.
+   */
+  virtual ProtobufTypes::MessagePtr
+  decodeResourceConcurrently(const ProtobufWkt::Any& resource) PURE;
+
+  /**
+   * Runs the checks for unknown and deprecated fields skipped by decodeResourceConcurrently().
+   * @param resource a protobuf message returned by decodeResourceConcurrently().
+   * @throw EnvoyException if the resource is rejected.
+   */
+  virtual void checkUnexpectedFields(const Protobuf::Message& resource) PURE;
+
   /**
    * @param resource some opaque resource (Protobuf::Message).
    * @return std::String the resource name in a Protobuf::Message returned by decodeResource(), e.g.
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/pure.h"
 #include "envoy/config/typed_config.h"
 #include "envoy/http/header_map.h"
@@ -33,6 +34,25 @@ public:
                              const Http::ResponseTrailerMap& response_trailers,
                              const StreamInfo::StreamInfo& stream_info,
                              absl::string_view local_reply_body) const PURE;
+
+  /**
+   * Append a formatted substitution line to a buffer. Formatters that can write their output
+   * directly override this to avoid building an intermediate string.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param response_trailers supplies the response trailers.
+   * @param stream_info supplies the stream info.
+   * @param local_reply_body supplies the local reply body.
+   * @param output supplies the buffer the line is appended to.
+   */
+  virtual void formatToBuffer(const Http::RequestHeaderMap& request_headers,
+                              const Http::ResponseHeaderMap& response_headers,
+                              const Http::ResponseTrailerMap& response_trailers,
+                              const StreamInfo::StreamInfo& stream_info,
+                              absl::string_view local_reply_body, Buffer::Instance& output) const {
+    output.add(format(request_headers, response_headers, response_trailers, stream_info,
+                      local_reply_body));
+  }
 };
 
 using FormatterPtr = std::unique_ptr<Formatter>;
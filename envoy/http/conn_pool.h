@@ -47,6 +47,15 @@ public:
                            absl::optional<Http::Protocol> protocol) PURE;
 };
 
+/**
+ * Per stream options of Instance::newStreamWithOptions().
+ */
+struct StreamOptions {
+  // True if the stream is idempotent and may be sent as early (0-RTT) data, in which case the pool
+  // may attach it to a connection before the connection handshake completes.
+  bool can_send_early_data_{};
+};
+
 /**
  * An instance of a generic connection pool.
  */
@@ -78,6 +87,20 @@ public:
   virtual Cancellable* newStream(Http::ResponseDecoder& response_decoder,
                                  Callbacks& callbacks) PURE;
 
+  /**
+   * Create a new stream on the pool, as newStream() does, with per stream options. Pools which do
+   * not support any of the options ignore them.
+   * @param response_decoder supplies the decoder events to fire when the response is
+   *                         available.
+   * @param cb supplies the callbacks to invoke when the connection is ready or has failed.
+   * @param options supplies the options of the stream.
+   * @return Cancellable* see newStream().
+   */
+  virtual Cancellable* newStreamWithOptions(Http::ResponseDecoder& response_decoder,
+                                            Callbacks& callbacks, const StreamOptions&) {
+    return newStream(response_decoder, callbacks);
+  }
+
   /**
    * Returns a user-friendly protocol description for logging.
    * @return absl::string_view a protocol description for logging.
@@ -30,6 +30,10 @@ enum class ConnectionEvent {
   RemoteClose,
   LocalClose,
   Connected,
+  // Raised before Connected by connections which can send early (0-RTT) data while the handshake
+  // completes, e.g. resumed QUIC connections. Only idempotent requests may be sent before
+  // Connected, as early data can be replayed.
+  ConnectedZeroRtt,
 };
 
 /**
@@ -325,6 +325,15 @@ public:
    */
   virtual void onReceiveError(Api::IoError::IoErrorCode error_code) PURE;
 
+  /**
+   * Called when the datagrams held by a batching udpPacketWriter() could not be written by the
+   * flush the listener performs at the end of an event loop iteration. Errors of send() and
+   * flush() calls are returned to their callers instead.
+   *
+   * @param error_code supplies the error of the flush.
+   */
+  virtual void onSendError(Api::IoError::IoErrorCode error_code) PURE;
+
   /**
    * Returns the pointer to the udp_packet_writer associated with the
    * UdpListenerCallback
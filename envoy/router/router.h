@@ -507,7 +507,7 @@ public:
 };
 
 class RateLimitPolicy;
-class Config;
+class CommonConfig;
 
 /**
  * All route specific config returned by the method at
@@ -543,9 +543,9 @@ public:
   virtual const RateLimitPolicy& rateLimitPolicy() const PURE;
 
   /**
-   * @return const Config& the RouteConfiguration that owns this virtual host.
+   * @return const CommonConfig& the RouteConfiguration that owns this virtual host.
    */
-  virtual const Config& routeConfig() const PURE;
+  virtual const CommonConfig& routeConfig() const PURE;
 
   /**
    * @return const RouteSpecificFilterConfig* the per-filter config pre-processed object for
@@ -1118,12 +1118,49 @@ enum class RouteEvalStatus {
 using RouteCallback = std::function<RouteMatchStatus(RouteConstSharedPtr, RouteEvalStatus)>;
 
 /**
- * The router configuration.
+ * Shared part of the route configuration. This data is shared by all the virtual hosts
+ * of the route configuration.
  */
-class Config {
+class CommonConfig {
 public:
-  virtual ~Config() = default;
+  virtual ~CommonConfig() = default;
+
+  /**
+   * Return a list of headers that will be cleaned from any requests that are not from an internal
+   * (RFC1918) source.
+   */
+  virtual const std::list<Http::LowerCaseString>& internalOnlyHeaders() const PURE;
+
+  /**
+   * @return const std::string the RouteConfiguration name.
+   */
+  virtual const std::string& name() const PURE;
 
+  /**
+   * @return whether router configuration uses VHDS.
+   */
+  virtual bool usesVhds() const PURE;
+
+  /**
+   * @return bool whether most specific header mutations should take precedence. The default
+   * evaluation order is route level, then virtual host level and finally global connection
+   * manager level.
+   */
+  virtual bool mostSpecificHeaderMutationsWins() const PURE;
+
+  /**
+   * @return uint32_t The maximum bytes of the response direct response body size. The default value
+   * is 4096.
+   * TODO(dio): To allow overrides at different levels (e.g. per-route, virtual host, etc).
+   */
+  virtual uint32_t maxDirectResponseBodySizeBytes() const PURE;
+};
+
+/**
+ * The router configuration.
+ */
+class Config : public CommonConfig {
+public:
   /**
    * Based on the incoming HTTP request headers, determine the target route (containing either a
    * route entry or a direct response entry) for the request.
@@ -1154,36 +1191,6 @@ public:
   virtual RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                                     const StreamInfo::StreamInfo& stream_info,
                                     uint64_t random_value) const PURE;
-
-  /**
-   * Return a list of headers that will be cleaned from any requests that are not from an internal
-   * (RFC1918) source.
-   */
-  virtual const std::list<Http::LowerCaseString>& internalOnlyHeaders() const PURE;
-
-  /**
-   * @return const std::string the RouteConfiguration name.
-   */
-  virtual const std::string& name() const PURE;
-
-  /**
-   * @return whether router configuration uses VHDS.
-   */
-  virtual bool usesVhds() const PURE;
-
-  /**
-   * @return bool whether most specific header mutations should take precedence. The default
-   * evaluation order is route level, then virtual host level and finally global connection
-   * manager level.
-   */
-  virtual bool mostSpecificHeaderMutationsWins() const PURE;
-
-  /**
-   * @return uint32_t The maximum bytes of the response direct response body size. The default value
-   * is 4096.
-   * TODO(dio): To allow overrides at different levels (e.g. per-route, virtual host, etc).
-   */
-  virtual uint32_t maxDirectResponseBodySizeBytes() const PURE;
 };
 
 using ConfigConstSharedPtr = std::shared_ptr<const Config>;
@@ -1286,6 +1293,12 @@ public:
   // downstream stream. It is in the GenericConnectionPoolCallbacks as the GenericConnectionPool
   // creates the GenericUpstream, and the GenericUpstream will need this interface.
   virtual UpstreamToDownstream& upstreamToDownstream() PURE;
+
+  /**
+   * @return whether the whole request has been encoded. When a new stream is requested, this is
+   *         whether the request ends with its headers.
+   */
+  virtual bool encodeComplete() const PURE;
 };
 
 /**
@@ -68,6 +68,13 @@ public:
    * @param value the value of the sample.
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
+
+  /**
+   * @return whether flush() may be called on the dedicated stats flush thread rather than on the
+   *         main thread. Sinks returning true must only use thread local or thread-safe state in
+   *         flush(), and must post any work that requires the main thread to the main dispatcher.
+   */
+  virtual bool flushOffMainThread() const { return false; }
 };
 
 using SinkPtr = std::unique_ptr<Sink>;
@@ -26,6 +26,17 @@ public:
     on_new_stream_();
     return pool_->newStream(response_decoder, callbacks);
   }
+
+  /**
+   * See documentation of Http::ConnectionPool::Instance.
+   */
+  Envoy::Http::ConnectionPool::Cancellable*
+  newStream(Http::ResponseDecoder& response_decoder,
+            Envoy::Http::ConnectionPool::Callbacks& callbacks,
+            const Envoy::Http::ConnectionPool::StreamOptions& options) {
+    on_new_stream_();
+    return pool_->newStreamWithOptions(response_decoder, callbacks, options);
+  }
   bool hasActiveConnections() const { return pool_->hasActiveConnections(); };
 
   /**
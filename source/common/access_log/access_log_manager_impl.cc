@@ -206,6 +206,21 @@ void AccessLogFileImpl::write(absl::string_view data) {
   }
 }
 
+void AccessLogFileImpl::write(Buffer::Instance& data) {
+  Thread::LockGuard lock(write_lock_);
+
+  if (flush_thread_ == nullptr) {
+    createFlushStructures();
+  }
+
+  stats_.write_buffered_.inc();
+  stats_.write_total_buffered_.add(data.length());
+  flush_buffer_.move(data);
+  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
+    flush_event_.notifyOne();
+  }
+}
+
 void AccessLogFileImpl::createFlushStructures() {
   flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
                                                Thread::Options{"AccessLogFlush"});
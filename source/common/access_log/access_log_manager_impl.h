@@ -72,6 +72,7 @@ public:
 
   // AccessLog::AccessLogFile
   void write(absl::string_view data) override;
+  void write(Buffer::Instance& data) override;
 
   /**
    * Reopen file asynchronously.
@@ -0,0 +1,56 @@
+#include "source/common/config/decode_thread_pool.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Config {
+
+DecodeThreadPool::DecodeThreadPool(Thread::ThreadFactory& thread_factory, uint32_t concurrency) {
+  ASSERT(concurrency > 0);
+  // Thread names are limited to 15 characters, see WorkerImpl::start().
+  Thread::Options options{"xds_decode"};
+  for (uint32_t i = 0; i < concurrency; ++i) {
+    threads_.push_back(
+        thread_factory.createThread([this]() -> void { threadRoutine(); }, options));
+  }
+}
+
+DecodeThreadPool::~DecodeThreadPool() {
+  {
+    Thread::LockGuard lock(mutex_);
+    shutdown_ = true;
+    cond_var_.notifyAll();
+  }
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+}
+
+void DecodeThreadPool::post(Task task) {
+  Thread::LockGuard lock(mutex_);
+  ASSERT(!shutdown_);
+  tasks_.push_back(std::move(task));
+  cond_var_.notifyOne();
+}
+
+void DecodeThreadPool::threadRoutine() {
+  while (true) {
+    Task task;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (tasks_.empty() && !shutdown_) {
+        cond_var_.wait(mutex_);
+      }
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+} // namespace Config
+} // namespace Envoy
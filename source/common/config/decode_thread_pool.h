@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/thread.h"
+
+#include "absl/base/thread_annotations.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * A fixed size pool of threads used to decode and validate xDS resources off the main thread.
+ * Tasks run in FIFO order on whichever thread is idle first; tasks must not touch main thread
+ * state (e.g. runtime or stats histograms) and should post their results back to the main thread.
+ */
+class DecodeThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @param thread_factory supplies the factory used to create the pool's threads.
+   * @param concurrency supplies the number of threads, which must be greater than zero.
+   */
+  DecodeThreadPool(Thread::ThreadFactory& thread_factory, uint32_t concurrency);
+
+  /**
+   * Waits for all queued tasks to run and joins the threads.
+   */
+  ~DecodeThreadPool();
+
+  /**
+   * Queues a task to run on one of the pool's threads. May be called from any thread.
+   */
+  void post(Task task);
+
+  /**
+   * @return uint32_t the number of threads in the pool.
+   */
+  uint32_t concurrency() const { return threads_.size(); }
+
+private:
+  void threadRoutine();
+
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar cond_var_;
+  std::list<Task> tasks_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using DecodeThreadPoolPtr = std::unique_ptr<DecodeThreadPool>;
+
+} // namespace Config
+} // namespace Envoy
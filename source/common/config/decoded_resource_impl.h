@@ -39,23 +39,53 @@ public:
     }
 
     return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
-        resource_decoder, absl::nullopt, Protobuf::RepeatedPtrField<std::string>(), resource, true,
-        version, absl::nullopt));
+        resource_decoder, absl::nullopt, Protobuf::RepeatedPtrField<std::string>(),
+        resource_decoder.decodeResource(resource), true, version, absl::nullopt));
+  }
+
+  /**
+   * Like fromResource(), but may be called from any thread. The decoded resource must be passed
+   * to OpaqueResourceDecoder::checkUnexpectedFields() on the main thread before it is used.
+   * @return DecodedResourceImplPtr the decoded resource, or nullptr if the resource can only be
+   *         decoded by fromResource() on the main thread.
+   */
+  static DecodedResourceImplPtr fromResourceConcurrently(OpaqueResourceDecoder& resource_decoder,
+                                                         const ProtobufWkt::Any& resource,
+                                                         const std::string& version) {
+    if (resource.Is<envoy::service::discovery::v3::Resource>()) {
+      envoy::service::discovery::v3::Resource r;
+      MessageUtil::unpackTo(resource, r);
+      auto message = resource_decoder.decodeResourceConcurrently(r.resource());
+      if (message == nullptr) {
+        return nullptr;
+      }
+      return std::unique_ptr<DecodedResourceImpl>(
+          new DecodedResourceImpl(resource_decoder, r.name(), r.aliases(), std::move(message),
+                                  r.has_resource(), version, ttlFromResource(r)));
+    }
+
+    auto message = resource_decoder.decodeResourceConcurrently(resource);
+    if (message == nullptr) {
+      return nullptr;
+    }
+    return std::unique_ptr<DecodedResourceImpl>(
+        new DecodedResourceImpl(resource_decoder, absl::nullopt,
+                                Protobuf::RepeatedPtrField<std::string>(), std::move(message), true,
+                                version, absl::nullopt));
   }
 
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder,
                       const envoy::service::discovery::v3::Resource& resource)
       : DecodedResourceImpl(resource_decoder, resource.name(), resource.aliases(),
-                            resource.resource(), resource.has_resource(), resource.version(),
-                            resource.has_ttl()
-                                ? absl::make_optional(std::chrono::milliseconds(
-                                      DurationUtil::durationToMilliseconds(resource.ttl())))
-                                : absl::nullopt) {}
+                            resource_decoder.decodeResource(resource.resource()),
+                            resource.has_resource(), resource.version(),
+                            ttlFromResource(resource)) {}
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder,
                       const xds::core::v3::CollectionEntry::InlineEntry& inline_entry)
       : DecodedResourceImpl(resource_decoder, inline_entry.name(),
-                            Protobuf::RepeatedPtrField<std::string>(), inline_entry.resource(),
-                            true, inline_entry.version(), absl::nullopt) {}
+                            Protobuf::RepeatedPtrField<std::string>(),
+                            resource_decoder.decodeResource(inline_entry.resource()), true,
+                            inline_entry.version(), absl::nullopt) {}
   DecodedResourceImpl(ProtobufTypes::MessagePtr resource, const std::string& name,
                       const std::vector<std::string>& aliases, const std::string& version)
       : resource_(std::move(resource)), has_resource_(true), name_(name), aliases_(aliases),
@@ -72,12 +102,19 @@ public:
 private:
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder, absl::optional<std::string> name,
                       const Protobuf::RepeatedPtrField<std::string>& aliases,
-                      const ProtobufWkt::Any& resource, bool has_resource,
+                      ProtobufTypes::MessagePtr resource, bool has_resource,
                       const std::string& version, absl::optional<std::chrono::milliseconds> ttl)
-      : resource_(resource_decoder.decodeResource(resource)), has_resource_(has_resource),
+      : resource_(std::move(resource)), has_resource_(has_resource),
         name_(name ? *name : resource_decoder.resourceName(*resource_)),
         aliases_(repeatedPtrFieldToVector(aliases)), version_(version), ttl_(ttl) {}
 
+  static absl::optional<std::chrono::milliseconds>
+  ttlFromResource(const envoy::service::discovery::v3::Resource& resource) {
+    return resource.has_ttl() ? absl::make_optional(std::chrono::milliseconds(
+                                    DurationUtil::durationToMilliseconds(resource.ttl())))
+                              : absl::nullopt;
+  }
+
   const ProtobufTypes::MessagePtr resource_;
   const bool has_resource_;
   const std::string name_;
@@ -1,5 +1,7 @@
 #include "source/common/config/grpc_mux_impl.h"
 
+#include <algorithm>
+
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
 #include "source/common/config/decoded_resource_impl.h"
@@ -19,7 +21,8 @@ GrpcMuxImpl::GrpcMuxImpl(const LocalInfo::LocalInfo& local_info,
                          const Protobuf::MethodDescriptor& service_method,
                          envoy::config::core::v3::ApiVersion transport_api_version,
                          Random::RandomGenerator& random, Stats::Scope& scope,
-                         const RateLimitSettings& rate_limit_settings, bool skip_subsequent_node)
+                         const RateLimitSettings& rate_limit_settings, bool skip_subsequent_node,
+                         DecodeThreadPoolPtr decode_pool)
     : grpc_stream_(this, std::move(async_client), service_method, random, dispatcher, scope,
                    rate_limit_settings),
       local_info_(local_info), skip_subsequent_node_(skip_subsequent_node),
@@ -28,8 +31,21 @@ GrpcMuxImpl::GrpcMuxImpl(const LocalInfo::LocalInfo& local_info,
       dynamic_update_callback_handle_(local_info.contextProvider().addDynamicContextUpdateCallback(
           [this](absl::string_view resource_type_url) {
             onDynamicContextUpdate(resource_type_url);
-          })) {
+          })),
+      decode_pool_(std::move(decode_pool)) {
   Config::Utility::checkLocalInfo("ads", local_info);
+  if (decode_pool_ != nullptr) {
+    decode_stats_ = std::make_unique<ControlPlaneDecodeStats>(ControlPlaneDecodeStats{
+        ALL_CONTROL_PLANE_DECODE_STATS(POOL_GAUGE_PREFIX(scope, "control_plane."),
+                                       POOL_HISTOGRAM_PREFIX(scope, "control_plane."))});
+  }
+}
+
+GrpcMuxImpl::~GrpcMuxImpl() {
+  // The decoders of the watches may be destroyed before the pool runs the remaining chunks.
+  if (!pending_responses_.empty()) {
+    pending_responses_.front()->cancel();
+  }
 }
 
 void GrpcMuxImpl::onDynamicContextUpdate(absl::string_view resource_type_url) {
@@ -135,6 +151,154 @@ ScopedResume GrpcMuxImpl::pause(const std::vector<std::string> type_urls) {
 void GrpcMuxImpl::onDiscoveryResponse(
     std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
     ControlPlaneStats& control_plane_stats) {
+  if (decode_pool_ == nullptr) {
+    processDiscoveryResponse(std::move(message), control_plane_stats, nullptr);
+    return;
+  }
+  pending_responses_.push(std::make_shared<PendingResponse>(
+      std::move(message), control_plane_stats, dispatcher_.timeSource().monotonicTime()));
+  decode_stats_->decode_pending_responses_.set(pending_responses_.size());
+  // Otherwise an earlier response is being decoded and this one is picked up once it is applied.
+  if (pending_responses_.size() == 1) {
+    processPendingResponses();
+  }
+}
+
+void GrpcMuxImpl::processPendingResponses() {
+  while (!pending_responses_.empty()) {
+    if (startDecoding(pending_responses_.front())) {
+      return;
+    }
+    applyFrontPendingResponse();
+  }
+}
+
+bool GrpcMuxImpl::startDecoding(const PendingResponseSharedPtr& pending_response) {
+  const auto& message = *pending_response->message_;
+  auto api_state = api_state_.find(message.type_url());
+  if (message.resources().empty() || api_state == api_state_.end() ||
+      api_state->second->watches_.empty()) {
+    return false;
+  }
+
+  pending_response->resource_decoder_ = &api_state->second->watches_.front()->resource_decoder_;
+  pending_response->decode_start_time_ = dispatcher_.timeSource().monotonicTime();
+  decode_stats_->decode_queue_ms_.recordValue(
+      std::chrono::duration_cast<std::chrono::milliseconds>(pending_response->decode_start_time_ -
+                                                            pending_response->received_time_)
+          .count());
+
+  const int num_resources = message.resources_size();
+  pending_response->resources_.resize(num_resources);
+  pending_response->errors_.resize(num_resources);
+  const int num_chunks = std::min<int>(decode_pool_->concurrency(), num_resources);
+  const int chunk_size = (num_resources + num_chunks - 1) / num_chunks;
+  pending_response->pending_chunks_ = (num_resources + chunk_size - 1) / chunk_size;
+  for (int begin = 0; begin < num_resources; begin += chunk_size) {
+    const int end = std::min(begin + chunk_size, num_resources);
+    // The chunks may run after we are destroyed, so they only reference the dispatcher, which
+    // outlives us.
+    decode_pool_->post([this, &dispatcher = dispatcher_, pending_response, begin, end,
+                        still_alive = std::weak_ptr<bool>(still_alive_)]() {
+      pending_response->decode(begin, end);
+      if (--pending_response->pending_chunks_ == 0) {
+        dispatcher.post([this, pending_response, still_alive]() {
+          if (still_alive.lock()) {
+            onResponseDecoded(pending_response);
+          }
+        });
+      }
+    });
+  }
+  return true;
+}
+
+void GrpcMuxImpl::onResponseDecoded(const PendingResponseSharedPtr& pending_response) {
+  if (pending_responses_.empty() || pending_responses_.front() != pending_response) {
+    // The response was dropped when its stream was closed.
+    return;
+  }
+  decode_stats_->decode_time_ms_.recordValue(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          dispatcher_.timeSource().monotonicTime() -
+          pending_responses_.front()->decode_start_time_)
+          .count());
+  applyFrontPendingResponse();
+  processPendingResponses();
+}
+
+void GrpcMuxImpl::applyFrontPendingResponse() {
+  PendingResponseSharedPtr pending_response = std::move(pending_responses_.front());
+  pending_responses_.pop();
+  decode_stats_->decode_pending_responses_.set(pending_responses_.size());
+  processDiscoveryResponse(std::move(pending_response->message_),
+                           pending_response->control_plane_stats_, pending_response.get());
+}
+
+void GrpcMuxImpl::cancelDecodeUsing(OpaqueResourceDecoder& resource_decoder) {
+  if (pending_responses_.empty() ||
+      pending_responses_.front()->resource_decoder_ != &resource_decoder) {
+    return;
+  }
+  // The response is still applied in order once the pool is done with it, decoding its resources
+  // on the main thread.
+  pending_responses_.front()->releaseDecoder();
+}
+
+void GrpcMuxImpl::dropPendingResponses() {
+  if (pending_responses_.empty()) {
+    return;
+  }
+  // The completion of the response being decoded finds it gone and is ignored. Its decoder is
+  // released now, as the watch owning it no longer finds the response to cancel its decode.
+  pending_responses_.front()->releaseDecoder();
+  pending_responses_ = {};
+  decode_stats_->decode_pending_responses_.set(0);
+}
+
+void GrpcMuxImpl::PendingResponse::decode(int begin, int end) {
+  for (int i = begin; i < end; ++i) {
+    absl::ReaderMutexLock lock(&decoder_lock_);
+    if (cancelled_) {
+      return;
+    }
+    TRY_NEEDS_AUDIT {
+      resources_[i] = DecodedResourceImpl::fromResourceConcurrently(
+          *resource_decoder_, message_->resources(i), message_->version_info());
+    }
+    catch (const EnvoyException& e) {
+      errors_[i] = e.what();
+    }
+  }
+}
+
+void GrpcMuxImpl::PendingResponse::releaseDecoder() {
+  cancel();
+  // Resources whose decoding starts from now on see the cancellation, so once the resources being
+  // decoded are done, the pool no longer uses the decoder.
+  absl::MutexLock lock(&decoder_lock_);
+  decoder_invalidated_ = true;
+}
+
+DecodedResourceImplPtr
+GrpcMuxImpl::PendingResponse::takeResource(int index, OpaqueResourceDecoder& resource_decoder) {
+  // Resources decoded with any decoder for this type URL can be used, as long as that decoder
+  // was alive while decoding.
+  if (decoder_invalidated_ || resources_.empty()) {
+    return nullptr;
+  }
+  if (!errors_[index].empty()) {
+    throw EnvoyException(errors_[index]);
+  }
+  if (resources_[index] != nullptr) {
+    resource_decoder.checkUnexpectedFields(resources_[index]->resource());
+  }
+  return std::move(resources_[index]);
+}
+
+void GrpcMuxImpl::processDiscoveryResponse(
+    std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+    ControlPlaneStats& control_plane_stats, PendingResponse* pending_response) {
   const std::string type_url = message->type_url();
   ENVOY_LOG(debug, "Received gRPC message for {} at version {}", type_url, message->version_info());
   if (api_state_.count(type_url) == 0) {
@@ -194,7 +358,8 @@ void GrpcMuxImpl::onDiscoveryResponse(
 
     const auto scoped_ttl_update = api_state.ttl_.scopedTtlUpdate();
 
-    for (const auto& resource : message->resources()) {
+    for (int i = 0; i < message->resources_size(); ++i) {
+      const auto& resource = message->resources(i);
       // TODO(snowp): Check the underlying type when the resource is a Resource.
       if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
           type_url != resource.type_url()) {
@@ -203,8 +368,14 @@ void GrpcMuxImpl::onDiscoveryResponse(
                         resource.type_url(), type_url, message->DebugString()));
       }
 
-      auto decoded_resource =
-          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info());
+      DecodedResourceImplPtr decoded_resource;
+      if (pending_response != nullptr) {
+        decoded_resource = pending_response->takeResource(i, resource_decoder);
+      }
+      if (decoded_resource == nullptr) {
+        decoded_resource =
+            DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info());
+      }
 
       if (decoded_resource->ttl()) {
         api_state.ttl_.add(*decoded_resource->ttl(), decoded_resource->name());
@@ -264,6 +435,7 @@ void GrpcMuxImpl::onDiscoveryResponse(
 void GrpcMuxImpl::onWriteable() { drainRequests(); }
 
 void GrpcMuxImpl::onStreamEstablished() {
+  dropPendingResponses();
   first_stream_request_ = true;
   grpc_stream_.maybeUpdateQueueSizeStat(0);
   request_queue_ = std::make_unique<std::queue<std::string>>();
@@ -273,6 +445,7 @@ void GrpcMuxImpl::onStreamEstablished() {
 }
 
 void GrpcMuxImpl::onEstablishmentFailure() {
+  dropPendingResponses();
   for (const auto& api_state : api_state_) {
     for (auto watch : api_state.second->watches_) {
       watch->callbacks_.onConfigUpdateFailed(
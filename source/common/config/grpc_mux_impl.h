@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <queue>
@@ -12,20 +13,40 @@
 #include "envoy/event/dispatcher.h"
 #include "envoy/grpc/status.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/common/cleanup.h"
 #include "source/common/common/logger.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/api_version.h"
+#include "source/common/config/decode_thread_pool.h"
+#include "source/common/config/decoded_resource_impl.h"
 #include "source/common/config/grpc_stream.h"
 #include "source/common/config/ttl.h"
 #include "source/common/config/utility.h"
 
 #include "absl/container/node_hash_map.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Config {
+
+/**
+ * All stats for decoding ADS responses on a DecodeThreadPool. @see stats_macros.h
+ */
+#define ALL_CONTROL_PLANE_DECODE_STATS(GAUGE, HISTOGRAM)                                           \
+  GAUGE(decode_pending_responses, Accumulate)                                                      \
+  HISTOGRAM(decode_queue_ms, Milliseconds)                                                         \
+  HISTOGRAM(decode_time_ms, Milliseconds)
+
+/**
+ * Struct definition for all control plane decode stats. @see stats_macros.h
+ */
+struct ControlPlaneDecodeStats {
+  ALL_CONTROL_PLANE_DECODE_STATS(GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
 /**
  * ADS API implementation that fetches via gRPC.
  */
@@ -37,7 +58,9 @@ public:
               Event::Dispatcher& dispatcher, const Protobuf::MethodDescriptor& service_method,
               envoy::config::core::v3::ApiVersion transport_api_version,
               Random::RandomGenerator& random, Stats::Scope& scope,
-              const RateLimitSettings& rate_limit_settings, bool skip_subsequent_node);
+              const RateLimitSettings& rate_limit_settings, bool skip_subsequent_node,
+              DecodeThreadPoolPtr decode_pool = nullptr);
+  ~GrpcMuxImpl() override;
 
   void start() override;
 
@@ -88,6 +111,7 @@ private:
     }
 
     ~GrpcMuxWatchImpl() override {
+      parent_.cancelDecodeUsing(resource_decoder_);
       watches_.erase(iter_);
       if (!resources_.empty()) {
         parent_.queueDiscoveryRequest(type_url_);
@@ -145,6 +169,60 @@ private:
     std::string control_plane_identifier_{};
   };
 
+  // A discovery response waiting to be applied on the main thread. When a DecodeThreadPool is
+  // configured, its resources are decoded on the pool first.
+  struct PendingResponse {
+    PendingResponse(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+                    ControlPlaneStats& control_plane_stats, MonotonicTime received_time)
+        : message_(std::move(message)), control_plane_stats_(control_plane_stats),
+          received_time_(received_time) {}
+
+    // Decodes the resources in [begin, end) until the decode is cancelled. Called on the decode
+    // pool.
+    void decode(int begin, int end);
+    // Stops decoding the resources not started yet.
+    void cancel() { cancelled_ = true; }
+    // Cancels the decode and waits for the resources being decoded at the moment, after which
+    // resource_decoder_ is no longer used by the decode pool.
+    void releaseDecoder();
+    // Returns the resource at index decoded on the decode pool, or nullptr if it has to be decoded
+    // on the main thread. Rethrows the error if decoding the resource failed.
+    DecodedResourceImplPtr takeResource(int index, OpaqueResourceDecoder& resource_decoder);
+
+    std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse> message_;
+    ControlPlaneStats& control_plane_stats_;
+    const MonotonicTime received_time_;
+    MonotonicTime decode_start_time_;
+    // The decoder the resources are decoded with, set on the main thread when decoding starts.
+    OpaqueResourceDecoder* resource_decoder_{};
+    // Set if resource_decoder_ was destroyed, in which case the decoded resources are dropped.
+    bool decoder_invalidated_{};
+    // Decoded resources and decode errors, indexed like message_->resources().
+    std::vector<DecodedResourceImplPtr> resources_;
+    std::vector<std::string> errors_;
+    // Held shared by the decode pool while it decodes a resource with resource_decoder_.
+    absl::Mutex decoder_lock_;
+    std::atomic<bool> cancelled_{};
+    std::atomic<uint32_t> pending_chunks_{};
+  };
+  using PendingResponseSharedPtr = std::shared_ptr<PendingResponse>;
+
+  void processDiscoveryResponse(
+      std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+      ControlPlaneStats& control_plane_stats, PendingResponse* pending_response);
+  // Applies pending responses in order until one has to be decoded on the decode pool.
+  void processPendingResponses();
+  // Starts decoding a pending response on the decode pool. Returns false if there is nothing to
+  // decode, in which case the response can be applied right away.
+  bool startDecoding(const PendingResponseSharedPtr& pending_response);
+  void onResponseDecoded(const PendingResponseSharedPtr& pending_response);
+  void applyFrontPendingResponse();
+  // Cancels decoding with resource_decoder, which is about to be destroyed. Only waits for the
+  // resources being decoded at the moment, not for the whole response.
+  void cancelDecodeUsing(OpaqueResourceDecoder& resource_decoder);
+  // Drops the responses received on a stream that has been closed, as their nonces are stale.
+  void dropPendingResponses();
+
   bool isHeartbeatResource(const std::string& type_url, const DecodedResource& resource) {
     return !resource.hasResource() &&
            resource.version() == apiStateFor(type_url).request_.version_info();
@@ -179,6 +257,15 @@ private:
 
   Event::Dispatcher& dispatcher_;
   Common::CallbackHandlePtr dynamic_update_callback_handle_;
+
+  // If set, resources are decoded on this pool before being applied on the main thread.
+  const DecodeThreadPoolPtr decode_pool_;
+  std::unique_ptr<ControlPlaneDecodeStats> decode_stats_;
+  // Responses waiting to be applied, in the order they were received. Only the response at the
+  // front is ever being decoded.
+  std::queue<PendingResponseSharedPtr> pending_responses_;
+  // Guards the completions posted from the decode pool.
+  std::shared_ptr<bool> still_alive_{std::make_shared<bool>(true)};
 };
 
 using GrpcMuxImplPtr = std::unique_ptr<GrpcMuxImpl>;
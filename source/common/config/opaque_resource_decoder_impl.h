@@ -24,6 +24,30 @@ public:
     return typed_message;
   }
 
+  ProtobufTypes::MessagePtr decodeResourceConcurrently(const ProtobufWkt::Any& resource) override {
+    auto typed_message = std::make_unique<Current>();
+    if (!resource.type_url().empty()) {
+      // Upgrading an earlier API version may consult runtime, so leave it to decodeResource().
+      if (TypeUtil::typeUrlToDescriptorFullName(resource.type_url()) !=
+          Current::descriptor()->full_name()) {
+        return nullptr;
+      }
+      MessageUtil::anyConvert<Current>(resource, *typed_message);
+      std::string err;
+      if (!Validate(*typed_message, &err)) {
+        ProtoExceptionUtil::throwProtoValidationException(err,
+                                                          API_RECOVER_ORIGINAL(*typed_message));
+      }
+    }
+    return typed_message;
+  }
+
+  void checkUnexpectedFields(const Protobuf::Message& resource) override {
+    if (!validation_visitor_.skipValidation()) {
+      MessageUtil::checkForUnexpectedFields(resource, validation_visitor_);
+    }
+  }
+
   std::string resourceName(const Protobuf::Message& resource) override {
     return MessageUtil::getStringField(resource, name_field_);
   }
@@ -31,11 +31,13 @@ ConnPoolImplBase::~ConnPoolImplBase() {
   ASSERT(ready_clients_.empty());
   ASSERT(busy_clients_.empty());
   ASSERT(connecting_clients_.empty());
+  ASSERT(early_data_clients_.empty());
   ASSERT(connecting_stream_capacity_ == 0);
 }
 
 void ConnPoolImplBase::destructAllConnections() {
-  for (auto* list : {&ready_clients_, &busy_clients_, &connecting_clients_}) {
+  for (auto* list :
+       {&ready_clients_, &busy_clients_, &connecting_clients_, &early_data_clients_}) {
     while (!list->empty()) {
       list->front()->close();
     }
@@ -72,8 +74,9 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
   // upstream selection logic may result in bypassing this upstream entirely.
   // If an Envoy user wants preconnecting for degraded upstreams this could be
   // added later via extending the preconnect config.
+  const uint64_t connecting_capacity = connectingAndEarlyDataStreamCapacity();
   if (host_->health() != Upstream::Host::Health::Healthy) {
-    return pending_streams_.size() > connecting_stream_capacity_;
+    return pending_streams_.size() > connecting_capacity;
   }
 
   // Determine if we are trying to prefetch for global preconnect or local preconnect.
@@ -84,7 +87,7 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     // prefetching for the next upcoming stream, which will likely be assigned to this pool.
     // We may eventually want to track preconnect_attempts to allow more preconnecting for
     // heavily weighted upstreams or sticky picks.
-    return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_stream_capacity_,
+    return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_capacity,
                          global_preconnect_ratio, true);
   } else {
     // Ensure this local pool has adequate connections for the given load.
@@ -92,11 +95,19 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     // Local preconnect does not need to anticipate a stream. It is called as
     // new streams are established or torn down and simply attempts to maintain
     // the correct ratio of streams and anticipated capacity.
-    return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_stream_capacity_,
+    return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_capacity,
                          perUpstreamPreconnectRatio());
   }
 }
 
+uint64_t ConnPoolImplBase::connectingAndEarlyDataStreamCapacity() const {
+  uint64_t capacity = connecting_stream_capacity_;
+  for (const auto& client : early_data_clients_) {
+    capacity += std::max<int64_t>(client->currentUnusedCapacity(), 0);
+  }
+  return capacity;
+}
+
 float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
   return host_->cluster().perUpstreamPreconnectRatio();
 }
@@ -135,7 +146,8 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
   // too many open connections, and this upstream has no connections, always create one, to
   // prevent pending streams being queued to this upstream with no way to be processed.
   if (can_create_connection ||
-      (ready_clients_.empty() && busy_clients_.empty() && connecting_clients_.empty())) {
+      (ready_clients_.empty() && busy_clients_.empty() && connecting_clients_.empty() &&
+       early_data_clients_.empty())) {
     ENVOY_LOG(debug, "creating a new connection");
     ActiveClientPtr client = instantiateActiveClient();
     if (client.get() == nullptr) {
@@ -160,7 +172,8 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
 
 void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient& client,
                                             AttachContext& context) {
-  ASSERT(client.state() == Envoy::ConnectionPool::ActiveClient::State::READY);
+  ASSERT(client.state() == Envoy::ConnectionPool::ActiveClient::State::READY ||
+         client.state() == Envoy::ConnectionPool::ActiveClient::State::READY_FOR_EARLY_DATA);
 
   if (!host_->cluster().resourceManager(priority_).requests().canCreate()) {
     ENVOY_LOG(debug, "max streams overflow");
@@ -171,11 +184,17 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
     ENVOY_CONN_LOG(debug, "creating stream", client);
 
     client.remaining_streams_--;
+    // A client sending early data stays in its state until the handshake completes, and then
+    // moves to the state matching its streams.
+    const bool early_data =
+        client.state() == Envoy::ConnectionPool::ActiveClient::State::READY_FOR_EARLY_DATA;
     if (client.remaining_streams_ == 0) {
       ENVOY_CONN_LOG(debug, "maximum streams per connection, DRAINING", client);
       host_->cluster().stats().upstream_cx_max_requests_.inc();
-      transitionActiveClientState(client, Envoy::ConnectionPool::ActiveClient::State::DRAINING);
-    } else if (client.numActiveStreams() + 1 >= client.concurrent_stream_limit_) {
+      if (!early_data) {
+        transitionActiveClientState(client, Envoy::ConnectionPool::ActiveClient::State::DRAINING);
+      }
+    } else if (!early_data && client.numActiveStreams() + 1 >= client.concurrent_stream_limit_) {
       // As soon as the new stream is created, the client will be maxed out.
       transitionActiveClientState(client, Envoy::ConnectionPool::ActiveClient::State::BUSY);
     }
@@ -221,10 +240,14 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
     if (!delay_attaching_stream) {
       onUpstreamReady();
     }
+  } else if (client.state() == ActiveClient::State::READY_FOR_EARLY_DATA &&
+             !delay_attaching_stream) {
+    onUpstreamReadyForEarlyData(client);
   }
 }
 
-ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context) {
+ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context,
+                                                         bool can_send_early_data) {
   ASSERT(static_cast<ssize_t>(connecting_stream_capacity_) ==
          connectingCapacity(connecting_clients_)); // O(n) debug check.
   if (!ready_clients_.empty()) {
@@ -236,8 +259,19 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context)
     return nullptr;
   }
 
+  if (can_send_early_data) {
+    for (auto& client : early_data_clients_) {
+      if (client->currentUnusedCapacity() > 0) {
+        ENVOY_CONN_LOG(debug, "using existing connection for early data", *client);
+        attachStreamToClient(*client, context);
+        tryCreateNewConnections();
+        return nullptr;
+      }
+    }
+  }
+
   if (host_->cluster().resourceManager(priority_).pendingRequests().canCreate()) {
-    ConnectionPool::Cancellable* pending = newPendingStream(context);
+    ConnectionPool::Cancellable* pending = newPendingStream(context, can_send_early_data);
     ENVOY_LOG(debug, "trying to create new connection");
     ENVOY_LOG(trace, fmt::format("{}", *this));
 
@@ -247,7 +281,7 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context)
     const ConnectionResult result = tryCreateNewConnections();
     // If there is not enough connecting capacity, the only reason to not
     // increase capacity is if the connection limits are exceeded.
-    ENVOY_BUG(pending_streams_.size() <= connecting_stream_capacity_ ||
+    ENVOY_BUG(pending_streams_.size() <= connectingAndEarlyDataStreamCapacity() ||
                   connecting_stream_capacity_ > old_capacity ||
                   (result == ConnectionResult::NoConnectionRateLimited ||
                    result == ConnectionResult::FailedToCreateConnection),
@@ -290,10 +324,30 @@ void ConnPoolImplBase::onUpstreamReady() {
   }
 }
 
+void ConnPoolImplBase::onUpstreamReadyForEarlyData(ActiveClient& client) {
+  ASSERT(client.state() == ActiveClient::State::READY_FOR_EARLY_DATA);
+  while (client.currentUnusedCapacity() > 0) {
+    // Pending streams are pushed onto the front, so look for the oldest one from the back. The
+    // list is searched again for each stream, as attaching a stream may cancel others.
+    auto it = std::find_if(
+        pending_streams_.rbegin(), pending_streams_.rend(),
+        [](const PendingStreamPtr& stream) { return stream->can_send_early_data_; });
+    if (it == pending_streams_.rend()) {
+      return;
+    }
+    ENVOY_CONN_LOG(debug, "attaching to next early data stream", client);
+    PendingStreamPtr stream = (*it)->removeFromList(pending_streams_);
+    state_.decrPendingStreams(1);
+    attachStreamToClient(client, stream->context());
+  }
+}
+
 std::list<ActiveClientPtr>& ConnPoolImplBase::owningList(ActiveClient::State state) {
   switch (state) {
   case ActiveClient::State::CONNECTING:
     return connecting_clients_;
+  case ActiveClient::State::READY_FOR_EARLY_DATA:
+    return early_data_clients_;
   case ActiveClient::State::READY:
     return ready_clients_;
   case ActiveClient::State::BUSY:
@@ -341,6 +395,11 @@ void ConnPoolImplBase::closeIdleConnectionsForDrainingPool() {
     for (auto& client : connecting_clients_) {
       to_close.push_back(client.get());
     }
+    for (auto& client : early_data_clients_) {
+      if (client->numActiveStreams() == 0) {
+        to_close.push_back(client.get());
+      }
+    }
   }
 
   for (auto& entry : to_close) {
@@ -353,7 +412,8 @@ void ConnPoolImplBase::drainConnectionsImpl() {
 
   // closeIdleConnections() closes all connections in ready_clients_ with no active streams,
   // so all remaining entries in ready_clients_ are serving streams. Move them and all entries
-  // in busy_clients_ to draining.
+  // in busy_clients_ to draining. Like connecting clients, clients sending early data are left to
+  // complete their handshakes.
   while (!ready_clients_.empty()) {
     transitionActiveClientState(*ready_clients_.front(), ActiveClient::State::DRAINING);
   }
@@ -374,7 +434,7 @@ void ConnPoolImplBase::checkForDrained() {
   closeIdleConnectionsForDrainingPool();
 
   if (pending_streams_.empty() && ready_clients_.empty() && busy_clients_.empty() &&
-      connecting_clients_.empty()) {
+      connecting_clients_.empty() && early_data_clients_.empty()) {
     ENVOY_LOG(debug, "invoking drained callbacks");
     for (const Instance::DrainedCb& cb : drained_callbacks_) {
       cb();
@@ -384,6 +444,19 @@ void ConnPoolImplBase::checkForDrained() {
 
 void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view failure_reason,
                                          Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::ConnectedZeroRtt) {
+    // The handshake is not complete, so the connect timer keeps running.
+    if (client.state() != ActiveClient::State::CONNECTING) {
+      return;
+    }
+    ASSERT(connecting_stream_capacity_ >= client.effectiveConcurrentStreamLimit());
+    connecting_stream_capacity_ -= client.effectiveConcurrentStreamLimit();
+    host_->cluster().stats().upstream_cx_connect_with_0_rtt_.inc();
+    transitionActiveClientState(client, ActiveClient::State::READY_FOR_EARLY_DATA);
+    onUpstreamReadyForEarlyData(client);
+    return;
+  }
+
   if (client.state() == ActiveClient::State::CONNECTING) {
     ASSERT(connecting_stream_capacity_ >= client.effectiveConcurrentStreamLimit());
     connecting_stream_capacity_ -= client.effectiveConcurrentStreamLimit();
@@ -408,7 +481,8 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
       Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
     }
 
-    if (client.state() == ActiveClient::State::CONNECTING) {
+    if (client.state() == ActiveClient::State::CONNECTING ||
+        client.state() == ActiveClient::State::READY_FOR_EARLY_DATA) {
       host_->cluster().stats().upstream_cx_connect_fail_.inc();
       host_->stats().cx_connect_fail_.inc();
 
@@ -452,8 +526,31 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
   } else if (event == Network::ConnectionEvent::Connected) {
     client.conn_connect_ms_->complete();
     client.conn_connect_ms_.reset();
-    ASSERT(client.state() == ActiveClient::State::CONNECTING);
-    transitionActiveClientState(client, ActiveClient::State::READY);
+    switch (client.state()) {
+    case ActiveClient::State::CONNECTING:
+      transitionActiveClientState(client, ActiveClient::State::READY);
+      break;
+    case ActiveClient::State::READY_FOR_EARLY_DATA:
+      // Move to the state the streams sent as early data left the client in.
+      if (client.remaining_streams_ == 0) {
+        transitionActiveClientState(client, ActiveClient::State::DRAINING);
+        if (client.numActiveStreams() == 0) {
+          // All the streams the client could serve have already completed.
+          client.close();
+          checkForDrained();
+          return;
+        }
+      } else if (client.numActiveStreams() >= client.concurrent_stream_limit_) {
+        transitionActiveClientState(client, ActiveClient::State::BUSY);
+      } else {
+        transitionActiveClientState(client, ActiveClient::State::READY);
+      }
+      break;
+    default:
+      // The client was drained while sending early data.
+      ASSERT(client.state() == ActiveClient::State::DRAINING);
+      break;
+    }
 
     // At this point, for the mixed ALPN pool, the client may be deleted. Do not
     // refer to client after this point.
@@ -463,7 +560,8 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
   }
 }
 
-PendingStream::PendingStream(ConnPoolImplBase& parent) : parent_(parent) {
+PendingStream::PendingStream(ConnPoolImplBase& parent, bool can_send_early_data)
+    : parent_(parent), can_send_early_data_(can_send_early_data) {
   parent_.host()->cluster().stats().upstream_rq_pending_total_.inc();
   parent_.host()->cluster().stats().upstream_rq_pending_active_.inc();
   parent_.host()->cluster().resourceManager(parent_.priority()).pendingRequests().inc();
@@ -504,7 +602,7 @@ bool ConnPoolImplBase::connectingConnectionIsExcess() const {
   // streams and active streams, and makes sure the connecting capacity would still be sufficient to
   // serve that even with the most recent client removed.
   return (pending_streams_.size() + num_active_streams_) * perUpstreamPreconnectRatio() <=
-         (connecting_stream_capacity_ -
+         (connectingAndEarlyDataStreamCapacity() -
           connecting_clients_.front()->effectiveConcurrentStreamLimit() + num_active_streams_);
 }
 
@@ -77,12 +77,20 @@ public:
   virtual bool hadNegativeDeltaOnStreamClosed() { return false; }
 
   enum class State {
-    CONNECTING, // Connection is not yet established.
-    READY,      // Additional streams may be immediately dispatched to this connection.
-    BUSY,       // Connection is at its concurrent stream limit.
-    DRAINING,   // No more streams can be dispatched to this connection, and it will be closed
-    // when all streams complete.
-    CLOSED // Connection is closed and object is queued for destruction.
+    // Connection is not yet established.
+    CONNECTING,
+    // Connection is not yet established, but streams that may be sent as early data can be
+    // dispatched to it.
+    READY_FOR_EARLY_DATA,
+    // Additional streams may be immediately dispatched to this connection.
+    READY,
+    // Connection is at its concurrent stream limit.
+    BUSY,
+    // No more streams can be dispatched to this connection, and it will be closed when all streams
+    // complete.
+    DRAINING,
+    // Connection is closed and object is queued for destruction.
+    CLOSED
   };
 
   State state() const { return state_; }
@@ -117,7 +125,7 @@ private:
 // yet established.
 class PendingStream : public LinkedObject<PendingStream>, public ConnectionPool::Cancellable {
 public:
-  PendingStream(ConnPoolImplBase& parent);
+  PendingStream(ConnPoolImplBase& parent, bool can_send_early_data);
   ~PendingStream() override;
 
   // ConnectionPool::Cancellable
@@ -128,6 +136,8 @@ public:
   virtual AttachContext& context() PURE;
 
   ConnPoolImplBase& parent_;
+  // Whether the stream may be dispatched to a connection before its handshake completes.
+  const bool can_send_early_data_;
 };
 
 using PendingStreamPtr = std::unique_ptr<PendingStream>;
@@ -195,11 +205,12 @@ public:
   // See if the drain process has started and/or completed.
   void checkForDrained();
   void scheduleOnUpstreamReady();
-  ConnectionPool::Cancellable* newStream(AttachContext& context);
+  ConnectionPool::Cancellable* newStream(AttachContext& context, bool can_send_early_data);
   // Called if this pool is likely to be picked soon, to determine if it's worth preconnecting.
   bool maybePreconnect(float global_preconnect_ratio);
 
-  virtual ConnectionPool::Cancellable* newPendingStream(AttachContext& context) PURE;
+  virtual ConnectionPool::Cancellable* newPendingStream(AttachContext& context,
+                                                       bool can_send_early_data) PURE;
 
   virtual void attachStreamToClient(Envoy::ConnectionPool::ActiveClient& client,
                                     AttachContext& context);
@@ -229,7 +240,7 @@ public:
     os << spaces << "ConnPoolImplBase " << this << DUMP_MEMBER(ready_clients_.size())
        << DUMP_MEMBER(busy_clients_.size()) << DUMP_MEMBER(connecting_clients_.size())
        << DUMP_MEMBER(connecting_stream_capacity_) << DUMP_MEMBER(num_active_streams_)
-       << DUMP_MEMBER(pending_streams_.size())
+       << DUMP_MEMBER(pending_streams_.size()) << DUMP_MEMBER(early_data_clients_.size())
        << " per upstream preconnect ratio: " << perUpstreamPreconnectRatio();
   }
 
@@ -274,6 +285,10 @@ protected:
   // connection preconnect.
   bool shouldCreateNewConnection(float global_preconnect_ratio) const;
 
+  // The connecting stream capacity plus the unused capacity of the clients sending early data,
+  // which both become available to all pending streams once the handshakes complete.
+  uint64_t connectingAndEarlyDataStreamCapacity() const;
+
   float perUpstreamPreconnectRatio() const;
 
   ConnectionPool::Cancellable*
@@ -315,6 +330,10 @@ protected:
   // Clients that are not ready to handle additional streams because they are CONNECTING.
   std::list<ActiveClientPtr> connecting_clients_;
 
+  // Clients that are still connecting but can already handle streams sent as early data.
+  // All entries are in state READY_FOR_EARLY_DATA.
+  std::list<ActiveClientPtr> early_data_clients_;
+
   // The number of streams that can be immediately dispatched
   // if all CONNECTING connections become connected.
   uint32_t connecting_stream_capacity_{0};
@@ -326,6 +345,8 @@ private:
   uint32_t num_active_streams_{0};
 
   void onUpstreamReady();
+  // Attaches the pending streams that may be sent as early data to the client.
+  void onUpstreamReadyForEarlyData(ActiveClient& client);
   Event::SchedulableCallbackPtr upstream_ready_cb_;
 };
 
@@ -1,7 +1,10 @@
 #include "source/common/formatter/substitution_formatter.h"
 
+#include <algorithm>
 #include <climits>
+#include <cmath>
 #include <cstdint>
+#include <iterator>
 #include <regex>
 #include <string>
 #include <vector>
@@ -13,6 +16,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/empty_string.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/json_escape_string.h"
 #include "source/common/common/thread.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/metadata.h"
@@ -52,6 +56,90 @@ const std::regex& getSystemTimeFormatNewlinePattern() {
 }
 const std::regex& getNewlinePattern() { CONSTRUCT_ON_FIRST_USE(std::regex, "\n"); }
 
+void appendTo(std::string& output, absl::string_view data) {
+  output.append(data.data(), data.size());
+}
+void appendTo(Buffer::Instance& output, absl::string_view data) { output.add(data); }
+
+// Appends str to output with JSON escaping applied, without surrounding quotes.
+void appendJsonEscaped(absl::string_view str, std::string& output) {
+  const uint64_t required_size = JsonEscaper::extraSpace(str);
+  if (required_size == 0) {
+    output.append(str.data(), str.size());
+  } else {
+    output.append(JsonEscaper::escapeString(str, required_size));
+  }
+}
+
+void appendJsonString(absl::string_view str, std::string& output) {
+  output.push_back('"');
+  appendJsonEscaped(str, output);
+  output.push_back('"');
+}
+
+void appendJsonNumber(double value, std::string& output) {
+  if (!std::isfinite(value)) {
+    // JSON has no representation for NaN or infinity.
+    output.append("null");
+  } else if (value == std::trunc(value) && std::abs(value) < 1e15) {
+    absl::StrAppend(&output, static_cast<int64_t>(value));
+  } else {
+    fmt::format_to(std::back_inserter(output), "{}", value);
+  }
+}
+
+void appendJsonValue(const ProtobufWkt::Value& value, std::string& output) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kNumberValue:
+    appendJsonNumber(value.number_value(), output);
+    break;
+  case ProtobufWkt::Value::kStringValue:
+    appendJsonString(value.string_value(), output);
+    break;
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    break;
+  case ProtobufWkt::Value::kStructValue: {
+    // Struct fields are unordered; sort them so the output is stable.
+    const auto& fields = value.struct_value().fields();
+    std::vector<const Protobuf::MapPair<std::string, ProtobufWkt::Value>*> sorted;
+    sorted.reserve(fields.size());
+    for (const auto& field : fields) {
+      sorted.push_back(&field);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto* lhs, const auto* rhs) { return lhs->first < rhs->first; });
+    output.push_back('{');
+    for (size_t i = 0; i < sorted.size(); i++) {
+      if (i > 0) {
+        output.push_back(',');
+      }
+      appendJsonString(sorted[i]->first, output);
+      output.push_back(':');
+      appendJsonValue(sorted[i]->second, output);
+    }
+    output.push_back('}');
+    break;
+  }
+  case ProtobufWkt::Value::kListValue: {
+    output.push_back('[');
+    bool first = true;
+    for (const auto& element : value.list_value().values()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendJsonValue(element, output);
+    }
+    output.push_back(']');
+    break;
+  }
+  default:
+    output.append("null");
+    break;
+  }
+}
+
 } // namespace
 
 const std::string SubstitutionFormatUtils::DEFAULT_FORMAT =
@@ -110,13 +198,46 @@ const std::string SubstitutionFormatUtils::getHostnameOrDefault() {
 
 FormatterImpl::FormatterImpl(const std::string& format, bool omit_empty_values)
     : empty_value_string_(omit_empty_values ? EMPTY_STRING : DefaultUnspecifiedValueString) {
-  providers_ = SubstitutionFormatParser::parse(format);
+  compile(SubstitutionFormatParser::parse(format));
 }
 
 FormatterImpl::FormatterImpl(const std::string& format, bool omit_empty_values,
                              const std::vector<CommandParserPtr>& command_parsers)
     : empty_value_string_(omit_empty_values ? EMPTY_STRING : DefaultUnspecifiedValueString) {
-  providers_ = SubstitutionFormatParser::parse(format, command_parsers);
+  compile(SubstitutionFormatParser::parse(format, command_parsers));
+}
+
+void FormatterImpl::compile(std::vector<FormatterProviderPtr>&& providers) {
+  for (FormatterProviderPtr& provider : providers) {
+    const auto* plain = dynamic_cast<const PlainStringFormatter*>(provider.get());
+    if (plain == nullptr) {
+      segments_.push_back({EMPTY_STRING, std::move(provider)});
+      continue;
+    }
+    literal_size_ += plain->value().size();
+    if (!segments_.empty() && segments_.back().provider_ == nullptr) {
+      segments_.back().literal_ += plain->value();
+    } else {
+      segments_.push_back({plain->value(), nullptr});
+    }
+  }
+}
+
+template <class Output>
+void FormatterImpl::formatTo(const Http::RequestHeaderMap& request_headers,
+                             const Http::ResponseHeaderMap& response_headers,
+                             const Http::ResponseTrailerMap& response_trailers,
+                             const StreamInfo::StreamInfo& stream_info,
+                             absl::string_view local_reply_body, Output& output) const {
+  for (const Segment& segment : segments_) {
+    if (segment.provider_ == nullptr) {
+      appendTo(output, segment.literal_);
+      continue;
+    }
+    const auto bit = segment.provider_->format(request_headers, response_headers,
+                                               response_trailers, stream_info, local_reply_body);
+    appendTo(output, bit.has_value() ? bit.value() : empty_value_string_);
+  }
 }
 
 std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
@@ -125,28 +246,33 @@ std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
                                   const StreamInfo::StreamInfo& stream_info,
                                   absl::string_view local_reply_body) const {
   std::string log_line;
-  log_line.reserve(256);
-
-  for (const FormatterProviderPtr& provider : providers_) {
-    const auto bit = provider->format(request_headers, response_headers, response_trailers,
-                                      stream_info, local_reply_body);
-    log_line += bit.value_or(empty_value_string_);
-  }
-
+  log_line.reserve(literal_size_ + 256);
+  formatTo(request_headers, response_headers, response_trailers, stream_info, local_reply_body,
+           log_line);
   return log_line;
 }
 
+void FormatterImpl::formatToBuffer(const Http::RequestHeaderMap& request_headers,
+                                   const Http::ResponseHeaderMap& response_headers,
+                                   const Http::ResponseTrailerMap& response_trailers,
+                                   const StreamInfo::StreamInfo& stream_info,
+                                   absl::string_view local_reply_body,
+                                   Buffer::Instance& output) const {
+  formatTo(request_headers, response_headers, response_trailers, stream_info, local_reply_body,
+           output);
+}
+
 std::string JsonFormatterImpl::format(const Http::RequestHeaderMap& request_headers,
                                       const Http::ResponseHeaderMap& response_headers,
                                       const Http::ResponseTrailerMap& response_trailers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       absl::string_view local_reply_body) const {
-  const ProtobufWkt::Struct output_struct = struct_formatter_.format(
-      request_headers, response_headers, response_trailers, stream_info, local_reply_body);
-
-  const std::string log_line =
-      MessageUtil::getJsonStringFromMessageOrDie(output_struct, false, true);
-  return absl::StrCat(log_line, "\n");
+  std::string log_line;
+  log_line.reserve(256);
+  struct_formatter_.formatJson(request_headers, response_headers, response_trailers, stream_info,
+                               local_reply_body, log_line);
+  log_line.push_back('\n');
+  return log_line;
 }
 
 StructFormatter::StructFormatter(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
@@ -298,6 +424,108 @@ ProtobufWkt::Struct StructFormatter::format(const Http::RequestHeaderMap& reques
   return structFormatMapCallback(struct_output_format_, visitor).struct_value();
 }
 
+bool StructFormatter::providersJsonCallback(const std::vector<FormatterProviderPtr>& providers,
+                                            const Http::RequestHeaderMap& request_headers,
+                                            const Http::ResponseHeaderMap& response_headers,
+                                            const Http::ResponseTrailerMap& response_trailers,
+                                            const StreamInfo::StreamInfo& stream_info,
+                                            absl::string_view local_reply_body,
+                                            std::string& output) const {
+  ASSERT(!providers.empty());
+  if (providers.size() == 1) {
+    const auto& provider = providers.front();
+    if (preserve_types_) {
+      const ProtobufWkt::Value value = provider->formatValue(
+          request_headers, response_headers, response_trailers, stream_info, local_reply_body);
+      if (omit_empty_values_ && value.kind_case() == ProtobufWkt::Value::kNullValue) {
+        return false;
+      }
+      appendJsonValue(value, output);
+      return true;
+    }
+
+    const auto str = provider->format(request_headers, response_headers, response_trailers,
+                                      stream_info, local_reply_body);
+    if (!str.has_value() && omit_empty_values_) {
+      return false;
+    }
+    appendJsonString(str.has_value() ? str.value() : DefaultUnspecifiedValueString, output);
+    return true;
+  }
+  // Multiple providers forces string output.
+  output.push_back('"');
+  for (const auto& provider : providers) {
+    const auto bit = provider->format(request_headers, response_headers, response_trailers,
+                                      stream_info, local_reply_body);
+    appendJsonEscaped(bit.has_value() ? bit.value() : empty_value_, output);
+  }
+  output.push_back('"');
+  return true;
+}
+
+void StructFormatter::structFormatMapJsonCallback(
+    const StructFormatter::StructFormatMapWrapper& format_map,
+    const StructFormatter::StructFormatJsonVisitor& visitor, std::string& output) const {
+  output.push_back('{');
+  bool first = true;
+  for (const auto& pair : *format_map.value_) {
+    const size_t start = output.size();
+    if (!first) {
+      output.push_back(',');
+    }
+    appendJsonString(pair.first, output);
+    output.push_back(':');
+    if (!absl::visit(visitor, pair.second)) {
+      // The value was omitted; drop the key as well.
+      output.resize(start);
+      continue;
+    }
+    first = false;
+  }
+  output.push_back('}');
+}
+
+void StructFormatter::structFormatListJsonCallback(
+    const StructFormatter::StructFormatListWrapper& format_list,
+    const StructFormatter::StructFormatJsonVisitor& visitor, std::string& output) const {
+  output.push_back('[');
+  bool first = true;
+  for (const auto& val : *format_list.value_) {
+    const size_t start = output.size();
+    if (!first) {
+      output.push_back(',');
+    }
+    if (!absl::visit(visitor, val)) {
+      output.resize(start);
+      continue;
+    }
+    first = false;
+  }
+  output.push_back(']');
+}
+
+void StructFormatter::formatJson(const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 absl::string_view local_reply_body, std::string& output) const {
+  StructFormatJsonVisitor visitor{
+      [&](const std::vector<FormatterProviderPtr>& providers) {
+        return providersJsonCallback(providers, request_headers, response_headers,
+                                     response_trailers, stream_info, local_reply_body, output);
+      },
+      [&, this](const StructFormatter::StructFormatMapWrapper& format_map) {
+        structFormatMapJsonCallback(format_map, visitor, output);
+        return true;
+      },
+      [&, this](const StructFormatter::StructFormatListWrapper& format_list) {
+        structFormatListJsonCallback(format_list, visitor, output);
+        return true;
+      },
+  };
+  structFormatMapJsonCallback(struct_output_format_, visitor, output);
+}
+
 void SubstitutionFormatParser::parseCommandHeader(const std::string& token, const size_t start,
                                                   std::string& main_header,
                                                   std::string& alternative_header,
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/time.h"
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/formatter/substitution_formatter.h"
@@ -152,9 +153,32 @@ public:
                      const StreamInfo::StreamInfo& stream_info,
                      absl::string_view local_reply_body) const override;
 
+  void formatToBuffer(const Http::RequestHeaderMap& request_headers,
+                      const Http::ResponseHeaderMap& response_headers,
+                      const Http::ResponseTrailerMap& response_trailers,
+                      const StreamInfo::StreamInfo& stream_info, absl::string_view local_reply_body,
+                      Buffer::Instance& output) const override;
+
 private:
+  // A piece of the compiled format: either literal text or a substitution provider. Adjacent
+  // literals in the format string are merged into a single segment at construction time.
+  struct Segment {
+    std::string literal_;
+    FormatterProviderPtr provider_;
+  };
+
+  void compile(std::vector<FormatterProviderPtr>&& providers);
+  template <class Output>
+  void formatTo(const Http::RequestHeaderMap& request_headers,
+                const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap& response_trailers,
+                const StreamInfo::StreamInfo& stream_info, absl::string_view local_reply_body,
+                Output& output) const;
+
   const std::string& empty_value_string_;
-  std::vector<FormatterProviderPtr> providers_;
+  std::vector<Segment> segments_;
+  // Sum of literal segment sizes, used to size the output up front.
+  size_t literal_size_{};
 };
 
 // Helper classes for StructFormatter::StructFormatMapVisitor.
@@ -178,6 +202,17 @@ public:
                              const StreamInfo::StreamInfo& stream_info,
                              absl::string_view local_reply_body) const;
 
+  /**
+   * Serializes the formatted structure as JSON and appends it to output. Keys and values are
+   * written directly rather than going through an intermediate Struct proto. Keys are emitted in
+   * lexicographic order.
+   */
+  void formatJson(const Http::RequestHeaderMap& request_headers,
+                  const Http::ResponseHeaderMap& response_headers,
+                  const Http::ResponseTrailerMap& response_trailers,
+                  const StreamInfo::StreamInfo& stream_info, absl::string_view local_reply_body,
+                  std::string& output) const;
+
 private:
   struct StructFormatMapWrapper;
   struct StructFormatListWrapper;
@@ -203,6 +238,13 @@ private:
       const std::function<ProtobufWkt::Value(const StructFormatter::StructFormatMapWrapper&)>,
       const std::function<ProtobufWkt::Value(const StructFormatter::StructFormatListWrapper&)>>;
 
+  // Visitor used by formatJson(). Each callback appends the JSON encoding of its value and returns
+  // false if the value was omitted, in which case nothing was appended.
+  using StructFormatJsonVisitor = StructFormatMapVisitorHelper<
+      const std::function<bool(const std::vector<FormatterProviderPtr>&)>,
+      const std::function<bool(const StructFormatter::StructFormatMapWrapper&)>,
+      const std::function<bool(const StructFormatter::StructFormatListWrapper&)>>;
+
   // Methods for building the format map.
   class FormatBuilder {
   public:
@@ -232,6 +274,20 @@ private:
   structFormatListCallback(const StructFormatter::StructFormatListWrapper& format_list,
                            const StructFormatMapVisitor& visitor) const;
 
+  // Methods for writing JSON directly.
+  bool providersJsonCallback(const std::vector<FormatterProviderPtr>& providers,
+                             const Http::RequestHeaderMap& request_headers,
+                             const Http::ResponseHeaderMap& response_headers,
+                             const Http::ResponseTrailerMap& response_trailers,
+                             const StreamInfo::StreamInfo& stream_info,
+                             absl::string_view local_reply_body, std::string& output) const;
+  void structFormatMapJsonCallback(const StructFormatter::StructFormatMapWrapper& format_map,
+                                   const StructFormatJsonVisitor& visitor,
+                                   std::string& output) const;
+  void structFormatListJsonCallback(const StructFormatter::StructFormatListWrapper& format_list,
+                                    const StructFormatJsonVisitor& visitor,
+                                    std::string& output) const;
+
   const bool omit_empty_values_;
   const bool preserve_types_;
   const std::string empty_value_;
@@ -277,6 +333,8 @@ public:
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
 
+  const std::string& value() const { return str_.string_value(); }
+
 private:
   ProtobufWkt::Value str_;
 };
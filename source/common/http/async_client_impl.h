@@ -191,7 +191,7 @@ private:
     Stats::StatName statName() const override { return {}; }
     const Router::RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
     const Router::CorsPolicy* corsPolicy() const override { return nullptr; }
-    const Router::Config& routeConfig() const override { return route_configuration_; }
+    const Router::CommonConfig& routeConfig() const override { return route_configuration_; }
     const Router::RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override {
       return nullptr;
     }
@@ -14,11 +14,10 @@ absl::string_view describePool(const ConnectionPool::Instance& pool) {
 }
 } // namespace
 
-ConnectivityGrid::WrapperCallbacks::WrapperCallbacks(ConnectivityGrid& grid,
-                                                     Http::ResponseDecoder& decoder,
-                                                     PoolIterator pool_it,
-                                                     ConnectionPool::Callbacks& callbacks)
-    : grid_(grid), decoder_(decoder), inner_callbacks_(&callbacks),
+ConnectivityGrid::WrapperCallbacks::WrapperCallbacks(
+    ConnectivityGrid& grid, Http::ResponseDecoder& decoder, PoolIterator pool_it,
+    ConnectionPool::Callbacks& callbacks, const ConnectionPool::StreamOptions& stream_options)
+    : grid_(grid), decoder_(decoder), stream_options_(stream_options), inner_callbacks_(&callbacks),
       next_attempt_timer_(
           grid_.dispatcher_.createTimer([this]() -> void { tryAnotherConnection(); })),
       current_(pool_it) {}
@@ -36,7 +35,7 @@ ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::~ConnectionAttem
 
 ConnectivityGrid::StreamCreationResult
 ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::newStream() {
-  auto* cancellable = pool().newStream(parent_.decoder_, *this);
+  auto* cancellable = pool().newStreamWithOptions(parent_.decoder_, *this, parent_.stream_options_);
   if (cancellable == nullptr) {
     return StreamCreationResult::ImmediateResult;
   }
@@ -246,6 +245,13 @@ bool ConnectivityGrid::hasActiveConnections() const {
 
 ConnectionPool::Cancellable* ConnectivityGrid::newStream(Http::ResponseDecoder& decoder,
                                                          ConnectionPool::Callbacks& callbacks) {
+  return newStreamWithOptions(decoder, callbacks, {});
+}
+
+ConnectionPool::Cancellable*
+ConnectivityGrid::newStreamWithOptions(Http::ResponseDecoder& decoder,
+                                       ConnectionPool::Callbacks& callbacks,
+                                       const ConnectionPool::StreamOptions& stream_options) {
   if (pools_.empty()) {
     createNextPool();
   }
@@ -255,7 +261,12 @@ ConnectionPool::Cancellable* ConnectivityGrid::newStream(Http::ResponseDecoder&
     createNextPool();
     ++pool;
   }
-  auto wrapped_callback = std::make_unique<WrapperCallbacks>(*this, decoder, pool, callbacks);
+  // A stream sent as early data is handed to the caller before the QUIC handshake completes, and
+  // could not fall back to TCP if the handshake then failed. Streams wait for the handshake.
+  ConnectionPool::StreamOptions options = stream_options;
+  options.can_send_early_data_ = false;
+  auto wrapped_callback =
+      std::make_unique<WrapperCallbacks>(*this, decoder, pool, callbacks, options);
   ConnectionPool::Cancellable* ret = wrapped_callback.get();
   LinkedList::moveIntoList(std::move(wrapped_callback), wrapped_callbacks_);
   if (wrapped_callbacks_.front()->newStream() == StreamCreationResult::ImmediateResult) {
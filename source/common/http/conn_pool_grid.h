@@ -37,7 +37,8 @@ public:
                            public LinkedObject<WrapperCallbacks> {
   public:
     WrapperCallbacks(ConnectivityGrid& grid, Http::ResponseDecoder& decoder, PoolIterator pool_it,
-                     ConnectionPool::Callbacks& callbacks);
+                     ConnectionPool::Callbacks& callbacks,
+                     const ConnectionPool::StreamOptions& stream_options);
 
     // This holds state for a single connection attempt to a specific pool.
     class ConnectionAttemptCallbacks : public ConnectionPool::Callbacks,
@@ -112,6 +113,8 @@ public:
     ConnectivityGrid& grid_;
     // The decoder for the original newStream, needed to create streams on subsequent pools.
     Http::ResponseDecoder& decoder_;
+    // The options of the original newStream, without early data, passed on to each pool.
+    const ConnectionPool::StreamOptions stream_options_;
     // The callbacks from the original caller, which must get onPoolFailure or
     // onPoolReady unless there is call to cancel(). Will be nullptr if the caller
     // has been notified while attempts are still pending.
@@ -141,6 +144,10 @@ public:
   bool hasActiveConnections() const override;
   ConnectionPool::Cancellable* newStream(Http::ResponseDecoder& response_decoder,
                                          ConnectionPool::Callbacks& callbacks) override;
+  ConnectionPool::Cancellable*
+  newStreamWithOptions(Http::ResponseDecoder& response_decoder,
+                       ConnectionPool::Callbacks& callbacks,
+                       const ConnectionPool::StreamOptions& stream_options) override;
   void addDrainedCallback(DrainedCb cb) override;
   void drainConnections() override;
   Upstream::HostDescriptionConstSharedPtr host() const override;
@@ -493,6 +493,18 @@ bool Utility::isWebSocketUpgradeRequest(const RequestHeaderMap& headers) {
                                  Http::Headers::get().UpgradeValues.WebSocket));
 }
 
+bool Utility::isSafeRequest(const RequestHeaderMap& headers, bool end_stream) {
+  if (!end_stream) {
+    return false;
+  }
+  const absl::string_view method = headers.getMethodValue();
+  return (method == Http::Headers::get().MethodValues.Get ||
+          method == Http::Headers::get().MethodValues.Head ||
+          method == Http::Headers::get().MethodValues.Options ||
+          method == Http::Headers::get().MethodValues.Trace) &&
+         !isUpgrade(headers);
+}
+
 void Utility::sendLocalReply(const bool& is_reset, StreamDecoderFilterCallbacks& callbacks,
                              const LocalReplyData& local_reply_data) {
   absl::string_view details;
@@ -312,6 +312,14 @@ bool isH2UpgradeRequest(const RequestHeaderMap& headers);
  */
 bool isWebSocketUpgradeRequest(const RequestHeaderMap& headers);
 
+/**
+ * Determine whether this request can be replayed without side effects, as early data can be. It
+ * must have a safe method (RFC 7231 section 4.2.1) and no body. Upgrade requests are never safe.
+ * @param headers supplies the request headers.
+ * @param end_stream supplies whether the request ends with its headers.
+ */
+bool isSafeRequest(const RequestHeaderMap& headers, bool end_stream);
+
 struct EncodeFunctions {
   // Function to modify locally generated response headers.
   std::function<void(ResponseHeaderMap& headers)> modify_headers_;
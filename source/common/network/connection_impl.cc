@@ -806,6 +806,9 @@ void ServerConnectionImpl::raiseEvent(ConnectionEvent event) {
   case ConnectionEvent::LocalClose:
     transport_connect_pending_ = false;
     transport_socket_connect_timer_.reset();
+    break;
+  case ConnectionEvent::ConnectedZeroRtt:
+    break;
   }
   ConnectionImpl::raiseEvent(event);
 }
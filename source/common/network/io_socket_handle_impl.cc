@@ -213,7 +213,7 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
     message.msg_control = nullptr;
     message.msg_controllen = 0;
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
-    auto io_result = sysCallResultToIoCallResult(result);
+    auto io_result = sendmsgResultToIoCallResult(result);
     // Emulated edge events need to registered if the socket operation did not complete
     // because the socket would block.
     if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
@@ -263,7 +263,7 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
       *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip->ipv6()->address();
     }
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
-    auto io_result = sysCallResultToIoCallResult(result);
+    auto io_result = sendmsgResultToIoCallResult(result);
     // Emulated edge events need to registered if the socket operation did not complete
     // because the socket would block.
     if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
@@ -546,7 +546,12 @@ Api::SysCallIntResult IoSocketHandleImpl::connect(Address::InstanceConstSharedPt
 
 Api::SysCallIntResult IoSocketHandleImpl::setOption(int level, int optname, const void* optval,
                                                     socklen_t optlen) {
-  return Api::OsSysCallsSingleton::get().setsockopt(fd_, level, optname, optval, optlen);
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().setsockopt(fd_, level, optname, optval, optlen);
+  if (result.rc_ == 0 && level == SOL_UDP && optname == UDP_SEGMENT) {
+    udp_segment_set_ = *static_cast<const int*>(optval) != 0;
+  }
+  return result;
 }
 
 Api::SysCallIntResult IoSocketHandleImpl::getOption(int level, int optname, void* optval,
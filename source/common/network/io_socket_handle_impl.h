@@ -100,10 +100,23 @@ protected:
              : Api::IoErrorPtr(new IoSocketError(result.errno_), IoSocketError::deleteIoError)));
   }
 
+  // Converts the result of a sendmsg() call. Once a UDP_SEGMENT size is set, the kernel also fails
+  // sends with EINVAL if the segments exceed the path MTU, which the caller has to handle.
+  Api::IoCallUint64Result sendmsgResultToIoCallResult(const Api::SysCallSizeResult& result) {
+    if (result.rc_ < 0 && result.errno_ == SOCKET_ERROR_INVAL && udp_segment_set_) {
+      return Api::IoCallUint64Result(
+          /*rc=*/0,
+          Api::IoErrorPtr(new IoSocketError(result.errno_), IoSocketError::deleteIoError));
+    }
+    return sysCallResultToIoCallResult(result);
+  }
+
   os_fd_t fd_;
   int socket_v6only_{false};
   const absl::optional<int> domain_;
   Event::FileEventPtr file_event_{nullptr};
+  // Whether a UDP_SEGMENT size is set on the socket.
+  bool udp_segment_set_{false};
 
   // The minimum cmsg buffer size to filled in destination address, packets dropped and gso
   // size when receiving a packet. It is possible for a received packet to contain both IPv4
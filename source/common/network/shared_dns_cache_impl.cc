@@ -0,0 +1,164 @@
+#include "source/common/network/shared_dns_cache_impl.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+SINGLETON_MANAGER_REGISTRATION(shared_dns_cache);
+
+SharedDnsCacheImpl::SharedDnsCacheImpl(DnsResolverSharedPtr resolver, TimeSource& time_source,
+                                       std::chrono::seconds max_ttl, Stats::Scope& root_scope)
+    : resolver_(std::move(resolver)), time_source_(time_source), max_ttl_(max_ttl),
+      scope_(root_scope.createScope("dns.shared_cache.")), stats_(generateStats(*scope_)) {}
+
+SharedDnsCacheImpl::~SharedDnsCacheImpl() {
+  for (const auto& pending_query : pending_queries_) {
+    if (pending_query.second->active_query_ != nullptr) {
+      pending_query.second->active_query_->cancel(ActiveDnsQuery::CancelReason::QueryAbandoned);
+    }
+  }
+}
+
+void SharedDnsCacheImpl::registerSingleton(Singleton::Manager& singleton_manager,
+                                           std::shared_ptr<SharedDnsCacheImpl> cache) {
+  singleton_manager.getTyped<SharedDnsCacheImpl>(
+      SINGLETON_MANAGER_REGISTERED_NAME(shared_dns_cache), [cache] { return cache; });
+}
+
+std::shared_ptr<SharedDnsCacheImpl>
+SharedDnsCacheImpl::singleton(Singleton::Manager& singleton_manager) {
+  return singleton_manager.getTyped<SharedDnsCacheImpl>(
+      SINGLETON_MANAGER_REGISTERED_NAME(shared_dns_cache), [] { return nullptr; });
+}
+
+SharedDnsCacheStats SharedDnsCacheImpl::generateStats(Stats::Scope& scope) {
+  return {ALL_SHARED_DNS_CACHE_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope))};
+}
+
+ActiveDnsQuery* SharedDnsCacheImpl::resolve(const std::string& dns_name,
+                                            DnsLookupFamily dns_lookup_family,
+                                            ResolveCb callback) {
+  Key key{dns_name, dns_lookup_family};
+
+  const auto cached = cache_.find(key);
+  if (cached != cache_.end()) {
+    const MonotonicTime now = time_source_.monotonicTime();
+    if (now < cached->second.expiry_) {
+      ENVOY_LOG(trace, "dns resolution for {} served from the shared cache", dns_name);
+      stats_.cache_hits_.inc();
+      // Round up, so that an answer is not advertised with a zero TTL before it expires.
+      const auto ttl = std::chrono::ceil<std::chrono::seconds>(cached->second.expiry_ - now);
+      std::list<DnsResponse> response;
+      for (const auto& resp : cached->second.response_) {
+        response.emplace_back(resp.address_, ttl);
+      }
+      callback(ResolutionStatus::Success, std::move(response));
+      return nullptr;
+    }
+    cache_.erase(cached);
+    stats_.cache_entries_.set(cache_.size());
+  }
+
+  const auto pending = pending_queries_.find(key);
+  if (pending != pending_queries_.end()) {
+    ENVOY_LOG(trace, "dns resolution for {} joins a pending query", dns_name);
+    stats_.coalesced_queries_.inc();
+    auto waiter = std::make_unique<Waiter>(*pending->second, std::move(callback));
+    Waiter& ret = *waiter;
+    LinkedList::moveIntoListBack(std::move(waiter), pending->second->waiters_);
+    return &ret;
+  }
+
+  stats_.queries_.inc();
+  auto pending_query = std::make_unique<PendingQuery>(*this, key);
+  PendingQuery& query = *pending_query;
+  auto waiter = std::make_unique<Waiter>(query, std::move(callback));
+  Waiter& ret = *waiter;
+  LinkedList::moveIntoListBack(std::move(waiter), query.waiters_);
+  pending_queries_.emplace(key, std::move(pending_query));
+
+  ActiveDnsQuery* active_query =
+      resolver_->resolve(dns_name, dns_lookup_family,
+                         [this, key](ResolutionStatus status, std::list<DnsResponse>&& response) {
+                           onResolved(key, status, std::move(response));
+                         });
+  // The pending query and its waiters are gone if the resolution completed inline.
+  if (active_query == nullptr) {
+    return nullptr;
+  }
+  query.active_query_ = active_query;
+  return &ret;
+}
+
+void SharedDnsCacheImpl::onResolved(const Key& key, ResolutionStatus status,
+                                    std::list<DnsResponse>&& response) {
+  const auto it = pending_queries_.find(key);
+  ASSERT(it != pending_queries_.end());
+  PendingQueryPtr pending_query = std::move(it->second);
+  pending_queries_.erase(it);
+  pending_query->resolved_ = true;
+
+  if (status == ResolutionStatus::Success && !response.empty()) {
+    insert(key, response);
+  }
+
+  // A callback may cancel the waiters that have not been called yet, so they are removed from the
+  // list one at a time.
+  auto& waiters = pending_query->waiters_;
+  while (!waiters.empty()) {
+    WaiterPtr waiter = waiters.front()->removeFromList(waiters);
+    if (waiters.empty()) {
+      waiter->callback_(status, std::move(response));
+    } else {
+      std::list<DnsResponse> copy(response);
+      waiter->callback_(status, std::move(copy));
+    }
+  }
+}
+
+void SharedDnsCacheImpl::insert(const Key& key, const std::list<DnsResponse>& response) {
+  std::chrono::seconds ttl = max_ttl_;
+  for (const auto& resp : response) {
+    ttl = std::min(ttl, resp.ttl_);
+  }
+  if (ttl.count() <= 0) {
+    return;
+  }
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  if (cache_.size() >= 2 * sweep_size_) {
+    for (auto it = cache_.begin(); it != cache_.end();) {
+      if (now >= it->second.expiry_) {
+        cache_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    sweep_size_ = std::max<size_t>(cache_.size(), 1);
+  }
+
+  cache_.insert_or_assign(key, CacheEntry{response, now + ttl});
+  stats_.cache_entries_.set(cache_.size());
+}
+
+void SharedDnsCacheImpl::Waiter::cancel(CancelReason reason) {
+  parent_.parent_.onWaiterCancelled(*this, reason);
+}
+
+void SharedDnsCacheImpl::onWaiterCancelled(Waiter& waiter, ActiveDnsQuery::CancelReason reason) {
+  PendingQuery& pending_query = waiter.parent_;
+  waiter.removeFromList(pending_query.waiters_);
+  if (pending_query.resolved_ || !pending_query.waiters_.empty()) {
+    return;
+  }
+
+  // Nobody waits for the answer anymore.
+  ENVOY_LOG(trace, "dns resolution for {} cancelled", pending_query.key_.first);
+  ASSERT(pending_query.active_query_ != nullptr);
+  pending_query.active_query_->cancel(reason);
+  pending_queries_.erase(pending_queries_.find(pending_query.key_));
+}
+
+} // namespace Network
+} // namespace Envoy
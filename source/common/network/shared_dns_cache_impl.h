@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/network/dns.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/linked_object.h"
+#include "source/common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * All shared DNS cache stats. @see stats_macros.h
+ */
+#define ALL_SHARED_DNS_CACHE_STATS(COUNTER, GAUGE)                                                 \
+  COUNTER(cache_hits)                                                                              \
+  COUNTER(coalesced_queries)                                                                       \
+  COUNTER(queries)                                                                                 \
+  GAUGE(cache_entries, NeverImport)
+
+/**
+ * Struct definition for all shared DNS cache stats. @see stats_macros.h
+ */
+struct SharedDnsCacheStats {
+  ALL_SHARED_DNS_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A DnsResolver that shares the resolutions of another resolver between its callers. Concurrent
+ * queries for the same name and lookup family are coalesced into one query, and successful
+ * answers are cached for the smallest TTL of their records, capped by a maximum TTL. Cached
+ * answers are returned inline, with the TTL they have left, so that the callers refresh them when
+ * they expire. Failures are not cached. All calls and callbacks are assumed to happen on the
+ * thread that owns the wrapped resolver.
+ */
+class SharedDnsCacheImpl : public DnsResolver,
+                           public Singleton::Instance,
+                           protected Logger::Loggable<Logger::Id::upstream> {
+public:
+  SharedDnsCacheImpl(DnsResolverSharedPtr resolver, TimeSource& time_source,
+                     std::chrono::seconds max_ttl, Stats::Scope& root_scope);
+  ~SharedDnsCacheImpl() override;
+
+  /**
+   * Makes the cache available to the components resolving with the default DNS resolver.
+   */
+  static void registerSingleton(Singleton::Manager& singleton_manager,
+                                std::shared_ptr<SharedDnsCacheImpl> cache);
+
+  /**
+   * @return the cache registered with registerSingleton(), or nullptr if there is none.
+   */
+  static std::shared_ptr<SharedDnsCacheImpl> singleton(Singleton::Manager& singleton_manager);
+
+  const SharedDnsCacheStats& stats() const { return stats_; }
+
+  // Network::DnsResolver
+  ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                          ResolveCb callback) override;
+
+private:
+  using Key = std::pair<std::string, DnsLookupFamily>;
+  struct PendingQuery;
+
+  // A caller waiting for the answer of a pending query.
+  struct Waiter : public ActiveDnsQuery, public LinkedObject<Waiter> {
+    Waiter(PendingQuery& parent, ResolveCb callback)
+        : parent_(parent), callback_(std::move(callback)) {}
+
+    // Network::ActiveDnsQuery
+    void cancel(CancelReason reason) override;
+
+    PendingQuery& parent_;
+    ResolveCb callback_;
+  };
+  using WaiterPtr = std::unique_ptr<Waiter>;
+
+  // A query to the wrapped resolver and the callers waiting for its answer.
+  struct PendingQuery {
+    PendingQuery(SharedDnsCacheImpl& parent, const Key& key) : parent_(parent), key_(key) {}
+
+    SharedDnsCacheImpl& parent_;
+    const Key key_;
+    ActiveDnsQuery* active_query_{};
+    // Set once the answer is being delivered to the waiters.
+    bool resolved_{};
+    std::list<WaiterPtr> waiters_;
+  };
+  using PendingQueryPtr = std::unique_ptr<PendingQuery>;
+
+  struct CacheEntry {
+    std::list<DnsResponse> response_;
+    MonotonicTime expiry_;
+  };
+
+  void onResolved(const Key& key, ResolutionStatus status, std::list<DnsResponse>&& response);
+  void onWaiterCancelled(Waiter& waiter, ActiveDnsQuery::CancelReason reason);
+  void insert(const Key& key, const std::list<DnsResponse>& response);
+
+  static SharedDnsCacheStats generateStats(Stats::Scope& scope);
+
+  const DnsResolverSharedPtr resolver_;
+  TimeSource& time_source_;
+  const std::chrono::seconds max_ttl_;
+  Stats::ScopePtr scope_;
+  SharedDnsCacheStats stats_;
+  absl::flat_hash_map<Key, PendingQueryPtr> pending_queries_;
+  absl::flat_hash_map<Key, CacheEntry> cache_;
+  // Expired entries are only removed when they are looked up, so the whole cache is swept once
+  // it has doubled in size since the last sweep.
+  size_t sweep_size_{0};
+};
+
+using SharedDnsCacheImplSharedPtr = std::shared_ptr<SharedDnsCacheImpl>;
+
+} // namespace Network
+} // namespace Envoy
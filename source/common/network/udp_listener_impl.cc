@@ -94,6 +94,13 @@ void UdpListenerImpl::processPacket(Address::InstanceConstSharedPtr local_addres
   cb_.onData(std::move(recvData));
 }
 
+void UdpListenerImpl::processPackets(absl::Span<UdpRecvData> packets) {
+  for (UdpRecvData& packet : packets) {
+    ASSERT(packet.addresses_.local_ != nullptr);
+    cb_.onData(std::move(packet));
+  }
+}
+
 void UdpListenerImpl::handleWriteCallback() {
   ENVOY_UDP_LOG(trace, "handleWriteCallback");
   cb_.onWriteReady(*socket_);
@@ -109,12 +116,29 @@ Api::IoCallUint64Result UdpListenerImpl::send(const UdpSendData& send_data) {
   ENVOY_UDP_LOG(trace, "send");
   Buffer::Instance& buffer = send_data.buffer_;
 
+  UdpPacketWriter& writer = cb_.udpPacketWriter();
   Api::IoCallUint64Result send_result =
-      cb_.udpPacketWriter().writePacket(buffer, send_data.local_ip_, send_data.peer_address_);
+      writer.writePacket(buffer, send_data.local_ip_, send_data.peer_address_);
 
   // The send_result normalizes the rc_ value to 0 in error conditions.
   // The drain call is hence 'safe' in success and failure cases.
   buffer.drain(send_result.rc_);
+
+  // A batching writer may hold on to the datagram. Make sure it goes out at the end of this event
+  // loop iteration even if the filters never flush.
+  if (writer.isBatchMode() && send_result.ok()) {
+    if (flush_cb_ == nullptr) {
+      flush_cb_ = dispatcher_.createSchedulableCallback([this]() {
+        const Api::IoCallUint64Result result = flush();
+        if (!result.ok()) {
+          cb_.onSendError(result.err_->getErrorCode());
+        }
+      });
+    }
+    if (!flush_cb_->enabled()) {
+      flush_cb_->scheduleCallbackCurrentIteration();
+    }
+  }
   return send_result;
 }
 
@@ -3,6 +3,7 @@
 #include <atomic>
 
 #include "envoy/common/time.h"
+#include "envoy/event/schedulable_cb.h"
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/event/event_impl_base.h"
@@ -44,6 +45,7 @@ public:
   void processPacket(Address::InstanceConstSharedPtr local_address,
                      Address::InstanceConstSharedPtr peer_address, Buffer::InstancePtr buffer,
                      MonotonicTime receive_time) override;
+  void processPackets(absl::Span<UdpRecvData> packets) override;
   uint64_t maxDatagramSize() const override { return config_.max_rx_datagram_size_; }
   void onDatagramsDropped(uint32_t dropped) override { cb_.onDatagramsDropped(dropped); }
   size_t numPacketsExpectedPerEventLoop() const override {
@@ -63,6 +65,8 @@ private:
 
   TimeSource& time_source_;
   const ResolvedUdpSocketConfig config_;
+  // Flushes the datagrams held by a batching writer at the end of the event loop iteration.
+  Event::SchedulableCallbackPtr flush_cb_;
 };
 
 class UdpListenerWorkerRouterImpl : public UdpListenerWorkerRouter {
@@ -1,6 +1,12 @@
 #include "source/common/network/udp_packet_writer_handler_impl.h"
 
+#include <algorithm>
+#include <cerrno>
+
+#include "envoy/common/platform.h"
+
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/logger.h"
 #include "source/common/network/utility.h"
 
 namespace Envoy {
@@ -24,5 +30,145 @@ Api::IoCallUint64Result UdpDefaultWriter::writePacket(const Buffer::Instance& bu
   return result;
 }
 
+UdpGsoWriter::UdpGsoWriter(Network::IoHandle& io_handle) : io_handle_(io_handle) {}
+
+Api::IoCallUint64Result UdpGsoWriter::writePacket(const Buffer::Instance& buffer,
+                                                  const Address::Ip* local_ip,
+                                                  const Address::Instance& peer_address) {
+  ASSERT(!write_blocked_, "Cannot write while IO handle is blocked.");
+  const uint64_t length = buffer.length();
+  if (num_segments_ > 0 && !canBatch(length, local_ip, peer_address)) {
+    Api::IoCallUint64Result result = sendAndClearBatch();
+    if (!result.ok()) {
+      // The result returned here is the one of the datagram given, which is still buffered. The
+      // error of the previous batch is returned by the next flush().
+      failed_batch_error_ = std::move(result);
+    }
+  }
+
+  if (num_segments_ == 0) {
+    segment_size_ = length;
+    // A datagram too large to be a segment is written on its own.
+    batch_closed_ = length > MaxSegmentSize;
+    local_address_ =
+        local_ip != nullptr ? Utility::parseInternetAddress(local_ip->addressAsString()) : nullptr;
+    peer_address_ = Utility::getAddressWithPort(peer_address, peer_address.ip()->port());
+  } else if (length < segment_size_) {
+    batch_closed_ = true;
+  }
+  batch_.add(buffer);
+  ++num_segments_;
+  return Api::IoCallUint64Result(length,
+                                 Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+}
+
+bool UdpGsoWriter::canBatch(uint64_t length, const Address::Ip* local_ip,
+                            const Address::Instance& peer_address) const {
+  if (batch_closed_ || num_segments_ >= MaxSegments || length == 0 || length > segment_size_ ||
+      batch_.length() + length > MaxBatchSize || !(peer_address == *peer_address_)) {
+    return false;
+  }
+  if (local_ip == nullptr || local_address_ == nullptr) {
+    return local_ip == nullptr && local_address_ == nullptr;
+  }
+  return local_ip->addressAsString() == local_address_->ip()->addressAsString();
+}
+
+Api::IoCallUint64Result UdpGsoWriter::flush() {
+  Api::IoCallUint64Result result = sendAndClearBatch();
+  if (failed_batch_error_.has_value()) {
+    if (result.ok()) {
+      result = std::move(failed_batch_error_.value());
+    }
+    failed_batch_error_.reset();
+  }
+  return result;
+}
+
+Api::IoCallUint64Result UdpGsoWriter::sendAndClearBatch() {
+  if (num_segments_ == 0) {
+    return Api::IoCallUint64Result(
+        /*rc=*/0,
+        /*err=*/Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+  }
+
+  Api::IoCallUint64Result result = sendBatch();
+  // Datagrams which could not be written are dropped, as with the default writer.
+  batch_.drain(batch_.length());
+  num_segments_ = 0;
+  batch_closed_ = false;
+  local_address_ = nullptr;
+  peer_address_ = nullptr;
+  if (result.err_ && result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+    // Writer is blocked when error code received is EWOULDBLOCK/EAGAIN
+    write_blocked_ = true;
+  }
+  return result;
+}
+
+Api::IoCallUint64Result UdpGsoWriter::sendBatch() {
+  const Address::Ip* local_ip = local_address_ != nullptr ? local_address_->ip() : nullptr;
+  if (num_segments_ == 1) {
+    // A send no larger than the socket's segment size goes out as a single datagram. A lone
+    // datagram larger than it would be split, so the segment size is cleared rather than raised,
+    // as it must not exceed the path MTU.
+    if (socket_segment_size_ != 0 && socket_segment_size_ < segment_size_ && !setSegmentSize(0)) {
+      ENVOY_LOG_MISC(debug, "failed to clear UDP_SEGMENT");
+    }
+    return Utility::writeToSocket(io_handle_, batch_, local_ip, *peer_address_);
+  }
+
+  if (gso_enabled_ && socket_segment_size_ != segment_size_ && !setSegmentSize(segment_size_)) {
+    ENVOY_LOG_MISC(debug, "failed to set UDP_SEGMENT, writing datagrams individually");
+    disableGso();
+  }
+  if (gso_enabled_) {
+    Api::IoCallUint64Result result =
+        Utility::writeToSocket(io_handle_, batch_, local_ip, *peer_address_);
+    // The kernel fails segmented sends with EINVAL if the segments exceed the path MTU, and with
+    // EIO if the egress device can't checksum them. The batch is still intact and is resent
+    // datagram by datagram.
+    if (result.ok() || (result.err_->getSystemErrorCode() != SOCKET_ERROR_INVAL &&
+                        result.err_->getSystemErrorCode() != EIO)) {
+      return result;
+    }
+    ENVOY_LOG_MISC(debug, "segmented send failed: {}, writing datagrams individually",
+                   result.err_->getErrorDetails());
+    disableGso();
+  }
+
+  // Without GSO, the batch is made of segment_size_ long datagrams and a possibly shorter last one.
+  uint64_t bytes_sent = 0;
+  while (batch_.length() > 0) {
+    Buffer::OwnedImpl datagram;
+    datagram.move(batch_, std::min(segment_size_, batch_.length()));
+    Api::IoCallUint64Result result =
+        Utility::writeToSocket(io_handle_, datagram, local_ip, *peer_address_);
+    if (!result.ok()) {
+      return result;
+    }
+    bytes_sent += result.rc_;
+  }
+  return Api::IoCallUint64Result(bytes_sent,
+                                 Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+}
+
+bool UdpGsoWriter::setSegmentSize(uint64_t segment_size) {
+  const int value = static_cast<int>(segment_size);
+  if (io_handle_.setOption(SOL_UDP, UDP_SEGMENT, &value, sizeof(value)).rc_ != 0) {
+    return false;
+  }
+  socket_segment_size_ = segment_size;
+  return true;
+}
+
+void UdpGsoWriter::disableGso() {
+  gso_enabled_ = false;
+  // Datagrams written individually must not be split by a segment size left on the socket.
+  if (socket_segment_size_ != 0 && !setSegmentSize(0)) {
+    ENVOY_LOG_MISC(debug, "failed to clear UDP_SEGMENT");
+  }
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -4,8 +4,11 @@
 #include "envoy/network/socket.h"
 #include "envoy/network/udp_packet_writer_handler.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/network/io_socket_error_impl.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Network {
 
@@ -49,5 +52,85 @@ public:
   }
 };
 
+/**
+ * Writer coalescing consecutive datagrams to the same peer into a single sendmsg call, which the
+ * kernel splits back into datagrams using UDP generic segmentation offload (UDP_SEGMENT). A batch
+ * holds datagrams of one size, optionally followed by a single shorter one, as GSO requires.
+ * Datagrams larger than MaxSegmentSize are written on their own. Datagrams are held until flush()
+ * is called or the next datagram can't join the batch, so the user of the writer must flush it at
+ * the end of each event loop iteration. Only used where the OS supports GSO, see
+ * Api::OsSysCalls::supportsUdpGso(). If the socket or the egress device turns out not to support
+ * GSO, the writer falls back to writing datagram by datagram.
+ */
+class UdpGsoWriter : public UdpPacketWriter {
+public:
+  UdpGsoWriter(Network::IoHandle& io_handle);
+
+  // Network::UdpPacketWriter
+  Api::IoCallUint64Result writePacket(const Buffer::Instance& buffer, const Address::Ip* local_ip,
+                                      const Address::Instance& peer_address) override;
+  bool isWriteBlocked() const override { return write_blocked_; }
+  void setWritable() override { write_blocked_ = false; }
+  uint64_t getMaxPacketSize(const Address::Instance& /*peer_address*/) const override {
+    return Network::UdpMaxOutgoingPacketSize;
+  }
+  bool isBatchMode() const override { return true; }
+  Network::UdpPacketWriterBuffer
+  getNextWriteLocation(const Address::Ip* /*local_ip*/,
+                       const Address::Instance& /*peer_address*/) override {
+    return {nullptr, 0, nullptr};
+  }
+  // Also returns the error of a batch writePacket() failed to write since the last flush, if the
+  // current batch was written successfully.
+  Api::IoCallUint64Result flush() override;
+
+  /**
+   * @return uint32_t the number of datagrams waiting for the next flush.
+   */
+  uint32_t bufferedDatagrams() const { return num_segments_; }
+
+  // The kernel rejects sends of more segments than this.
+  static constexpr uint32_t MaxSegments = 64;
+  // The payload of a batch has to fit in a single IP packet.
+  static constexpr uint64_t MaxBatchSize = 65507;
+  // The kernel rejects GSO sends with segments exceeding the path MTU. This is the largest UDP
+  // payload which fits a 1500 byte MTU with an IPv6 header.
+  static constexpr uint64_t MaxSegmentSize = 1452;
+
+private:
+  bool canBatch(uint64_t length, const Address::Ip* local_ip,
+                const Address::Instance& peer_address) const;
+  Api::IoCallUint64Result sendAndClearBatch();
+  Api::IoCallUint64Result sendBatch();
+  bool setSegmentSize(uint64_t segment_size);
+  void disableGso();
+
+  Network::IoHandle& io_handle_;
+  bool write_blocked_{};
+  // Cleared if the socket rejects UDP_SEGMENT or a segmented send, after which batches are written
+  // datagram by datagram.
+  bool gso_enabled_{true};
+  // The UDP_SEGMENT value currently set on the socket, 0 if none. Any send larger than it is
+  // segmented.
+  uint64_t socket_segment_size_{};
+  Buffer::OwnedImpl batch_;
+  uint64_t segment_size_{};
+  uint32_t num_segments_{};
+  // Set once a datagram shorter than segment_size_ was added, which has to be the last one.
+  bool batch_closed_{};
+  Address::InstanceConstSharedPtr local_address_;
+  Address::InstanceConstSharedPtr peer_address_;
+  // Error of the last batch writePacket() failed to write to make room for a datagram.
+  absl::optional<Api::IoCallUint64Result> failed_batch_error_;
+};
+
+class UdpGsoWriterFactory : public Network::UdpPacketWriterFactory {
+public:
+  Network::UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                    Stats::Scope&) override {
+    return std::make_unique<UdpGsoWriter>(io_handle);
+  }
+};
+
 } // namespace Network
 } // namespace Envoy
@@ -1,6 +1,8 @@
 #include "source/common/network/utility.h"
 
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <list>
 #include <memory>
 #include <sstream>
@@ -27,8 +29,10 @@
 #include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Network {
@@ -118,6 +122,97 @@ Api::IoCallUint64Result receiveMessage(uint64_t max_rx_datagram_size, Buffer::In
 
 } // namespace
 
+// A block of a UdpRecvArena. It is referenced by the arena while it is the arena's current block,
+// and by each datagram received into it. The references are counted explicitly, as the datagrams
+// may be released on other workers and the arena relies on the count to reuse the block. The
+// buffer fragments of the datagrams live with the block and are reused along with it.
+class UdpRecvArena::Block {
+public:
+  explicit Block(uint64_t size) : memory_(new uint8_t[size]) {}
+
+  uint8_t* memory() { return memory_.get(); }
+
+  // Whether all the datagrams received into the block have been released. Only the arena adds
+  // references, so this stays true until the arena hands out another datagram.
+  bool unused() const { return references_.load(std::memory_order_acquire) == 1; }
+
+  // Prepares an unused block for the next receive call.
+  void reuse() {
+    ASSERT(unused());
+    used_fragments_ = 0;
+  }
+
+  // @return the fragment of a datagram received into the block, which references the block until
+  // it is done.
+  Buffer::BufferFragment& fragment(uint64_t offset, uint64_t length) {
+    references_.fetch_add(1, std::memory_order_relaxed);
+    if (used_fragments_ == fragments_.size()) {
+      fragments_.emplace_back(*this);
+    }
+    Fragment& fragment = fragments_[used_fragments_++];
+    fragment.data_ = memory_.get() + offset;
+    fragment.size_ = length;
+    return fragment;
+  }
+
+  // Drops a reference, and deletes the block if it was the last one.
+  void release() {
+    if (references_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+private:
+  class Fragment : public Buffer::BufferFragment {
+  public:
+    explicit Fragment(Block& block) : block_(block) {}
+
+    // Buffer::BufferFragment
+    const void* data() const override { return data_; }
+    size_t size() const override { return size_; }
+    void done() override { block_.release(); }
+
+    Block& block_;
+    const uint8_t* data_{};
+    size_t size_{};
+  };
+
+  const std::unique_ptr<uint8_t[]> memory_;
+  // A deque, so that growing it does not move the fragments handed out.
+  std::deque<Fragment> fragments_;
+  size_t used_fragments_{0};
+  std::atomic<uint32_t> references_{1};
+};
+
+UdpRecvArena::~UdpRecvArena() {
+  if (block_ != nullptr) {
+    block_->release();
+  }
+}
+
+Buffer::RawSlice UdpRecvArena::reserve() {
+  if (block_ != nullptr && block_->unused()) {
+    block_->reuse();
+  } else {
+    if (block_ != nullptr) {
+      block_->release();
+    }
+    block_ = new Block(size_);
+    ++blocks_allocated_;
+  }
+  return {block_->memory(), size_};
+}
+
+Buffer::InstancePtr UdpRecvArena::datagram(uint64_t offset, uint64_t length) {
+  ASSERT(block_ != nullptr && offset + length <= size_);
+  auto buffer = std::make_unique<Buffer::OwnedImpl>();
+  if (length == 0) {
+    return buffer;
+  }
+  buffer->addBufferFragment(block_->fragment(offset, length));
+  return buffer;
+}
+
 std::string Utility::hostFromTcpUrl(const std::string& url) {
   return hostFromUrl(url, TCP_SCHEME, "TCP");
 }
@@ -566,10 +661,8 @@ Api::IoCallUint64Result Utility::writeToSocket(IoHandle& handle, Buffer::RawSlic
   return send_result;
 }
 
-void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
-                            Address::InstanceConstSharedPtr peer_addess,
-                            Address::InstanceConstSharedPtr local_address,
-                            UdpPacketProcessor& udp_packet_processor, MonotonicTime receive_time) {
+void checkPeerAddress(uint64_t bytes_read, const Address::InstanceConstSharedPtr& peer_addess,
+                      const Address::InstanceConstSharedPtr& local_address) {
   RELEASE_ASSERT(
       peer_addess != nullptr,
       fmt::format("Unable to get remote address on the socket bount to local address: {} ",
@@ -580,6 +673,13 @@ void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
                  fmt::format("Unsupported remote address: {} local address: {}, receive size: "
                              "{}",
                              peer_addess->asString(), local_address->asString(), bytes_read));
+}
+
+void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
+                            Address::InstanceConstSharedPtr peer_addess,
+                            Address::InstanceConstSharedPtr local_address,
+                            UdpPacketProcessor& udp_packet_processor, MonotonicTime receive_time) {
+  checkPeerAddress(bytes_read, peer_addess, local_address);
   udp_packet_processor.processPacket(std::move(local_address), std::move(peer_addess),
                                      std::move(buffer), receive_time);
 }
@@ -588,70 +688,64 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
                                                 const Address::Instance& local_address,
                                                 UdpPacketProcessor& udp_packet_processor,
                                                 MonotonicTime receive_time, bool use_gro,
-                                                uint32_t* packets_dropped) {
+                                                uint32_t* packets_dropped, UdpRecvArena* arena) {
+  // The packets of a GRO or recvmmsg read reference one arena block and are passed as a batch.
+  absl::optional<UdpRecvArena> read_arena;
+  if ((use_gro || handle.supportsMmsg()) && arena == nullptr) {
+    arena =
+        &read_arena.emplace(NUM_DATAGRAMS_PER_RECEIVE * udp_packet_processor.maxDatagramSize());
+  }
+  absl::InlinedVector<UdpRecvData, NUM_DATAGRAMS_PER_RECEIVE> packets;
 
   if (use_gro) {
-    Buffer::InstancePtr buffer = std::make_unique<Buffer::OwnedImpl>();
     IoHandle::RecvMsgOutput output(1, packets_dropped);
-
-    // TODO(yugant): Avoid allocating 24k for each read by getting memory from UdpPacketProcessor
-    const uint64_t max_rx_datagram_size_with_gro =
-        NUM_DATAGRAMS_PER_RECEIVE * udp_packet_processor.maxDatagramSize();
+    const uint64_t max_rx_datagram_size_with_gro = arena->size();
     ENVOY_LOG_MISC(trace, "starting gro recvmsg with max={}", max_rx_datagram_size_with_gro);
 
-    Api::IoCallUint64Result result =
-        receiveMessage(max_rx_datagram_size_with_gro, buffer, output, handle, local_address);
+    Buffer::RawSlice slice = arena->reserve();
+    Api::IoCallUint64Result result = handle.recvmsg(&slice, 1, local_address.ip()->port(), output);
 
     if (!result.ok() || output.msg_[0].truncated_and_dropped_) {
       return result;
     }
 
+    const uint64_t bytes_read = std::min(max_rx_datagram_size_with_gro, result.rc_);
     const uint64_t gso_size = output.msg_[0].gso_size_;
     ENVOY_LOG_MISC(trace, "gro recvmsg bytes {} with gso_size as {}", result.rc_, gso_size);
+    checkPeerAddress(bytes_read, output.msg_[0].peer_address_, output.msg_[0].local_address_);
 
-    // Skip gso segmentation and proceed as a single payload.
     if (gso_size == 0u) {
-      passPayloadToProcessor(result.rc_, std::move(buffer), std::move(output.msg_[0].peer_address_),
-                             std::move(output.msg_[0].local_address_), udp_packet_processor,
-                             receive_time);
-      return result;
-    }
-
-    // Segment the buffer read by the recvmsg syscall into gso_sized sub buffers.
-    // TODO(mattklein123): The following code should be optimized to avoid buffer copies, either by
-    // switching to slices or by using a CoW buffer type.
-    while (buffer->length() > 0) {
-      const uint64_t bytes_to_copy = std::min(buffer->length(), gso_size);
-      Buffer::InstancePtr sub_buffer = std::make_unique<Buffer::OwnedImpl>();
-      sub_buffer->move(*buffer, bytes_to_copy);
-      passPayloadToProcessor(bytes_to_copy, std::move(sub_buffer), output.msg_[0].peer_address_,
-                             output.msg_[0].local_address_, udp_packet_processor, receive_time);
+      // Skip gso segmentation and proceed as a single payload.
+      packets.push_back({{std::move(output.msg_[0].local_address_),
+                          std::move(output.msg_[0].peer_address_)},
+                         arena->datagram(0, bytes_read),
+                         receive_time});
+    } else {
+      // Segment the payload read by the recvmsg syscall into gso_sized packets. The packets
+      // reference the arena block, so this does not copy.
+      for (uint64_t offset = 0; offset < bytes_read; offset += gso_size) {
+        packets.push_back({{output.msg_[0].local_address_, output.msg_[0].peer_address_},
+                           arena->datagram(offset, std::min(bytes_read - offset, gso_size)),
+                           receive_time});
+      }
     }
 
+    udp_packet_processor.processPackets(absl::MakeSpan(packets));
     return result;
   }
 
   if (handle.supportsMmsg()) {
     const auto max_rx_datagram_size = udp_packet_processor.maxDatagramSize();
+    ASSERT(arena->size() >= NUM_DATAGRAMS_PER_RECEIVE * max_rx_datagram_size);
 
-    // Buffer::ReservationSingleSlice is always passed by value, and can only be constructed
-    // by Buffer::Instance::reserve(), so this is needed to keep a fixed array
-    // in which all elements are legally constructed.
-    struct BufferAndReservation {
-      BufferAndReservation(uint64_t max_rx_datagram_size)
-          : buffer_(std::make_unique<Buffer::OwnedImpl>()),
-            reservation_(buffer_->reserveSingleSlice(max_rx_datagram_size, true)) {}
-
-      Buffer::InstancePtr buffer_;
-      Buffer::ReservationSingleSlice reservation_;
-    };
+    // Each packet is received into its own max_rx_datagram_size region of the arena block.
     constexpr uint32_t num_slices_per_packet = 1u;
-    absl::InlinedVector<BufferAndReservation, NUM_DATAGRAMS_PER_RECEIVE> buffers;
+    const Buffer::RawSlice block = arena->reserve();
     RawSliceArrays slices(NUM_DATAGRAMS_PER_RECEIVE,
                           absl::FixedArray<Buffer::RawSlice>(num_slices_per_packet));
     for (uint32_t i = 0; i < NUM_DATAGRAMS_PER_RECEIVE; i++) {
-      buffers.push_back(max_rx_datagram_size);
-      slices[i][0] = buffers[i].reservation_.slice();
+      slices[i][0] = {static_cast<uint8_t*>(block.mem_) + i * max_rx_datagram_size,
+                      max_rx_datagram_size};
     }
 
     IoHandle::RecvMsgOutput output(NUM_DATAGRAMS_PER_RECEIVE, packets_dropped);
@@ -669,16 +763,20 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
         continue;
       }
 
-      Buffer::RawSlice* slice = slices[i].data();
       const uint64_t msg_len = output.msg_[i].msg_len_;
-      ASSERT(msg_len <= slice->len_);
+      ASSERT(msg_len <= slices[i][0].len_);
       ENVOY_LOG_MISC(debug, "Receive a packet with {} bytes from {}", msg_len,
                      output.msg_[i].peer_address_->asString());
 
-      buffers[i].reservation_.commit(std::min(max_rx_datagram_size, msg_len));
-
-      passPayloadToProcessor(msg_len, std::move(buffers[i].buffer_), output.msg_[i].peer_address_,
-                             output.msg_[i].local_address_, udp_packet_processor, receive_time);
+      checkPeerAddress(msg_len, output.msg_[i].peer_address_, output.msg_[i].local_address_);
+      packets.push_back({{std::move(output.msg_[i].local_address_),
+                          std::move(output.msg_[i].peer_address_)},
+                         arena->datagram(i * max_rx_datagram_size,
+                                         std::min(max_rx_datagram_size, msg_len)),
+                         receive_time});
+    }
+    if (!packets.empty()) {
+      udp_packet_processor.processPackets(absl::MakeSpan(packets));
     }
     return result;
   }
@@ -720,11 +818,14 @@ Api::IoErrorPtr Utility::readPacketsFromSocket(IoHandle& handle,
   num_reads = std::max<size_t>(1, num_reads);
   bool honor_read_limit =
       Runtime::runtimeFeatureEnabled("envoy.reloadable_features.udp_per_event_loop_read_limit");
+  // Shared by the reads below, so that a block is usually allocated once per read event.
+  UdpRecvArena arena(NUM_DATAGRAMS_PER_RECEIVE * udp_packet_processor.maxDatagramSize());
   do {
     const uint32_t old_packets_dropped = packets_dropped;
     const MonotonicTime receive_time = time_source.monotonicTime();
-    Api::IoCallUint64Result result = Utility::readFromSocket(
-        handle, local_address, udp_packet_processor, receive_time, use_gro, &packets_dropped);
+    Api::IoCallUint64Result result =
+        Utility::readFromSocket(handle, local_address, udp_packet_processor, receive_time, use_gro,
+                                &packets_dropped, &arena);
 
     if (!result.ok()) {
       // No more to read or encountered a system error.
@@ -760,11 +861,16 @@ ResolvedUdpSocketConfig::ResolvedUdpSocketConfig(
     const envoy::config::core::v3::UdpSocketConfig& config, bool prefer_gro_default)
     : max_rx_datagram_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_rx_datagram_size,
                                                             DEFAULT_UDP_MAX_DATAGRAM_SIZE)),
-      prefer_gro_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, prefer_gro, prefer_gro_default)) {
+      prefer_gro_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, prefer_gro, prefer_gro_default)),
+      prefer_gso_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, prefer_gso, false)) {
   if (prefer_gro_ && !Api::OsSysCallsSingleton::get().supportsUdpGro()) {
     ENVOY_LOG_MISC(
         warn, "GRO requested but not supported by the OS. Check OS config or disable prefer_gro.");
   }
+  if (prefer_gso_ && !Api::OsSysCallsSingleton::get().supportsUdpGso()) {
+    ENVOY_LOG_MISC(
+        warn, "GSO requested but not supported by the OS. Check OS config or disable prefer_gso.");
+  }
 }
 
 } // namespace Network
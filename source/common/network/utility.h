@@ -10,6 +10,7 @@
 #include "envoy/network/listener.h"
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 namespace Envoy {
 namespace Network {
@@ -50,6 +51,18 @@ public:
                              Address::InstanceConstSharedPtr peer_address,
                              Buffer::InstancePtr buffer, MonotonicTime receive_time) PURE;
 
+  /**
+   * Consume the packets read out of the socket by one receive call. The default implementation
+   * passes them to processPacket() one at a time.
+   * @param packets supplies the packets read. Their contents may be moved out.
+   */
+  virtual void processPackets(absl::Span<UdpRecvData> packets) {
+    for (UdpRecvData& packet : packets) {
+      processPacket(std::move(packet.addresses_.local_), std::move(packet.addresses_.peer_),
+                    std::move(packet.buffer_), packet.receive_time_);
+    }
+  }
+
   /**
    * Called whenever datagrams are dropped due to overflow or truncation.
    * @param dropped supplies the number of dropped datagrams.
@@ -72,6 +85,44 @@ static const uint64_t DEFAULT_UDP_MAX_DATAGRAM_SIZE = 1500;
 static const uint64_t NUM_DATAGRAMS_PER_RECEIVE = 16;
 static const uint64_t MAX_NUM_PACKETS_PER_EVENT_LOOP = 6000;
 
+/**
+ * Memory that UDP datagrams are received into. The datagrams of a receive call are handed out as
+ * buffers referencing the arena's current block rather than as separately allocated copies. The
+ * block, and the buffer fragments of its datagrams, are reused by the next receive call once all
+ * the datagrams of the previous one have been released, which is the common case as packet
+ * processors consume datagrams inline. Otherwise a new block is allocated, and the old one lives
+ * until its last datagram is released, on whichever thread that happens. Each datagram still
+ * takes a buffer of its own, as it is owned by whoever it is passed to.
+ */
+class UdpRecvArena {
+public:
+  explicit UdpRecvArena(uint64_t size) : size_(size) {}
+  ~UdpRecvArena();
+  UdpRecvArena(const UdpRecvArena&) = delete;
+  UdpRecvArena& operator=(const UdpRecvArena&) = delete;
+
+  /**
+   * @return the memory of the current block to receive into.
+   */
+  Buffer::RawSlice reserve();
+
+  /**
+   * @return a buffer referencing the datagram received at the offset of the memory returned by
+   * the last reserve().
+   */
+  Buffer::InstancePtr datagram(uint64_t offset, uint64_t length);
+
+  uint64_t size() const { return size_; }
+  uint64_t blocksAllocated() const { return blocks_allocated_; }
+
+private:
+  class Block;
+
+  const uint64_t size_;
+  Block* block_{nullptr};
+  uint64_t blocks_allocated_{0};
+};
+
 /**
  * Wrapper which resolves UDP socket proto config with defaults.
  */
@@ -81,6 +132,7 @@ struct ResolvedUdpSocketConfig {
 
   uint64_t max_rx_datagram_size_;
   bool prefer_gro_;
+  bool prefer_gso_;
 };
 
 /**
@@ -363,12 +415,16 @@ public:
    * @param prefer_gro supplies whether to use GRO if the OS supports it.
    * @param packets_dropped is the output parameter for number of packets dropped in kernel. If the
    * caller is not interested in it, nullptr can be passed in.
+   * @param arena supplies the memory that recvmmsg and GRO reads receive into, which must be of
+   * NUM_DATAGRAMS_PER_RECEIVE times the max datagram size. If nullptr, the memory is allocated for
+   * this read. The packets of such a read are passed with one processPackets() call.
    */
   static Api::IoCallUint64Result readFromSocket(IoHandle& handle,
                                                 const Address::Instance& local_address,
                                                 UdpPacketProcessor& udp_packet_processor,
                                                 MonotonicTime receive_time, bool use_gro,
-                                                uint32_t* packets_dropped);
+                                                uint32_t* packets_dropped,
+                                                UdpRecvArena* arena = nullptr);
 
   /**
    * Read some packets from a given UDP socket and pass the packet to a given
@@ -0,0 +1,152 @@
+#include "source/common/protobuf/deterministic_hash.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/hash.h"
+
+namespace Envoy {
+namespace DeterministicProtoHash {
+namespace {
+
+uint64_t hashMessage(const Protobuf::Message& message, uint64_t seed);
+
+template <class T> uint64_t hashScalar(T value, uint64_t seed) {
+  return HashUtil::xxHash64(absl::string_view(reinterpret_cast<const char*>(&value), sizeof(T)),
+                            seed);
+}
+
+// Hashes the value of a singular field if index is negative, otherwise the element at index of a
+// repeated field.
+uint64_t hashFieldValue(const Protobuf::Message& message, const Protobuf::FieldDescriptor& field,
+                        int index, uint64_t seed) {
+  const Protobuf::Reflection& reflection = *message.GetReflection();
+  const bool repeated = index >= 0;
+  switch (field.cpp_type()) {
+  case Protobuf::FieldDescriptor::CPPTYPE_INT32:
+    return hashScalar(repeated ? reflection.GetRepeatedInt32(message, &field, index)
+                               : reflection.GetInt32(message, &field),
+                      seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_INT64:
+    return hashScalar(repeated ? reflection.GetRepeatedInt64(message, &field, index)
+                               : reflection.GetInt64(message, &field),
+                      seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_UINT32:
+    return hashScalar(repeated ? reflection.GetRepeatedUInt32(message, &field, index)
+                               : reflection.GetUInt32(message, &field),
+                      seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_UINT64:
+    return hashScalar(repeated ? reflection.GetRepeatedUInt64(message, &field, index)
+                               : reflection.GetUInt64(message, &field),
+                      seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+    return hashScalar(repeated ? reflection.GetRepeatedDouble(message, &field, index)
+                               : reflection.GetDouble(message, &field),
+                      seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+    return hashScalar(repeated ? reflection.GetRepeatedFloat(message, &field, index)
+                               : reflection.GetFloat(message, &field),
+                      seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_BOOL:
+    return hashScalar(repeated ? reflection.GetRepeatedBool(message, &field, index)
+                               : reflection.GetBool(message, &field),
+                      seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_ENUM:
+    return hashScalar(repeated ? reflection.GetRepeatedEnumValue(message, &field, index)
+                               : reflection.GetEnumValue(message, &field),
+                      seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_STRING: {
+    std::string scratch;
+    const std::string& value =
+        repeated ? reflection.GetRepeatedStringReference(message, &field, index, &scratch)
+                 : reflection.GetStringReference(message, &field, &scratch);
+    return HashUtil::xxHash64(value, seed);
+  }
+  case Protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+    return hashMessage(repeated ? reflection.GetRepeatedMessage(message, &field, index)
+                                : reflection.GetMessage(message, &field),
+                       seed);
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+uint64_t hashField(const Protobuf::Message& message, const Protobuf::FieldDescriptor& field,
+                   uint64_t seed) {
+  seed = hashScalar(field.number(), seed);
+  if (!field.is_repeated()) {
+    return hashFieldValue(message, field, -1, seed);
+  }
+
+  const int size = message.GetReflection()->FieldSize(message, &field);
+  seed = hashScalar(size, seed);
+  if (!field.is_map()) {
+    for (int i = 0; i < size; ++i) {
+      seed = hashFieldValue(message, field, i, seed);
+    }
+    return seed;
+  }
+
+  // Map iteration order is unspecified, so combine the entry hashes in sorted order.
+  std::vector<uint64_t> entry_hashes;
+  entry_hashes.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    entry_hashes.push_back(hashFieldValue(message, field, i, 0));
+  }
+  std::sort(entry_hashes.begin(), entry_hashes.end());
+  for (const uint64_t entry_hash : entry_hashes) {
+    seed = hashScalar(entry_hash, seed);
+  }
+  return seed;
+}
+
+// Hashes the message packed in an Any if its type is known, like Protobuf::TextFormat does when
+// expanding Any, since the serialized bytes of equal messages may differ (e.g. map order).
+uint64_t hashAny(const Protobuf::Message& any, uint64_t seed) {
+  const Protobuf::Descriptor& descriptor = *any.GetDescriptor();
+  const Protobuf::Reflection& reflection = *any.GetReflection();
+  std::string type_url_scratch;
+  const std::string& type_url =
+      reflection.GetStringReference(any, descriptor.FindFieldByNumber(1), &type_url_scratch);
+  std::string value_scratch;
+  const std::string& value =
+      reflection.GetStringReference(any, descriptor.FindFieldByNumber(2), &value_scratch);
+  seed = HashUtil::xxHash64(type_url, seed);
+
+  const size_t pos = type_url.find_last_of('/');
+  const Protobuf::Descriptor* type = descriptor.file()->pool()->FindMessageTypeByName(
+      pos == std::string::npos ? type_url : type_url.substr(pos + 1));
+  if (type != nullptr) {
+    const Protobuf::Message* prototype = reflection.GetMessageFactory()->GetPrototype(type);
+    if (prototype != nullptr) {
+      std::unique_ptr<Protobuf::Message> unpacked(prototype->New());
+      if (unpacked->ParseFromString(value)) {
+        return hashMessage(*unpacked, seed);
+      }
+    }
+  }
+  return HashUtil::xxHash64(value, seed);
+}
+
+uint64_t hashMessage(const Protobuf::Message& message, uint64_t seed) {
+  if (message.GetDescriptor()->full_name() == "google.protobuf.Any") {
+    return hashAny(message, seed);
+  }
+
+  // ListFields() skips unknown fields and returns the set fields ordered by field number.
+  std::vector<const Protobuf::FieldDescriptor*> fields;
+  message.GetReflection()->ListFields(message, &fields);
+  for (const Protobuf::FieldDescriptor* field : fields) {
+    seed = hashField(message, *field, seed);
+  }
+  return seed;
+}
+
+} // namespace
+
+uint64_t hash(const Protobuf::Message& message) { return hashMessage(message, 0); }
+
+} // namespace DeterministicProtoHash
+} // namespace Envoy
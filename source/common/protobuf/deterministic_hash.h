@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#include "source/common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace DeterministicProtoHash {
+
+/**
+ * Hashes a message by walking its fields with reflection, without serializing it. The hash only
+ * depends on the message contents: map entries are hashed independently of their order, known
+ * types in google.protobuf.Any are hashed as the unpacked message rather than as serialized bytes
+ * and unknown fields are ignored. Equal messages of the same type hash to the same value.
+ * @param message supplies the message to hash.
+ * @return uint64_t the hash.
+ */
+uint64_t hash(const Protobuf::Message& message);
+
+} // namespace DeterministicProtoHash
+} // namespace Envoy
@@ -12,12 +12,14 @@
 #include "source/common/common/fmt.h"
 #include "source/common/config/api_type_oracle.h"
 #include "source/common/config/version_converter.h"
+#include "source/common/protobuf/deterministic_hash.h"
 #include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/protobuf/visitor.h"
 #include "source/common/protobuf/well_known.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/match.h"
 #include "udpa/annotations/sensitive.pb.h"
 #include "yaml-cpp/yaml.h"
@@ -120,6 +122,168 @@ ProtobufWkt::Value parseYamlNode(const YAML::Node& node) {
   return value;
 }
 
+YAML::Node loadYamlNode(const std::string& yaml) {
+  TRY_ASSERT_MAIN_THREAD { return YAML::Load(yaml); }
+  END_TRY
+  catch (YAML::ParserException& e) {
+    throw EnvoyException(e.what());
+  }
+  catch (std::exception& e) {
+    // There is a potentially wide space of exceptions thrown by the YAML parser,
+    // and enumerating them all may be difficult. Envoy doesn't work well with
+    // unhandled exceptions, so we capture them and record the exception name in
+    // the Envoy Exception text.
+    throw EnvoyException(fmt::format("Unexpected YAML exception: {}", +e.what()));
+  }
+}
+
+// Appends the string as a JSON string literal.
+void appendJsonString(absl::string_view value, std::string& json) {
+  json.push_back('"');
+  for (const char c : value) {
+    switch (c) {
+    case '"':
+      json.append("\\\"");
+      break;
+    case '\\':
+      json.append("\\\\");
+      break;
+    case '\n':
+      json.append("\\n");
+      break;
+    case '\r':
+      json.append("\\r");
+      break;
+    case '\t':
+      json.append("\\t");
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        json.append(fmt::format("\\u{:04x}", static_cast<int>(c)));
+      } else {
+        json.push_back(c);
+      }
+    }
+  }
+  json.push_back('"');
+}
+
+// Appends a YAML node as the JSON that MessageToJsonString() prints for the ProtobufWkt::Value
+// built by parseYamlNode(), without building that value. This only uses the public protobuf API:
+// the JSON is parsed by JsonStringToMessage() like any other JSON configuration, so the proto3
+// JSON mapping, errors and unknown field reports are those of the JSON path.
+void appendYamlNodeAsJson(const YAML::Node& node, std::string& json) {
+  switch (node.Type()) {
+  case YAML::NodeType::Null:
+    json.append("null");
+    break;
+  case YAML::NodeType::Scalar: {
+    if (node.Tag() == "!") {
+      appendJsonString(node.Scalar(), json);
+      break;
+    }
+    bool bool_value;
+    if (YAML::convert<bool>::decode(node, bool_value)) {
+      json.append(bool_value ? "true" : "false");
+      break;
+    }
+    int64_t int_value;
+    if (YAML::convert<int64_t>::decode(node, int_value)) {
+      // Like parseYamlNode(), only small numbers are numbers, larger ones are strings.
+      if (std::numeric_limits<int32_t>::min() <= int_value &&
+          std::numeric_limits<int32_t>::max() >= int_value) {
+        json.append(std::to_string(int_value));
+      } else {
+        appendJsonString(std::to_string(int_value), json);
+      }
+      break;
+    }
+    appendJsonString(node.Scalar(), json);
+    break;
+  }
+  case YAML::NodeType::Sequence: {
+    json.push_back('[');
+    bool first = true;
+    for (const auto& it : node) {
+      if (!first) {
+        json.push_back(',');
+      }
+      first = false;
+      appendYamlNodeAsJson(it, json);
+    }
+    json.push_back(']');
+    break;
+  }
+  case YAML::NodeType::Map: {
+    // Duplicate keys collapse to the last value, as they do in a ProtobufWkt::Struct.
+    std::vector<std::pair<std::string, YAML::Node>> fields;
+    absl::flat_hash_map<std::string, size_t> field_index;
+    fields.reserve(node.size());
+    for (const auto& it : node) {
+      if (it.first.Tag() == "!ignore") {
+        continue;
+      }
+      std::string key = it.first.as<std::string>();
+      const auto inserted = field_index.emplace(key, fields.size());
+      if (inserted.second) {
+        fields.emplace_back(std::move(key), it.second);
+      } else {
+        fields[inserted.first->second].second = it.second;
+      }
+    }
+    json.push_back('{');
+    for (size_t i = 0; i < fields.size(); ++i) {
+      if (i > 0) {
+        json.push_back(',');
+      }
+      appendJsonString(fields[i].first, json);
+      json.push_back(':');
+      appendYamlNodeAsJson(fields[i].second, json);
+    }
+    json.push_back('}');
+    break;
+  }
+  case YAML::NodeType::Undefined:
+    throw EnvoyException("Undefined YAML value");
+  }
+}
+
+ProtobufWkt::Value yamlNodeToValue(const YAML::Node& node) {
+  TRY_ASSERT_MAIN_THREAD { return parseYamlNode(node); }
+  END_TRY
+  catch (YAML::BadConversion& e) {
+    throw EnvoyException(e.what());
+  }
+  catch (std::exception& e) {
+    throw EnvoyException(fmt::format("Unexpected YAML exception: {}", +e.what()));
+  }
+}
+
+std::string yamlNodeToJson(const YAML::Node& node) {
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.stream_yaml_to_proto")) {
+    std::string json;
+    TRY_ASSERT_MAIN_THREAD { appendYamlNodeAsJson(node, json); }
+    END_TRY
+    catch (YAML::BadConversion& e) {
+      throw EnvoyException(e.what());
+    }
+    catch (std::exception& e) {
+      throw EnvoyException(fmt::format("Unexpected YAML exception: {}", +e.what()));
+    }
+    return json;
+  }
+  const ProtobufWkt::Value value = yamlNodeToValue(node);
+  Protobuf::util::JsonPrintOptions json_options;
+  json_options.preserve_proto_field_names = true;
+  std::string json;
+  const auto status = Protobuf::util::MessageToJsonString(value, &json, json_options);
+  if (!status.ok()) {
+    throw EnvoyException(fmt::format("Unable to convert protobuf message to JSON string: {} {}",
+                                     status.ToString(), value.DebugString()));
+  }
+  return json;
+}
+
 void jsonConvertInternal(const Protobuf::Message& source,
                          ProtobufMessage::ValidationVisitor& validation_visitor,
                          Protobuf::Message& dest, bool do_boosting = true) {
@@ -193,6 +357,47 @@ void tryWithApiBoosting(MessageXformFn f, Protobuf::Message& message) {
   }
 }
 
+// Loads JSON into a message at the given version, distinguishing unknown fields (which may be
+// renames in a later version) from other parse errors.
+void loadJsonAtVersion(const std::string& json, Protobuf::Message& message,
+                       MessageVersion message_version,
+                       ProtobufMessage::ValidationVisitor& validation_visitor) {
+  Protobuf::util::JsonParseOptions options;
+  options.case_insensitive_enum_parsing = true;
+  // Let's first try and get a clean parse when checking for unknown fields;
+  // this should be the common case.
+  options.ignore_unknown_fields = false;
+  const auto strict_status = Protobuf::util::JsonStringToMessage(json, &message, options);
+  if (strict_status.ok()) {
+    // Success, no need to do any extra work.
+    return;
+  }
+  // If we fail, we see if we get a clean parse when allowing unknown fields.
+  // This is essentially a workaround
+  // for https://github.com/protocolbuffers/protobuf/issues/5967.
+  // TODO(htuch): clean this up when protobuf supports JSON/YAML unknown field
+  // detection directly.
+  options.ignore_unknown_fields = true;
+  const auto relaxed_status = Protobuf::util::JsonStringToMessage(json, &message, options);
+  // If we still fail with relaxed unknown field checking, the error has nothing
+  // to do with unknown fields.
+  if (!relaxed_status.ok()) {
+    throw EnvoyException("Unable to parse JSON as proto (" + relaxed_status.ToString() +
+                         "): " + json);
+  }
+  // We know it's an unknown field at this point. If we're at the latest
+  // version, then it's definitely an unknown field, otherwise we try to
+  // load again at a later version.
+  if (message_version == MessageVersion::LatestVersion) {
+    validation_visitor.onUnknownField("type " + message.GetTypeName() + " reason " +
+                                      strict_status.ToString());
+  } else if (message_version == MessageVersion::LatestVersionValidate) {
+    throw ProtobufMessage::UnknownProtoFieldException(absl::StrCat("Unknown field in: ", json));
+  } else {
+    throw ApiBoostRetryException("Unknown field, possibly a rename, try again.");
+  }
+}
+
 // Logs a warning for use of a deprecated field or runtime-overridden use of an
 // otherwise fatal field. Throws a warning on use of a fatal by default field.
 void deprecatedFieldHelper(Runtime::Loader* runtime, bool proto_annotated_as_deprecated,
@@ -332,6 +537,10 @@ void MessageUtil::onVersionUpgradeDeprecation(absl::string_view desc, bool /*rej
 }
 
 size_t MessageUtil::hash(const Protobuf::Message& message) {
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.deterministic_proto_hash")) {
+    return DeterministicProtoHash::hash(message);
+  }
+
   std::string text_format;
 
   {
@@ -351,40 +560,7 @@ void MessageUtil::loadFromJson(const std::string& json, Protobuf::Message& messa
                                bool do_boosting) {
   auto load_json = [&json, &validation_visitor](Protobuf::Message& message,
                                                 MessageVersion message_version) {
-    Protobuf::util::JsonParseOptions options;
-    options.case_insensitive_enum_parsing = true;
-    // Let's first try and get a clean parse when checking for unknown fields;
-    // this should be the common case.
-    options.ignore_unknown_fields = false;
-    const auto strict_status = Protobuf::util::JsonStringToMessage(json, &message, options);
-    if (strict_status.ok()) {
-      // Success, no need to do any extra work.
-      return;
-    }
-    // If we fail, we see if we get a clean parse when allowing unknown fields.
-    // This is essentially a workaround
-    // for https://github.com/protocolbuffers/protobuf/issues/5967.
-    // TODO(htuch): clean this up when protobuf supports JSON/YAML unknown field
-    // detection directly.
-    options.ignore_unknown_fields = true;
-    const auto relaxed_status = Protobuf::util::JsonStringToMessage(json, &message, options);
-    // If we still fail with relaxed unknown field checking, the error has nothing
-    // to do with unknown fields.
-    if (!relaxed_status.ok()) {
-      throw EnvoyException("Unable to parse JSON as proto (" + relaxed_status.ToString() +
-                           "): " + json);
-    }
-    // We know it's an unknown field at this point. If we're at the latest
-    // version, then it's definitely an unknown field, otherwise we try to
-    // load again at a later version.
-    if (message_version == MessageVersion::LatestVersion) {
-      validation_visitor.onUnknownField("type " + message.GetTypeName() + " reason " +
-                                        strict_status.ToString());
-    } else if (message_version == MessageVersion::LatestVersionValidate) {
-      throw ProtobufMessage::UnknownProtoFieldException(absl::StrCat("Unknown field in: ", json));
-    } else {
-      throw ApiBoostRetryException("Unknown field, possibly a rename, try again.");
-    }
+    loadJsonAtVersion(json, message, message_version, validation_visitor);
   };
 
   if (do_boosting) {
@@ -403,13 +579,25 @@ void MessageUtil::loadFromJson(const std::string& json, ProtobufWkt::Struct& mes
 void MessageUtil::loadFromYaml(const std::string& yaml, Protobuf::Message& message,
                                ProtobufMessage::ValidationVisitor& validation_visitor,
                                bool do_boosting) {
-  ProtobufWkt::Value value = ValueUtil::loadFromYaml(yaml);
-  if (value.kind_case() == ProtobufWkt::Value::kStructValue ||
-      value.kind_case() == ProtobufWkt::Value::kListValue) {
-    jsonConvertInternal(value, validation_visitor, message, do_boosting);
-    return;
+  const YAML::Node node = loadYamlNode(yaml);
+  if (!node.IsMap() && !node.IsSequence()) {
+    throw EnvoyException("Unable to convert YAML as JSON: " + yaml);
+  }
+  // The JSON is built once, and only if needed, for all the versions tried by API boosting.
+  std::string json;
+  auto load_yaml = [&node, &json, &validation_visitor](Protobuf::Message& message,
+                                                       MessageVersion message_version) {
+    if (json.empty()) {
+      json = yamlNodeToJson(node);
+    }
+    loadJsonAtVersion(json, message, message_version, validation_visitor);
+  };
+
+  if (do_boosting) {
+    tryWithApiBoosting(load_yaml, message);
+  } else {
+    load_yaml(message, MessageVersion::LatestVersion);
   }
-  throw EnvoyException("Unable to convert YAML as JSON: " + yaml);
 }
 
 void MessageUtil::loadFromYaml(const std::string& yaml, ProtobufWkt::Struct& message) {
@@ -893,21 +1081,7 @@ void MessageUtil::redact(Protobuf::Message& message) {
 }
 
 ProtobufWkt::Value ValueUtil::loadFromYaml(const std::string& yaml) {
-  TRY_ASSERT_MAIN_THREAD { return parseYamlNode(YAML::Load(yaml)); }
-  END_TRY
-  catch (YAML::ParserException& e) {
-    throw EnvoyException(e.what());
-  }
-  catch (YAML::BadConversion& e) {
-    throw EnvoyException(e.what());
-  }
-  catch (std::exception& e) {
-    // There is a potentially wide space of exceptions thrown by the YAML parser,
-    // and enumerating them all may be difficult. Envoy doesn't work well with
-    // unhandled exceptions, so we capture them and record the exception name in
-    // the Envoy Exception text.
-    throw EnvoyException(fmt::format("Unexpected YAML exception: {}", +e.what()));
-  }
+  return yamlNodeToValue(loadYamlNode(yaml));
 }
 
 bool ValueUtil::equal(const ProtobufWkt::Value& v1, const ProtobufWkt::Value& v2) {
@@ -242,9 +242,11 @@ public:
   using FileExtensions = ConstSingleton<FileExtensionValues>;
 
   /**
-   * A hash function uses Protobuf::TextFormat to force deterministic serialization recursively
-   * including known types in google.protobuf.Any. See
-   * https://github.com/protocolbuffers/protobuf/issues/5731 for the context.
+   * A hash function that is deterministic recursively including known types in
+   * google.protobuf.Any. See https://github.com/protocolbuffers/protobuf/issues/5731 for the
+   * context. The message is hashed with DeterministicProtoHash::hash() unless the
+   * envoy.reloadable_features.deterministic_proto_hash runtime feature is disabled, in which case
+   * it is printed with Protobuf::TextFormat and the text is hashed.
    * Using this function is discouraged, see discussion in
    * https://github.com/envoyproxy/envoy/issues/8301.
    */
@@ -18,6 +18,8 @@
 #include "source/common/quic/quic_network_connection.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Quic {
 
@@ -74,8 +76,15 @@ ActiveQuicListener::ActiveQuicListener(
   auto connection_helper = std::make_unique<EnvoyQuicConnectionHelper>(dispatcher_);
   crypto_config_->AddDefaultConfig(random, connection_helper->GetClock(),
                                    quic::QuicCryptoServerConfig::ConfigOptions());
-  auto alarm_factory =
-      std::make_unique<EnvoyQuicAlarmFactory>(dispatcher_, *connection_helper->GetClock());
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.quic_alarm_scheduler")) {
+    alarm_scheduler_ = std::make_unique<EnvoyQuicAlarmScheduler>(
+        dispatcher_, *connection_helper->GetClock(),
+        EnvoyQuicAlarmScheduler::generateStats(
+            listener_config.listenerScope(),
+            absl::StrCat(parent.statPrefix(), "quic_alarm_scheduler")));
+  }
+  auto alarm_factory = std::make_unique<EnvoyQuicAlarmFactory>(
+      dispatcher_, *connection_helper->GetClock(), alarm_scheduler_.get());
   quic_dispatcher_ = std::make_unique<EnvoyQuicDispatcher>(
       crypto_config_.get(), quic_config, &version_manager_, std::move(connection_helper),
       std::move(alarm_factory), quic::kQuicDefaultConnectionIdLength, parent, *config_, stats_,
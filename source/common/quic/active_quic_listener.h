@@ -7,6 +7,7 @@
 #include "envoy/runtime/runtime.h"
 
 #include "source/common/protobuf/utility.h"
+#include "source/common/quic/envoy_quic_alarm_scheduler.h"
 #include "source/common/quic/envoy_quic_dispatcher.h"
 #include "source/common/quic/envoy_quic_proof_source_factory_interface.h"
 #include "source/common/runtime/runtime_protos.h"
@@ -78,6 +79,8 @@ private:
   std::unique_ptr<quic::QuicCryptoServerConfig> crypto_config_;
   Event::Dispatcher& dispatcher_;
   quic::QuicVersionManager version_manager_;
+  // Schedules the alarms of the connections, if enabled. It must outlive quic_dispatcher_.
+  std::unique_ptr<EnvoyQuicAlarmScheduler> alarm_scheduler_;
   std::unique_ptr<EnvoyQuicDispatcher> quic_dispatcher_;
   const bool kernel_worker_routing_;
   absl::optional<Runtime::FeatureFlag> enabled_{};
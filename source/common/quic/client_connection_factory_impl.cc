@@ -6,20 +6,22 @@
 namespace Envoy {
 namespace Quic {
 
-const Envoy::Ssl::ClientContextConfig&
-getConfig(Network::TransportSocketFactory& transport_socket_factory) {
+QuicClientTransportSocketFactory&
+getFactory(Network::TransportSocketFactory& transport_socket_factory) {
   auto* quic_socket_factory =
       dynamic_cast<QuicClientTransportSocketFactory*>(&transport_socket_factory);
   ASSERT(quic_socket_factory != nullptr);
-  return quic_socket_factory->clientContextConfig();
+  return *quic_socket_factory;
+}
+
+const Envoy::Ssl::ClientContextConfig&
+getConfig(Network::TransportSocketFactory& transport_socket_factory) {
+  return getFactory(transport_socket_factory).clientContextConfig();
 }
 
 Envoy::Ssl::ClientContextSharedPtr
 getContext(Network::TransportSocketFactory& transport_socket_factory) {
-  auto* quic_socket_factory =
-      dynamic_cast<QuicClientTransportSocketFactory*>(&transport_socket_factory);
-  ASSERT(quic_socket_factory != nullptr);
-  return quic_socket_factory->sslCtx();
+  return getFactory(transport_socket_factory).sslCtx();
 }
 
 std::shared_ptr<quic::QuicCryptoClientConfig> PersistentQuicInfoImpl::cryptoConfig() {
@@ -29,12 +31,14 @@ std::shared_ptr<quic::QuicCryptoClientConfig> PersistentQuicInfoImpl::cryptoConf
     return nullptr;
   }
 
-  // If the secret has been updated, update the proof source.
+  // If the secret has been updated, update the proof source. The session cache is shared with
+  // the other pools using the same transport socket factory, so that the connections of this pool
+  // can resume, and send early data on, the sessions established by pools which no longer exist.
   if (context.get() != client_context_.get()) {
     client_context_ = context;
     client_config_ = std::make_shared<quic::QuicCryptoClientConfig>(
-        std::make_unique<EnvoyQuicProofVerifier>(getContext(transport_socket_factory_)),
-        std::make_unique<EnvoyQuicSessionCache>((time_source_)));
+        std::make_unique<EnvoyQuicProofVerifier>(context),
+        getFactory(transport_socket_factory_).createSessionCache(context, time_source_));
   }
   // Return the latest client config.
   return client_config_;
@@ -4,6 +4,10 @@ namespace Envoy {
 namespace Quic {
 
 quic::QuicAlarm* EnvoyQuicAlarmFactory::CreateAlarm(quic::QuicAlarm::Delegate* delegate) {
+  if (scheduler_ != nullptr) {
+    return new EnvoyQuicScheduledAlarm(
+        *scheduler_, quic::QuicArenaScopedPtr<quic::QuicAlarm::Delegate>(delegate));
+  }
   return new EnvoyQuicAlarm(dispatcher_, clock_,
                             quic::QuicArenaScopedPtr<quic::QuicAlarm::Delegate>(delegate));
 }
@@ -11,6 +15,13 @@ quic::QuicAlarm* EnvoyQuicAlarmFactory::CreateAlarm(quic::QuicAlarm::Delegate* d
 quic::QuicArenaScopedPtr<quic::QuicAlarm>
 EnvoyQuicAlarmFactory::CreateAlarm(quic::QuicArenaScopedPtr<quic::QuicAlarm::Delegate> delegate,
                                    quic::QuicConnectionArena* arena) {
+  if (scheduler_ != nullptr) {
+    if (arena != nullptr) {
+      return arena->New<EnvoyQuicScheduledAlarm>(*scheduler_, std::move(delegate));
+    }
+    return quic::QuicArenaScopedPtr<quic::QuicAlarm>(
+        new EnvoyQuicScheduledAlarm(*scheduler_, std::move(delegate)));
+  }
   if (arena != nullptr) {
     return arena->New<EnvoyQuicAlarm>(dispatcher_, clock_, std::move(delegate));
   }
@@ -2,6 +2,7 @@
 
 #include "source/common/common/non_copyable.h"
 #include "source/common/quic/envoy_quic_alarm.h"
+#include "source/common/quic/envoy_quic_alarm_scheduler.h"
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -21,8 +22,10 @@ namespace Quic {
 
 class EnvoyQuicAlarmFactory : public quic::QuicAlarmFactory, NonCopyable {
 public:
-  EnvoyQuicAlarmFactory(Event::Dispatcher& dispatcher, const quic::QuicClock& clock)
-      : dispatcher_(dispatcher), clock_(clock) {}
+  // If scheduler is not null, the alarms are scheduled by it instead of using a timer each.
+  EnvoyQuicAlarmFactory(Event::Dispatcher& dispatcher, const quic::QuicClock& clock,
+                        EnvoyQuicAlarmScheduler* scheduler = nullptr)
+      : dispatcher_(dispatcher), clock_(clock), scheduler_(scheduler) {}
 
   ~EnvoyQuicAlarmFactory() override = default;
 
@@ -35,6 +38,7 @@ public:
 private:
   Event::Dispatcher& dispatcher_;
   const quic::QuicClock& clock_;
+  EnvoyQuicAlarmScheduler* const scheduler_;
 };
 
 } // namespace Quic
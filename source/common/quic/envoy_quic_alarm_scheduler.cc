@@ -0,0 +1,249 @@
+#include "source/common/quic/envoy_quic_alarm_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Quic {
+
+EnvoyQuicAlarmScheduler::EnvoyQuicAlarmScheduler(Event::Dispatcher& dispatcher,
+                                                 const quic::QuicClock& clock,
+                                                 const EnvoyQuicAlarmSchedulerStats& stats)
+    : clock_(clock), stats_(stats), timer_(dispatcher.createTimer([this]() { onTimer(); })),
+      first_tick_(toMicroseconds(clock_.ApproximateNow()) / TickMicroseconds) {}
+
+EnvoyQuicAlarmScheduler::~EnvoyQuicAlarmScheduler() {
+  ASSERT(pending_ == 0);
+  stats_.alarms_pending_.sub(reported_pending_);
+}
+
+EnvoyQuicAlarmSchedulerStats EnvoyQuicAlarmScheduler::generateStats(Stats::Scope& scope,
+                                                                     const std::string& prefix) {
+  return {ALL_QUIC_ALARM_SCHEDULER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                         POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+int64_t EnvoyQuicAlarmScheduler::toMicroseconds(quic::QuicTime time) {
+  return std::max<int64_t>(0, (time - quic::QuicTime::Zero()).ToMicroseconds());
+}
+
+void EnvoyQuicAlarmScheduler::link(Entry*& head, Entry& entry) {
+  entry.prev_ = nullptr;
+  entry.next_ = head;
+  if (head != nullptr) {
+    head->prev_ = &entry;
+  }
+  head = &entry;
+}
+
+void EnvoyQuicAlarmScheduler::unlink(Entry*& head, Entry& entry) {
+  if (entry.prev_ != nullptr) {
+    entry.prev_->next_ = entry.next_;
+  } else {
+    head = entry.next_;
+  }
+  if (entry.next_ != nullptr) {
+    entry.next_->prev_ = entry.prev_;
+  }
+  entry.prev_ = nullptr;
+  entry.next_ = nullptr;
+}
+
+void EnvoyQuicAlarmScheduler::schedule(Entry& entry, quic::QuicTime deadline) {
+  cancel(entry);
+  const int64_t now = toMicroseconds(clock_.ApproximateNow());
+  if (current_.empty() && wheel_entries_ == 0 && overflow_.empty()) {
+    // Nothing is waiting on the ticks up to now, so the wheel can start from the current tick.
+    first_tick_ = std::max<uint64_t>(first_tick_, now / TickMicroseconds);
+  }
+  ++pending_;
+  entry.deadline_ = toMicroseconds(deadline);
+  entry.tick_ = entry.deadline_ / TickMicroseconds;
+  if (entry.deadline_ <= now || entry.tick_ < first_tick_) {
+    entry.location_ = Entry::Location::Due;
+    link(due_, entry);
+    armTimer(now);
+    return;
+  }
+  if (entry.tick_ == first_tick_) {
+    insertIntoCurrent(entry);
+  } else if (entry.tick_ - first_tick_ < WheelSlots) {
+    insertIntoWheel(entry);
+  } else {
+    entry.location_ = Entry::Location::Overflow;
+    entry.overflow_it_ = overflow_.emplace(entry.deadline_, &entry);
+  }
+  armTimer(entry.deadline_);
+}
+
+void EnvoyQuicAlarmScheduler::cancel(Entry& entry) {
+  switch (entry.location_) {
+  case Entry::Location::None:
+    return;
+  case Entry::Location::Current:
+    current_.erase(entry.overflow_it_);
+    break;
+  case Entry::Location::Wheel: {
+    const uint32_t index = slot(entry.tick_);
+    unlink(slots_[index], entry);
+    if (slots_[index] == nullptr) {
+      occupied_slots_[index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+    --wheel_entries_;
+    break;
+  }
+  case Entry::Location::Overflow:
+    overflow_.erase(entry.overflow_it_);
+    break;
+  case Entry::Location::Due:
+    unlink(due_, entry);
+    break;
+  case Entry::Location::Firing:
+    unlink(firing_, entry);
+    break;
+  }
+  // The timer stays armed, as a wakeup without due alarms is cheaper than tracking whether the
+  // cancelled entry was the earliest one.
+  entry.location_ = Entry::Location::None;
+  --pending_;
+}
+
+void EnvoyQuicAlarmScheduler::insertIntoCurrent(Entry& entry) {
+  entry.location_ = Entry::Location::Current;
+  entry.overflow_it_ = current_.emplace(entry.deadline_, &entry);
+}
+
+void EnvoyQuicAlarmScheduler::insertIntoWheel(Entry& entry) {
+  const uint32_t index = slot(entry.tick_);
+  entry.location_ = Entry::Location::Wheel;
+  slot_min_deadlines_[index] = slots_[index] == nullptr
+                                   ? entry.deadline_
+                                   : std::min(slot_min_deadlines_[index], entry.deadline_);
+  link(slots_[index], entry);
+  occupied_slots_[index / 64] |= uint64_t(1) << (index % 64);
+  ++wheel_entries_;
+}
+
+void EnvoyQuicAlarmScheduler::moveToFiring(Entry& entry) {
+  entry.location_ = Entry::Location::Firing;
+  link(firing_, entry);
+}
+
+int64_t EnvoyQuicAlarmScheduler::nextDeadline() const {
+  int64_t next = overflow_.empty() ? NotArmed : overflow_.begin()->first;
+  if (!current_.empty()) {
+    next = std::min(next, current_.begin()->first);
+  }
+  if (wheel_entries_ == 0) {
+    return next;
+  }
+  // The wheel holds the ticks after first_tick_, so scan the slots starting from the one of
+  // first_tick_ and wrapping around. The earliest alarm is in the first occupied slot.
+  const uint32_t start = slot(first_tick_);
+  for (uint32_t distance = 0; distance < WheelSlots;) {
+    const uint32_t index = (start + distance) % WheelSlots;
+    const uint64_t word = occupied_slots_[index / 64] >> (index % 64);
+    if (word == 0) {
+      distance += 64 - index % 64;
+      continue;
+    }
+    uint32_t offset = 0;
+    while ((word & (uint64_t(1) << offset)) == 0) {
+      ++offset;
+    }
+    next = std::min(next, slot_min_deadlines_[index + offset]);
+    break;
+  }
+  return next;
+}
+
+void EnvoyQuicAlarmScheduler::armTimer(int64_t deadline) {
+  if (deadline >= armed_deadline_) {
+    return;
+  }
+  armed_deadline_ = deadline;
+  const int64_t now = toMicroseconds(clock_.ApproximateNow());
+  // Like EnvoyQuicAlarm, wait at least 1us so that alarms never fire in the event loop iteration
+  // they are set in.
+  timer_->enableHRTimer(std::chrono::microseconds(std::max<int64_t>(1, deadline - now)));
+}
+
+void EnvoyQuicAlarmScheduler::onTimer() {
+  armed_deadline_ = NotArmed;
+  stats_.wakeups_.inc();
+
+  while (due_ != nullptr) {
+    Entry& entry = *due_;
+    unlink(due_, entry);
+    moveToFiring(entry);
+  }
+  // The approximate time is from before the event loop waited for this timer, so read the clock,
+  // which also updates the approximate time the alarms firing see.
+  const int64_t now = toMicroseconds(clock_.Now());
+  const uint64_t now_tick = now / TickMicroseconds;
+  while (!current_.empty() && current_.begin()->first <= now) {
+    Entry& entry = *current_.begin()->second;
+    current_.erase(current_.begin());
+    moveToFiring(entry);
+  }
+  if (now_tick > first_tick_) {
+    // The alarms of the past ticks are all due, and those of the current tick up to now. The
+    // others of the current tick are ordered, each once, for the wakeups to come.
+    const uint64_t last_tick = std::min<uint64_t>(now_tick, first_tick_ + WheelSlots - 1);
+    for (uint64_t tick = first_tick_ + 1; tick <= last_tick && wheel_entries_ > 0; ++tick) {
+      const uint32_t index = slot(tick);
+      while (slots_[index] != nullptr) {
+        Entry& entry = *slots_[index];
+        unlink(slots_[index], entry);
+        --wheel_entries_;
+        if (entry.deadline_ <= now) {
+          moveToFiring(entry);
+        } else {
+          insertIntoCurrent(entry);
+        }
+      }
+      occupied_slots_[index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+    first_tick_ = now_tick;
+  }
+  // Move the alarms the wheel now covers out of the overflow.
+  while (!overflow_.empty() &&
+         static_cast<uint64_t>(overflow_.begin()->first / TickMicroseconds) <
+             first_tick_ + WheelSlots) {
+    Entry& entry = *overflow_.begin()->second;
+    overflow_.erase(overflow_.begin());
+    if (entry.deadline_ <= now) {
+      moveToFiring(entry);
+    } else if (entry.tick_ == first_tick_) {
+      insertIntoCurrent(entry);
+    } else {
+      insertIntoWheel(entry);
+    }
+  }
+
+  // The alarms firing may set, cancel or delete any alarm, including the ones still to fire.
+  uint64_t fired = 0;
+  while (firing_ != nullptr) {
+    Entry& entry = *firing_;
+    unlink(firing_, entry);
+    entry.location_ = Entry::Location::None;
+    --pending_;
+    ++fired;
+    entry.onDeadline();
+  }
+  stats_.alarms_fired_.add(fired);
+  if (pending_ > reported_pending_) {
+    stats_.alarms_pending_.add(pending_ - reported_pending_);
+  } else {
+    stats_.alarms_pending_.sub(reported_pending_ - pending_);
+  }
+  reported_pending_ = pending_;
+  ENVOY_LOG(trace, "fired {} QUIC alarms, {} pending", fired, pending_);
+
+  armTimer(nextDeadline());
+}
+
+} // namespace Quic
+} // namespace Envoy
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/common/non_copyable.h"
+
+#include "quiche/quic/core/quic_alarm.h"
+#include "quiche/quic/core/quic_arena_scoped_ptr.h"
+#include "quiche/quic/core/quic_clock.h"
+#include "quiche/quic/core/quic_time.h"
+
+namespace Envoy {
+namespace Quic {
+
+/**
+ * All QUIC alarm scheduler stats. @see stats_macros.h
+ */
+#define ALL_QUIC_ALARM_SCHEDULER_STATS(COUNTER, GAUGE)                                             \
+  COUNTER(alarms_fired)                                                                            \
+  COUNTER(wakeups)                                                                                 \
+  GAUGE(alarms_pending, Accumulate)
+
+/**
+ * Struct definition for all QUIC alarm scheduler stats. @see stats_macros.h
+ */
+struct EnvoyQuicAlarmSchedulerStats {
+  ALL_QUIC_ALARM_SCHEDULER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Schedules the alarms of the QUIC connections of a worker on one dispatcher timer, instead of one
+ * timer per alarm. Alarms due within the next WheelSlots ticks are bucketed by tick in a timer
+ * wheel, where setting and cancelling them are constant time list operations, and later alarms are
+ * kept ordered by deadline until the wheel reaches them. Once the wheel reaches a tick, the alarms
+ * of the tick that are not due yet are ordered by deadline too, so that alarms spread inside a tick
+ * are not scanned again at every wakeup. The timer is armed for the exact deadline of the earliest
+ * alarm, or for a lower bound of the deadlines of the first occupied wheel slot, so alarms do not
+ * fire late. All the alarms due at a wakeup fire in one batch, so the packets they send are
+ * written back to back. Alarms set to a deadline that has already passed fire on the next event
+ * loop iteration, as QUICHE does not expect alarms to fire in the iteration they are set in.
+ */
+class EnvoyQuicAlarmScheduler : NonCopyable, protected Logger::Loggable<Logger::Id::quic> {
+public:
+  static constexpr uint32_t WheelSlots = 1024;
+  static constexpr int64_t TickMicroseconds = 1000;
+
+  class Entry;
+  // Alarms by deadline in microseconds.
+  using OverflowMap = std::multimap<int64_t, Entry*>;
+
+  // An alarm scheduled by the scheduler. It must be cancelled before it is destroyed.
+  class Entry {
+  public:
+    virtual ~Entry() = default;
+
+    // Called once the deadline the entry was scheduled for has passed.
+    virtual void onDeadline() PURE;
+
+  private:
+    friend class EnvoyQuicAlarmScheduler;
+
+    enum class Location : uint8_t { None, Current, Wheel, Overflow, Due, Firing };
+
+    Location location_{Location::None};
+    // The deadline in microseconds, and the tick of the wheel it is in.
+    int64_t deadline_{0};
+    uint64_t tick_{0};
+    // Links of the wheel slot, due or firing list the entry is in.
+    Entry* prev_{nullptr};
+    Entry* next_{nullptr};
+    // The position of the entry in the current tick or the overflow, if it is there.
+    OverflowMap::iterator overflow_it_;
+  };
+
+  EnvoyQuicAlarmScheduler(Event::Dispatcher& dispatcher, const quic::QuicClock& clock,
+                          const EnvoyQuicAlarmSchedulerStats& stats);
+  ~EnvoyQuicAlarmScheduler();
+
+  static EnvoyQuicAlarmSchedulerStats generateStats(Stats::Scope& scope,
+                                                    const std::string& prefix);
+
+  // Schedules the entry for the deadline, replacing any previous deadline.
+  void schedule(Entry& entry, quic::QuicTime deadline);
+  // Cancels the entry if it is scheduled.
+  void cancel(Entry& entry);
+
+  size_t pendingAlarms() const { return pending_; }
+
+private:
+  static constexpr int64_t NotArmed = std::numeric_limits<int64_t>::max();
+
+  static int64_t toMicroseconds(quic::QuicTime time);
+  static void link(Entry*& head, Entry& entry);
+  static void unlink(Entry*& head, Entry& entry);
+
+  uint32_t slot(uint64_t tick) const { return tick & (WheelSlots - 1); }
+  void insertIntoCurrent(Entry& entry);
+  void insertIntoWheel(Entry& entry);
+  void moveToFiring(Entry& entry);
+  // Returns the deadline of the earliest alarm in the current tick or the overflow, or the lower
+  // bound of the first occupied wheel slot if it is earlier, or NotArmed.
+  int64_t nextDeadline() const;
+  // Arms the timer for the deadline, if it is earlier than the one the timer is armed for.
+  void armTimer(int64_t deadline);
+  void onTimer();
+
+  const quic::QuicClock& clock_;
+  EnvoyQuicAlarmSchedulerStats stats_;
+  Event::TimerPtr timer_;
+  // The deadline the timer is armed for, or NotArmed.
+  int64_t armed_deadline_{NotArmed};
+  // The current tick. The alarms of the earlier ticks have fired, and those of the current tick
+  // are in current_ rather than in its wheel slot, which the wheel reuses for a later tick.
+  uint64_t first_tick_;
+  OverflowMap current_;
+  std::array<Entry*, WheelSlots> slots_{};
+  // A lower bound of the deadlines in each occupied slot. Cancelling an alarm does not raise it,
+  // which at worst wakes the timer up once early, when the wheel reaches the slot.
+  std::array<int64_t, WheelSlots> slot_min_deadlines_{};
+  std::array<uint64_t, WheelSlots / 64> occupied_slots_{};
+  size_t wheel_entries_{0};
+  OverflowMap overflow_;
+  Entry* due_{nullptr};
+  Entry* firing_{nullptr};
+  size_t pending_{0};
+  size_t reported_pending_{0};
+};
+
+/**
+ * A QUIC alarm scheduled by an EnvoyQuicAlarmScheduler.
+ */
+class EnvoyQuicScheduledAlarm : public quic::QuicAlarm, public EnvoyQuicAlarmScheduler::Entry {
+public:
+  EnvoyQuicScheduledAlarm(EnvoyQuicAlarmScheduler& scheduler,
+                          quic::QuicArenaScopedPtr<quic::QuicAlarm::Delegate> delegate)
+      : QuicAlarm(std::move(delegate)), scheduler_(scheduler) {}
+  ~EnvoyQuicScheduledAlarm() override { scheduler_.cancel(*this); }
+
+  // quic::QuicAlarm
+  void CancelImpl() override { scheduler_.cancel(*this); }
+  void SetImpl() override { scheduler_.schedule(*this, deadline()); }
+  void UpdateImpl() override { scheduler_.schedule(*this, deadline()); }
+
+  // EnvoyQuicAlarmScheduler::Entry
+  void onDeadline() override { Fire(); }
+
+private:
+  EnvoyQuicAlarmScheduler& scheduler_;
+};
+
+} // namespace Quic
+} // namespace Envoy
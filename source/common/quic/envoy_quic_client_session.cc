@@ -114,6 +114,16 @@ void EnvoyQuicClientSession::OnTlsHandshakeComplete() {
   raiseConnectionEvent(Network::ConnectionEvent::Connected);
 }
 
+void EnvoyQuicClientSession::OnNewEncryptionKeyAvailable(
+    quic::EncryptionLevel level, std::unique_ptr<quic::QuicEncrypter> encrypter) {
+  quic::QuicSpdyClientSession::OnNewEncryptionKeyAvailable(level, std::move(encrypter));
+  if (level == quic::ENCRYPTION_ZERO_RTT) {
+    // The session was resumed, streams can be sent as early data until the handshake completes.
+    ENVOY_CONN_LOG(trace, "able to send early data", *this);
+    raiseConnectionEvent(Network::ConnectionEvent::ConnectedZeroRtt);
+  }
+}
+
 size_t EnvoyQuicClientSession::WriteHeadersOnHeadersStream(
     quic::QuicStreamId id, spdy::SpdyHeaderBlock headers, bool fin,
     const spdy::SpdyStreamPrecedence& precedence,
@@ -167,5 +167,40 @@ bssl::UniquePtr<SSL_SESSION> EnvoyQuicSessionCache::Entry::popSession() {
 
 SSL_SESSION* EnvoyQuicSessionCache::Entry::peekSession() { return sessions[0].get(); }
 
+class SharedEnvoyQuicSessionCache::Handle : public quic::SessionCache {
+public:
+  explicit Handle(SharedEnvoyQuicSessionCacheSharedPtr parent) : parent_(std::move(parent)) {}
+
+  // From quic::SessionCache.
+  void Insert(const quic::QuicServerId& server_id, bssl::UniquePtr<SSL_SESSION> session,
+              const quic::TransportParameters& params,
+              const quic::ApplicationState* application_state) override {
+    Thread::LockGuard lock(parent_->mutex_);
+    parent_->cache_.Insert(server_id, std::move(session), params, application_state);
+  }
+  std::unique_ptr<quic::QuicResumptionState> Lookup(const quic::QuicServerId& server_id,
+                                                    const SSL_CTX* ctx) override {
+    Thread::LockGuard lock(parent_->mutex_);
+    return parent_->cache_.Lookup(server_id, ctx);
+  }
+  void ClearEarlyData(const quic::QuicServerId& server_id) override {
+    Thread::LockGuard lock(parent_->mutex_);
+    parent_->cache_.ClearEarlyData(server_id);
+  }
+
+private:
+  // Keeps the cache alive as long as a crypto config uses it.
+  const SharedEnvoyQuicSessionCacheSharedPtr parent_;
+};
+
+std::unique_ptr<quic::SessionCache> SharedEnvoyQuicSessionCache::createHandle() {
+  return std::make_unique<Handle>(shared_from_this());
+}
+
+size_t SharedEnvoyQuicSessionCache::size() const {
+  Thread::LockGuard lock(mutex_);
+  return cache_.size();
+}
+
 } // namespace Quic
 } // namespace Envoy
@@ -2,6 +2,9 @@
 
 #include "envoy/common/time.h"
 
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/thread.h"
+
 #include "quiche/quic/core/crypto/quic_crypto_client_config.h"
 
 namespace Envoy {
@@ -61,5 +64,28 @@ private:
   TimeSource& time_source_;
 };
 
+// An EnvoyQuicSessionCache shared by the crypto configs of several connection pools, possibly on
+// different threads, so that session tickets and transport parameters outlive the pools that
+// received them. Each crypto config owns a handle returned by createHandle().
+class SharedEnvoyQuicSessionCache
+    : public std::enable_shared_from_this<SharedEnvoyQuicSessionCache> {
+public:
+  explicit SharedEnvoyQuicSessionCache(TimeSource& time_source) : cache_(time_source) {}
+
+  // Returns a quic::SessionCache which reads and writes this cache under its lock.
+  std::unique_ptr<quic::SessionCache> createHandle();
+
+  // Returns number of entries in the cache.
+  size_t size() const;
+
+private:
+  class Handle;
+
+  mutable Thread::MutexBasicLockable mutex_;
+  EnvoyQuicSessionCache cache_ ABSL_GUARDED_BY(mutex_);
+};
+
+using SharedEnvoyQuicSessionCacheSharedPtr = std::shared_ptr<SharedEnvoyQuicSessionCache>;
+
 } // namespace Quic
 } // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include "envoy/extensions/transport_sockets/quic/v3/quic_transport.pb.validate.h"
 
+#include "source/common/quic/envoy_quic_session_cache.h"
 #include "source/extensions/transport_sockets/tls/context_config_impl.h"
 
 namespace Envoy {
@@ -49,6 +50,17 @@ QuicClientTransportSocketFactory::QuicClientTransportSocketFactory(
       fallback_factory_(std::make_unique<Extensions::TransportSockets::Tls::ClientSslSocketFactory>(
           std::move(config), factory_context.sslContextManager(), factory_context.scope())) {}
 
+std::unique_ptr<quic::SessionCache> QuicClientTransportSocketFactory::createSessionCache(
+    const Envoy::Ssl::ClientContextSharedPtr& context, TimeSource& time_source) {
+  Thread::LockGuard lock(session_cache_lock_);
+  if (session_cache_ == nullptr || context != session_cache_context_) {
+    // Sessions established with a previous context must not skip the verification of the new one.
+    session_cache_context_ = context;
+    session_cache_ = std::make_shared<SharedEnvoyQuicSessionCache>(time_source);
+  }
+  return session_cache_->createHandle();
+}
+
 ProtobufTypes::MessagePtr QuicClientTransportSocketConfigFactory::createEmptyConfigProto() {
   return std::make_unique<envoy::extensions::transport_sockets::quic::v3::QuicUpstreamTransport>();
 }
@@ -6,11 +6,19 @@
 #include "envoy/ssl/context_config.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/thread.h"
 #include "source/extensions/transport_sockets/tls/ssl_socket.h"
 
+namespace quic {
+class SessionCache;
+} // namespace quic
+
 namespace Envoy {
 namespace Quic {
 
+class SharedEnvoyQuicSessionCache;
+
 #define QUIC_TRANSPORT_SOCKET_FACTORY_STATS(COUNTER)                                               \
   COUNTER(context_config_update_by_sds)                                                            \
   COUNTER(upstream_context_secrets_not_ready)                                                      \
@@ -114,6 +122,13 @@ public:
     return fallback_factory_->config();
   }
 
+  // Returns the session cache for a crypto config created with the given client context. The
+  // session tickets and transport parameters are shared by all the connection pools using this
+  // factory, on any thread, so that a new pool can resume the sessions of a drained one. They
+  // are dropped once the client context is updated.
+  std::unique_ptr<quic::SessionCache>
+  createSessionCache(const Envoy::Ssl::ClientContextSharedPtr& context, TimeSource& time_source);
+
 protected:
   // fallback_factory_ will update the context.
   void onSecretUpdated() override {}
@@ -121,6 +136,10 @@ protected:
 private:
   // The QUIC client transport socket can create TLS sockets for fallback to TCP.
   std::unique_ptr<Extensions::TransportSockets::Tls::ClientSslSocketFactory> fallback_factory_;
+  Thread::MutexBasicLockable session_cache_lock_;
+  // The client context the sessions in session_cache_ were established with.
+  Envoy::Ssl::ClientContextSharedPtr session_cache_context_ ABSL_GUARDED_BY(session_cache_lock_);
+  std::shared_ptr<SharedEnvoyQuicSessionCache> session_cache_ ABSL_GUARDED_BY(session_cache_lock_);
 };
 
 // Base class to create above QuicTransportSocketFactory for server and client
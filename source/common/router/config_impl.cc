@@ -59,6 +59,28 @@ void mergeTransforms(Http::HeaderTransforms& dest, const Http::HeaderTransforms&
                                 src.headers_to_remove.end());
 }
 
+// Returns the fields of the route configuration that CommonConfigImpl is built from.
+envoy::config::route::v3::RouteConfiguration
+commonConfig(const envoy::config::route::v3::RouteConfiguration& config) {
+  envoy::config::route::v3::RouteConfiguration common_config;
+  common_config.set_name(config.name());
+  *common_config.mutable_internal_only_headers() = config.internal_only_headers();
+  *common_config.mutable_request_headers_to_add() = config.request_headers_to_add();
+  *common_config.mutable_request_headers_to_remove() = config.request_headers_to_remove();
+  *common_config.mutable_response_headers_to_add() = config.response_headers_to_add();
+  *common_config.mutable_response_headers_to_remove() = config.response_headers_to_remove();
+  common_config.set_most_specific_header_mutations_wins(
+      config.most_specific_header_mutations_wins());
+  if (config.has_max_direct_response_body_size_bytes()) {
+    *common_config.mutable_max_direct_response_body_size_bytes() =
+        config.max_direct_response_body_size_bytes();
+  }
+  if (config.has_vhds()) {
+    *common_config.mutable_vhds() = config.vhds();
+  }
+  return common_config;
+}
+
 } // namespace
 
 const std::string& OriginalConnectPort::key() {
@@ -1185,7 +1207,8 @@ RouteConstSharedPtr ConnectRouteEntryImpl::matches(const Http::RequestHeaderMap&
 
 VirtualHostImpl::VirtualHostImpl(
     const envoy::config::route::v3::VirtualHost& virtual_host,
-    const OptionalHttpFilters& optional_http_filters, const ConfigImpl& global_route_config,
+    const OptionalHttpFilters& optional_http_filters,
+    const CommonConfigSharedPtr& global_route_config,
     Server::Configuration::ServerFactoryContext& factory_context, Stats::Scope& scope,
     ProtobufMessage::ValidationVisitor& validator,
     const absl::optional<Upstream::ClusterManager::ClusterInfoMaps>& validation_clusters)
@@ -1258,16 +1281,10 @@ VirtualHostImpl::VirtualHostImpl(
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
 
-    if (validation_clusters.has_value()) {
-      routes_.back()->validateClusters(*validation_clusters);
-      for (const auto& shadow_policy : routes_.back()->shadowPolicies()) {
-        ASSERT(!shadow_policy->cluster().empty());
-        if (!validation_clusters->hasCluster(shadow_policy->cluster())) {
-          throw EnvoyException(
-              fmt::format("route: unknown shadow cluster '{}'", shadow_policy->cluster()));
-        }
-      }
-    }
+  }
+
+  if (validation_clusters.has_value()) {
+    validateClusters(*validation_clusters);
   }
 
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
@@ -1295,7 +1312,21 @@ VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
   headers_ = Http::HeaderUtility::buildHeaderDataVector(virtual_cluster.headers());
 }
 
-const Config& VirtualHostImpl::routeConfig() const { return global_route_config_; }
+void VirtualHostImpl::validateClusters(
+    const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const {
+  for (const auto& route : routes_) {
+    route->validateClusters(cluster_info_maps);
+    for (const auto& shadow_policy : route->shadowPolicies()) {
+      ASSERT(!shadow_policy->cluster().empty());
+      if (!cluster_info_maps.hasCluster(shadow_policy->cluster())) {
+        throw EnvoyException(
+            fmt::format("route: unknown shadow cluster '{}'", shadow_policy->cluster()));
+      }
+    }
+  }
+}
+
+const CommonConfig& VirtualHostImpl::routeConfig() const { return *global_route_config_; }
 
 const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::string& name) const {
   return per_filter_configs_.get(name);
@@ -1325,9 +1356,10 @@ const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
 
 RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& route_config,
                            const OptionalHttpFilters& optional_http_filters,
-                           const ConfigImpl& global_route_config,
+                           const CommonConfigSharedPtr& global_route_config,
                            Server::Configuration::ServerFactoryContext& factory_context,
-                           ProtobufMessage::ValidationVisitor& validator, bool validate_clusters)
+                           ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+                           const RouteMatcher* previous_matcher)
     : vhost_scope_(factory_context.scope().scopeFromStatName(
           factory_context.routerContext().virtualClusterStatNames().vhost_)) {
   absl::optional<Upstream::ClusterManager::ClusterInfoMaps> validation_clusters;
@@ -1335,9 +1367,27 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
     validation_clusters = factory_context.clusterManager().clusters();
   }
   for (const auto& virtual_host_config : route_config.virtual_hosts()) {
-    VirtualHostSharedPtr virtual_host(
-        new VirtualHostImpl(virtual_host_config, optional_http_filters, global_route_config,
-                            factory_context, *vhost_scope_, validator, validation_clusters));
+    const uint64_t virtual_host_hash = MessageUtil::hash(virtual_host_config);
+    VirtualHostSharedPtr virtual_host;
+    if (previous_matcher != nullptr) {
+      const auto it = previous_matcher->virtual_hosts_by_hash_.find(virtual_host_hash);
+      // The hashes of different configurations may collide, so compare the configurations too.
+      if (it != previous_matcher->virtual_hosts_by_hash_.end() &&
+          Protobuf::util::MessageDifferencer::Equals(it->second.config_, virtual_host_config)) {
+        // The clusters may have changed since the virtual host was built.
+        virtual_host = it->second.virtual_host_;
+        if (validation_clusters.has_value()) {
+          virtual_host->validateClusters(*validation_clusters);
+        }
+      }
+    }
+    if (virtual_host == nullptr) {
+      virtual_host = std::make_shared<VirtualHostImpl>(
+          virtual_host_config, optional_http_filters, global_route_config, factory_context,
+          *vhost_scope_, validator, validation_clusters);
+    }
+    virtual_hosts_by_hash_.emplace(virtual_host_hash,
+                                   ReusableVirtualHost{virtual_host_config, virtual_host});
     for (const std::string& domain_name : virtual_host_config.domains()) {
       const std::string domain = Http::LowerCaseString(domain_name).get();
       bool duplicate_found = false;
@@ -1497,17 +1547,28 @@ ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& confi
                        const OptionalHttpFilters& optional_http_filters,
                        Server::Configuration::ServerFactoryContext& factory_context,
                        ProtobufMessage::ValidationVisitor& validator,
-                       bool validate_clusters_default)
-    : name_(config.name()), symbol_table_(factory_context.scope().symbolTable()),
-      uses_vhds_(config.has_vhds()),
+                       bool validate_clusters_default, const ConfigImpl* previous_config)
+    : shared_config_(std::make_shared<CommonConfigImpl>(config)) {
+  const RouteMatcher* previous_matcher = nullptr;
+  // Virtual hosts hold the shared config, so they can only be reused if it is unchanged.
+  if (previous_config != nullptr &&
+      Protobuf::util::MessageDifferencer::Equals(previous_config->shared_config_->config(),
+                                                 shared_config_->config())) {
+    shared_config_ = previous_config->shared_config_;
+    previous_matcher = previous_config->route_matcher_.get();
+  }
+  route_matcher_ = std::make_unique<RouteMatcher>(
+      config, optional_http_filters, shared_config_, factory_context, validator,
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default),
+      previous_matcher);
+}
+
+CommonConfigImpl::CommonConfigImpl(const envoy::config::route::v3::RouteConfiguration& config)
+    : config_(commonConfig(config)), name_(config.name()), uses_vhds_(config.has_vhds()),
       most_specific_header_mutations_wins_(config.most_specific_header_mutations_wins()),
       max_direct_response_body_size_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_direct_response_body_size_bytes,
                                           DEFAULT_MAX_DIRECT_RESPONSE_BODY_SIZE_BYTES)) {
-  route_matcher_ = std::make_unique<RouteMatcher>(
-      config, optional_http_filters, *this, factory_context, validator,
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
-
   for (const std::string& header : config.internal_only_headers()) {
     internal_only_headers_.push_back(Http::LowerCaseString(header));
   }
@@ -31,6 +31,7 @@
 #include "source/common/router/tls_context_match_criteria_impl.h"
 #include "source/common/stats/symbol_table_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/types/optional.h"
 
@@ -180,7 +181,50 @@ private:
   const bool legacy_enabled_;
 };
 
-class ConfigImpl;
+/**
+ * Implementation of CommonConfig that holds the route configuration state shared by all the
+ * virtual hosts. Virtual hosts hold it by shared_ptr, so that a virtual host that is unchanged
+ * across route configuration updates can be reused by the next ConfigImpl.
+ */
+class CommonConfigImpl : public CommonConfig {
+public:
+  CommonConfigImpl(const envoy::config::route::v3::RouteConfiguration& config);
+
+  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; }
+  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; }
+
+  /**
+   * @return const envoy::config::route::v3::RouteConfiguration& the parts of the
+   *         RouteConfiguration this was built from.
+   */
+  const envoy::config::route::v3::RouteConfiguration& config() const { return config_; }
+
+  // Router::CommonConfig
+  const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
+    return internal_only_headers_;
+  }
+  const std::string& name() const override { return name_; }
+  bool usesVhds() const override { return uses_vhds_; }
+  bool mostSpecificHeaderMutationsWins() const override {
+    return most_specific_header_mutations_wins_;
+  }
+  uint32_t maxDirectResponseBodySizeBytes() const override {
+    return max_direct_response_body_size_bytes_;
+  }
+
+private:
+  const envoy::config::route::v3::RouteConfiguration config_;
+  std::list<Http::LowerCaseString> internal_only_headers_;
+  HeaderParserPtr request_headers_parser_;
+  HeaderParserPtr response_headers_parser_;
+  const std::string name_;
+  const bool uses_vhds_;
+  const bool most_specific_header_mutations_wins_;
+  const uint32_t max_direct_response_body_size_bytes_;
+};
+
+using CommonConfigSharedPtr = std::shared_ptr<const CommonConfigImpl>;
+
 /**
  * Holds all routing configuration for an entire virtual host.
  */
@@ -188,7 +232,8 @@ class VirtualHostImpl : public VirtualHost {
 public:
   VirtualHostImpl(
       const envoy::config::route::v3::VirtualHost& virtual_host,
-      const OptionalHttpFilters& optional_http_filters, const ConfigImpl& global_route_config,
+      const OptionalHttpFilters& optional_http_filters,
+      const CommonConfigSharedPtr& global_route_config,
       Server::Configuration::ServerFactoryContext& factory_context, Stats::Scope& scope,
       ProtobufMessage::ValidationVisitor& validator,
       const absl::optional<Upstream::ClusterManager::ClusterInfoMaps>& validation_clusters);
@@ -198,7 +243,8 @@ public:
                                           const StreamInfo::StreamInfo& stream_info,
                                           uint64_t random_value) const;
   const VirtualCluster* virtualClusterFromEntries(const Http::HeaderMap& headers) const;
-  const ConfigImpl& globalRouteConfig() const { return global_route_config_; }
+  void validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const;
+  const CommonConfigImpl& globalRouteConfig() const { return *global_route_config_; }
   const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; }
   const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; }
 
@@ -206,7 +252,7 @@ public:
   const CorsPolicy* corsPolicy() const override { return cors_policy_.get(); }
   Stats::StatName statName() const override { return stat_name_storage_.statName(); }
   const RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
-  const Config& routeConfig() const override;
+  const CommonConfig& routeConfig() const override;
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override;
   bool includeAttemptCountInRequest() const override { return include_attempt_count_in_request_; }
   bool includeAttemptCountInResponse() const override { return include_attempt_count_in_response_; }
@@ -265,8 +311,7 @@ private:
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
   std::unique_ptr<const CorsPolicyImpl> cors_policy_;
-  const ConfigImpl& global_route_config_; // See note in RouteEntryImplBase::clusterEntry() on why
-                                          // raw ref to the top level config is currently safe.
+  const CommonConfigSharedPtr global_route_config_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
   PerFilterConfigs per_filter_configs_;
@@ -1021,11 +1066,17 @@ public:
  */
 class RouteMatcher {
 public:
+  /**
+   * @param previous_matcher if not nullptr, supplies the matcher of the previous version of the
+   *        route configuration. Virtual hosts whose configuration is unchanged are reused from it
+   *        instead of being built again. It must share global_route_config with this matcher.
+   */
   RouteMatcher(const envoy::config::route::v3::RouteConfiguration& config,
                const OptionalHttpFilters& optional_http_filters,
-               const ConfigImpl& global_http_config,
+               const CommonConfigSharedPtr& global_route_config,
                Server::Configuration::ServerFactoryContext& factory_context,
-               ProtobufMessage::ValidationVisitor& validator, bool validate_clusters);
+               ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+               const RouteMatcher* previous_matcher);
 
   RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                             const StreamInfo::StreamInfo& stream_info, uint64_t random_value) const;
@@ -1042,6 +1093,13 @@ private:
 
   Stats::ScopePtr vhost_scope_;
   absl::node_hash_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
+  struct ReusableVirtualHost {
+    envoy::config::route::v3::VirtualHost config_;
+    VirtualHostSharedPtr virtual_host_;
+  };
+
+  // All virtual hosts keyed by the hash of their configuration, for reuse by the next matcher.
+  absl::flat_hash_map<uint64_t, ReusableVirtualHost> virtual_hosts_by_hash_;
   // std::greater as a minor optimization to iterate from more to less specific
   //
   // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
@@ -1062,13 +1120,23 @@ private:
  */
 class ConfigImpl : public Config {
 public:
+  /**
+   * @param previous_config if not nullptr, supplies the previous version of this route
+   *        configuration. If the configuration outside of the virtual hosts is unchanged, the
+   *        virtual hosts whose configuration is unchanged are shared with it.
+   */
   ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
              const OptionalHttpFilters& optional_http_filters,
              Server::Configuration::ServerFactoryContext& factory_context,
-             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default);
+             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default,
+             const ConfigImpl* previous_config = nullptr);
 
-  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
-  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+  const HeaderParser& requestHeaderParser() const {
+    return shared_config_->requestHeaderParser();
+  }
+  const HeaderParser& responseHeaderParser() const {
+    return shared_config_->responseHeaderParser();
+  }
 
   bool virtualHostExists(const Http::RequestHeaderMap& headers) const {
     return route_matcher_->findVirtualHost(headers) != nullptr;
@@ -1086,31 +1154,24 @@ public:
                             uint64_t random_value) const override;
 
   const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
-    return internal_only_headers_;
+    return shared_config_->internalOnlyHeaders();
   }
 
-  const std::string& name() const override { return name_; }
+  const std::string& name() const override { return shared_config_->name(); }
 
-  bool usesVhds() const override { return uses_vhds_; }
+  bool usesVhds() const override { return shared_config_->usesVhds(); }
 
   bool mostSpecificHeaderMutationsWins() const override {
-    return most_specific_header_mutations_wins_;
+    return shared_config_->mostSpecificHeaderMutationsWins();
   }
 
   uint32_t maxDirectResponseBodySizeBytes() const override {
-    return max_direct_response_body_size_bytes_;
+    return shared_config_->maxDirectResponseBodySizeBytes();
   }
 
 private:
+  CommonConfigSharedPtr shared_config_;
   std::unique_ptr<RouteMatcher> route_matcher_;
-  std::list<Http::LowerCaseString> internal_only_headers_;
-  HeaderParserPtr request_headers_parser_;
-  HeaderParserPtr response_headers_parser_;
-  const std::string name_;
-  Stats::SymbolTable& symbol_table_;
-  const bool uses_vhds_;
-  const bool most_specific_header_mutations_wins_;
-  const uint32_t max_direct_response_body_size_bytes_;
 };
 
 /**
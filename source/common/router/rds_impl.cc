@@ -1,9 +1,11 @@
 #include "source/common/router/rds_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/admin/v3/config_dump.pb.h"
 #include "envoy/api/v2/route.pb.h"
@@ -13,6 +15,7 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/hash.h"
 #include "source/common/config/api_version.h"
 #include "source/common/config/utility.h"
 #include "source/common/config/version_converter.h"
@@ -52,20 +55,49 @@ RouteConfigProviderSharedPtr RouteConfigProviderUtil::create(
   }
 }
 
+namespace {
+
+// Static route configurations are shared if their content and the parameters they are built with
+// are identical.
+uint64_t staticRouteConfigKey(const envoy::config::route::v3::RouteConfiguration& config,
+                              const OptionalHttpFilters& optional_http_filters,
+                              ProtobufMessage::ValidationVisitor& validator) {
+  std::vector<absl::string_view> key_parts(optional_http_filters.begin(),
+                                           optional_http_filters.end());
+  std::sort(key_parts.begin(), key_parts.end());
+  const uintptr_t validator_address = reinterpret_cast<uintptr_t>(&validator);
+  key_parts.emplace_back(reinterpret_cast<const char*>(&validator_address),
+                         sizeof(validator_address));
+  return HashUtil::xxHash64(absl::MakeSpan(key_parts), MessageUtil::hash(config));
+}
+
+} // namespace
+
+bool StaticRouteConfig::matches(const envoy::config::route::v3::RouteConfiguration& route_config,
+                                const OptionalHttpFilters& optional_http_filters,
+                                const ProtobufMessage::ValidationVisitor& validator) const {
+  return &validator_ == &validator && optional_http_filters_ == optional_http_filters &&
+         Protobuf::util::MessageDifferencer::Equals(proto_, route_config);
+}
+
 StaticRouteConfigProviderImpl::StaticRouteConfigProviderImpl(
     const envoy::config::route::v3::RouteConfiguration& config,
     const OptionalHttpFilters& optional_http_filters,
     Server::Configuration::ServerFactoryContext& factory_context,
     ProtobufMessage::ValidationVisitor& validator,
     RouteConfigProviderManagerImpl& route_config_provider_manager)
-    : config_(new ConfigImpl(config, optional_http_filters, factory_context, validator, true)),
-      route_config_proto_{config}, last_updated_(factory_context.timeSource().systemTime()),
+    : route_config_key_(staticRouteConfigKey(config, optional_http_filters, validator)),
+      route_config_(route_config_provider_manager.getOrCreateStaticRouteConfig(
+          route_config_key_, config, optional_http_filters, factory_context, validator)),
+      last_updated_(factory_context.timeSource().systemTime()),
       route_config_provider_manager_(route_config_provider_manager) {
   route_config_provider_manager_.static_route_config_providers_.insert(this);
 }
 
 StaticRouteConfigProviderImpl::~StaticRouteConfigProviderImpl() {
   route_config_provider_manager_.static_route_config_providers_.erase(this);
+  route_config_.reset();
+  route_config_provider_manager_.removeStaticRouteConfigIfUnused(route_config_key_);
 }
 
 // TODO(htuch): If support for multiple clusters is added per #1170 cluster_name_
@@ -302,7 +334,11 @@ void RdsRouteConfigProviderImpl::onConfigUpdate() {
 void RdsRouteConfigProviderImpl::validateConfig(
     const envoy::config::route::v3::RouteConfiguration& config) const {
   // TODO(lizan): consider cache the config here until onConfigUpdate.
-  ConfigImpl validation_config(config, optional_http_filters_, factory_context_, validator_, false);
+  // Unchanged virtual hosts of the current config are reused, as they have already been validated.
+  const auto current_config =
+      std::static_pointer_cast<const ConfigImpl>(config_update_info_->parsedConfiguration());
+  ConfigImpl validation_config(config, optional_http_filters_, factory_context_, validator_, false,
+                               current_config.get());
 }
 
 // Schedules a VHDS request on the main thread and queues up the callback to use when the VHDS
@@ -380,6 +416,41 @@ RouteConfigProviderPtr RouteConfigProviderManagerImpl::createStaticRouteConfigPr
   return provider;
 }
 
+StaticRouteConfigSharedPtr RouteConfigProviderManagerImpl::getOrCreateStaticRouteConfig(
+    uint64_t key, const envoy::config::route::v3::RouteConfiguration& route_config,
+    const OptionalHttpFilters& optional_http_filters,
+    Server::Configuration::ServerFactoryContext& factory_context,
+    ProtobufMessage::ValidationVisitor& validator) {
+  auto it = static_route_configs_.find(key);
+  bool key_in_use = false;
+  if (it != static_route_configs_.end()) {
+    // Entries are removed by the destructor of the last provider using them.
+    auto existing = it->second.lock();
+    ASSERT(existing != nullptr);
+    if (existing->matches(route_config, optional_http_filters, validator)) {
+      return existing;
+    }
+    // The key collides with a different configuration, which keeps the entry.
+    key_in_use = true;
+  }
+
+  auto shared_config = std::make_shared<const StaticRouteConfig>(StaticRouteConfig{
+      route_config, optional_http_filters, validator,
+      std::make_shared<ConfigImpl>(route_config, optional_http_filters, factory_context,
+                                   validator, true)});
+  if (!key_in_use) {
+    static_route_configs_[key] = shared_config;
+  }
+  return shared_config;
+}
+
+void RouteConfigProviderManagerImpl::removeStaticRouteConfigIfUnused(uint64_t key) {
+  auto it = static_route_configs_.find(key);
+  if (it != static_route_configs_.end() && it->second.expired()) {
+    static_route_configs_.erase(it);
+  }
+}
+
 std::unique_ptr<envoy::admin::v3::RoutesConfigDump>
 RouteConfigProviderManagerImpl::dumpRouteConfigs(
     const Matchers::StringMatcher& name_matcher) const {
@@ -34,6 +34,7 @@
 #include "source/common/router/route_config_update_receiver_impl.h"
 #include "source/common/router/vhds.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/container/node_hash_set.h"
 
@@ -62,6 +63,28 @@ public:
 
 class RouteConfigProviderManagerImpl;
 
+/**
+ * A static route configuration and the Config built from it. Static route configurations with
+ * identical content are built once and shared by all the providers that use them.
+ */
+struct StaticRouteConfig {
+  /**
+   * @return bool whether this was built from the given configuration and parameters. The key
+   *         static route configurations are looked up with is a hash, so a match of the key alone
+   *         does not guarantee this.
+   */
+  bool matches(const envoy::config::route::v3::RouteConfiguration& route_config,
+               const OptionalHttpFilters& optional_http_filters,
+               const ProtobufMessage::ValidationVisitor& validator) const;
+
+  const envoy::config::route::v3::RouteConfiguration proto_;
+  const OptionalHttpFilters optional_http_filters_;
+  const ProtobufMessage::ValidationVisitor& validator_;
+  ConfigConstSharedPtr config_;
+};
+
+using StaticRouteConfigSharedPtr = std::shared_ptr<const StaticRouteConfig>;
+
 /**
  * Implementation of RouteConfigProvider that holds a static route configuration.
  */
@@ -75,9 +98,9 @@ public:
   ~StaticRouteConfigProviderImpl() override;
 
   // Router::RouteConfigProvider
-  Router::ConfigConstSharedPtr config() override { return config_; }
+  Router::ConfigConstSharedPtr config() override { return route_config_->config_; }
   absl::optional<ConfigInfo> configInfo() const override {
-    return ConfigInfo{route_config_proto_, ""};
+    return ConfigInfo{route_config_->proto_, ""};
   }
   SystemTime lastUpdated() const override { return last_updated_; }
   void onConfigUpdate() override {}
@@ -88,8 +111,8 @@ public:
   }
 
 private:
-  ConfigConstSharedPtr config_;
-  envoy::config::route::v3::RouteConfiguration route_config_proto_;
+  const uint64_t route_config_key_;
+  StaticRouteConfigSharedPtr route_config_;
   SystemTime last_updated_;
   RouteConfigProviderManagerImpl& route_config_provider_manager_;
 };
@@ -259,12 +282,23 @@ public:
                                   ProtobufMessage::ValidationVisitor& validator) override;
 
 private:
+  StaticRouteConfigSharedPtr
+  getOrCreateStaticRouteConfig(uint64_t key,
+                               const envoy::config::route::v3::RouteConfiguration& route_config,
+                               const OptionalHttpFilters& optional_http_filters,
+                               Server::Configuration::ServerFactoryContext& factory_context,
+                               ProtobufMessage::ValidationVisitor& validator);
+  void removeStaticRouteConfigIfUnused(uint64_t key);
+
   // TODO(jsedgwick) These two members are prime candidates for the owned-entry list/map
   // as in ConfigTracker. I.e. the ProviderImpls would have an EntryOwner for these lists
   // Then the lifetime management stuff is centralized and opaque.
   absl::node_hash_map<uint64_t, std::weak_ptr<RdsRouteConfigProviderImpl>>
       dynamic_route_config_providers_;
   absl::node_hash_set<RouteConfigProvider*> static_route_config_providers_;
+  // Static route configurations shared by the static providers, keyed by the hash of their
+  // content and of the parameters they were built with.
+  absl::flat_hash_map<uint64_t, std::weak_ptr<const StaticRouteConfig>> static_route_configs_;
   Server::ConfigTracker::EntryOwnerPtr config_tracker_entry_;
 
   friend class RdsRouteConfigSubscription;
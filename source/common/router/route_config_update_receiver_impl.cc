@@ -30,7 +30,8 @@ bool RouteConfigUpdateReceiverImpl::onRdsUpdate(
   rebuildRouteConfig(rds_virtual_hosts_, *vhds_virtual_hosts_, *route_config_proto_);
   config_ = std::make_shared<ConfigImpl>(
       *route_config_proto_, optional_http_filters_, factory_context_,
-      factory_context_.messageValidationContext().dynamicValidationVisitor(), false);
+      factory_context_.messageValidationContext().dynamicValidationVisitor(), false,
+      config_.get());
 
   onUpdateCommon(version_info);
   return true;
@@ -55,7 +56,8 @@ bool RouteConfigUpdateReceiverImpl::onVhdsUpdate(
 
   auto new_config = std::make_shared<ConfigImpl>(
       *route_config_after_this_update, optional_http_filters_, factory_context_,
-      factory_context_.messageValidationContext().dynamicValidationVisitor(), false);
+      factory_context_.messageValidationContext().dynamicValidationVisitor(), false,
+      config_.get());
 
   // No exception, route_config_after_this_update is valid, can update the state.
   vhds_virtual_hosts_ = std::move(vhosts_after_this_update);
@@ -75,7 +75,7 @@ private:
   absl::optional<RouteConfigProvider::ConfigInfo> config_info_;
   std::set<std::string> resource_ids_in_last_update_;
   bool vhds_configuration_changed_;
-  ConfigConstSharedPtr config_;
+  std::shared_ptr<const ConfigImpl> config_;
   const OptionalHttpFilters& optional_http_filters_;
 };
 
@@ -82,6 +82,7 @@ public:
                    const StreamInfo::StreamInfo& info,
                    absl::optional<Http::Protocol> protocol) override;
   UpstreamToDownstream& upstreamToDownstream() override { return *this; }
+  bool encodeComplete() const override { return encode_complete_; }
 
   void clearRequestEncoder();
   void onStreamMaxDurationReached();
@@ -117,7 +118,6 @@ public:
   bool createPerTryTimeoutOnRequestComplete() {
     return create_per_try_timeout_on_request_complete_;
   }
-  bool encodeComplete() const { return encode_complete_; }
   RouterFilterInterface& parent() { return parent_; }
 
 private:
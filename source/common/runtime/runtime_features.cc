@@ -61,6 +61,7 @@ constexpr const char* runtime_features[] = {
     "envoy.reloadable_features.check_unsupported_typed_per_filter_config",
     "envoy.reloadable_features.check_ocsp_policy",
     "envoy.reloadable_features.correct_scheme_and_xfp",
+    "envoy.reloadable_features.deterministic_proto_hash",
     "envoy.reloadable_features.disable_tls_inspector_injection",
     "envoy.reloadable_features.dont_add_content_length_for_bodiless_requests",
     "envoy.reloadable_features.enable_compression_without_content_length_header",
@@ -81,12 +82,15 @@ constexpr const char* runtime_features[] = {
     "envoy.reloadable_features.no_chunked_encoding_header_for_304",
     "envoy.reloadable_features.prefer_quic_kernel_bpf_packet_routing",
     "envoy.reloadable_features.preserve_downstream_scheme",
+    "envoy.reloadable_features.quic_alarm_scheduler",
     "envoy.reloadable_features.remove_forked_chromium_url",
     "envoy.reloadable_features.require_ocsp_response_for_must_staple_certs",
     "envoy.reloadable_features.require_strict_1xx_and_204_response_headers",
     "envoy.reloadable_features.return_502_for_upstream_protocol_errors",
     "envoy.reloadable_features.send_strict_1xx_and_204_response_headers",
+    "envoy.reloadable_features.stream_yaml_to_proto",
     "envoy.reloadable_features.strip_port_from_connect",
+    "envoy.reloadable_features.tls_shared_session_cache",
     "envoy.reloadable_features.treat_host_like_authority",
     "envoy.reloadable_features.treat_upstream_connect_timeout_as_connect_failure",
     "envoy.reloadable_features.udp_per_event_loop_read_limit",
@@ -123,6 +127,8 @@ constexpr const char* disabled_runtime_features[] = {
     // CacheOption is CacheWhenRuntimeEnabled.
     // Caller that use AlwaysCache option will always cache, unaffected by this runtime.
     "envoy.reloadable_features.enable_grpc_async_client_cache",
+    // Early data may be replayed by an attacker, so sending it upstream is opt-in.
+    "envoy.reloadable_features.http3_upstream_early_data",
 };
 
 RuntimeFeatures::RuntimeFeatures() {
@@ -29,7 +29,7 @@ struct TcpAttachContext : public Envoy::ConnectionPool::AttachContext {
 class TcpPendingStream : public Envoy::ConnectionPool::PendingStream {
 public:
   TcpPendingStream(Envoy::ConnectionPool::ConnPoolImplBase& parent, TcpAttachContext& context)
-      : Envoy::ConnectionPool::PendingStream(parent), context_(context) {}
+      : Envoy::ConnectionPool::PendingStream(parent, false), context_(context) {}
   Envoy::ConnectionPool::AttachContext& context() override { return context_; }
 
   TcpAttachContext context_;
@@ -171,14 +171,14 @@ public:
   }
   ConnectionPool::Cancellable* newConnection(Tcp::ConnectionPool::Callbacks& callbacks) override {
     TcpAttachContext context(&callbacks);
-    return Envoy::ConnectionPool::ConnPoolImplBase::newStream(context);
+    return Envoy::ConnectionPool::ConnPoolImplBase::newStream(context, false);
   }
   bool maybePreconnect(float preconnect_ratio) override {
     return Envoy::ConnectionPool::ConnPoolImplBase::maybePreconnect(preconnect_ratio);
   }
 
-  ConnectionPool::Cancellable*
-  newPendingStream(Envoy::ConnectionPool::AttachContext& context) override {
+  ConnectionPool::Cancellable* newPendingStream(Envoy::ConnectionPool::AttachContext& context,
+                                                bool) override {
     Envoy::ConnectionPool::PendingStreamPtr pending_stream =
         std::make_unique<TcpPendingStream>(*this, typedContext<TcpAttachContext>(context));
     return addPendingStream(std::move(pending_stream));
@@ -371,7 +371,11 @@ ClusterManagerImpl::ClusterManagerImpl(
                     "StreamAggregatedResources"),
           Config::Utility::getAndCheckTransportVersion(dyn_resources.ads_config()), random_, stats_,
           Envoy::Config::Utility::parseRateLimitSettings(dyn_resources.ads_config()),
-          bootstrap.dynamic_resources().ads_config().set_node_on_first_message_only());
+          bootstrap.dynamic_resources().ads_config().set_node_on_first_message_only(),
+          dyn_resources.ads_decode_threads() > 0
+              ? std::make_unique<Config::DecodeThreadPool>(api.threadFactory(),
+                                                           dyn_resources.ads_decode_threads())
+              : nullptr);
     }
   } else {
     ads_mux_ = std::make_unique<Config::NullGrpcMuxImpl>();
@@ -0,0 +1,143 @@
+#include "source/extensions/access_loggers/aggregate/aggregate_access_log_impl.h"
+
+#include <map>
+
+#include "source/common/common/fmt.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Aggregate {
+
+void GroupStats::merge(const GroupStats& other) {
+  count_ += other.count_;
+  const histogram_t* other_durations = other.durations_ms_.get();
+  hist_accumulate(durations_ms_.get(), &other_durations, 1);
+}
+
+AggregateAccessLog::AggregateAccessLog(
+    const envoy::extensions::access_loggers::aggregate::v3::AggregateAccessLog& config,
+    AccessLog::FilterPtr&& filter, AccessLog::AccessLogManager& log_manager,
+    Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls)
+    : ImplBase(std::move(filter)),
+      max_groups_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_groups, 1000)),
+      flush_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, flush_interval, 10000)),
+      writer_(std::make_shared<Writer>()),
+      tls_slot_(ThreadLocal::TypedSlot<ThreadLocalGroups>::makeUnique(tls)),
+      flush_timer_(main_thread_dispatcher.createTimer([this]() { flush(); })) {
+  writer_->log_file_ =
+      log_manager.createAccessLog({Filesystem::DestinationType::File, config.path()});
+
+  // Sort the keys so that the output and the group keys do not depend on map iteration order.
+  const std::map<std::string, std::string> keys(config.keys().begin(), config.keys().end());
+  for (const auto& [name, format] : keys) {
+    writer_->key_names_.push_back(name);
+    key_formatters_.push_back(std::make_unique<Formatter::FormatterImpl>(format, false));
+  }
+
+  if (config.duration_quantiles().empty()) {
+    writer_->quantiles_ = {0.5, 0.9, 0.99};
+  } else {
+    writer_->quantiles_.assign(config.duration_quantiles().begin(),
+                               config.duration_quantiles().end());
+  }
+  for (const double quantile : writer_->quantiles_) {
+    writer_->quantile_names_.push_back(fmt::format("p{:g}", quantile * 100));
+  }
+
+  tls_slot_->set([](Event::Dispatcher&) { return std::make_shared<ThreadLocalGroups>(); });
+  flush_timer_->enableTimer(flush_interval_);
+}
+
+void AggregateAccessLog::emitLog(const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info) {
+  GroupKey key;
+  key.reserve(key_formatters_.size());
+  for (const auto& formatter : key_formatters_) {
+    key.push_back(formatter->format(request_headers, response_headers, response_trailers,
+                                    stream_info, absl::string_view()));
+  }
+
+  GroupMap& groups = (*tls_slot_)->groups_;
+  auto it = groups.find(key);
+  if (it == groups.end()) {
+    if (groups.size() >= max_groups_) {
+      key.clear();
+    }
+    it = groups.try_emplace(std::move(key)).first;
+  }
+
+  GroupStats& group = it->second;
+  group.count_++;
+  const absl::optional<std::chrono::nanoseconds> duration = stream_info.requestComplete();
+  if (duration.has_value()) {
+    hist_insert(group.durations_ms_.get(),
+                std::chrono::duration<double, std::milli>(duration.value()).count(), 1);
+  }
+}
+
+void AggregateAccessLog::flush() {
+  // Neither callback may capture this, as the logger can be destroyed while the flush is still
+  // in flight on the workers.
+  auto merged = std::make_shared<MergedGroups>();
+  tls_slot_->runOnAllThreads(
+      [merged](OptRef<ThreadLocalGroups> tls_groups) {
+        GroupMap groups;
+        groups.swap(tls_groups->groups_);
+        Thread::LockGuard lock(merged->mutex_);
+        for (auto& [key, stats] : groups) {
+          auto it = merged->groups_.find(key);
+          if (it == merged->groups_.end()) {
+            merged->groups_.emplace(key, std::move(stats));
+          } else {
+            it->second.merge(stats);
+          }
+        }
+      },
+      [merged, writer = writer_]() {
+        Thread::LockGuard lock(merged->mutex_);
+        writer->write(merged->groups_);
+      });
+  flush_timer_->enableTimer(flush_interval_);
+}
+
+void AggregateAccessLog::Writer::write(const GroupMap& groups) const {
+  std::vector<double> values(quantiles_.size());
+  for (const auto& [key, stats] : groups) {
+    ProtobufWkt::Struct entry;
+    auto& fields = *entry.mutable_fields();
+    if (key.empty()) {
+      fields["overflow"] = ValueUtil::boolValue(true);
+    } else {
+      ASSERT(key.size() == key_names_.size());
+      for (size_t i = 0; i < key.size(); i++) {
+        fields[key_names_[i]] = ValueUtil::stringValue(key[i]);
+      }
+    }
+    fields["count"] = ValueUtil::numberValue(stats.count_);
+
+    if (hist_sample_count(stats.durations_ms_.get()) > 0) {
+      hist_approx_quantile(stats.durations_ms_.get(), quantiles_.data(),
+                           static_cast<int>(quantiles_.size()), values.data());
+      ProtobufWkt::Struct durations;
+      for (size_t i = 0; i < values.size(); i++) {
+        (*durations.mutable_fields())[quantile_names_[i]] = ValueUtil::numberValue(values[i]);
+      }
+      fields["duration_ms"] = ValueUtil::structValue(durations);
+    }
+
+    log_file_->write(
+        absl::StrCat(MessageUtil::getJsonStringFromMessageOrDie(entry, false, true), "\n"));
+  }
+}
+
+} // namespace Aggregate
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/access_loggers/aggregate/v3/aggregate.pb.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/thread.h"
+#include "source/common/formatter/substitution_formatter.h"
+#include "source/extensions/access_loggers/common/access_log_base.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "circllhist.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Aggregate {
+
+/**
+ * Request count and duration sketch for one group of requests.
+ */
+struct GroupStats {
+  void merge(const GroupStats& other);
+
+  uint64_t count_{};
+  std::unique_ptr<histogram_t, decltype(&hist_free)> durations_ms_{hist_alloc(), hist_free};
+};
+
+// The formatted key values of a group, in key name order. The overflow group has an empty key.
+using GroupKey = std::vector<std::string>;
+using GroupMap = absl::flat_hash_map<GroupKey, GroupStats>;
+
+/**
+ * Access log Instance that rolls up requests into per-interval aggregates. Each worker aggregates
+ * into thread local state, which the main thread collects and writes on every flush interval.
+ */
+class AggregateAccessLog : public Common::ImplBase {
+public:
+  AggregateAccessLog(const envoy::extensions::access_loggers::aggregate::v3::AggregateAccessLog&
+                         config,
+                     AccessLog::FilterPtr&& filter, AccessLog::AccessLogManager& log_manager,
+                     Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls);
+
+private:
+  struct ThreadLocalGroups : public ThreadLocal::ThreadLocalObject {
+    GroupMap groups_;
+  };
+
+  // Per-worker groups collected by an in-flight flush.
+  struct MergedGroups {
+    Thread::MutexBasicLockable mutex_;
+    GroupMap groups_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  // Output state. It is shared with in-flight flushes, which may complete after the logger has
+  // been destroyed.
+  struct Writer {
+    void write(const GroupMap& groups) const;
+
+    AccessLog::AccessLogFileSharedPtr log_file_;
+    std::vector<std::string> key_names_;
+    std::vector<double> quantiles_;
+    std::vector<std::string> quantile_names_;
+  };
+
+  // Common::ImplBase
+  void emitLog(const Http::RequestHeaderMap& request_headers,
+               const Http::ResponseHeaderMap& response_headers,
+               const Http::ResponseTrailerMap& response_trailers,
+               const StreamInfo::StreamInfo& stream_info) override;
+
+  void flush();
+
+  // In the same order as Writer::key_names_.
+  std::vector<Formatter::FormatterPtr> key_formatters_;
+  const uint32_t max_groups_;
+  const std::chrono::milliseconds flush_interval_;
+  std::shared_ptr<Writer> writer_;
+  ThreadLocal::TypedSlotPtr<ThreadLocalGroups> tls_slot_;
+  Event::TimerPtr flush_timer_;
+};
+
+} // namespace Aggregate
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
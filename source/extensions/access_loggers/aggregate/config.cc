@@ -0,0 +1,42 @@
+#include "source/extensions/access_loggers/aggregate/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/access_loggers/aggregate/v3/aggregate.pb.h"
+#include "envoy/extensions/access_loggers/aggregate/v3/aggregate.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/protobuf/protobuf.h"
+#include "source/extensions/access_loggers/aggregate/aggregate_access_log_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Aggregate {
+
+AccessLog::InstanceSharedPtr AggregateAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+    Server::Configuration::CommonFactoryContext& context) {
+  const auto& aggregate_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::access_loggers::aggregate::v3::AggregateAccessLog&>(
+      config, context.messageValidationVisitor());
+  return std::make_shared<AggregateAccessLog>(aggregate_config, std::move(filter),
+                                              context.accessLogManager(), context.dispatcher(),
+                                              context.threadLocal());
+}
+
+ProtobufTypes::MessagePtr AggregateAccessLogFactory::createEmptyConfigProto() {
+  return std::make_unique<envoy::extensions::access_loggers::aggregate::v3::AggregateAccessLog>();
+}
+
+std::string AggregateAccessLogFactory::name() const { return "envoy.access_loggers.aggregate"; }
+
+/**
+ * Static registration for the aggregate access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(AggregateAccessLogFactory, Server::Configuration::AccessLogInstanceFactory);
+
+} // namespace Aggregate
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -1,5 +1,7 @@
 #include "source/extensions/access_loggers/common/file_access_log_impl.h"
 
+#include "source/common/buffer/buffer_impl.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
@@ -16,8 +18,11 @@ void FileAccessLog::emitLog(const Http::RequestHeaderMap& request_headers,
                             const Http::ResponseHeaderMap& response_headers,
                             const Http::ResponseTrailerMap& response_trailers,
                             const StreamInfo::StreamInfo& stream_info) {
-  log_file_->write(formatter_->format(request_headers, response_headers, response_trailers,
-                                      stream_info, absl::string_view()));
+  // The line is formatted straight into a buffer whose content is moved into the file buffer.
+  Buffer::OwnedImpl log_line;
+  formatter_->formatToBuffer(request_headers, response_headers, response_trailers, stream_info,
+                             absl::string_view(), log_line);
+  log_file_->write(log_line);
 }
 
 } // namespace File
@@ -170,16 +170,17 @@ public:
 
   GrpcAccessLogger(const Grpc::RawAsyncClientSharedPtr& client,
                    std::chrono::milliseconds buffer_flush_interval_msec,
-                   uint64_t max_buffer_size_bytes, Event::Dispatcher& dispatcher,
-                   Stats::Scope& scope, std::string access_log_prefix,
-                   const Protobuf::MethodDescriptor& service_method)
-      : GrpcAccessLogger(client, buffer_flush_interval_msec, max_buffer_size_bytes, dispatcher,
-                         scope, access_log_prefix, service_method, absl::nullopt) {}
+                   uint64_t max_buffer_size_bytes, uint64_t max_pending_buffer_size_bytes,
+                   Event::Dispatcher& dispatcher, Stats::Scope& scope,
+                   std::string access_log_prefix, const Protobuf::MethodDescriptor& service_method)
+      : GrpcAccessLogger(client, buffer_flush_interval_msec, max_buffer_size_bytes,
+                         max_pending_buffer_size_bytes, dispatcher, scope, access_log_prefix,
+                         service_method, absl::nullopt) {}
   GrpcAccessLogger(const Grpc::RawAsyncClientSharedPtr& client,
                    std::chrono::milliseconds buffer_flush_interval_msec,
-                   uint64_t max_buffer_size_bytes, Event::Dispatcher& dispatcher,
-                   Stats::Scope& scope, std::string access_log_prefix,
-                   const Protobuf::MethodDescriptor& service_method,
+                   uint64_t max_buffer_size_bytes, uint64_t max_pending_buffer_size_bytes,
+                   Event::Dispatcher& dispatcher, Stats::Scope& scope,
+                   std::string access_log_prefix, const Protobuf::MethodDescriptor& service_method,
                    envoy::config::core::v3::ApiVersion transport_api_version)
       : client_(client, service_method, transport_api_version),
         buffer_flush_interval_msec_(buffer_flush_interval_msec),
@@ -188,28 +189,15 @@ public:
           flush_timer_->enableTimer(buffer_flush_interval_msec_);
         })),
         max_buffer_size_bytes_(max_buffer_size_bytes),
+        max_pending_buffer_size_bytes_(max_pending_buffer_size_bytes),
         stats_({ALL_GRPC_ACCESS_LOGGER_STATS(POOL_COUNTER_PREFIX(scope, access_log_prefix))}) {
+    ASSERT(max_pending_buffer_size_bytes_ > 0);
     flush_timer_->enableTimer(buffer_flush_interval_msec_);
   }
 
-  void log(HttpLogProto&& entry) {
-    if (!canLogMore()) {
-      return;
-    }
-    approximate_message_size_bytes_ += entry.ByteSizeLong();
-    addEntry(std::move(entry));
-    if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
-      flush();
-    }
-  }
+  void log(HttpLogProto&& entry) { logEntry(std::move(entry)); }
 
-  void log(TcpLogProto&& entry) {
-    approximate_message_size_bytes_ += entry.ByteSizeLong();
-    addEntry(std::move(entry));
-    if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
-      flush();
-    }
-  }
+  void log(TcpLogProto&& entry) { logEntry(std::move(entry)); }
 
 protected:
   Detail::GrpcAccessLogClient<LogRequest, LogResponse> client_;
@@ -239,13 +227,26 @@ private:
     }
   }
 
+  template <class LogProto> void logEntry(LogProto&& entry) {
+    if (!canLogMore()) {
+      return;
+    }
+    approximate_message_size_bytes_ += entry.ByteSizeLong();
+    addEntry(std::move(entry));
+    if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
+      flush();
+    }
+  }
+
+  // Entries stay buffered while the stream is above its write buffer high watermark. Bound the
+  // memory held by this worker in that case and drop (and count) anything beyond the limit.
   bool canLogMore() {
-    if (max_buffer_size_bytes_ == 0 || approximate_message_size_bytes_ < max_buffer_size_bytes_) {
+    if (approximate_message_size_bytes_ < max_pending_buffer_size_bytes_) {
       stats_.logs_written_.inc();
       return true;
     }
     flush();
-    if (approximate_message_size_bytes_ < max_buffer_size_bytes_) {
+    if (approximate_message_size_bytes_ < max_pending_buffer_size_bytes_) {
       stats_.logs_written_.inc();
       return true;
     }
@@ -256,6 +257,7 @@ private:
   const std::chrono::milliseconds buffer_flush_interval_msec_;
   const Event::TimerPtr flush_timer_;
   const uint64_t max_buffer_size_bytes_;
+  const uint64_t max_pending_buffer_size_bytes_;
   uint64_t approximate_message_size_bytes_ = 0;
   GrpcAccessLoggerStats stats_;
 };
@@ -289,18 +291,25 @@ public:
     if (it != cache.access_loggers_.end()) {
       return it->second;
     }
+    const uint64_t buffer_size_bytes =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, DefaultBufferSizeBytes);
     const auto logger = createLogger(
         config, transport_version,
         async_client_manager_.factoryForGrpcService(config.grpc_service(), scope_, false)
             ->createUncachedRawAsyncClient(),
         std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, buffer_flush_interval, 1000)),
-        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384), cache.dispatcher_,
-        scope);
+        buffer_size_bytes,
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+            config, max_pending_buffer_size_bytes,
+            buffer_size_bytes > 0 ? buffer_size_bytes : DefaultBufferSizeBytes),
+        cache.dispatcher_, scope);
     cache.access_loggers_.emplace(cache_key, logger);
     return logger;
   }
 
 private:
+  static constexpr uint64_t DefaultBufferSizeBytes = 16384;
+
   /**
    * Per-thread cache.
    */
@@ -319,7 +328,8 @@ private:
   createLogger(const ConfigProto& config, envoy::config::core::v3::ApiVersion transport_version,
                const Grpc::RawAsyncClientSharedPtr& client,
                std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-               Event::Dispatcher& dispatcher, Stats::Scope& scope) PURE;
+               uint64_t max_pending_buffer_size_bytes, Event::Dispatcher& dispatcher,
+               Stats::Scope& scope) PURE;
 
   Grpc::AsyncClientManager& async_client_manager_;
   Stats::Scope& scope_;
@@ -18,11 +18,12 @@ namespace GrpcCommon {
 GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(
     const Grpc::RawAsyncClientSharedPtr& client, std::string log_name,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-    Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
+    uint64_t max_pending_buffer_size_bytes, Event::Dispatcher& dispatcher,
+    const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
     envoy::config::core::v3::ApiVersion transport_api_version)
     : GrpcAccessLogger(
-          std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes, dispatcher, scope,
-          GRPC_LOG_STATS_PREFIX,
+          std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes,
+          max_pending_buffer_size_bytes, dispatcher, scope, GRPC_LOG_STATS_PREFIX,
           Grpc::VersionedMethods("envoy.service.accesslog.v3.AccessLogService.StreamAccessLogs",
                                  "envoy.service.accesslog.v2.AccessLogService.StreamAccessLogs")
               .getMethodDescriptorForVersion(transport_api_version),
@@ -58,10 +59,10 @@ GrpcAccessLoggerImpl::SharedPtr GrpcAccessLoggerCacheImpl::createLogger(
     envoy::config::core::v3::ApiVersion transport_version,
     const Grpc::RawAsyncClientSharedPtr& client,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-    Event::Dispatcher& dispatcher, Stats::Scope& scope) {
-  return std::make_shared<GrpcAccessLoggerImpl>(client, config.log_name(),
-                                                buffer_flush_interval_msec, max_buffer_size_bytes,
-                                                dispatcher, local_info_, scope, transport_version);
+    uint64_t max_pending_buffer_size_bytes, Event::Dispatcher& dispatcher, Stats::Scope& scope) {
+  return std::make_shared<GrpcAccessLoggerImpl>(
+      client, config.log_name(), buffer_flush_interval_msec, max_buffer_size_bytes,
+      max_pending_buffer_size_bytes, dispatcher, local_info_, scope, transport_version);
 }
 
 } // namespace GrpcCommon
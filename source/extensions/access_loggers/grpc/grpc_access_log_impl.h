@@ -25,8 +25,9 @@ class GrpcAccessLoggerImpl
 public:
   GrpcAccessLoggerImpl(const Grpc::RawAsyncClientSharedPtr& client, std::string log_name,
                        std::chrono::milliseconds buffer_flush_interval_msec,
-                       uint64_t max_buffer_size_bytes, Event::Dispatcher& dispatcher,
-                       const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
+                       uint64_t max_buffer_size_bytes, uint64_t max_pending_buffer_size_bytes,
+                       Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info,
+                       Stats::Scope& scope,
                        envoy::config::core::v3::ApiVersion transport_api_version);
 
 private:
@@ -56,7 +57,8 @@ private:
                envoy::config::core::v3::ApiVersion transport_version,
                const Grpc::RawAsyncClientSharedPtr& client,
                std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-               Event::Dispatcher& dispatcher, Stats::Scope& scope) override;
+               uint64_t max_pending_buffer_size_bytes, Event::Dispatcher& dispatcher,
+               Stats::Scope& scope) override;
 
   const LocalInfo::LocalInfo& local_info_;
 };
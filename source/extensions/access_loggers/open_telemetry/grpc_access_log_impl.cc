@@ -23,11 +23,12 @@ namespace OpenTelemetry {
 GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(
     const Grpc::RawAsyncClientSharedPtr& client, std::string log_name,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-    Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
+    uint64_t max_pending_buffer_size_bytes, Event::Dispatcher& dispatcher,
+    const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
     envoy::config::core::v3::ApiVersion transport_api_version)
     : GrpcAccessLogger(
-          client, buffer_flush_interval_msec, max_buffer_size_bytes, dispatcher, scope,
-          GRPC_LOG_STATS_PREFIX,
+          client, buffer_flush_interval_msec, max_buffer_size_bytes,
+          max_pending_buffer_size_bytes, dispatcher, scope, GRPC_LOG_STATS_PREFIX,
           Grpc::VersionedMethods("opentelemetry.proto.collector.logs.v1.LogsService.Export",
                                  "opentelemetry.proto.collector.logs.v1.LogsService.Export")
               .getMethodDescriptorForVersion(transport_api_version),
@@ -81,10 +82,10 @@ GrpcAccessLoggerImpl::SharedPtr GrpcAccessLoggerCacheImpl::createLogger(
     envoy::config::core::v3::ApiVersion transport_version,
     const Grpc::RawAsyncClientSharedPtr& client,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-    Event::Dispatcher& dispatcher, Stats::Scope& scope) {
-  return std::make_shared<GrpcAccessLoggerImpl>(client, config.log_name(),
-                                                buffer_flush_interval_msec, max_buffer_size_bytes,
-                                                dispatcher, local_info_, scope, transport_version);
+    uint64_t max_pending_buffer_size_bytes, Event::Dispatcher& dispatcher, Stats::Scope& scope) {
+  return std::make_shared<GrpcAccessLoggerImpl>(
+      client, config.log_name(), buffer_flush_interval_msec, max_buffer_size_bytes,
+      max_pending_buffer_size_bytes, dispatcher, local_info_, scope, transport_version);
 }
 
 } // namespace OpenTelemetry
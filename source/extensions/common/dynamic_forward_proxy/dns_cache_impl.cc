@@ -18,10 +18,12 @@ namespace DynamicForwardProxy {
 DnsCacheImpl::DnsCacheImpl(
     Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
     Random::RandomGenerator& random, Runtime::Loader& loader, Stats::Scope& root_scope,
-    const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config)
+    const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config,
+    Network::DnsResolverSharedPtr shared_resolver)
     : main_thread_dispatcher_(main_thread_dispatcher),
       dns_lookup_family_(Upstream::getDnsLookupFamilyFromEnum(config.dns_lookup_family())),
-      resolver_(selectDnsResolver(config, main_thread_dispatcher)), tls_slot_(tls),
+      resolver_(selectDnsResolver(config, main_thread_dispatcher, std::move(shared_resolver))),
+      tls_slot_(tls),
       scope_(root_scope.createScope(fmt::format("dns_cache.{}.", config.name()))),
       stats_(generateDnsCacheStats(*scope_)),
       resource_manager_(*scope_, loader, config.name(), config.dns_cache_circuit_breaker()),
@@ -56,10 +58,13 @@ DnsCacheImpl::DnsCacheImpl(
 }
 
 DnsCacheImpl::~DnsCacheImpl() {
-  for (const auto& primary_host : primary_hosts_) {
-    if (primary_host.second->active_query_ != nullptr) {
-      primary_host.second->active_query_->cancel(
-          Network::ActiveDnsQuery::CancelReason::QueryAbandoned);
+  for (auto& shard : primary_host_shards_) {
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    for (const auto& primary_host : shard.hosts_) {
+      if (primary_host.second->active_query_ != nullptr) {
+        primary_host.second->active_query_->cancel(
+            Network::ActiveDnsQuery::CancelReason::QueryAbandoned);
+      }
     }
   }
 
@@ -70,7 +75,12 @@ DnsCacheImpl::~DnsCacheImpl() {
 
 Network::DnsResolverSharedPtr DnsCacheImpl::selectDnsResolver(
     const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config,
-    Event::Dispatcher& main_thread_dispatcher) {
+    Event::Dispatcher& main_thread_dispatcher, Network::DnsResolverSharedPtr shared_resolver) {
+  if (shared_resolver != nullptr && !config.has_dns_resolution_config() &&
+      !config.use_tcp_for_dns_lookups()) {
+    return shared_resolver;
+  }
+
   envoy::config::core::v3::DnsResolverOptions dns_resolver_options;
   std::vector<Network::Address::InstanceConstSharedPtr> resolvers;
   if (config.has_dns_resolution_config()) {
@@ -102,11 +112,12 @@ DnsCacheImpl::loadDnsCacheEntry(absl::string_view host, uint16_t default_port,
   ThreadLocalHostInfo& tls_host_info = *tls_slot_;
 
   auto [is_overflow, host_info] = [&]() {
-    absl::ReaderMutexLock read_lock{&primary_hosts_lock_};
-    auto tls_host = primary_hosts_.find(host);
+    PrimaryHostShard& shard = primaryHostShard(host);
+    absl::ReaderMutexLock read_lock{&shard.lock_};
+    auto tls_host = shard.hosts_.find(host);
     return std::make_tuple(
-        primary_hosts_.size() >= max_hosts_,
-        (tls_host != primary_hosts_.end() && tls_host->second->host_info_->firstResolveComplete())
+        num_primary_hosts_.load(std::memory_order_relaxed) >= max_hosts_,
+        (tls_host != shard.hosts_.end() && tls_host->second->host_info_->firstResolveComplete())
             ? absl::optional<DnsHostInfoSharedPtr>(tls_host->second->host_info_)
             : absl::nullopt);
   }();
@@ -139,11 +150,13 @@ Upstream::ResourceAutoIncDecPtr DnsCacheImpl::canCreateDnsRequest() {
 }
 
 void DnsCacheImpl::iterateHostMap(IterateHostMapCb iterate_callback) {
-  absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-  for (const auto& host : primary_hosts_) {
-    // Only include hosts that have ever resolved to an address.
-    if (host.second->host_info_->address() != nullptr) {
-      iterate_callback(host.first, host.second->host_info_);
+  for (auto& shard : primary_host_shards_) {
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    for (const auto& host : shard.hosts_) {
+      // Only include hosts that have ever resolved to an address.
+      if (host.second->host_info_->address() != nullptr) {
+        iterate_callback(host.first, host.second->host_info_);
+      }
     }
   }
 }
@@ -151,9 +164,10 @@ void DnsCacheImpl::iterateHostMap(IterateHostMapCb iterate_callback) {
 absl::optional<const DnsHostInfoSharedPtr> DnsCacheImpl::getHost(absl::string_view host_name) {
   // Find a host with the given name.
   const auto host_info = [&]() -> const DnsHostInfoSharedPtr {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    auto it = primary_hosts_.find(host_name);
-    return it != primary_hosts_.end() ? it->second->host_info_ : nullptr;
+    PrimaryHostShard& shard = primaryHostShard(host_name);
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    auto it = shard.hosts_.find(host_name);
+    return it != shard.hosts_.end() ? it->second->host_info_ : nullptr;
   }();
 
   // Only include hosts that have ever resolved to an address.
@@ -176,12 +190,13 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
   // already in the map it's either in the process of being resolved or the resolution is already
   // heading out to the worker threads. Either way the pending resolution will be completed.
 
-  // Functions like this one that modify primary_hosts_ are only called in the main thread so we
-  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
+  // Functions like this one that modify the primary hosts are only called in the main thread so
+  // we know it is safe to use the PrimaryHostInfo pointers outside of the lock.
+  PrimaryHostShard& shard = primaryHostShard(host);
   auto* primary_host = [&]() {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    auto host_it = primary_hosts_.find(host);
-    return host_it != primary_hosts_.end() ? host_it->second.get() : nullptr;
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    auto host_it = shard.hosts_.find(host);
+    return host_it != shard.hosts_.end() ? host_it->second.get() : nullptr;
   }();
 
   if (primary_host) {
@@ -195,8 +210,8 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
   // independent primary hosts with independent DNS resolutions. I'm not sure how much this will
   // matter, but we could consider collapsing these down and sharing the underlying DNS resolution.
   {
-    absl::WriterMutexLock writer_lock{&primary_hosts_lock_};
-    primary_host = primary_hosts_
+    absl::WriterMutexLock writer_lock{&shard.lock_};
+    primary_host = shard.hosts_
                        // try_emplace() is used here for direct argument forwarding.
                        .try_emplace(host, std::make_unique<PrimaryHostInfo>(
                                               *this, std::string(host_attributes.host_),
@@ -206,17 +221,19 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
                                               [this, host]() { onResolveTimeout(host); }))
                        .first->second.get();
   }
+  num_primary_hosts_.fetch_add(1, std::memory_order_relaxed);
 
   startResolve(host, *primary_host);
 }
 
 DnsCacheImpl::PrimaryHostInfo& DnsCacheImpl::getPrimaryHost(const std::string& host) {
-  // Functions modify primary_hosts_ are only called in the main thread so we
+  // Functions modify the primary hosts are only called in the main thread so we
   // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
   ASSERT(main_thread_dispatcher_.isThreadSafe());
-  absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-  const auto primary_host_it = primary_hosts_.find(host);
-  ASSERT(primary_host_it != primary_hosts_.end());
+  PrimaryHostShard& shard = primaryHostShard(host);
+  absl::ReaderMutexLock reader_lock{&shard.lock_};
+  const auto primary_host_it = shard.hosts_.find(host);
+  ASSERT(primary_host_it != shard.hosts_.end());
   return *(primary_host_it->second.get());
 }
 
@@ -252,12 +269,14 @@ void DnsCacheImpl::onReResolve(const std::string& host) {
       runRemoveCallbacks(host);
     }
     {
-      absl::WriterMutexLock writer_lock{&primary_hosts_lock_};
-      auto host_it = primary_hosts_.find(host);
-      ASSERT(host_it != primary_hosts_.end());
+      PrimaryHostShard& shard = primaryHostShard(host);
+      absl::WriterMutexLock writer_lock{&shard.lock_};
+      auto host_it = shard.hosts_.find(host);
+      ASSERT(host_it != shard.hosts_.end());
       host_to_erase = std::move(host_it->second);
-      primary_hosts_.erase(host_it);
+      shard.hosts_.erase(host_it);
     }
+    num_primary_hosts_.fetch_sub(1, std::memory_order_relaxed);
     notifyThreads(host, primary_host.host_info_);
   } else {
     startResolve(host, primary_host);
@@ -286,14 +305,9 @@ void DnsCacheImpl::finishResolve(const std::string& host,
   ASSERT(main_thread_dispatcher_.isThreadSafe());
   ENVOY_LOG(debug, "main thread resolve complete for host '{}'. {} results", host, response.size());
 
-  // Functions like this one that modify primary_hosts_ are only called in the main thread so we
-  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
-  auto* primary_host_info = [&]() {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    const auto primary_host_it = primary_hosts_.find(host);
-    ASSERT(primary_host_it != primary_hosts_.end());
-    return primary_host_it->second.get();
-  }();
+  // Functions like this one that modify the primary hosts are only called in the main thread so
+  // we know it is safe to use the PrimaryHostInfo pointers outside of the lock.
+  auto* primary_host_info = &getPrimaryHost(host);
 
   const bool first_resolve = !primary_host_info->host_info_->firstResolveComplete();
   primary_host_info->timeout_timer_->disableTimer();
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+
 #include "envoy/common/backoff_strategy.h"
 #include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
 #include "envoy/http/filter.h"
@@ -7,6 +10,7 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/common/cleanup.h"
+#include "source/common/common/hash.h"
 #include "source/extensions/common/dynamic_forward_proxy/dns_cache.h"
 #include "source/extensions/common/dynamic_forward_proxy/dns_cache_resource_manager.h"
 
@@ -43,12 +47,17 @@ class DnsCacheImpl : public DnsCache, Logger::Loggable<Logger::Id::forward_proxy
 public:
   DnsCacheImpl(Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
                Random::RandomGenerator& random, Runtime::Loader& loader, Stats::Scope& root_scope,
-               const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config);
+               const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config,
+               Network::DnsResolverSharedPtr shared_resolver);
   ~DnsCacheImpl() override;
   static DnsCacheStats generateDnsCacheStats(Stats::Scope& scope);
+  /**
+   * @return the shared resolver if there is one and the config does not customize the resolver,
+   *         otherwise a resolver created for the config.
+   */
   static Network::DnsResolverSharedPtr selectDnsResolver(
       const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config,
-      Event::Dispatcher& main_thread_dispatcher);
+      Event::Dispatcher& main_thread_dispatcher, Network::DnsResolverSharedPtr shared_resolver);
 
   // DnsCache
   LoadDnsCacheEntryResult loadDnsCacheEntry(absl::string_view host, uint16_t default_port,
@@ -108,20 +117,22 @@ private:
     void touch() final { last_used_time_ = time_source_.monotonicTime().time_since_epoch(); }
 
     void setAddress(Network::Address::InstanceConstSharedPtr address) {
-      absl::WriterMutexLock lock{&resolve_lock_};
-      first_resolve_complete_ = true;
-      address_ = address;
+      {
+        absl::WriterMutexLock lock{&resolve_lock_};
+        address_ = address;
+      }
+      setFirstResolveComplete();
     }
     std::chrono::steady_clock::duration lastUsedTime() const { return last_used_time_.load(); }
 
+    // The flag is read on every cache hit, so it is kept out of the address lock. It is set after
+    // the address is, so that a host seen as resolved also has its address visible.
     bool firstResolveComplete() const {
-      absl::ReaderMutexLock lock{&resolve_lock_};
-      return first_resolve_complete_;
+      return first_resolve_complete_.load(std::memory_order_acquire);
     }
 
     void setFirstResolveComplete() {
-      absl::WriterMutexLock lock{&resolve_lock_};
-      first_resolve_complete_ = true;
+      first_resolve_complete_.store(true, std::memory_order_release);
     }
 
   private:
@@ -134,7 +145,7 @@ private:
     // Using std::chrono::steady_clock::duration is required for compilation within an atomic vs.
     // using MonotonicTime.
     std::atomic<std::chrono::steady_clock::duration> last_used_time_;
-    bool first_resolve_complete_ ABSL_GUARDED_BY(resolve_lock_){false};
+    std::atomic<bool> first_resolve_complete_{false};
   };
 
   // Primary host information that accounts for TTL, re-resolution, etc.
@@ -156,6 +167,19 @@ private:
   // individual entries.
   using PrimaryHostInfoPtr = std::unique_ptr<PrimaryHostInfo>;
 
+  // The primary hosts are split into shards with a lock each, so that the lookups of the workers
+  // on different hosts do not contend on one lock, and the main thread adding or removing a host
+  // only blocks the lookups of its shard. The shards are only modified on the main thread.
+  static constexpr uint32_t PrimaryHostShards = 16;
+  struct PrimaryHostShard {
+    absl::Mutex lock_;
+    absl::flat_hash_map<std::string, PrimaryHostInfoPtr> hosts_ ABSL_GUARDED_BY(lock_);
+  };
+
+  PrimaryHostShard& primaryHostShard(absl::string_view host) {
+    return primary_host_shards_[HashUtil::xxHash64(host) % PrimaryHostShards];
+  }
+
   struct AddUpdateCallbacksHandleImpl : public AddUpdateCallbacksHandle,
                                         RaiiListElement<AddUpdateCallbacksHandleImpl*> {
     AddUpdateCallbacksHandleImpl(std::list<AddUpdateCallbacksHandleImpl*>& parent,
@@ -167,8 +191,7 @@ private:
 
   void startCacheLoad(const std::string& host, uint16_t default_port);
 
-  void startResolve(const std::string& host, PrimaryHostInfo& host_info)
-      ABSL_LOCKS_EXCLUDED(primary_hosts_lock_);
+  void startResolve(const std::string& host, PrimaryHostInfo& host_info);
   void finishResolve(const std::string& host, Network::DnsResolver::ResolutionStatus status,
                      std::list<Network::DnsResponse>&& response);
   void runAddUpdateCallbacks(const std::string& host, const DnsHostInfoSharedPtr& host_info);
@@ -185,9 +208,9 @@ private:
   Stats::ScopePtr scope_;
   DnsCacheStats stats_;
   std::list<AddUpdateCallbacksHandleImpl*> update_callbacks_;
-  absl::Mutex primary_hosts_lock_;
-  absl::flat_hash_map<std::string, PrimaryHostInfoPtr>
-      primary_hosts_ ABSL_GUARDED_BY(primary_hosts_lock_);
+  std::array<PrimaryHostShard, PrimaryHostShards> primary_host_shards_;
+  // The number of primary hosts in all shards, checked against max_hosts_ on every cache miss.
+  std::atomic<size_t> num_primary_hosts_{0};
   DnsCacheResourceManagerImpl resource_manager_;
   const std::chrono::milliseconds refresh_interval_;
   const std::chrono::milliseconds timeout_interval_;
@@ -2,6 +2,7 @@
 
 #include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
 
+#include "source/common/network/shared_dns_cache_impl.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
 
@@ -27,7 +28,7 @@ DnsCacheSharedPtr DnsCacheManagerImpl::getCache(
   }
 
   DnsCacheSharedPtr new_cache = std::make_shared<DnsCacheImpl>(
-      main_thread_dispatcher_, tls_, random_, loader_, root_scope_, config);
+      main_thread_dispatcher_, tls_, random_, loader_, root_scope_, config, shared_resolver_);
   caches_.emplace(config.name(), ActiveCache{config, new_cache});
   return new_cache;
 }
@@ -35,8 +36,9 @@ DnsCacheSharedPtr DnsCacheManagerImpl::getCache(
 DnsCacheManagerSharedPtr DnsCacheManagerFactoryImpl::get() {
   return singleton_manager_.getTyped<DnsCacheManager>(
       SINGLETON_MANAGER_REGISTERED_NAME(dns_cache_manager), [this] {
-        return std::make_shared<DnsCacheManagerImpl>(dispatcher_, tls_, random_, loader_,
-                                                     root_scope_);
+        return std::make_shared<DnsCacheManagerImpl>(
+            dispatcher_, tls_, random_, loader_, root_scope_,
+            Network::SharedDnsCacheImpl::singleton(singleton_manager_));
       });
 }
 
@@ -4,6 +4,7 @@ EXTENSIONS = {
     # Access loggers
     #
 
+    "envoy.access_loggers.aggregate":                   "//source/extensions/access_loggers/aggregate:config",
     "envoy.access_loggers.file":                        "//source/extensions/access_loggers/file:config",
     "envoy.access_loggers.http_grpc":                   "//source/extensions/access_loggers/grpc:http_config",
     "envoy.access_loggers.tcp_grpc":                    "//source/extensions/access_loggers/grpc:tcp_config",
@@ -236,6 +237,12 @@ EXTENSIONS = {
     "envoy.upstreams.http.http":                        "//source/extensions/upstreams/http/http:config",
     "envoy.upstreams.http.tcp":                         "//source/extensions/upstreams/http/tcp:config",
 
+    #
+    # Private key providers
+    #
+
+    "envoy.tls.key_providers.offload":                  "//source/extensions/private_key_providers/offload:config",
+
     #
     # Watchdog actions
     #
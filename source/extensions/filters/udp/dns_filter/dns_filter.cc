@@ -15,6 +15,9 @@ namespace DnsFilter {
 
 static constexpr std::chrono::milliseconds DEFAULT_RESOLVER_TIMEOUT{500};
 static constexpr std::chrono::seconds DEFAULT_RESOLVER_TTL{300};
+static constexpr uint64_t DEFAULT_CACHE_MAX_ENTRIES{10000};
+static constexpr std::chrono::seconds DEFAULT_CACHE_MAX_TTL{300};
+static constexpr std::chrono::seconds DEFAULT_CACHE_NEGATIVE_TTL{30};
 
 DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
     Server::Configuration::ListenerFactoryContext& context,
@@ -174,6 +177,25 @@ DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
     resolver_timeout_ = std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
         client_config, resolver_timeout, DEFAULT_RESOLVER_TIMEOUT.count()));
     max_pending_lookups_ = client_config.max_pending_lookups();
+
+    if (client_config.has_response_cache()) {
+      const auto& cache_config = client_config.response_cache();
+      DnsResponseCacheConfig response_cache_config{};
+      response_cache_config.max_entries =
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(cache_config, max_entries, DEFAULT_CACHE_MAX_ENTRIES);
+      response_cache_config.max_ttl = cache_config.has_max_ttl()
+                                          ? std::chrono::seconds(cache_config.max_ttl().seconds())
+                                          : DEFAULT_CACHE_MAX_TTL;
+      response_cache_config.negative_ttl =
+          cache_config.has_negative_ttl()
+              ? std::chrono::seconds(cache_config.negative_ttl().seconds())
+              : DEFAULT_CACHE_NEGATIVE_TTL;
+      if (cache_config.has_prefetch_threshold()) {
+        response_cache_config.prefetch_threshold =
+            PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(cache_config, prefetch_threshold, 0) / 100;
+      }
+      response_cache_config_ = response_cache_config;
+    }
   }
 }
 
@@ -246,15 +268,32 @@ DnsFilter::DnsFilter(Network::UdpReadFilterCallbacks& callbacks,
       config_->stats().unanswered_queries_.inc();
     }
 
+    // Only cache what the external resolvers answered, not timeouts or failures such as a refused
+    // query or an unreachable resolver. A successful resolution without addresses is a name error
+    // or an empty answer and is cached as a negative one. Cached answers carry the TTL they are
+    // cached for.
+    std::chrono::seconds ttl = getDomainTTL(query->name_);
+    if (cache_ != nullptr && context->in_callback_ &&
+        context->resolution_status_ == Network::DnsResolver::ResolutionStatus::Success) {
+      ttl = cache_->insert(query->name_, query->type_, iplist, context->resolution_ttl_);
+    }
+
     incrementExternalQueryTypeCount(query->type_);
     for (const auto& ip : iplist) {
       incrementExternalQueryTypeAnswerCount(query->type_);
-      const std::chrono::seconds ttl = getDomainTTL(query->name_);
       message_parser_.storeDnsAnswerRecord(context, *query, ttl, std::move(ip));
     }
     sendDnsResponse(std::move(context));
   };
 
+  const auto& cache_config = config->responseCacheConfig();
+  if (cache_config.has_value()) {
+    cache_ = std::make_unique<DnsFilterCache>(
+        listener_.dispatcher().timeSource(), cache_config->max_entries, cache_config->max_ttl,
+        cache_config->negative_ttl, cache_config->prefetch_threshold,
+        config_->stats().cache_evictions_);
+  }
+
   resolver_ = std::make_unique<DnsFilterResolver>(
       resolver_callback_, config->resolvers(), config->resolverTimeout(), listener_.dispatcher(),
       config->maxPendingLookups(), config->dnsResolverOptions());
@@ -331,6 +370,10 @@ DnsLookupResponseCode DnsFilter::getResponseForQuery(DnsQueryContextPtr& context
     // Forwarding queries is enabled if the configuration contains a client configuration
     // for the dns_filter.
     if (forward_queries) {
+      if (cache_ != nullptr && resolveViaCache(context, *query)) {
+        continue;
+      }
+
       ENVOY_LOG(debug, "resolving name [{}] via external resolvers", query->name_);
       resolver_->resolveExternalQuery(std::move(context), query.get());
 
@@ -358,6 +401,41 @@ bool DnsFilter::resolveViaConfiguredHosts(DnsQueryContextPtr& context,
   }
 }
 
+bool DnsFilter::resolveViaCache(DnsQueryContextPtr& context, const DnsQueryRecord& query) {
+  const auto answer = cache_->lookup(query);
+  if (!answer.has_value()) {
+    return false;
+  }
+
+  ENVOY_LOG(trace, "using cached answer for [{}] with {} addresses", query.name_,
+            answer->addresses_->size());
+  if (answer->addresses_->empty()) {
+    config_->stats().cache_negative_hits_.inc();
+  } else {
+    config_->stats().cache_hits_.inc();
+  }
+  for (const auto& address : *answer->addresses_) {
+    message_parser_.storeDnsAnswerRecord(context, query, answer->ttl_, address);
+  }
+
+  if (answer->prefetch_) {
+    config_->stats().cache_prefetches_.inc();
+    resolver_->prefetch(query.name_, query.type_,
+                        [this, name = query.name_,
+                         type = query.type_](Network::DnsResolver::ResolutionStatus status,
+                                             std::chrono::seconds ttl, AddressConstPtrVec& iplist) {
+                          // Keep the cached answer until it expires if the refresh failed.
+                          if (status == Network::DnsResolver::ResolutionStatus::Success &&
+                              !iplist.empty()) {
+                            cache_->insert(name, type, iplist, ttl);
+                          } else {
+                            cache_->onPrefetchFailed(name, type);
+                          }
+                        });
+  }
+  return true;
+}
+
 std::chrono::seconds DnsFilter::getDomainTTL(const absl::string_view domain) {
   const auto& domain_ttl_config = config_->domainTtl();
   const auto& iter = domain_ttl_config.find(domain);
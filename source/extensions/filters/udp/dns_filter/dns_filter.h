@@ -9,6 +9,7 @@
 #include "source/common/common/utility.h"
 #include "source/common/config/config_provider_impl.h"
 #include "source/common/network/utility.h"
+#include "source/extensions/filters/udp/dns_filter/dns_filter_cache.h"
 #include "source/extensions/filters/udp/dns_filter/dns_filter_resolver.h"
 #include "source/extensions/filters/udp/dns_filter/dns_parser.h"
 
@@ -26,6 +27,10 @@ namespace DnsFilter {
   COUNTER(a_record_queries)                                                                        \
   COUNTER(aaaa_record_queries)                                                                     \
   COUNTER(srv_record_queries)                                                                      \
+  COUNTER(cache_evictions)                                                                         \
+  COUNTER(cache_hits)                                                                              \
+  COUNTER(cache_negative_hits)                                                                     \
+  COUNTER(cache_prefetches)                                                                        \
   COUNTER(cluster_a_record_answers)                                                                \
   COUNTER(cluster_aaaa_record_answers)                                                             \
   COUNTER(cluster_srv_record_answers)                                                              \
@@ -68,6 +73,13 @@ struct DnsEndpointConfig {
   absl::optional<DnsSrvRecordPtr> service_list;
 };
 
+struct DnsResponseCacheConfig {
+  uint64_t max_entries;
+  std::chrono::seconds max_ttl;
+  std::chrono::seconds negative_ttl;
+  absl::optional<double> prefetch_threshold;
+};
+
 using DnsVirtualDomainConfig = absl::flat_hash_map<std::string, DnsEndpointConfig>;
 using DnsVirtualDomainConfigSharedPtr = std::shared_ptr<DnsVirtualDomainConfig>;
 
@@ -94,6 +106,9 @@ public:
   const envoy::config::core::v3::DnsResolverOptions& dnsResolverOptions() const {
     return dns_resolver_options_;
   }
+  const absl::optional<DnsResponseCacheConfig>& responseCacheConfig() const {
+    return response_cache_config_;
+  }
   const TrieLookupTable<DnsVirtualDomainConfigSharedPtr>& getDnsTrie() const {
     return dns_lookup_trie_;
   }
@@ -128,6 +143,7 @@ private:
   Random::RandomGenerator& random_;
   uint64_t max_pending_lookups_;
   envoy::config::core::v3::DnsResolverOptions dns_resolver_options_;
+  absl::optional<DnsResponseCacheConfig> response_cache_config_;
 };
 
 using DnsFilterEnvoyConfigSharedPtr = std::shared_ptr<const DnsFilterEnvoyConfig>;
@@ -230,6 +246,16 @@ private:
    */
   bool resolveViaConfiguredHosts(DnsQueryContextPtr& context, const DnsQueryRecord& query);
 
+  /**
+   * @brief Resolves the supplied query from the cached answers of the external resolvers. Starts
+   * refreshing the answer in the background if it is about to expire.
+   *
+   * @param context object containing the query context
+   * @param query query object containing the name to be resolved
+   * @return bool true if an answer, possibly negative, is cached for the query
+   */
+  bool resolveViaCache(DnsQueryContextPtr& context, const DnsQueryRecord& query);
+
   /**
    * @brief Increment the counter for the given query type for external queries
    *
@@ -371,6 +397,8 @@ private:
   Network::UdpListener& listener_;
   Upstream::ClusterManager& cluster_manager_;
   DnsMessageParser message_parser_;
+  // Only set if the answers of the external resolvers are cached.
+  DnsFilterCachePtr cache_;
   DnsFilterResolverPtr resolver_;
   Network::Address::InstanceConstSharedPtr local_;
   Network::Address::InstanceConstSharedPtr peer_;
@@ -0,0 +1,95 @@
+#include "source/extensions/filters/udp/dns_filter/dns_filter_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+
+DnsFilterCache::DnsFilterCache(TimeSource& time_source, uint64_t max_entries,
+                               std::chrono::seconds max_ttl, std::chrono::seconds negative_ttl,
+                               absl::optional<double> prefetch_threshold,
+                               Stats::Counter& evictions)
+    : time_source_(time_source), max_entries_(max_entries), max_ttl_(max_ttl),
+      negative_ttl_(negative_ttl), prefetch_threshold_(prefetch_threshold), evictions_(evictions) {
+  ASSERT(max_entries_ > 0);
+}
+
+absl::optional<DnsFilterCache::CachedAnswer> DnsFilterCache::lookup(const DnsQueryRecord& query) {
+  const auto it = index_.find(Key(query.name_, query.type_));
+  if (it == index_.end()) {
+    return absl::nullopt;
+  }
+
+  Entry& entry = *it->second;
+  const MonotonicTime now = time_source_.monotonicTime();
+  if (now >= entry.expiry_) {
+    ENVOY_LOG(trace, "Cached answer for [{}] expired", query.name_);
+    remove(it);
+    return absl::nullopt;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+
+  // Round up, so that an answer is never advertised with a zero TTL before it expires.
+  const auto ttl_left = std::chrono::ceil<std::chrono::seconds>(entry.expiry_ - now);
+  bool prefetch = false;
+  if (prefetch_threshold_.has_value() && !entry.prefetching_ && !entry.addresses_.empty() &&
+      ttl_left.count() <= entry.ttl_.count() * prefetch_threshold_.value()) {
+    ENVOY_LOG(trace, "Prefetching answer for [{}] with {}s left", query.name_, ttl_left.count());
+    entry.prefetching_ = true;
+    prefetch = true;
+  }
+  return CachedAnswer{&entry.addresses_, ttl_left, prefetch};
+}
+
+std::chrono::seconds DnsFilterCache::insert(const std::string& name, uint16_t type,
+                                            const AddressConstPtrVec& addresses,
+                                            std::chrono::seconds ttl) {
+  const std::chrono::seconds cache_ttl =
+      addresses.empty() ? negative_ttl_ : std::min(ttl, max_ttl_);
+  auto it = index_.find(Key(name, type));
+  if (cache_ttl.count() == 0) {
+    if (it != index_.end()) {
+      remove(it);
+    }
+    return cache_ttl;
+  }
+
+  const MonotonicTime expiry = time_source_.monotonicTime() + cache_ttl;
+  if (it != index_.end()) {
+    Entry& entry = *it->second;
+    entry.addresses_ = addresses;
+    entry.expiry_ = expiry;
+    entry.ttl_ = cache_ttl;
+    entry.prefetching_ = false;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return cache_ttl;
+  }
+
+  if (entries_.size() >= max_entries_) {
+    ENVOY_LOG(trace, "Evicting cached answer for [{}]", entries_.back().name_);
+    remove(index_.find(Key(entries_.back().name_, entries_.back().type_)));
+    evictions_.inc();
+  }
+  entries_.push_front(Entry{name, type, addresses, expiry, cache_ttl, false});
+  index_.emplace(Key(entries_.front().name_, type), entries_.begin());
+  return cache_ttl;
+}
+
+void DnsFilterCache::onPrefetchFailed(const std::string& name, uint16_t type) {
+  const auto it = index_.find(Key(name, type));
+  if (it != index_.end()) {
+    it->second->prefetching_ = false;
+  }
+}
+
+void DnsFilterCache::remove(absl::flat_hash_map<Key, EntryList::iterator>::iterator it) {
+  // Erase the index entry first, as its key references the entry's name.
+  const EntryList::iterator entry = it->second;
+  index_.erase(it);
+  entries_.erase(entry);
+}
+
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/stats/stats.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/filters/udp/dns_filter/dns_parser.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+
+/**
+ * This class caches the answers to the queries the DNS filter resolved externally, keyed by the
+ * query name and type. Each worker's filter has its own cache, so it is not thread safe. Positive
+ * answers are kept for the smallest TTL returned by the resolver, capped by the maximum TTL, and
+ * negative answers for the negative TTL. Once the cache is full, the least recently used answer is
+ * evicted.
+ */
+class DnsFilterCache : Logger::Loggable<Logger::Id::filter> {
+public:
+  struct CachedAnswer {
+    // Empty for a negative answer.
+    const AddressConstPtrVec* addresses_;
+    // The time left before the answer expires, to be used as the TTL of the answer records.
+    std::chrono::seconds ttl_;
+    // Whether the answer should be refreshed in the background.
+    bool prefetch_;
+  };
+
+  DnsFilterCache(TimeSource& time_source, uint64_t max_entries, std::chrono::seconds max_ttl,
+                 std::chrono::seconds negative_ttl, absl::optional<double> prefetch_threshold,
+                 Stats::Counter& evictions);
+
+  /**
+   * @brief Looks up a valid answer for a query. An expired answer is removed from the cache.
+   *
+   * If the answer is in the last part of its TTL defined by the prefetch threshold, the first
+   * lookup sets prefetch_ in the returned answer until the answer is replaced or the prefetch
+   * fails.
+   *
+   * @param query the query record
+   * @return absl::optional<CachedAnswer> the cached answer, if any
+   */
+  absl::optional<CachedAnswer> lookup(const DnsQueryRecord& query);
+
+  /**
+   * @brief Caches the answer of the upstream resolvers to a query, replacing any cached answer
+   *
+   * @param name the queried name
+   * @param type the queried record type
+   * @param addresses the resolved addresses, empty for a negative answer
+   * @param ttl the smallest TTL of the resolved addresses
+   * @return std::chrono::seconds the time the answer is cached for, zero if it is not cached
+   */
+  std::chrono::seconds insert(const std::string& name, uint16_t type,
+                              const AddressConstPtrVec& addresses, std::chrono::seconds ttl);
+
+  /**
+   * @brief Allows the answer to a query to be prefetched again after a failed prefetch
+   */
+  void onPrefetchFailed(const std::string& name, uint16_t type);
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  struct Entry {
+    const std::string name_;
+    const uint16_t type_;
+    AddressConstPtrVec addresses_;
+    MonotonicTime expiry_;
+    std::chrono::seconds ttl_;
+    bool prefetching_;
+  };
+  using EntryList = std::list<Entry>;
+  // The keys reference the name stored in the entry, so that lookups don't copy the query name.
+  using Key = std::pair<absl::string_view, uint16_t>;
+
+  void remove(absl::flat_hash_map<Key, EntryList::iterator>::iterator it);
+
+  TimeSource& time_source_;
+  const uint64_t max_entries_;
+  const std::chrono::seconds max_ttl_;
+  const std::chrono::seconds negative_ttl_;
+  const absl::optional<double> prefetch_threshold_;
+  Stats::Counter& evictions_;
+  // Most recently used first.
+  EntryList entries_;
+  absl::flat_hash_map<Key, EntryList::iterator> index_;
+};
+
+using DnsFilterCachePtr = std::unique_ptr<DnsFilterCache>;
+
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -7,6 +7,25 @@ namespace Extensions {
 namespace UdpFilters {
 namespace DnsFilter {
 
+namespace {
+
+// The smallest TTL of the resolved addresses, which is how long the answer as a whole is valid.
+std::chrono::seconds minTtl(const std::list<Network::DnsResponse>& response) {
+  std::chrono::seconds ttl = std::chrono::seconds::max();
+  for (const auto& resp : response) {
+    ttl = std::min(ttl, resp.ttl_);
+  }
+  return response.empty() ? std::chrono::seconds(0) : ttl;
+}
+
+} // namespace
+
+DnsFilterResolver::~DnsFilterResolver() {
+  for (auto& prefetch : prefetches_) {
+    prefetch.second->cancel(Network::ActiveDnsQuery::CancelReason::QueryAbandoned);
+  }
+}
+
 void DnsFilterResolver::resolveExternalQuery(DnsQueryContextPtr context,
                                              const DnsQueryRecord* domain_query) {
   // Create an external resolution context for the query.
@@ -86,8 +105,8 @@ void DnsFilterResolver::resolveExternalQuery(DnsQueryContextPtr context,
                        ctx.query_context->resolution_status_ = status;
                        ctx.resolver_status = DnsFilterResolverStatus::Complete;
 
-                       // C-ares doesn't expose the TTL in the data available here.
                        if (status == Network::DnsResolver::ResolutionStatus::Success) {
+                         ctx.query_context->resolution_ttl_ = minTtl(response);
                          ctx.resolved_hosts.reserve(response.size());
                          for (const auto& resp : response) {
                            ASSERT(resp.address_ != nullptr);
@@ -101,6 +120,33 @@ void DnsFilterResolver::resolveExternalQuery(DnsQueryContextPtr context,
                      });
 }
 
+void DnsFilterResolver::prefetch(const std::string& name, uint16_t type,
+                                 DnsFilterPrefetchCallback callback) {
+  ASSERT(type == DNS_RECORD_TYPE_A || type == DNS_RECORD_TYPE_AAAA);
+  const Network::DnsLookupFamily lookup_family = type == DNS_RECORD_TYPE_A
+                                                     ? Network::DnsLookupFamily::V4Only
+                                                     : Network::DnsLookupFamily::V6Only;
+  const uint64_t id = next_prefetch_id_++;
+  Network::ActiveDnsQuery* query = resolver_->resolve(
+      name, lookup_family,
+      [this, id, callback](Network::DnsResolver::ResolutionStatus status,
+                           std::list<Network::DnsResponse>&& response) -> void {
+        prefetches_.erase(id);
+        AddressConstPtrVec resolved_hosts;
+        if (status == Network::DnsResolver::ResolutionStatus::Success) {
+          resolved_hosts.reserve(response.size());
+          for (const auto& resp : response) {
+            resolved_hosts.emplace_back(resp.address_);
+          }
+        }
+        callback(status, minTtl(response), resolved_hosts);
+      });
+  // The query is null if it completed inline.
+  if (query != nullptr) {
+    prefetches_.emplace(id, query);
+  }
+}
+
 void DnsFilterResolver::onResolveTimeout() {
   const uint64_t now = DateUtil::nowToSeconds(dispatcher_.timeSource());
   ENVOY_LOG(trace, "Pending queries: {}", lookups_.size());
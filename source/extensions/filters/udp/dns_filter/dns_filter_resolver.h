@@ -12,6 +12,10 @@ namespace DnsFilter {
 
 enum class DnsFilterResolverStatus { Pending, Complete, TimedOut };
 
+using DnsFilterPrefetchCallback =
+    std::function<void(Network::DnsResolver::ResolutionStatus status, std::chrono::seconds ttl,
+                       AddressConstPtrVec& ipaddr)>;
+
 /*
  * This class encapsulates the logic of handling an asynchronous DNS request for the DNS filter.
  * External request timeouts are handled here.
@@ -25,6 +29,8 @@ public:
       : timeout_(timeout), dispatcher_(dispatcher),
         resolver_(dispatcher.createDnsResolver(resolvers, dns_resolver_options)),
         callback_(callback), max_pending_lookups_(max_pending_lookups) {}
+  ~DnsFilterResolver();
+
   /**
    * @brief entry point to resolve the name in a DnsQueryRecord
    *
@@ -36,6 +42,18 @@ public:
    */
   void resolveExternalQuery(DnsQueryContextPtr context, const DnsQueryRecord* domain_query);
 
+  /**
+   * @brief resolves a name for which no client is waiting, such as a cached name about to expire
+   *
+   * Unlike resolveExternalQuery, the lookup is neither retried nor counted against the maximum
+   * number of pending lookups. Pending prefetches are cancelled when the resolver is destroyed.
+   *
+   * @param name the name to resolve
+   * @param type the record type, A or AAAA
+   * @param callback the callback invoked with the resolved addresses and their smallest TTL
+   */
+  void prefetch(const std::string& name, uint16_t type, DnsFilterPrefetchCallback callback);
+
 private:
   struct LookupContext {
     const DnsQueryRecord* query_rec;
@@ -68,6 +86,8 @@ private:
   DnsFilterResolverCallback& callback_;
   absl::flat_hash_map<const DnsQueryRecord*, LookupContext> lookups_;
   uint64_t max_pending_lookups_;
+  absl::flat_hash_map<uint64_t, Network::ActiveDnsQuery*> prefetches_;
+  uint64_t next_prefetch_id_{};
 };
 
 using DnsFilterResolverPtr = std::unique_ptr<DnsFilterResolver>;
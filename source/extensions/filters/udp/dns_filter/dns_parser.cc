@@ -7,82 +7,69 @@
 #include "source/common/network/utility.h"
 #include "source/extensions/filters/udp/dns_filter/dns_filter_utils.h"
 
-#include "ares.h"
-
 namespace Envoy {
 namespace Extensions {
 namespace UdpFilters {
 namespace DnsFilter {
 
-bool BaseDnsRecord::serializeSpecificName(Buffer::OwnedImpl& output, const absl::string_view name) {
-  // Iterate over a name e.g. "www.domain.com" once and produce a buffer containing each name
-  // segment prefixed by its length
+bool DnsWireBuffer::writeName(const absl::string_view name) {
+  // Iterate over a name e.g. "www.domain.com" once and write each name segment prefixed by its
+  // length
   static constexpr char SEPARATOR = '.';
 
-  // Names are restricted to 255 bytes per RFC
-  if (name.size() > MAX_NAME_LENGTH) {
+  // Names are restricted to 255 bytes per RFC. The encoded name takes two more bytes for the
+  // first length and the terminating null byte.
+  if (name.size() > MAX_NAME_LENGTH || name.size() + 2 > CAPACITY - length_) {
     return false;
   }
 
+  const size_t start = length_;
   size_t last = 0;
-  size_t count = name.find_first_of(SEPARATOR);
-  auto iter = name.begin();
-
-  while (count != std::string::npos) {
-    if ((count - last) > MAX_LABEL_LENGTH) {
+  while (true) {
+    const size_t separator = name.find(SEPARATOR, last);
+    const size_t count = (separator == absl::string_view::npos ? name.size() : separator) - last;
+    if (count > MAX_LABEL_LENGTH) {
+      length_ = start;
       return false;
     }
 
-    count -= last;
-    output.writeBEInt<uint8_t>(count);
-    for (size_t i = 0; i < count; i++) {
-      output.writeByte(*iter);
-      ++iter;
-    }
+    data_[length_++] = static_cast<uint8_t>(count);
+    std::copy_n(name.data() + last, count, data_.begin() + length_);
+    length_ += count;
 
-    // periods are not serialized. Skip to the next character
-    if (*iter == SEPARATOR) {
-      ++iter;
+    // Periods are not serialized
+    if (separator == absl::string_view::npos) {
+      break;
     }
-
-    // Move our last marker to the first position after where we stopped. Search for the next name
-    // separator
-    last += count;
-    count = name.find_first_of(SEPARATOR, ++last);
-  }
-
-  // Write the remaining segment prepended by its length
-  count = name.size() - last;
-  output.writeBEInt<uint8_t>(count);
-  for (size_t i = 0; i < count; i++) {
-    output.writeByte(*iter++);
+    last = separator + 1;
   }
 
   // Terminate the name record with a null byte
-  output.writeByte(0x00);
+  data_[length_++] = 0x00;
   return true;
 }
 
-bool BaseDnsRecord::serializeName(Buffer::OwnedImpl& output) {
-  return serializeSpecificName(output, name_);
+bool BaseDnsRecord::serializeHeader(DnsWireBuffer& output, const std::chrono::seconds ttl) {
+  return output.writeName(name_) && output.writeBEInt<uint16_t>(type_) &&
+         output.writeBEInt<uint16_t>(class_) &&
+         output.writeBEInt<uint32_t>(static_cast<uint32_t>(ttl.count()));
 }
 
 // Serialize a DNS Query Record
-bool DnsQueryRecord::serialize(Buffer::OwnedImpl& output) {
-  if (serializeName(output)) {
-    output.writeBEInt<uint16_t>(type_);
-    output.writeBEInt<uint16_t>(class_);
+bool DnsQueryRecord::serialize(DnsWireBuffer& output) {
+  const size_t start = output.length();
+  if (output.writeName(name_) && output.writeBEInt<uint16_t>(type_) &&
+      output.writeBEInt<uint16_t>(class_)) {
+    return true;
   }
-  return (output.length() > 0);
+  output.truncate(start);
+  return false;
 }
 
 // Serialize a single DNS Answer Record
-bool DnsAnswerRecord::serialize(Buffer::OwnedImpl& output) {
-  if (serializeName(output)) {
-    output.writeBEInt<uint16_t>(type_);
-    output.writeBEInt<uint16_t>(class_);
-    output.writeBEInt<uint32_t>(static_cast<uint32_t>(ttl_.count()));
-
+bool DnsAnswerRecord::serialize(DnsWireBuffer& output) {
+  const size_t start = output.length();
+  if (serializeHeader(output, ttl_)) {
     ASSERT(ip_addr_ != nullptr);
     const auto ip_address = ip_addr_->ip();
 
@@ -90,37 +77,43 @@ bool DnsAnswerRecord::serialize(Buffer::OwnedImpl& output) {
     if (ip_address->ipv6() != nullptr) {
       // Store the 128bit address with 2 64 bit writes
       const absl::uint128 addr6 = ip_address->ipv6()->address();
-      output.writeBEInt<uint16_t>(sizeof(addr6));
-      output.writeLEInt<uint64_t>(absl::Uint128Low64(addr6));
-      output.writeLEInt<uint64_t>(absl::Uint128High64(addr6));
+      if (output.writeBEInt<uint16_t>(sizeof(addr6)) &&
+          output.writeLEInt<uint64_t>(absl::Uint128Low64(addr6)) &&
+          output.writeLEInt<uint64_t>(absl::Uint128High64(addr6))) {
+        return true;
+      }
     } else if (ip_address->ipv4() != nullptr) {
-      output.writeBEInt<uint16_t>(4);
-      output.writeLEInt<uint32_t>(ip_address->ipv4()->address());
+      if (output.writeBEInt<uint16_t>(4) &&
+          output.writeLEInt<uint32_t>(ip_address->ipv4()->address())) {
+        return true;
+      }
     }
   }
-  return (output.length() > 0);
+  output.truncate(start);
+  return false;
 }
 
-bool DnsSrvRecord::serialize(Buffer::OwnedImpl& output) {
-  if (!targets_.empty()) {
-    // The Service Record being serialized should have only one target
-    const auto& target = targets_.begin();
-    Buffer::OwnedImpl target_buf{};
-    if (serializeSpecificName(target_buf, target->first) && serializeName(output)) {
-      output.writeBEInt<uint16_t>(type_);
-      output.writeBEInt<uint16_t>(class_);
-      output.writeBEInt<uint32_t>(static_cast<uint32_t>(ttl_.count()));
-
-      const uint16_t data_length = sizeof(target->second.priority) + sizeof(target->second.weight) +
-                                   sizeof(target->second.port) + target_buf.length();
-      output.writeBEInt<uint16_t>(data_length);
-      output.writeBEInt<uint16_t>(target->second.priority);
-      output.writeBEInt<uint16_t>(target->second.weight);
-      output.writeBEInt<uint16_t>(target->second.port);
-      output.move(target_buf);
+bool DnsSrvRecord::serialize(DnsWireBuffer& output) {
+  if (targets_.empty()) {
+    return false;
+  }
+
+  // The Service Record being serialized should have only one target
+  const auto& target = targets_.begin();
+  const size_t start = output.length();
+  if (serializeHeader(output, ttl_)) {
+    // The data length is known once the target name is written
+    const size_t data_length_offset = output.length();
+    if (output.writeBEInt<uint16_t>(0) && output.writeBEInt<uint16_t>(target->second.priority) &&
+        output.writeBEInt<uint16_t>(target->second.weight) &&
+        output.writeBEInt<uint16_t>(target->second.port) && output.writeName(target->first)) {
+      output.setBEInt16(data_length_offset,
+                        output.length() - data_length_offset - sizeof(uint16_t));
+      return true;
     }
   }
-  return (output.length() > 0);
+  output.truncate(start);
+  return false;
 }
 
 void DnsSrvRecord::addTarget(const absl::string_view target, const DnsTargetAttributes& attrs) {
@@ -276,24 +269,88 @@ bool DnsMessageParser::parseAnswerRecords(DnsAnswerMap& answers, const uint16_t
 const std::string DnsMessageParser::parseDnsNameRecord(const Buffer::InstancePtr& buffer,
                                                        uint64_t& available_bytes,
                                                        uint64_t& name_offset) {
-  void* buf = buffer->linearize(static_cast<uint32_t>(buffer->length()));
-  const unsigned char* linearized_data = static_cast<const unsigned char*>(buf);
-  const unsigned char* record = linearized_data + name_offset;
-  long encoded_len;
-  char* output;
+  static constexpr uint8_t POINTER_MASK = 0xc0;
+  static constexpr absl::string_view RESERVED_CHARACTERS{"\".;\\()@$"};
+
+  const uint64_t length = buffer->length();
+  const uint8_t* data =
+      static_cast<const uint8_t*>(buffer->linearize(static_cast<uint32_t>(length)));
+
+  // The name is decoded into a fixed size buffer. Names must be shorter than MAX_NAME_LENGTH so
+  // that they can be serialized in a response.
+  std::array<char, MAX_NAME_LENGTH - 1> name;
+  size_t name_length = 0;
+  auto append = [&name, &name_length](char c) -> bool {
+    if (name_length == name.size()) {
+      return false;
+    }
+    name[name_length++] = c;
+    return true;
+  };
+
+  // Compression pointers are followed as they are reached. Each pointer must point before the
+  // labels that led to it, so that they cannot loop.
+  uint64_t position = name_offset;
+  uint64_t limit = name_offset;
+  uint64_t encoded_length = 0;
+  while (true) {
+    if (position >= length) {
+      return EMPTY_STRING;
+    }
 
-  const int result =
-      ares_expand_name(record, linearized_data, buffer->length(), &output, &encoded_len);
-  if (result != ARES_SUCCESS) {
-    return EMPTY_STRING;
+    const uint8_t label_length = data[position];
+    if ((label_length & POINTER_MASK) == POINTER_MASK) {
+      if (position + 1 >= length) {
+        return EMPTY_STRING;
+      }
+      const uint64_t target = ((label_length & ~POINTER_MASK) << 8) | data[position + 1];
+      if (target >= limit) {
+        return EMPTY_STRING;
+      }
+      if (encoded_length == 0) {
+        encoded_length = position + 2 - name_offset;
+      }
+      position = limit = target;
+      continue;
+    }
+
+    // The other label types are reserved
+    if ((label_length & POINTER_MASK) != 0 || position + 1 + label_length > length) {
+      return EMPTY_STRING;
+    }
+    ++position;
+    if (label_length == 0) {
+      break;
+    }
+
+    if (name_length > 0 && !append('.')) {
+      return EMPTY_STRING;
+    }
+    // Escape the characters as c-ares does, for consistency with RFC 1035 5.1
+    for (const uint8_t* c = data + position; c < data + position + label_length; ++c) {
+      bool ok;
+      if (*c < 0x20 || *c > 0x7e) {
+        ok = append('\\') && append('0' + *c / 100) && append('0' + (*c % 100) / 10) &&
+             append('0' + *c % 10);
+      } else if (RESERVED_CHARACTERS.find(*c) != absl::string_view::npos) {
+        ok = append('\\') && append(*c);
+      } else {
+        ok = append(*c);
+      }
+      if (!ok) {
+        return EMPTY_STRING;
+      }
+    }
+    position += label_length;
   }
 
-  std::string name(output);
-  ares_free_string(output);
-  name_offset += encoded_len;
-  available_bytes -= encoded_len;
+  if (encoded_length == 0) {
+    encoded_length = position - name_offset;
+  }
+  name_offset += encoded_length;
+  available_bytes -= encoded_length;
 
-  return name;
+  return std::string(name.data(), name_length);
 }
 
 DnsAnswerRecordPtr DnsMessageParser::parseDnsARecord(DnsAnswerCtx& ctx) {
@@ -311,11 +368,8 @@ DnsAnswerRecordPtr DnsMessageParser::parseDnsARecord(DnsAnswerCtx& ctx) {
   case DNS_RECORD_TYPE_AAAA:
     if (ctx.available_bytes_ >= sizeof(absl::uint128)) {
       sockaddr_in6 sa6;
-      uint8_t* address6_bytes = reinterpret_cast<uint8_t*>(&sa6.sin6_addr.s6_addr);
-      static constexpr size_t count = sizeof(absl::uint128) / sizeof(uint8_t);
-      for (size_t index = 0; index < count; index++) {
-        *address6_bytes++ = ctx.buffer_->peekLEInt<uint8_t>(ctx.offset_++);
-      }
+      ctx.buffer_->copyOut(ctx.offset_, sizeof(absl::uint128), &sa6.sin6_addr.s6_addr);
+      ctx.offset_ += sizeof(absl::uint128);
       ip_addr = std::make_shared<Network::Address::Ipv6Instance>(sa6, true);
     }
     break;
@@ -649,13 +703,17 @@ void DnsMessageParser::buildResponseBuffer(DnsQueryContextPtr& query_context,
   uint16_t serialized_authority_rrs = 0;
   uint16_t serialized_additional_rrs = 0;
 
-  Buffer::OwnedImpl query_buffer{};
-  Buffer::OwnedImpl answer_buffer{};
-  Buffer::OwnedImpl addl_rec_buffer{};
+  // The records of each section are serialized on the stack and copied once into the response.
+  // The header is written in front of the queries once the record counts are known.
+  DnsWireBuffer query_buffer;
+  DnsWireBuffer answer_buffer;
+  DnsWireBuffer addl_rec_buffer;
+  query_buffer.write(&query_context->response_header_, sizeof(DnsHeader));
 
   ENVOY_LOG(trace, "Building response for query ID [{}]", query_context->id_);
 
   for (const auto& query : query_context->queries_) {
+    const size_t query_start = query_buffer.length();
     if (!query->serialize(query_buffer)) {
       ENVOY_LOG(debug, "Unable to serialize query record for {}", query->name_);
       continue;
@@ -663,7 +721,7 @@ void DnsMessageParser::buildResponseBuffer(DnsQueryContextPtr& query_context,
 
     // Serialize and account for each query's size. That said, there should be only one query.
     ++serialized_queries;
-    total_buffer_size += query_buffer.length();
+    total_buffer_size += query_buffer.length() - query_start;
 
     const auto& answers = query_context->answers_;
     if (answers.empty()) {
@@ -682,8 +740,8 @@ void DnsMessageParser::buildResponseBuffer(DnsQueryContextPtr& query_context,
       const auto answer = std::next(answers.begin(), (index++ % num_answers));
       ++touched_answers;
 
-      // Query names are limited to 255 characters. Since we are using c-ares to decode the
-      // encoded query names, we should not end up with a non-conforming name here.
+      // Query names are limited to 255 characters. The parser rejects longer names, so we
+      // should not end up with a non-conforming name here.
       //
       // See Section 2.3.4 of https://tools.ietf.org/html/rfc1035
       RELEASE_ASSERT(query->name_.size() < MAX_NAME_LENGTH,
@@ -703,31 +761,30 @@ void DnsMessageParser::buildResponseBuffer(DnsQueryContextPtr& query_context,
           const auto& rr = additional_rrs.find(target->first);
 
           if (rr != additional_rrs.end()) {
-            Buffer::OwnedImpl serialized_rr{};
+            const size_t rr_start = addl_rec_buffer.length();
 
             // If serializing the additional record fails, skip serializing the answer record
-            if (!rr->second->serialize(serialized_rr)) {
+            if (!rr->second->serialize(addl_rec_buffer)) {
               ENVOY_LOG(debug, "Unable to serialize answer record for {}", query->name_);
               continue;
             }
-            total_buffer_size += serialized_rr.length();
-            addl_rec_buffer.add(serialized_rr);
+            total_buffer_size += addl_rec_buffer.length() - rr_start;
             ++serialized_additional_rrs;
           }
         }
 
         // Now we serialize the answer record. We check the length of the serialized
         // data to ensure we don't exceed the DNS response limit
-        Buffer::OwnedImpl serialized_answer;
-        if (!answer->second->serialize(serialized_answer)) {
+        const size_t answer_start = answer_buffer.length();
+        if (!answer->second->serialize(answer_buffer)) {
           ENVOY_LOG(debug, "Unable to serialize answer record for {}", query->name_);
           continue;
         }
-        total_buffer_size += serialized_answer.length();
+        total_buffer_size += answer_buffer.length() - answer_start;
         if (total_buffer_size > MAX_DNS_RESPONSE_SIZE) {
+          answer_buffer.truncate(answer_start);
           break;
         }
-        answer_buffer.add(serialized_answer);
         if (++serialized_answers == MAX_RETURNED_RECORDS) {
           break;
         }
@@ -740,21 +797,19 @@ void DnsMessageParser::buildResponseBuffer(DnsQueryContextPtr& query_context,
                       serialized_authority_rrs, serialized_additional_rrs);
 
   // Build the response buffer for transmission to the client
-  buffer.writeBEInt<uint16_t>(query_context->response_header_.id);
-
   uint16_t flags;
   safeMemcpyUnsafeSrc(&flags, static_cast<void*>(&query_context->response_header_.flags));
-  buffer.writeBEInt<uint16_t>(flags);
-
-  buffer.writeBEInt<uint16_t>(query_context->response_header_.questions);
-  buffer.writeBEInt<uint16_t>(query_context->response_header_.answers);
-  buffer.writeBEInt<uint16_t>(query_context->response_header_.authority_rrs);
-  buffer.writeBEInt<uint16_t>(query_context->response_header_.additional_rrs);
-
-  // write the queries and answers
-  buffer.move(query_buffer);
-  buffer.move(answer_buffer);
-  buffer.move(addl_rec_buffer);
+  query_buffer.setBEInt16(0, query_context->response_header_.id);
+  query_buffer.setBEInt16(2, flags);
+  query_buffer.setBEInt16(4, query_context->response_header_.questions);
+  query_buffer.setBEInt16(6, query_context->response_header_.answers);
+  query_buffer.setBEInt16(8, query_context->response_header_.authority_rrs);
+  query_buffer.setBEInt16(10, query_context->response_header_.additional_rrs);
+
+  // write the header, queries and answers
+  buffer.add(query_buffer.data(), query_buffer.length());
+  buffer.add(answer_buffer.data(), answer_buffer.length());
+  buffer.add(addl_rec_buffer.data(), addl_rec_buffer.length());
 }
 
 } // namespace DnsFilter
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/platform.h"
 #include "envoy/common/random_generator.h"
@@ -18,6 +22,81 @@ namespace Extensions {
 namespace UdpFilters {
 namespace DnsFilter {
 
+/**
+ * DnsWireBuffer is a fixed capacity buffer into which DNS records are serialized in wire format.
+ * It lives on the stack while a response is built, so that serializing records does not allocate.
+ * A write that does not fit fails without writing anything.
+ */
+class DnsWireBuffer {
+public:
+  // Large enough for a response section at the size limit and the records that overflow it.
+  static constexpr size_t CAPACITY = 3 * MAX_DNS_RESPONSE_SIZE;
+
+  const uint8_t* data() const { return data_.data(); }
+  size_t length() const { return length_; }
+  absl::string_view toStringView() const {
+    return {reinterpret_cast<const char*>(data_.data()), length_};
+  }
+
+  /**
+   * @brief Discards the data written after the given length, e.g. a partially serialized record
+   */
+  void truncate(size_t length) {
+    ASSERT(length <= length_);
+    length_ = length;
+  }
+
+  /**
+   * @brief Writes a name as a sequence of labels, each prefixed by its length
+   *
+   * @param name the name to write, e.g. "www.domain.com"
+   * @return bool true if the name is valid and fits in the buffer
+   */
+  bool writeName(absl::string_view name);
+
+  bool write(const void* data, size_t size) {
+    if (size > CAPACITY - length_) {
+      return false;
+    }
+    std::copy_n(static_cast<const uint8_t*>(data), size, data_.begin() + length_);
+    length_ += size;
+    return true;
+  }
+
+  template <typename T> bool writeBEInt(T value) {
+    if (sizeof(T) > CAPACITY - length_) {
+      return false;
+    }
+    for (size_t i = sizeof(T); i > 0; --i) {
+      data_[length_++] = static_cast<uint8_t>(value >> (8 * (i - 1)));
+    }
+    return true;
+  }
+
+  template <typename T> bool writeLEInt(T value) {
+    if (sizeof(T) > CAPACITY - length_) {
+      return false;
+    }
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      data_[length_++] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return true;
+  }
+
+  /**
+   * @brief Overwrites a 16 bit field written earlier, e.g. a length known once the data follows
+   */
+  void setBEInt16(size_t offset, uint16_t value) {
+    ASSERT(offset + sizeof(value) <= length_);
+    data_[offset] = static_cast<uint8_t>(value >> 8);
+    data_[offset + 1] = static_cast<uint8_t>(value);
+  }
+
+private:
+  std::array<uint8_t, CAPACITY> data_;
+  size_t length_{0};
+};
+
 /**
  * BaseDnsRecord contains the fields and functions common to both query and answer records.
  */
@@ -26,15 +105,21 @@ public:
   BaseDnsRecord(const absl::string_view rec_name, const uint16_t rec_type, const uint16_t rec_class)
       : name_(rec_name), type_(rec_type), class_(rec_class) {}
   virtual ~BaseDnsRecord() = default;
-  bool serializeName(Buffer::OwnedImpl& output);
-  virtual bool serialize(Buffer::OwnedImpl& output) PURE;
+
+  /**
+   * @brief Serializes the record. If the record cannot be serialized nothing is written.
+   *
+   * @param output the buffer to which the record is appended
+   * @return bool true if the record was serialized
+   */
+  virtual bool serialize(DnsWireBuffer& output) PURE;
 
   const std::string name_;
   const uint16_t type_;
   const uint16_t class_;
 
 protected:
-  bool serializeSpecificName(Buffer::OwnedImpl& output, const absl::string_view name);
+  bool serializeHeader(DnsWireBuffer& output, const std::chrono::seconds ttl);
 };
 
 /**
@@ -46,7 +131,7 @@ public:
   DnsQueryRecord(const absl::string_view rec_name, const uint16_t rec_type,
                  const uint16_t rec_class)
       : BaseDnsRecord(rec_name, rec_type, rec_class) {}
-  bool serialize(Buffer::OwnedImpl& output) override;
+  bool serialize(DnsWireBuffer& output) override;
 
   std::unique_ptr<Stats::HistogramCompletableTimespanImpl> query_time_ms_;
 };
@@ -66,7 +151,7 @@ public:
                   const uint16_t rec_class, const std::chrono::seconds ttl,
                   Network::Address::InstanceConstSharedPtr ipaddr)
       : BaseDnsRecord(query_name, rec_type, rec_class), ttl_(ttl), ip_addr_(ipaddr) {}
-  bool serialize(Buffer::OwnedImpl& output) override;
+  bool serialize(DnsWireBuffer& output) override;
 
   const std::chrono::seconds ttl_;
   const Network::Address::InstanceConstSharedPtr ip_addr_;
@@ -103,7 +188,7 @@ public:
     bool is_cluster;
   };
 
-  bool serialize(Buffer::OwnedImpl& output) override;
+  bool serialize(DnsWireBuffer& output) override;
   void addTarget(const absl::string_view target, const DnsTargetAttributes& attrs);
 
   std::string proto_;
@@ -180,6 +265,8 @@ public:
   uint64_t retry_;
   uint16_t id_;
   Network::DnsResolver::ResolutionStatus resolution_status_;
+  // The smallest TTL of the addresses returned by the external resolver.
+  std::chrono::seconds resolution_ttl_{};
   DnsHeader header_;
   DnsHeader response_header_;
   DnsQueryPtrVec queries_;
@@ -241,7 +328,7 @@ public:
           ttl_(ttl), offset_(offset) {}
 
     const Buffer::InstancePtr& buffer_;
-    const std::string record_name_;
+    const absl::string_view record_name_;
     const uint16_t record_type_;
     const uint16_t record_class_;
     const uint16_t available_bytes_;
@@ -408,12 +495,14 @@ private:
                            const uint16_t additional_rrs);
 
   /**
-   * @brief Extracts a DNS query name from a buffer
+   * @brief Extracts a DNS name from a buffer. The labels are decoded in place, following any
+   * compression pointers as they are reached, so the name is only copied once into the result.
    *
    * @param buffer the buffer from which the name is extracted
    * @param available_bytes the size of the remaining bytes in the buffer on which we can operate
    * @param name_offset the offset from which parsing begins and ends. The updated value is
    * returned to the caller
+   * @return the name, or an empty string if the encoded name is invalid
    */
   const std::string parseDnsNameRecord(const Buffer::InstancePtr& buffer, uint64_t& available_bytes,
                                        uint64_t& name_offset);
@@ -1,5 +1,7 @@
 #include "source/extensions/filters/udp/udp_proxy/udp_proxy_filter.h"
 
+#include <algorithm>
+
 #include "envoy/network/listener.h"
 
 #include "source/common/network/socket_option_factory.h"
@@ -60,6 +62,9 @@ UdpProxyFilter::ClusterInfo::ClusterInfo(UdpProxyFilter& filter,
       member_update_cb_handle_(cluster.prioritySet().addMemberUpdateCb(
           [this](const Upstream::HostVector&, const Upstream::HostVector& hosts_removed) {
             for (const auto& host : hosts_removed) {
+              if (flow_table_ != nullptr) {
+                flow_table_->onHostRemoved(*host);
+              }
               // This is similar to removeSession() but slightly different due to removeSession()
               // also handling deletion of the host to session map entry if there are no sessions
               // left. It would be nice to unify the logic but that can be cleaned up later.
@@ -72,7 +77,12 @@ UdpProxyFilter::ClusterInfo::ClusterInfo(UdpProxyFilter& filter,
                 host_to_sessions_.erase(host_sessions_it);
               }
             }
-          })) {}
+          })) {
+  if (filter.config_->maxSharedSocketsPerHost().has_value()) {
+    flow_table_ =
+        std::make_unique<FlowTable>(*this, filter.config_->maxSharedSocketsPerHost().value());
+  }
+}
 
 UdpProxyFilter::ClusterInfo::~ClusterInfo() {
   // Sanity check the session accounting. This is not as fast as a straight teardown, but this is
@@ -84,6 +94,10 @@ UdpProxyFilter::ClusterInfo::~ClusterInfo() {
 }
 
 void UdpProxyFilter::ClusterInfo::onData(Network::UdpRecvData& data) {
+  if (flow_table_ != nullptr && flow_table_->onData(data)) {
+    return;
+  }
+
   const auto active_session_it = sessions_.find(data.addresses_);
   ActiveSession* active_session;
   if (active_session_it == sessions_.end()) {
@@ -103,6 +117,11 @@ void UdpProxyFilter::ClusterInfo::onData(Network::UdpRecvData& data) {
       return;
     }
 
+    // With shared upstream sockets, a session is an ActiveSession only once its host has no
+    // socket left in the flow table.
+    if (flow_table_ != nullptr && flow_table_->addFlow(data, host)) {
+      return;
+    }
     active_session = createSession(std::move(data.addresses_), host);
   } else {
     active_session = active_session_it->get();
@@ -152,6 +171,227 @@ void UdpProxyFilter::ClusterInfo::removeSession(const ActiveSession* session) {
   sessions_.erase(session);
 }
 
+UdpProxyFilter::FlowTable::FlowTable(ClusterInfo& cluster, uint32_t max_sockets_per_host)
+    : cluster_(cluster), max_sockets_per_host_(max_sockets_per_host),
+      expiry_timer_(cluster.filter_.read_callbacks_->udpListener().dispatcher().createTimer(
+          [this] { onExpiryTimer(); })) {}
+
+UdpProxyFilter::FlowTable::~FlowTable() {
+  cluster_.filter_.config_->stats().downstream_sess_active_.sub(flows_.size());
+}
+
+bool UdpProxyFilter::FlowTable::onData(Network::UdpRecvData& data) {
+  const auto index_it = flow_index_.find(data.addresses_);
+  if (index_it == flow_index_.end()) {
+    return false;
+  }
+  const FlowList::iterator flow_it = index_it->second;
+  if (flow_it->socket_->host().health() == Upstream::Host::Health::Unhealthy) {
+    // As with sessions owning their socket, move the session to a healthy host if there is one.
+    UdpLoadBalancerContext context(cluster_.filter_.config_->hashPolicy(), data.addresses_.peer_);
+    Upstream::HostConstSharedPtr host = cluster_.cluster_.loadBalancer().chooseHost(&context);
+    if (host != nullptr && host->health() != Upstream::Host::Health::Unhealthy &&
+        host.get() != &flow_it->socket_->host() && canOpenSocket(*host)) {
+      ENVOY_LOG(debug, "upstream session unhealthy, moving the session to another host");
+      closeSocket(*flow_it);
+      openSocket(*flow_it, host);
+    }
+  }
+
+  markUsed(flow_it, data.receive_time_);
+  flow_it->socket_->write(*data.buffer_);
+  return true;
+}
+
+bool UdpProxyFilter::FlowTable::addFlow(Network::UdpRecvData& data,
+                                        const Upstream::HostConstSharedPtr& host) {
+  if (!canOpenSocket(*host)) {
+    return false;
+  }
+
+  flows_.push_back(Flow{std::move(data.addresses_), nullptr, data.receive_time_});
+  const FlowList::iterator flow_it = std::prev(flows_.end());
+  flow_index_.emplace(flow_it->addresses_, flow_it);
+  openSocket(*flow_it, host);
+  cluster_.filter_.config_->stats().downstream_sess_total_.inc();
+  cluster_.filter_.config_->stats().downstream_sess_active_.inc();
+  if (!expiry_timer_->enabled()) {
+    enableExpiryTimer(data.receive_time_);
+  }
+  flow_it->socket_->write(*data.buffer_);
+  return true;
+}
+
+bool UdpProxyFilter::FlowTable::canOpenSocket(const Upstream::Host& host) const {
+  const auto host_it = sockets_per_host_.find(&host);
+  return host_it == sockets_per_host_.end() || host_it->second < max_sockets_per_host_;
+}
+
+void UdpProxyFilter::FlowTable::openSocket(Flow& flow, const Upstream::HostConstSharedPtr& host) {
+  ++sockets_per_host_[host.get()];
+  flow.socket_ = std::make_unique<FlowSocket>(*this, flow.addresses_, host);
+}
+
+void UdpProxyFilter::FlowTable::closeSocket(Flow& flow) {
+  const auto host_it = sockets_per_host_.find(&flow.socket_->host());
+  ASSERT(host_it != sockets_per_host_.end());
+  if (--host_it->second == 0) {
+    sockets_per_host_.erase(host_it);
+  }
+  flow.socket_.reset();
+}
+
+void UdpProxyFilter::FlowTable::markUsed(FlowList::iterator flow_it, MonotonicTime now) {
+  flow_it->last_used_ = now;
+  flows_.splice(flows_.end(), flows_, flow_it);
+}
+
+void UdpProxyFilter::FlowTable::touch(const Network::UdpRecvData::LocalPeerAddresses& addresses,
+                                      MonotonicTime now) {
+  const auto index_it = flow_index_.find(addresses);
+  if (index_it != flow_index_.end()) {
+    markUsed(index_it->second, now);
+  }
+}
+
+void UdpProxyFilter::FlowTable::removeFlow(FlowList::iterator flow_it) {
+  closeSocket(*flow_it);
+  flow_index_.erase(flow_it->addresses_);
+  cluster_.filter_.config_->stats().downstream_sess_active_.dec();
+  flows_.erase(flow_it);
+}
+
+void UdpProxyFilter::FlowTable::onHostRemoved(const Upstream::Host& host) {
+  if (!sockets_per_host_.contains(&host)) {
+    return;
+  }
+  for (auto flow_it = flows_.begin(); flow_it != flows_.end();) {
+    if (&flow_it->socket_->host() == &host) {
+      removeFlow(flow_it++);
+    } else {
+      ++flow_it;
+    }
+  }
+}
+
+void UdpProxyFilter::FlowTable::enableExpiryTimer(MonotonicTime now) {
+  ASSERT(!flows_.empty());
+  // The least recently used session is the first one to expire.
+  const MonotonicTime expiry =
+      flows_.front().last_used_ + cluster_.filter_.config_->sessionTimeout();
+  expiry_timer_->enableTimer(
+      std::max(std::chrono::ceil<std::chrono::milliseconds>(expiry - now),
+               std::chrono::milliseconds(0)));
+}
+
+void UdpProxyFilter::FlowTable::onExpiryTimer() {
+  const MonotonicTime now = cluster_.filter_.config_->timeSource().monotonicTime();
+  const std::chrono::milliseconds timeout = cluster_.filter_.config_->sessionTimeout();
+  uint64_t expired = 0;
+  while (!flows_.empty() && now - flows_.front().last_used_ >= timeout) {
+    removeFlow(flows_.begin());
+    ++expired;
+  }
+  ENVOY_LOG(debug, "expired {} idle sessions, {} left", expired, flows_.size());
+  cluster_.filter_.config_->stats().idle_timeout_.add(expired);
+  if (!flows_.empty()) {
+    enableExpiryTimer(now);
+  }
+}
+
+UdpProxyFilter::FlowSocket::FlowSocket(FlowTable& table,
+                                       const Network::UdpRecvData::LocalPeerAddresses& addresses,
+                                       const Upstream::HostConstSharedPtr& host)
+    : table_(table), addresses_(addresses), host_(host),
+      socket_(table.cluster_.filter_.createSocket(host)) {
+  socket_->ioHandle().initializeFileEvent(
+      table.cluster_.filter_.read_callbacks_->udpListener().dispatcher(),
+      [this](uint32_t) { onReadReady(); }, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read);
+  ENVOY_LOG(debug, "creating new flow table upstream socket: downstream={} local={} upstream={}",
+            addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
+            host->address()->asStringView());
+  table_.cluster_.cluster_.info()
+      ->resourceManager(Upstream::ResourcePriority::Default)
+      .connections()
+      .inc();
+}
+
+UdpProxyFilter::FlowSocket::~FlowSocket() {
+  table_.cluster_.cluster_.info()
+      ->resourceManager(Upstream::ResourcePriority::Default)
+      .connections()
+      .dec();
+}
+
+void UdpProxyFilter::FlowSocket::write(const Buffer::Instance& buffer) {
+  ENVOY_LOG(trace, "writing {} byte datagram upstream: downstream={} local={} upstream={}",
+            buffer.length(), addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
+            host_->address()->asStringView());
+  const uint64_t buffer_length = buffer.length();
+  ClusterInfo& cluster = table_.cluster_;
+  cluster.filter_.config_->stats().downstream_sess_rx_bytes_.add(buffer_length);
+  cluster.filter_.config_->stats().downstream_sess_rx_datagrams_.inc();
+
+  const Api::IoCallUint64Result rc =
+      Network::Utility::writeToSocket(socket_->ioHandle(), buffer, nullptr, *host_->address());
+  if (!rc.ok()) {
+    cluster.cluster_stats_.sess_tx_errors_.inc();
+  } else {
+    cluster.cluster_stats_.sess_tx_datagrams_.inc();
+    cluster.cluster_.info()->stats().upstream_cx_tx_bytes_total_.add(buffer_length);
+  }
+}
+
+void UdpProxyFilter::FlowSocket::onReadReady() {
+  ClusterInfo& cluster = table_.cluster_;
+  // As the local address of received packets is not used, pass the host address instead.
+  uint32_t packets_dropped = 0;
+  const Api::IoErrorPtr result = Network::Utility::readPacketsFromSocket(
+      socket_->ioHandle(), *host_->address(), *this, cluster.filter_.config_->timeSource(),
+      cluster.filter_.config_->upstreamSocketConfig().prefer_gro_, packets_dropped);
+  if (result == nullptr) {
+    socket_->ioHandle().activateFileEvents(Event::FileReadyType::Read);
+    return;
+  }
+  if (result->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+    cluster.cluster_stats_.sess_rx_errors_.inc();
+  }
+  // Flush out buffered data at the end of IO event.
+  cluster.filter_.read_callbacks_->udpListener().flush();
+}
+
+void UdpProxyFilter::FlowSocket::processPacket(Network::Address::InstanceConstSharedPtr,
+                                               Network::Address::InstanceConstSharedPtr,
+                                               Buffer::InstancePtr buffer,
+                                               MonotonicTime receive_time) {
+  ClusterInfo& cluster = table_.cluster_;
+  const uint64_t buffer_length = buffer->length();
+  ENVOY_LOG(trace, "writing {} byte datagram downstream: downstream={} local={} upstream={}",
+            buffer_length, addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
+            host_->address()->asStringView());
+  cluster.cluster_stats_.sess_rx_datagrams_.inc();
+  cluster.cluster_.info()->stats().upstream_cx_rx_bytes_total_.add(buffer_length);
+
+  table_.touch(addresses_, receive_time);
+  Network::UdpSendData data{addresses_.local_->ip(), *addresses_.peer_, *buffer};
+  const Api::IoCallUint64Result rc = cluster.filter_.read_callbacks_->udpListener().send(data);
+  if (!rc.ok()) {
+    cluster.filter_.config_->stats().downstream_sess_tx_errors_.inc();
+  } else {
+    cluster.filter_.config_->stats().downstream_sess_tx_bytes_.add(buffer_length);
+    cluster.filter_.config_->stats().downstream_sess_tx_datagrams_.inc();
+  }
+}
+
+uint64_t UdpProxyFilter::FlowSocket::maxDatagramSize() const {
+  return table_.cluster_.filter_.config_->upstreamSocketConfig().max_rx_datagram_size_;
+}
+
+void UdpProxyFilter::FlowSocket::onDatagramsDropped(uint32_t dropped) {
+  table_.cluster_.cluster_stats_.sess_rx_datagrams_dropped_.add(dropped);
+}
+
 UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
                                              Network::UdpRecvData::LocalPeerAddresses&& addresses,
                                              const Upstream::HostConstSharedPtr& host)
@@ -161,7 +401,16 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
           [this] { onIdleTimer(); })),
       // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
       //       is bound until the first packet is sent to the upstream host.
-      socket_(cluster.filter_.createSocket(host)) {
+      socket_(cluster.filter_.createSocket(host)),
+      writer_(cluster.filter_.config_->upstreamSocketConfig().prefer_gso_ &&
+                      Api::OsSysCallsSingleton::get().supportsUdpGso()
+                  ? std::make_unique<Network::UdpGsoWriter>(socket_->ioHandle())
+                  : nullptr),
+      flush_upstream_cb_(writer_ != nullptr
+                             ? cluster.filter_.read_callbacks_->udpListener()
+                                   .dispatcher()
+                                   .createSchedulableCallback([this] { flushUpstream(); })
+                             : nullptr) {
 
   socket_->ioHandle().initializeFileEvent(
       cluster.filter_.read_callbacks_->udpListener().dispatcher(),
@@ -196,6 +445,9 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
 }
 
 UdpProxyFilter::ActiveSession::~ActiveSession() {
+  if (writer_ != nullptr) {
+    flushUpstream();
+  }
   ENVOY_LOG(debug, "deleting the session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host_->address()->asStringView());
@@ -249,8 +501,20 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   //       set. We allow the OS to select the right IP based on outbound routing rules if
   //       use_original_src_ip_ is not set, else use downstream peer IP as local IP.
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
-  Api::IoCallUint64Result rc =
-      Network::Utility::writeToSocket(socket_->ioHandle(), buffer, local_ip, *host_->address());
+  Api::IoCallUint64Result rc = Api::ioCallUint64ResultNoError();
+  if (writer_ != nullptr) {
+    // The datagram is usually held by the writer, in which case it is counted as sent here and
+    // errors are counted when the batch is flushed.
+    rc = writer_->writePacket(buffer, local_ip, *host_->address());
+    // There is no write event for upstream sockets. Datagrams which do not fit in the socket
+    // buffer are dropped like without GSO, and the next write tries again.
+    writer_->setWritable();
+    if (!flush_upstream_cb_->enabled()) {
+      flush_upstream_cb_->scheduleCallbackCurrentIteration();
+    }
+  } else {
+    rc = Network::Utility::writeToSocket(socket_->ioHandle(), buffer, local_ip, *host_->address());
+  }
   if (!rc.ok()) {
     cluster_.cluster_stats_.sess_tx_errors_.inc();
   } else {
@@ -259,6 +523,14 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   }
 }
 
+void UdpProxyFilter::ActiveSession::flushUpstream() {
+  const Api::IoCallUint64Result rc = writer_->flush();
+  writer_->setWritable();
+  if (!rc.ok()) {
+    cluster_.cluster_stats_.sess_tx_errors_.inc();
+  }
+}
+
 void UdpProxyFilter::ActiveSession::processPacket(Network::Address::InstanceConstSharedPtr,
                                                   Network::Address::InstanceConstSharedPtr,
                                                   Buffer::InstancePtr buffer, MonotonicTime) {
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <list>
+
 #include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/network/filter.h"
@@ -9,11 +12,13 @@
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/network/socket_impl.h"
 #include "source/common/network/socket_interface.h"
+#include "source/common/network/udp_packet_writer_handler_impl.h"
 #include "source/common/network/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/upstream/load_balancer_impl.h"
 #include "source/extensions/filters/udp/udp_proxy/hash_policy_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 
 // TODO(mattklein123): UDP session access logging.
@@ -81,6 +86,14 @@ public:
     if (!config.hash_policies().empty()) {
       hash_policy_ = std::make_unique<HashPolicyImpl>(config.hash_policies());
     }
+    if (config.has_shared_upstream_sockets()) {
+      if (use_original_src_ip_) {
+        ExceptionUtil::throwEnvoyException(
+            "Shared upstream sockets can't be used together with use_original_src_ip.");
+      }
+      max_shared_sockets_per_host_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config.shared_upstream_sockets(), max_sockets_per_host, 16);
+    }
   }
 
   const std::string& cluster() const { return cluster_; }
@@ -93,6 +106,8 @@ public:
   const Network::ResolvedUdpSocketConfig& upstreamSocketConfig() const {
     return upstream_socket_config_;
   }
+  // Set if sessions share upstream sockets.
+  absl::optional<uint32_t> maxSharedSocketsPerHost() const { return max_shared_sockets_per_host_; }
 
 private:
   static UdpProxyDownstreamStats generateStats(const std::string& stat_prefix,
@@ -110,6 +125,7 @@ private:
   std::unique_ptr<const HashPolicyImpl> hash_policy_;
   mutable UdpProxyDownstreamStats stats_;
   const Network::ResolvedUdpSocketConfig upstream_socket_config_;
+  absl::optional<uint32_t> max_shared_sockets_per_host_;
 };
 
 using UdpProxyFilterConfigSharedPtr = std::shared_ptr<const UdpProxyFilterConfig>;
@@ -166,6 +182,7 @@ private:
   private:
     void onIdleTimer();
     void onReadReady();
+    void flushUpstream();
 
     // Network::UdpPacketProcessor
     void processPacket(Network::Address::InstanceConstSharedPtr local_address,
@@ -196,6 +213,10 @@ private:
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
     const Network::SocketPtr socket_;
+    // Only set if the upstream socket config prefers GSO. Datagrams written upstream during an
+    // event loop iteration are then sent together at the end of the iteration.
+    const Network::UdpPacketWriterPtr writer_;
+    const Event::SchedulableCallbackPtr flush_upstream_cb_;
   };
 
   using ActiveSessionPtr = std::unique_ptr<ActiveSession>;
@@ -237,6 +258,95 @@ private:
     }
   };
 
+  class FlowTable;
+
+  /**
+   * The upstream socket of a session tracked by the flow table. The socket is opened for the
+   * session and closed with it, so its ephemeral port identifies the session to the upstream host
+   * and every datagram received on it is a reply to the session's client.
+   */
+  class FlowSocket : public Network::UdpPacketProcessor {
+  public:
+    FlowSocket(FlowTable& table, const Network::UdpRecvData::LocalPeerAddresses& addresses,
+               const Upstream::HostConstSharedPtr& host);
+    ~FlowSocket() override;
+    const Upstream::Host& host() const { return *host_; }
+    void write(const Buffer::Instance& buffer);
+
+  private:
+    void onReadReady();
+
+    // Network::UdpPacketProcessor
+    void processPacket(Network::Address::InstanceConstSharedPtr local_address,
+                       Network::Address::InstanceConstSharedPtr peer_address,
+                       Buffer::InstancePtr buffer, MonotonicTime receive_time) override;
+    uint64_t maxDatagramSize() const override;
+    void onDatagramsDropped(uint32_t dropped) override;
+    size_t numPacketsExpectedPerEventLoop() const final {
+      return Network::MAX_NUM_PACKETS_PER_EVENT_LOOP;
+    }
+
+    FlowTable& table_;
+    // Owned by the flow table entry, which outlives the socket.
+    const Network::UdpRecvData::LocalPeerAddresses& addresses_;
+    const Upstream::HostConstSharedPtr host_;
+    const Network::SocketPtr socket_;
+  };
+
+  using FlowSocketPtr = std::unique_ptr<FlowSocket>;
+
+  /**
+   * Tracks the sessions of a cluster when upstream sockets are shared. A session is a flow table
+   * entry with a socket of its own, instead of an ActiveSession with its own file event and idle
+   * timer. Entries are kept in least recently used order, so that a single timer expires idle
+   * sessions in the order they went idle, only visiting the expired ones. Once a host has
+   * max_sockets_per_host sessions in the table, further sessions to it are ActiveSessions.
+   */
+  class FlowTable {
+  public:
+    FlowTable(ClusterInfo& cluster, uint32_t max_sockets_per_host);
+    ~FlowTable();
+    /**
+     * Forwards a datagram of a session in the table upstream.
+     * @return bool false if the session is not in the table.
+     */
+    bool onData(Network::UdpRecvData& data);
+    /**
+     * Adds a session to the table and forwards its first datagram upstream.
+     * @return bool false, leaving the data untouched, if the host has no socket left for another
+     *         session.
+     */
+    bool addFlow(Network::UdpRecvData& data, const Upstream::HostConstSharedPtr& host);
+    void onHostRemoved(const Upstream::Host& host);
+    void touch(const Network::UdpRecvData::LocalPeerAddresses& addresses, MonotonicTime now);
+    size_t size() const { return flows_.size(); }
+
+    ClusterInfo& cluster_;
+
+  private:
+    struct Flow {
+      Network::UdpRecvData::LocalPeerAddresses addresses_;
+      FlowSocketPtr socket_;
+      MonotonicTime last_used_;
+    };
+    // Least recently used first.
+    using FlowList = std::list<Flow>;
+
+    bool canOpenSocket(const Upstream::Host& host) const;
+    void openSocket(Flow& flow, const Upstream::HostConstSharedPtr& host);
+    void closeSocket(Flow& flow);
+    void markUsed(FlowList::iterator flow_it, MonotonicTime now);
+    void removeFlow(FlowList::iterator flow_it);
+    void enableExpiryTimer(MonotonicTime now);
+    void onExpiryTimer();
+
+    const uint32_t max_sockets_per_host_;
+    FlowList flows_;
+    absl::flat_hash_map<Network::UdpRecvData::LocalPeerAddresses, FlowList::iterator> flow_index_;
+    absl::flat_hash_map<const Upstream::Host*, uint32_t> sockets_per_host_;
+    const Event::TimerPtr expiry_timer_;
+  };
+
   /**
    * Wraps all cluster specific UDP processing including session tracking, stats, etc. In the future
    * we will very likely support different types of routing to multiple upstream clusters.
@@ -261,6 +371,8 @@ private:
     }
 
     Envoy::Common::CallbackHandlePtr member_update_cb_handle_;
+    // Only set if sessions share upstream sockets, in which case sessions_ stays empty.
+    std::unique_ptr<FlowTable> flow_table_;
     absl::flat_hash_set<ActiveSessionPtr, HeterogeneousActiveSessionHash,
                         HeterogeneousActiveSessionEqual>
         sessions_;
@@ -0,0 +1,44 @@
+#include "source/extensions/private_key_providers/offload/config.h"
+
+#include "envoy/extensions/private_key_providers/offload/v3alpha/offload.pb.h"
+#include "envoy/extensions/private_key_providers/offload/v3alpha/offload.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/private_key_providers/offload/crypto_thread_pool.h"
+#include "source/extensions/private_key_providers/offload/offload_private_key_provider.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+
+SINGLETON_MANAGER_REGISTRATION(crypto_thread_pool_registry);
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+OffloadPrivateKeyMethodFactory::createPrivateKeyMethodProviderInstance(
+    const envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  const auto message = MessageUtil::anyConvertAndValidate<
+      envoy::extensions::private_key_providers::offload::v3alpha::OffloadPrivateKeyMethodConfig>(
+      config.typed_config(), factory_context.messageValidationVisitor());
+
+  Thread::ThreadFactory& thread_factory = factory_context.api().threadFactory();
+  auto registry = factory_context.singletonManager().getTyped<CryptoThreadPoolRegistry>(
+      SINGLETON_MANAGER_REGISTERED_NAME(crypto_thread_pool_registry),
+      [&thread_factory] { return std::make_shared<CryptoThreadPoolRegistry>(thread_factory); });
+  return std::make_shared<OffloadPrivateKeyMethodProvider>(
+      message, factory_context.api(), std::move(registry));
+}
+
+/**
+ * Static registration for the offload private key provider. @see RegistryFactory.
+ */
+REGISTER_FACTORY(OffloadPrivateKeyMethodFactory, Ssl::PrivateKeyMethodProviderInstanceFactory);
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
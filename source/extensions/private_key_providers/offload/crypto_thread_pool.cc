@@ -0,0 +1,73 @@
+#include "source/extensions/private_key_providers/offload/crypto_thread_pool.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+
+CryptoThreadPool::CryptoThreadPool(Thread::ThreadFactory& thread_factory, uint32_t concurrency) {
+  ASSERT(concurrency > 0);
+  // Thread names are limited to 15 characters, see WorkerImpl::start().
+  Thread::Options options{"tls_offload"};
+  for (uint32_t i = 0; i < concurrency; ++i) {
+    threads_.push_back(
+        thread_factory.createThread([this]() -> void { threadRoutine(); }, options));
+  }
+}
+
+CryptoThreadPool::~CryptoThreadPool() {
+  {
+    Thread::LockGuard lock(mutex_);
+    shutdown_ = true;
+    cond_var_.notifyAll();
+  }
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+}
+
+void CryptoThreadPool::post(Task task) {
+  Thread::LockGuard lock(mutex_);
+  ASSERT(!shutdown_);
+  tasks_.push_back(std::move(task));
+  cond_var_.notifyOne();
+}
+
+void CryptoThreadPool::threadRoutine() {
+  while (true) {
+    Task task;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (tasks_.empty() && !shutdown_) {
+        cond_var_.wait(mutex_);
+      }
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+CryptoThreadPoolSharedPtr CryptoThreadPoolRegistry::pool(uint32_t concurrency) {
+  auto it = pools_.find(concurrency);
+  if (it != pools_.end()) {
+    CryptoThreadPoolSharedPtr existing = it->second.lock();
+    if (existing != nullptr) {
+      return existing;
+    }
+  }
+  auto pool = std::make_shared<CryptoThreadPool>(thread_factory_, concurrency);
+  pools_[concurrency] = pool;
+  return pool;
+}
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "envoy/singleton/instance.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/thread.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+
+/**
+ * A fixed size pool of threads running private key operations for the TLS handshakes of the
+ * workers. Tasks run in FIFO order on whichever thread is idle first; they must not touch worker
+ * state and post their results back to the worker's dispatcher instead.
+ */
+class CryptoThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @param thread_factory supplies the factory used to create the pool's threads.
+   * @param concurrency supplies the number of threads, which must be greater than zero.
+   */
+  CryptoThreadPool(Thread::ThreadFactory& thread_factory, uint32_t concurrency);
+
+  /**
+   * Waits for all queued tasks to run and joins the threads.
+   */
+  ~CryptoThreadPool();
+
+  /**
+   * Queues a task to run on one of the pool's threads. May be called from any thread.
+   */
+  void post(Task task);
+
+  /**
+   * @return uint32_t the number of threads in the pool.
+   */
+  uint32_t concurrency() const { return threads_.size(); }
+
+private:
+  void threadRoutine();
+
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar cond_var_;
+  std::list<Task> tasks_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using CryptoThreadPoolSharedPtr = std::shared_ptr<CryptoThreadPool>;
+
+/**
+ * Hands out the crypto thread pools, so that all providers asking for the same number of threads
+ * share one pool instead of each starting its own threads. Pools are only weakly referenced and
+ * live as long as some provider uses them. Only used on the main thread.
+ */
+class CryptoThreadPoolRegistry : public Singleton::Instance {
+public:
+  explicit CryptoThreadPoolRegistry(Thread::ThreadFactory& thread_factory)
+      : thread_factory_(thread_factory) {}
+
+  /**
+   * @param concurrency supplies the number of threads, which must be greater than zero.
+   * @return CryptoThreadPoolSharedPtr the pool with this number of threads.
+   */
+  CryptoThreadPoolSharedPtr pool(uint32_t concurrency);
+
+private:
+  Thread::ThreadFactory& thread_factory_;
+  absl::flat_hash_map<uint32_t, std::weak_ptr<CryptoThreadPool>> pools_;
+};
+
+using CryptoThreadPoolRegistrySharedPtr = std::shared_ptr<CryptoThreadPoolRegistry>;
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
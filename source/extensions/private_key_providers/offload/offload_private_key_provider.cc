@@ -0,0 +1,370 @@
+#include "source/extensions/private_key_providers/offload/offload_private_key_provider.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/macros.h"
+#include "source/common/config/datasource.h"
+#include "source/common/protobuf/utility.h"
+
+#include "openssl/evp.h"
+#include "openssl/rsa.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+
+namespace {
+
+bool sign(EVP_PKEY* key, uint16_t signature_algorithm, const std::vector<uint8_t>& in,
+          std::vector<uint8_t>& out) {
+  if (SSL_get_signature_algorithm_key_type(signature_algorithm) != EVP_PKEY_id(key)) {
+    return false;
+  }
+  const EVP_MD* md = SSL_get_signature_algorithm_digest(signature_algorithm);
+  if (md == nullptr) {
+    return false;
+  }
+
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pctx, md, nullptr, key)) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) ||
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1))) {
+    return false;
+  }
+
+  size_t out_len = 0;
+  if (!EVP_DigestSign(ctx.get(), nullptr, &out_len, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(out_len);
+  if (!EVP_DigestSign(ctx.get(), out.data(), &out_len, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+bool decrypt(EVP_PKEY* key, const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+  RSA* rsa = EVP_PKEY_get0_RSA(key);
+  if (rsa == nullptr) {
+    return false;
+  }
+  out.resize(RSA_size(rsa));
+  size_t out_len = 0;
+  if (!RSA_decrypt(rsa, &out_len, out.data(), out.size(), in.data(), in.size(),
+                   RSA_NO_PADDING)) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+OffloadPrivateKeyConnection* getConnection(SSL* ssl) {
+  return static_cast<OffloadPrivateKeyConnection*>(
+      SSL_get_ex_data(ssl, OffloadPrivateKeyMethodProvider::connectionIndex()));
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len) {
+  OffloadPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->sign(out, out_len, max_out, signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, uint8_t* out, size_t* out_len,
+                                           size_t max_out, const uint8_t* in, size_t in_len) {
+  OffloadPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->decrypt(out, out_len, max_out, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  OffloadPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->complete(out, out_len, max_out);
+}
+
+int createIndex() {
+  int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+  return index;
+}
+
+} // namespace
+
+OffloadOperation::OffloadOperation(Type type, uint16_t signature_algorithm, const uint8_t* in,
+                                   size_t in_len, TransportSockets::Tls::PrivateKeySharedPtr key,
+                                   Ssl::PrivateKeyConnectionCallbacks& cb,
+                                   Event::Dispatcher& dispatcher)
+    : type_(type), signature_algorithm_(signature_algorithm), input_(in, in + in_len),
+      key_(std::move(key)), cb_(&cb), dispatcher_(&dispatcher) {}
+
+void OffloadOperation::run() {
+  succeeded_ = type_ == Type::Sign ? sign(key_.get(), signature_algorithm_, input_, output_)
+                                   : decrypt(key_.get(), input_, output_);
+}
+
+void OffloadOperation::postCompletion() {
+  Thread::LockGuard guard(lock_);
+  if (dispatcher_ == nullptr) {
+    return;
+  }
+  dispatcher_->post([operation = shared_from_this()]() {
+    if (operation->cb_ == nullptr) {
+      return;
+    }
+    operation->completed_ = true;
+    operation->cb_->onPrivateKeyMethodComplete();
+  });
+}
+
+void OffloadOperation::cancel() {
+  Thread::LockGuard guard(lock_);
+  dispatcher_ = nullptr;
+  cb_ = nullptr;
+}
+
+ssl_private_key_result_t OffloadOperation::result(uint8_t* out, size_t* out_len,
+                                                  size_t max_out) const {
+  if (!succeeded_ || output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  std::copy(output_.begin(), output_.end(), out);
+  *out_len = output_.size();
+  return ssl_private_key_success;
+}
+
+OperationBatcher::OperationBatcher(CryptoThreadPool& pool, uint32_t max_pending_operations,
+                                   uint32_t max_batch_size)
+    : pool_(pool), max_pending_operations_(max_pending_operations),
+      max_batch_size_(max_batch_size) {}
+
+bool OperationBatcher::add(const OffloadOperationSharedPtr& operation,
+                           absl::optional<uint64_t>& opened_batch) {
+  if (pending_operations_.fetch_add(1) >= max_pending_operations_) {
+    pending_operations_.fetch_sub(1);
+    return false;
+  }
+
+  Thread::LockGuard guard(lock_);
+  open_batch_.push_back(operation);
+  if (open_batch_.size() >= max_batch_size_) {
+    postBatch(std::move(open_batch_));
+    open_batch_.clear();
+  } else if (open_batch_.size() == 1) {
+    opened_batch = generation_;
+  }
+  return true;
+}
+
+void OperationBatcher::flush(uint64_t generation) {
+  Thread::LockGuard guard(lock_);
+  if (shut_down_ || generation_ != generation) {
+    // The batch filled up and was handed over in the meantime.
+    return;
+  }
+  postBatch(std::move(open_batch_));
+  open_batch_.clear();
+}
+
+void OperationBatcher::shutdown() {
+  Thread::LockGuard guard(lock_);
+  shut_down_ = true;
+  open_batch_.clear();
+}
+
+void OperationBatcher::postBatch(Batch batch) {
+  ++generation_;
+  pool_.post([self = shared_from_this(), batch = std::move(batch)]() { self->runBatch(batch); });
+}
+
+void OperationBatcher::runBatch(const Batch& batch) {
+  // BoringSSL has no multi-buffer RSA or ECDSA, so the operations of a batch are performed one
+  // after the other. Batching still saves a crypto thread wake-up and a pool queue round trip per
+  // operation.
+  for (const OffloadOperationSharedPtr& operation : batch) {
+    operation->run();
+    pending_operations_.fetch_sub(1);
+    operation->postCompletion();
+  }
+}
+
+OffloadPrivateKeyConnection::OffloadPrivateKeyConnection(Ssl::PrivateKeyConnectionCallbacks& cb,
+                                                         Event::Dispatcher& dispatcher)
+    : cb_(cb), dispatcher_(dispatcher) {}
+
+OffloadPrivateKeyConnection::~OffloadPrivateKeyConnection() {
+  if (operation_ != nullptr) {
+    operation_->cancel();
+  }
+  if (flush_timer_ != nullptr && flush_timer_->enabled()) {
+    // Hand the batch over now, so that the operations of other connections in it don't wait for
+    // the batch to fill up.
+    flushBatch();
+  }
+}
+
+void OffloadPrivateKeyConnection::addProvider(OffloadPrivateKeyMethodProvider& provider) {
+  OffloadPrivateKeyMethodProvider*& slot =
+      provider.keyType() == EVP_PKEY_RSA ? rsa_provider_ : ecdsa_provider_;
+  if (slot != nullptr) {
+    throw EnvoyException("Can't distinguish between two offload private key providers with the "
+                         "same key type on one connection.");
+  }
+  slot = &provider;
+}
+
+ssl_private_key_result_t OffloadPrivateKeyConnection::sign(uint8_t* out, size_t* out_len,
+                                                           size_t max_out,
+                                                           uint16_t signature_algorithm,
+                                                           const uint8_t* in, size_t in_len) {
+  OffloadPrivateKeyMethodProvider* provider =
+      SSL_get_signature_algorithm_key_type(signature_algorithm) == EVP_PKEY_RSA ? rsa_provider_
+                                                                               : ecdsa_provider_;
+  return start(provider, OffloadOperation::Type::Sign, signature_algorithm, in, in_len, out,
+               out_len, max_out);
+}
+
+ssl_private_key_result_t OffloadPrivateKeyConnection::decrypt(uint8_t* out, size_t* out_len,
+                                                              size_t max_out, const uint8_t* in,
+                                                              size_t in_len) {
+  return start(rsa_provider_, OffloadOperation::Type::Decrypt, 0, in, in_len, out, out_len,
+               max_out);
+}
+
+ssl_private_key_result_t OffloadPrivateKeyConnection::start(
+    OffloadPrivateKeyMethodProvider* provider, OffloadOperation::Type type,
+    uint16_t signature_algorithm, const uint8_t* in, size_t in_len, uint8_t* out, size_t* out_len,
+    size_t max_out) {
+  if (provider == nullptr || operation_ != nullptr) {
+    return ssl_private_key_failure;
+  }
+  auto operation = std::make_shared<OffloadOperation>(type, signature_algorithm, in, in_len,
+                                                      provider->key(), cb_, dispatcher_);
+  absl::optional<uint64_t> opened_batch;
+  if (!provider->offload(operation, opened_batch)) {
+    // The crypto threads are saturated; queueing more work behind them would only add latency.
+    operation->run();
+    return operation->result(out, out_len, max_out);
+  }
+  if (opened_batch.has_value()) {
+    armFlushTimer(*provider, opened_batch.value());
+  }
+  operation_ = std::move(operation);
+  return ssl_private_key_retry;
+}
+
+void OffloadPrivateKeyConnection::armFlushTimer(OffloadPrivateKeyMethodProvider& provider,
+                                                uint64_t generation) {
+  if (flush_timer_ == nullptr) {
+    flush_timer_ = dispatcher_.createTimer([this]() { flushBatch(); });
+  }
+  flush_batcher_ = provider.batcher();
+  flush_generation_ = generation;
+  flush_timer_->enableHRTimer(provider.batchDelay());
+}
+
+void OffloadPrivateKeyConnection::flushBatch() {
+  if (OperationBatcherSharedPtr batcher = flush_batcher_.lock()) {
+    batcher->flush(flush_generation_);
+  }
+}
+
+ssl_private_key_result_t OffloadPrivateKeyConnection::complete(uint8_t* out, size_t* out_len,
+                                                               size_t max_out) {
+  if (operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  if (!operation_->completed_) {
+    // The operation didn't finish yet, retry.
+    return ssl_private_key_retry;
+  }
+  OffloadOperationSharedPtr operation = std::move(operation_);
+  return operation->result(out, out_len, max_out);
+}
+
+OffloadPrivateKeyMethodProvider::OffloadPrivateKeyMethodProvider(
+    const envoy::extensions::private_key_providers::offload::v3alpha::
+        OffloadPrivateKeyMethodConfig& config,
+    Api::Api& api, CryptoThreadPoolRegistrySharedPtr registry)
+    : registry_(std::move(registry)),
+      pool_(registry_->pool(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, thread_count, std::max(1U, std::thread::hardware_concurrency())))),
+      batcher_(std::make_shared<OperationBatcher>(
+          *pool_, PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_pending_operations, 1024),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_batch_size, 1))),
+      batch_delay_(Protobuf::util::TimeUtil::DurationToMicroseconds(config.max_batch_delay())) {
+
+  key_ = TransportSockets::Tls::PemCache::get().privateKey(
+      Config::DataSource::read(config.private_key(), false, api), "");
+  if (key_ == nullptr) {
+    throw EnvoyException("Failed to load private key for the offload private key provider.");
+  }
+  if (keyType() != EVP_PKEY_RSA && keyType() != EVP_PKEY_EC) {
+    throw EnvoyException("The offload private key provider only supports RSA and ECDSA keys.");
+  }
+
+  method_ = std::make_shared<SSL_PRIVATE_KEY_METHOD>();
+  method_->sign = privateKeySign;
+  method_->decrypt = privateKeyDecrypt;
+  method_->complete = privateKeyComplete;
+}
+
+OffloadPrivateKeyMethodProvider::~OffloadPrivateKeyMethodProvider() {
+  // Queued tasks keep the batcher alive after the provider, and with it the pool, is gone, so
+  // connections flushing late must not hand over batches.
+  batcher_->shutdown();
+}
+
+void OffloadPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  OffloadPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    connection = new OffloadPrivateKeyConnection(cb, dispatcher);
+    SSL_set_ex_data(ssl, connectionIndex(), connection);
+  }
+  connection->addProvider(*this);
+}
+
+void OffloadPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  // With several providers on one connection the first call tears down the shared state.
+  OffloadPrivateKeyConnection* connection = getConnection(ssl);
+  SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+  delete connection;
+}
+
+bool OffloadPrivateKeyMethodProvider::checkFips() {
+  if (keyType() == EVP_PKEY_RSA) {
+    RSA* rsa = EVP_PKEY_get0_RSA(key_.get());
+    return rsa != nullptr && RSA_check_fips(rsa);
+  }
+  const EC_KEY* ec_key = EVP_PKEY_get0_EC_KEY(key_.get());
+  return ec_key != nullptr && EC_KEY_check_fips(ec_key);
+}
+
+int OffloadPrivateKeyMethodProvider::connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, createIndex());
+}
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/private_key_providers/offload/v3alpha/offload.pb.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/ssl/private_key/private_key_callbacks.h"
+
+#include "source/common/common/thread.h"
+#include "source/extensions/private_key_providers/offload/crypto_thread_pool.h"
+#include "source/extensions/transport_sockets/tls/pem_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/types/optional.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+
+/**
+ * One signing or decryption, shared between the connection that started it and the crypto thread
+ * performing it.
+ */
+class OffloadOperation : public std::enable_shared_from_this<OffloadOperation> {
+public:
+  enum class Type { Sign, Decrypt };
+
+  OffloadOperation(Type type, uint16_t signature_algorithm, const uint8_t* in, size_t in_len,
+                   TransportSockets::Tls::PrivateKeySharedPtr key,
+                   Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher);
+
+  /**
+   * Performs the operation. May be called on any thread, but only once.
+   */
+  void run();
+
+  /**
+   * Called on the crypto thread after run(). Resumes the handshake on the worker, unless the
+   * connection went away in the meantime.
+   */
+  void postCompletion();
+
+  /**
+   * Stops the result from being delivered to the connection. Called on the worker.
+   */
+  void cancel();
+
+  /**
+   * Copies the result for BoringSSL once the operation finished. Called on the worker.
+   */
+  ssl_private_key_result_t result(uint8_t* out, size_t* out_len, size_t max_out) const;
+
+  // Set on the worker once the result was posted back to it.
+  bool completed_{};
+
+private:
+  const Type type_;
+  const uint16_t signature_algorithm_;
+  const std::vector<uint8_t> input_;
+  const TransportSockets::Tls::PrivateKeySharedPtr key_;
+  // Written by run() and read on the worker after the completion was posted, which orders them.
+  std::vector<uint8_t> output_;
+  bool succeeded_{};
+  // Only used on the worker.
+  Ssl::PrivateKeyConnectionCallbacks* cb_;
+  Thread::MutexBasicLockable lock_;
+  Event::Dispatcher* dispatcher_ ABSL_GUARDED_BY(lock_);
+};
+
+using OffloadOperationSharedPtr = std::shared_ptr<OffloadOperation>;
+
+/**
+ * Hands the operations of a provider to the crypto threads, bounding how many are pending and
+ * grouping concurrent operations into batches run by a single crypto thread task. A batch is
+ * handed over once it is full or, through flush(), max_batch_delay after it was opened, whichever
+ * comes first.
+ */
+class OperationBatcher : public std::enable_shared_from_this<OperationBatcher> {
+public:
+  OperationBatcher(CryptoThreadPool& pool, uint32_t max_pending_operations,
+                   uint32_t max_batch_size);
+
+  /**
+   * Queues an operation on the crypto threads. May be called from any thread.
+   * @param opened_batch set to the generation of the batch if the operation opened a batch that is
+   *        not full yet, which the caller then has to flush() once the batch delay passed.
+   * @return bool false if the provider is at its limit of pending operations, in which case the
+   *         caller performs the operation itself.
+   */
+  bool add(const OffloadOperationSharedPtr& operation, absl::optional<uint64_t>& opened_batch);
+
+  /**
+   * Hands the open batch over to the crypto threads if it still is the batch of the given
+   * generation. May be called from any thread.
+   */
+  void flush(uint64_t generation);
+
+  /**
+   * Drops the open batch and ignores later flushes. Called when the provider, which owns the pool,
+   * goes away.
+   */
+  void shutdown();
+
+private:
+  using Batch = std::vector<OffloadOperationSharedPtr>;
+
+  void postBatch(Batch batch) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void runBatch(const Batch& batch);
+
+  // Owned by the provider, which outlives all calls to add(). Queued tasks only reference the
+  // batcher, so that the pool is never released from one of its own threads.
+  CryptoThreadPool& pool_;
+  const uint32_t max_pending_operations_;
+  const uint32_t max_batch_size_;
+  std::atomic<uint32_t> pending_operations_{0};
+  Thread::MutexBasicLockable lock_;
+  Batch open_batch_ ABSL_GUARDED_BY(lock_);
+  // Incremented whenever the open batch is handed over.
+  uint64_t generation_ ABSL_GUARDED_BY(lock_){};
+  bool shut_down_ ABSL_GUARDED_BY(lock_){};
+};
+
+using OperationBatcherSharedPtr = std::shared_ptr<OperationBatcher>;
+
+class OffloadPrivateKeyMethodProvider;
+
+/**
+ * Per connection state, attached to the SSL object. A listener serving both an RSA and an ECDSA
+ * certificate registers two providers on the same connection; the signature algorithm picked by
+ * BoringSSL tells which of them holds the key of the selected certificate.
+ */
+class OffloadPrivateKeyConnection {
+public:
+  OffloadPrivateKeyConnection(Ssl::PrivateKeyConnectionCallbacks& cb,
+                              Event::Dispatcher& dispatcher);
+  ~OffloadPrivateKeyConnection();
+
+  /**
+   * Adds a provider to the connection. Throws if a provider with the same key type was added.
+   */
+  void addProvider(OffloadPrivateKeyMethodProvider& provider);
+
+  ssl_private_key_result_t sign(uint8_t* out, size_t* out_len, size_t max_out,
+                                uint16_t signature_algorithm, const uint8_t* in, size_t in_len);
+  ssl_private_key_result_t decrypt(uint8_t* out, size_t* out_len, size_t max_out,
+                                   const uint8_t* in, size_t in_len);
+  ssl_private_key_result_t complete(uint8_t* out, size_t* out_len, size_t max_out);
+
+private:
+  ssl_private_key_result_t start(OffloadPrivateKeyMethodProvider* provider,
+                                 OffloadOperation::Type type, uint16_t signature_algorithm,
+                                 const uint8_t* in, size_t in_len, uint8_t* out, size_t* out_len,
+                                 size_t max_out);
+  // Flushes the batch opened by the connection's operation once the batch delay passed, so that
+  // partial batches neither wait for more operations nor hold a crypto thread.
+  void armFlushTimer(OffloadPrivateKeyMethodProvider& provider, uint64_t generation);
+  void flushBatch();
+
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  Event::Dispatcher& dispatcher_;
+  OffloadPrivateKeyMethodProvider* rsa_provider_{};
+  OffloadPrivateKeyMethodProvider* ecdsa_provider_{};
+  OffloadOperationSharedPtr operation_;
+  // Created on the first batch the connection opens, on the connection's worker.
+  Event::TimerPtr flush_timer_;
+  std::weak_ptr<OperationBatcher> flush_batcher_;
+  uint64_t flush_generation_{};
+};
+
+/**
+ * Private key provider performing the RSA and ECDSA operations of TLS handshakes on a pool of
+ * crypto threads, so that slow signatures do not stall the other connections of a worker.
+ */
+class OffloadPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider {
+public:
+  OffloadPrivateKeyMethodProvider(
+      const envoy::extensions::private_key_providers::offload::v3alpha::
+          OffloadPrivateKeyMethodConfig& config,
+      Api::Api& api, CryptoThreadPoolRegistrySharedPtr registry);
+  ~OffloadPrivateKeyMethodProvider() override;
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override {
+    return method_;
+  }
+
+  /**
+   * @return int the EVP_PKEY type of the provider's key.
+   */
+  int keyType() const { return EVP_PKEY_id(key_.get()); }
+
+  const TransportSockets::Tls::PrivateKeySharedPtr& key() const { return key_; }
+
+  /**
+   * Queues an operation on the crypto threads. @see OperationBatcher::add().
+   */
+  bool offload(const OffloadOperationSharedPtr& operation,
+               absl::optional<uint64_t>& opened_batch) {
+    return batcher_->add(operation, opened_batch);
+  }
+
+  const OperationBatcherSharedPtr& batcher() const { return batcher_; }
+
+  /**
+   * @return std::chrono::microseconds how long a batch that is not full waits for more operations.
+   */
+  std::chrono::microseconds batchDelay() const { return batch_delay_; }
+
+  static int connectionIndex();
+
+private:
+  TransportSockets::Tls::PrivateKeySharedPtr key_;
+  // Keeps the registry alive, so that providers created later find the pool in use.
+  const CryptoThreadPoolRegistrySharedPtr registry_;
+  CryptoThreadPoolSharedPtr pool_;
+  // Shared with the queued tasks, which may outlive the provider.
+  OperationBatcherSharedPtr batcher_;
+  std::chrono::microseconds batch_delay_{};
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+};
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
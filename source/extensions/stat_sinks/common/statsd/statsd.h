@@ -60,6 +60,8 @@ public:
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override;
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
+  // Writers are thread local.
+  bool flushOffMainThread() const override { return true; }
 
   bool getUseTagForTest() { return use_tag_; }
   uint64_t getBufferSizeForTest() { return buffer_size_; }
@@ -115,6 +117,8 @@ public:
     tls_->getTyped<TlsSink>().onTimespanComplete(histogram.name(),
                                                  std::chrono::milliseconds(value));
   }
+  // Connections are thread local.
+  bool flushOffMainThread() const override { return true; }
 
   const std::string& getPrefix() { return prefix_; }
 
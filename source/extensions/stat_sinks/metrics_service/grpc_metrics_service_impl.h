@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include "envoy/event/dispatcher.h"
 #include "envoy/grpc/async_client.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/network/connection.h"
@@ -118,26 +119,48 @@ private:
  */
 template <class RequestProto, class ResponseProto> class MetricsServiceSink : public Stats::Sink {
 public:
+  /**
+   * @param main_thread_dispatcher if supplied, allows the sink to be flushed off the main thread.
+   *        Metrics are then built on the flushing thread and sent on the main thread, which owns
+   *        the gRPC stream.
+   */
   MetricsServiceSink(
       const GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto>& grpc_metrics_streamer,
-      bool report_counters_as_deltas, bool emit_labels)
+      bool report_counters_as_deltas, bool emit_labels,
+      Event::Dispatcher* main_thread_dispatcher = nullptr)
       : MetricsServiceSink(grpc_metrics_streamer,
-                           MetricsFlusher(report_counters_as_deltas, emit_labels)) {}
+                           MetricsFlusher(report_counters_as_deltas, emit_labels),
+                           main_thread_dispatcher) {}
 
   MetricsServiceSink(
       const GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto>& grpc_metrics_streamer,
-      MetricsFlusher&& flusher)
-      : flusher_(std::move(flusher)), grpc_metrics_streamer_(std::move(grpc_metrics_streamer)) {}
+      MetricsFlusher&& flusher, Event::Dispatcher* main_thread_dispatcher = nullptr)
+      : flusher_(std::move(flusher)), grpc_metrics_streamer_(std::move(grpc_metrics_streamer)),
+        main_thread_dispatcher_(main_thread_dispatcher) {}
 
   // MetricsService::Sink
   void flush(Stats::MetricSnapshot& snapshot) override {
-    grpc_metrics_streamer_->send(flusher_.flush(snapshot));
+    MetricsPtr metrics = flusher_.flush(snapshot);
+    if (main_thread_dispatcher_ == nullptr || main_thread_dispatcher_->isThreadSafe()) {
+      grpc_metrics_streamer_->send(std::move(metrics));
+      return;
+    }
+    // The dispatcher only accepts copyable callbacks, so hand the metrics over via a shared_ptr.
+    std::shared_ptr<MetricsPtr::element_type> shared_metrics = std::move(metrics);
+    main_thread_dispatcher_->post(
+        [grpc_metrics_streamer = grpc_metrics_streamer_, shared_metrics]() -> void {
+          auto metrics = std::make_unique<MetricsPtr::element_type>();
+          metrics->Swap(shared_metrics.get());
+          grpc_metrics_streamer->send(std::move(metrics));
+        });
   }
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+  bool flushOffMainThread() const override { return main_thread_dispatcher_ != nullptr; }
 
 private:
   const MetricsFlusher flusher_;
   GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto> grpc_metrics_streamer_;
+  Event::Dispatcher* const main_thread_dispatcher_;
 };
 
 } // namespace MetricsService
@@ -26,6 +26,7 @@
 #include "source/extensions/transport_sockets/tls/cert_validator/cert_validator.h"
 #include "source/extensions/transport_sockets/tls/cert_validator/factory.h"
 #include "source/extensions/transport_sockets/tls/cert_validator/utility.h"
+#include "source/extensions/transport_sockets/tls/pem_cache.h"
 #include "source/extensions/transport_sockets/tls/stats.h"
 #include "source/extensions/transport_sockets/tls/utility.h"
 
@@ -68,13 +69,10 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
 
   if (config_ != nullptr && !config_->caCert().empty() && !provides_certificates) {
     ca_file_path_ = config_->caCertPath();
-    bssl::UniquePtr<BIO> bio(
-        BIO_new_mem_buf(const_cast<char*>(config_->caCert().data()), config_->caCert().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
+    // The parsed bundle is shared with every other context trusting the same CA bundle; each
+    // X509_STORE below only takes references to its certificates and CRLs.
+    ca_list_ = PemCache::get().x509InfoList(config_->caCert());
+    if (ca_list_ == nullptr) {
       throw EnvoyException(
           absl::StrCat("Failed to load trusted CA certificates from ", config_->caCertPath()));
     }
@@ -82,7 +80,7 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
     for (auto& ctx : contexts) {
       X509_STORE* store = SSL_CTX_get_cert_store(ctx);
       bool has_crl = false;
-      for (const X509_INFO* item : list.get()) {
+      for (const X509_INFO* item : ca_list_.get()) {
         if (item->x509) {
           X509_STORE_add_cert(store, item->x509);
           if (ca_cert_ == nullptr) {
@@ -116,22 +114,15 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
   }
 
   if (config_ != nullptr && !config_->certificateRevocationList().empty()) {
-    bssl::UniquePtr<BIO> bio(
-        BIO_new_mem_buf(const_cast<char*>(config_->certificateRevocationList().data()),
-                        config_->certificateRevocationList().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
+    crl_list_ = PemCache::get().x509InfoList(config_->certificateRevocationList());
+    if (crl_list_ == nullptr) {
       throw EnvoyException(
           absl::StrCat("Failed to load CRL from ", config_->certificateRevocationListPath()));
     }
 
     for (auto& ctx : contexts) {
       X509_STORE* store = SSL_CTX_get_cert_store(ctx);
-      for (const X509_INFO* item : list.get()) {
+      for (const X509_INFO* item : crl_list_.get()) {
         if (item->crl) {
           X509_STORE_add_crl(store, item->crl);
         }
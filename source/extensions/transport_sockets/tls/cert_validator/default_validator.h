@@ -17,6 +17,7 @@
 #include "source/common/common/matchers.h"
 #include "source/common/stats/symbol_table_impl.h"
 #include "source/extensions/transport_sockets/tls/cert_validator/cert_validator.h"
+#include "source/extensions/transport_sockets/tls/pem_cache.h"
 #include "source/extensions/transport_sockets/tls/stats.h"
 
 #include "absl/synchronization/mutex.h"
@@ -112,6 +113,9 @@ private:
 
   bool allow_untrusted_certificate_{false};
   bssl::UniquePtr<X509> ca_cert_;
+  // Held so that contexts created later with the same CA bundle or CRL reuse the parsed copy.
+  X509InfoListSharedPtr ca_list_;
+  X509InfoListSharedPtr crl_list_;
   std::string ca_file_path_;
   std::vector<Matchers::StringMatcherImpl> subject_alt_name_matchers_;
   std::vector<std::vector<uint8_t>> verify_certificate_hash_list_;
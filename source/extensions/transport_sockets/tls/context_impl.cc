@@ -22,15 +22,18 @@
 #include "source/common/runtime/runtime_features.h"
 #include "source/common/stats/utility.h"
 #include "source/extensions/transport_sockets/tls/cert_validator/factory.h"
+#include "source/extensions/transport_sockets/tls/session_cache.h"
 #include "source/extensions/transport_sockets/tls/stats.h"
 #include "source/extensions/transport_sockets/tls/utility.h"
 
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "openssl/evp.h"
 #include "openssl/hmac.h"
 #include "openssl/rand.h"
+#include "openssl/sha.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -53,6 +56,116 @@ bool cbsContainsU16(CBS& cbs, uint16_t n) {
   return false;
 }
 
+// Builds the digest session caches are shared by.
+class SessionCacheKeyBuilder {
+public:
+  SessionCacheKeyBuilder() { SHA256_Init(&sha256_); }
+
+  // Length-prefix every field so that adjacent fields cannot be confused with each other.
+  void add(absl::string_view field) {
+    const uint64_t length = field.size();
+    SHA256_Update(&sha256_, &length, sizeof(length));
+    SHA256_Update(&sha256_, field.data(), field.size());
+  }
+
+  // Adds the settings the peer certificate is verified with. Returns false if they cannot be
+  // compared with others, i.e. if a custom validator is configured.
+  bool addValidationContext(const Envoy::Ssl::CertificateValidationContextConfig* validation) {
+    if (validation == nullptr) {
+      add("");
+      return true;
+    }
+    if (validation->customValidatorConfig().has_value()) {
+      return false;
+    }
+    add(validation->caCert());
+    add(validation->certificateRevocationList());
+    for (const envoy::type::matcher::v3::StringMatcher& matcher :
+         validation->subjectAltNameMatchers()) {
+      add(std::to_string(MessageUtil::hash(matcher)));
+    }
+    for (const std::string& hash : validation->verifyCertificateHashList()) {
+      add(hash);
+    }
+    for (const std::string& hash : validation->verifyCertificateSpkiList()) {
+      add(hash);
+    }
+    add(absl::StrCat(validation->allowExpiredCertificate() ? "1" : "0", ":",
+                     validation->trustChainVerification()));
+    return true;
+  }
+
+  std::string digest() {
+    std::string digest(SHA256_DIGEST_LENGTH, '\0');
+    SHA256_Final(reinterpret_cast<uint8_t*>(digest.data()), &sha256_);
+    return digest;
+  }
+
+private:
+  SHA256_CTX sha256_;
+};
+
+// Returns a digest of the stats scope, which identifies the cluster, and of everything in a client
+// context configuration that affects which sessions the context may resume, or an empty string if
+// the configuration cannot be compared with others, e.g. because it relies on a custom handshaker,
+// validator or private key provider. Only rebuilds of the same cluster share sessions.
+std::string clientSessionCacheKey(const Envoy::Ssl::ClientContextConfig& config,
+                                  absl::string_view scope_name) {
+  const Ssl::HandshakerCapabilities capabilities = config.capabilities();
+  if (config.sslctxCb() != nullptr || capabilities.provides_certificates ||
+      capabilities.verifies_peer_certificates || capabilities.handles_session_resumption ||
+      capabilities.provides_ciphers_and_curves || capabilities.handles_alpn_selection) {
+    return "";
+  }
+
+  SessionCacheKeyBuilder key;
+  key.add(scope_name);
+  key.add(config.serverNameIndication());
+  key.add(config.alpnProtocols());
+  key.add(config.cipherSuites());
+  key.add(config.ecdhCurves());
+  key.add(absl::StrCat(config.minProtocolVersion(), ":", config.maxProtocolVersion(), ":",
+                       config.allowRenegotiation() ? "1" : "0", ":",
+                       config.signingAlgorithmsForTest()));
+  for (const Envoy::Ssl::TlsCertificateConfig& tls_certificate : config.tlsCertificates()) {
+    if (tls_certificate.privateKeyMethod() != nullptr) {
+      return "";
+    }
+    key.add(tls_certificate.certificateChain());
+    key.add(tls_certificate.privateKey());
+    key.add(tls_certificate.password());
+  }
+  if (!key.addValidationContext(config.certificateValidationContext())) {
+    return "";
+  }
+  return key.digest();
+}
+
+// Returns a digest of the session ID context and of the settings a server context verifies
+// clients and negotiates connections with, which a resumed session would bypass, or an empty
+// string if the configuration cannot be compared with others. The session ID context only covers
+// the server names, the trusted CA and the certificate pins.
+std::string serverSessionCacheKey(const Envoy::Ssl::ServerContextConfig& config,
+                                  absl::string_view session_id_context) {
+  const Ssl::HandshakerCapabilities capabilities = config.capabilities();
+  if (config.sslctxCb() != nullptr || capabilities.verifies_peer_certificates ||
+      capabilities.provides_ciphers_and_curves) {
+    return "";
+  }
+
+  SessionCacheKeyBuilder key;
+  key.add(session_id_context);
+  key.add(config.alpnProtocols());
+  key.add(config.cipherSuites());
+  key.add(config.ecdhCurves());
+  key.add(absl::StrCat(config.minProtocolVersion(), ":", config.maxProtocolVersion(), ":",
+                       config.requireClientCertificate() ? "1" : "0"));
+  if (!key.addValidationContext(config.certificateValidationContext())) {
+    return "";
+  }
+  return key.digest();
+}
+
 } // namespace
 
 int ContextImpl::sslExtendedSocketInfoIndex() {
@@ -288,17 +401,13 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
 #endif
         SSL_CTX_set_private_key_method(ctx.ssl_ctx_.get(), private_key_method.get());
       } else {
-        // Load private key.
-        bio.reset(BIO_new_mem_buf(const_cast<char*>(tls_certificate.privateKey().data()),
-                                  tls_certificate.privateKey().size()));
-        RELEASE_ASSERT(bio != nullptr, "");
-        bssl::UniquePtr<EVP_PKEY> pkey(
-            PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr,
-                                    !tls_certificate.password().empty()
-                                        ? const_cast<char*>(tls_certificate.password().c_str())
-                                        : nullptr));
-
-        if (pkey == nullptr || !SSL_CTX_use_PrivateKey(ctx.ssl_ctx_.get(), pkey.get())) {
+        // Load private key. Contexts using the same key, e.g. a certificate shared by many filter
+        // chains, share one parsed copy.
+        ctx.private_key_ =
+            PemCache::get().privateKey(tls_certificate.privateKey(), tls_certificate.password());
+        EVP_PKEY* pkey = ctx.private_key_.get();
+
+        if (pkey == nullptr || !SSL_CTX_use_PrivateKey(ctx.ssl_ctx_.get(), pkey)) {
           throw EnvoyException(fmt::format("Failed to load private key from {}, Cause: {}",
                                            tls_certificate.privateKeyPath(),
                                            Utility::getLastCryptoError().value_or("unknown")));
@@ -308,7 +417,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
         // Verify that private keys are passing FIPS pairwise consistency tests.
         switch (pkey_id) {
         case EVP_PKEY_EC: {
-          const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey.get());
+          const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey);
           if (!EC_KEY_check_fips(ecdsa_private_key)) {
             throw EnvoyException(fmt::format("Failed to load private key from {}, ECDSA key failed "
                                              "pairwise consistency test required in FIPS mode",
@@ -316,7 +425,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
           }
         } break;
         case EVP_PKEY_RSA: {
-          RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey.get());
+          RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey);
           if (!RSA_check_fips(rsa_private_key)) {
             throw EnvoyException(fmt::format("Failed to load private key from {}, RSA key failed "
                                              "pairwise consistency test required in FIPS mode",
@@ -581,6 +690,16 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
   }
 
   if (max_session_keys_ > 0) {
+    std::string session_cache_key;
+    if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.tls_shared_session_cache")) {
+      // Stats names carry the scope prefix, e.g. "cluster.<name>.".
+      session_cache_key = clientSessionCacheKey(config, stats_.handshake_.name());
+    }
+    session_cache_ =
+        session_cache_key.empty()
+            ? std::make_shared<ClientSessionCache>(max_session_keys_)
+            : SessionCacheRegistry::get().clientCache(session_cache_key, max_session_keys_);
+
     SSL_CTX_set_session_cache_mode(tls_contexts_[0].ssl_ctx_.get(), SSL_SESS_CACHE_CLIENT);
     SSL_CTX_sess_set_new_cb(
         tls_contexts_[0].ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
@@ -645,48 +764,29 @@ bssl::UniquePtr<SSL> ClientContextImpl::newSsl(const Network::TransportSocketOpt
     SSL_set_renegotiate_mode(ssl_con.get(), ssl_renegotiate_freely);
   }
 
-  if (max_session_keys_ > 0) {
-    if (session_keys_single_use_) {
-      // Stored single-use session keys, use write/write locks.
-      absl::WriterMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
-        // Remove single-use session key (TLS 1.3) after first use.
-        if (SSL_SESSION_should_be_single_use(session)) {
-          session_keys_.pop_front();
-        }
-      }
-    } else {
-      // Never stored single-use session keys, use read/write locks.
-      absl::ReaderMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
-      }
-    }
+  if (session_cache_ != nullptr) {
+    session_cache_->setSession(ssl_con.get());
   }
 
   return ssl_con;
 }
 
+void ClientContextImpl::logHandshake(SSL* ssl) const {
+  ContextImpl::logHandshake(ssl);
+
+  // An offered session may still be rejected by the server, so hits are counted from the
+  // handshake rather than from the cache lookup.
+  if (session_cache_ != nullptr) {
+    if (SSL_session_reused(ssl)) {
+      stats_.session_cache_hit_.inc();
+    } else {
+      stats_.session_cache_miss_.inc();
+    }
+  }
+}
+
 int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
-  // In case we ever store single-use session key (TLS 1.3),
-  // we need to switch to using write/write locks.
-  if (SSL_SESSION_should_be_single_use(session)) {
-    session_keys_single_use_ = true;
-  }
-  absl::WriterMutexLock l(&session_keys_mu_);
-  // Evict oldest entries.
-  while (session_keys_.size() >= max_session_keys_) {
-    session_keys_.pop_back();
-  }
-  // Add new session key at the front of the queue, so that it's used first.
-  session_keys_.push_front(bssl::UniquePtr<SSL_SESSION>(session));
+  session_cache_->addSession(bssl::UniquePtr<SSL_SESSION>(session));
   return 1; // Tell BoringSSL that we took ownership of the session.
 }
 
@@ -716,6 +816,21 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   // is used. We do this early because it can throw an EnvoyException.
   const SessionContextID session_id = generateHashForSessionContextId(server_names);
 
+  // Keep stateful resumption working across rebuilds of this context, e.g. on listener or filter
+  // chain updates, by storing sessions in a cache shared by all contexts with this session ID
+  // context and the same client verification and negotiation settings, instead of BoringSSL's per
+  // SSL_CTX cache.
+  if (!config.capabilities().handles_session_resumption &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.tls_shared_session_cache")) {
+    const std::string session_cache_key = serverSessionCacheKey(
+        config, absl::string_view(reinterpret_cast<const char*>(session_id.data()),
+                                  session_id.size()));
+    if (!session_cache_key.empty()) {
+      session_cache_ = SessionCacheRegistry::get().serverCache(
+          session_cache_key, SSL_CTX_sess_get_cache_size(tls_contexts_[0].ssl_ctx_.get()));
+    }
+  }
+
   // First, configure the base context for ClientHello interception.
   // TODO(htuch): replace with SSL_IDENTITY when we have this as a means to do multi-cert in
   // BoringSSL.
@@ -775,6 +890,25 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
         SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_id.data(), session_id.size());
     RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
 
+    if (session_cache_ != nullptr) {
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        auto* server_context_impl = static_cast<ServerContextImpl*>(
+            static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl))));
+        server_context_impl->session_cache_->addSession(bssl::UniquePtr<SSL_SESSION>(session));
+        return 1; // Tell BoringSSL that we took ownership of the session.
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+            auto* server_context_impl = static_cast<ServerContextImpl*>(
+                static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl))));
+            return server_context_impl->findSession(
+                absl::string_view(reinterpret_cast<const char*>(id), id_len), out_copy);
+          });
+    }
+
     auto& ocsp_resp_bytes = tls_certificates[i].get().ocspStaple();
     if (ocsp_resp_bytes.empty()) {
       if (Runtime::runtimeFeatureEnabled(
@@ -899,6 +1033,18 @@ ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string
   return session_id;
 }
 
+SSL_SESSION* ServerContextImpl::findSession(absl::string_view session_id, int* out_copy) {
+  bssl::UniquePtr<SSL_SESSION> session = session_cache_->findSession(session_id);
+  if (session == nullptr) {
+    stats_.session_cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.session_cache_hit_.inc();
+  // Hand BoringSSL our new reference rather than asking it to take one.
+  *out_copy = 0;
+  return session.release();
+}
+
 int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv,
                                             EVP_CIPHER_CTX* ctx, HMAC_CTX* hmac_ctx, int encrypt) {
   const EVP_MD* hmac = EVP_sha256();
@@ -19,6 +19,8 @@
 #include "source/extensions/transport_sockets/tls/cert_validator/cert_validator.h"
 #include "source/extensions/transport_sockets/tls/context_manager_impl.h"
 #include "source/extensions/transport_sockets/tls/ocsp/ocsp.h"
+#include "source/extensions/transport_sockets/tls/pem_cache.h"
+#include "source/extensions/transport_sockets/tls/session_cache.h"
 #include "source/extensions/transport_sockets/tls/stats.h"
 
 #include "absl/synchronization/mutex.h"
@@ -46,6 +48,8 @@ struct TlsContext {
   bool is_ecdsa_{};
   bool is_must_staple_{};
   Ssl::PrivateKeyMethodProviderSharedPtr private_key_method_provider_{};
+  // Held so that contexts created later with the same key reuse the parsed copy.
+  PrivateKeySharedPtr private_key_;
 
   std::string getCertChainFileName() const { return cert_chain_file_path_; };
   bool isCipherEnabled(uint16_t cipher_id, uint16_t client_version);
@@ -62,7 +66,7 @@ public:
    * Logs successful TLS handshake and updates stats.
    * @param ssl the connection to log
    */
-  void logHandshake(SSL* ssl) const;
+  virtual void logHandshake(SSL* ssl) const;
 
   SslStats& stats() { return stats_; }
 
@@ -135,6 +139,9 @@ public:
 
   bssl::UniquePtr<SSL> newSsl(const Network::TransportSocketOptions* options) override;
 
+  // ContextImpl
+  void logHandshake(SSL* ssl) const override;
+
 private:
   int newSessionKey(SSL_SESSION* session);
   uint16_t parseSigningAlgorithmsForTest(const std::string& sigalgs);
@@ -142,9 +149,8 @@ private:
   const std::string server_name_indication_;
   const bool allow_renegotiation_;
   const size_t max_session_keys_;
-  absl::Mutex session_keys_mu_;
-  std::deque<bssl::UniquePtr<SSL_SESSION>> session_keys_ ABSL_GUARDED_BY(session_keys_mu_);
-  bool session_keys_single_use_{false};
+  // Shared with other contexts built from an identical configuration, unless disabled.
+  ClientSessionCacheSharedPtr session_cache_;
 };
 
 enum class OcspStapleAction { Staple, NoStaple, Fail, ClientNotCapable };
@@ -166,6 +172,7 @@ private:
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
+  SSL_SESSION* findSession(absl::string_view session_id, int* out_copy);
   bool isClientEcdsaCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   bool isClientOcspCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   OcspStapleAction ocspStapleAction(const TlsContext& ctx, bool client_ocsp_capable);
@@ -174,6 +181,9 @@ private:
 
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
   const Ssl::ServerContextConfig::OcspStaplePolicy ocsp_staple_policy_;
+  // Stateful resumption cache shared with other contexts with the same session ID context and
+  // client verification and negotiation settings, unless disabled.
+  ServerSessionCacheSharedPtr session_cache_;
 };
 
 } // namespace Tls
@@ -0,0 +1,98 @@
+#include "source/extensions/transport_sockets/tls/pem_cache.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/macros.h"
+
+#include "absl/strings/str_cat.h"
+#include "openssl/pem.h"
+#include "openssl/sha.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+namespace {
+
+std::string sha256(absl::string_view data) {
+  std::string digest(SHA256_DIGEST_LENGTH, '\0');
+  SHA256(reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+         reinterpret_cast<uint8_t*>(digest.data()));
+  return digest;
+}
+
+} // namespace
+
+PemCache& PemCache::get() { MUTABLE_CONSTRUCT_ON_FIRST_USE(PemCache); }
+
+template <class T, class ParseFn>
+std::shared_ptr<T> PemCache::findOrParse(EntryMap<T>& entries, const std::string& key,
+                                         ParseFn parse) {
+  auto it = entries.find(key);
+  if (it != entries.end()) {
+    std::shared_ptr<T> existing = it->second.lock();
+    if (existing != nullptr) {
+      return existing;
+    }
+  }
+
+  bssl::UniquePtr<T> parsed = parse();
+  if (parsed == nullptr) {
+    return nullptr;
+  }
+  // Drop entries whose contexts have all gone away. This only happens on a miss, which is
+  // already paying for a PEM parse, so the sweep does not show up on the hit path.
+  for (auto entry = entries.begin(); entry != entries.end();) {
+    if (entry->second.expired()) {
+      entries.erase(entry++);
+    } else {
+      ++entry;
+    }
+  }
+  std::shared_ptr<T> result(std::move(parsed));
+  entries[key] = result;
+  return result;
+}
+
+X509InfoListSharedPtr PemCache::x509InfoList(absl::string_view pem) {
+  Thread::LockGuard guard(lock_);
+  return findOrParse(x509_info_lists_, sha256(pem), [pem]() {
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), pem.size()));
+    RELEASE_ASSERT(bio != nullptr, "");
+    return bssl::UniquePtr<STACK_OF(X509_INFO)>(
+        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
+  });
+}
+
+PrivateKeySharedPtr PemCache::privateKey(absl::string_view pem, absl::string_view password) {
+  Thread::LockGuard guard(lock_);
+  // The password is part of the cache key so that loading an encrypted key with the wrong
+  // password keeps failing even after it was loaded with the right one. Only its digest is kept.
+  const std::string key = absl::StrCat(sha256(pem), sha256(password));
+  return findOrParse(private_keys_, key, [pem, password]() {
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), pem.size()));
+    RELEASE_ASSERT(bio != nullptr, "");
+    const std::string password_str(password);
+    return bssl::UniquePtr<EVP_PKEY>(PEM_read_bio_PrivateKey(
+        bio.get(), nullptr, nullptr,
+        !password_str.empty() ? const_cast<char*>(password_str.c_str()) : nullptr));
+  });
+}
+
+size_t PemCache::size() {
+  Thread::LockGuard guard(lock_);
+  size_t live = 0;
+  for (const auto& entry : x509_info_lists_) {
+    live += entry.second.expired() ? 0 : 1;
+  }
+  for (const auto& entry : private_keys_) {
+    live += entry.second.expired() ? 0 : 1;
+  }
+  return live;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "source/common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "openssl/ssl.h"
+#include "openssl/x509v3.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+using X509InfoListSharedPtr = std::shared_ptr<STACK_OF(X509_INFO)>;
+using PrivateKeySharedPtr = std::shared_ptr<EVP_PKEY>;
+
+/**
+ * Process-wide cache of parsed PEM material. Listeners and clusters commonly reference the same
+ * CA bundle, CRL or private key from many filter chains and clusters; without sharing, every
+ * context parses its own copy and every X509_STORE holds its own copy of each certificate.
+ *
+ * Entries are keyed by a SHA-256 digest of their input and are only weakly referenced by the
+ * cache, so parsed material lives exactly as long as some context holds on to it. Parse failures
+ * are never cached, and leave the BoringSSL error queue as the parser left it so that callers
+ * can report the cause exactly as before.
+ *
+ * The returned objects are shared by reference count and must be treated as immutable.
+ */
+class PemCache {
+public:
+  /**
+   * @return PemCache& the process-wide cache.
+   */
+  static PemCache& get();
+
+  /**
+   * Parses (or finds a previously parsed copy of) a PEM bundle of certificates and CRLs, as done
+   * by BoringSSL's X509_load_cert_crl_file().
+   * @param pem the PEM encoded bundle.
+   * @return X509InfoListSharedPtr the parsed bundle, or nullptr if it could not be parsed.
+   */
+  X509InfoListSharedPtr x509InfoList(absl::string_view pem);
+
+  /**
+   * Parses (or finds a previously parsed copy of) a PEM encoded private key.
+   * @param pem the PEM encoded private key.
+   * @param password the password protecting the key, or empty if it is not encrypted.
+   * @return PrivateKeySharedPtr the parsed key, or nullptr if it could not be parsed.
+   */
+  PrivateKeySharedPtr privateKey(absl::string_view pem, absl::string_view password);
+
+  /**
+   * @return size_t the number of live entries in the cache. Used by tests.
+   */
+  size_t size();
+
+private:
+  template <class T>
+  using EntryMap = absl::flat_hash_map<std::string, std::weak_ptr<T>>;
+
+  template <class T, class ParseFn>
+  std::shared_ptr<T> findOrParse(EntryMap<T>& entries, const std::string& key, ParseFn parse)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  Thread::MutexBasicLockable lock_;
+  EntryMap<STACK_OF(X509_INFO)> x509_info_lists_ ABSL_GUARDED_BY(lock_);
+  EntryMap<EVP_PKEY> private_keys_ ABSL_GUARDED_BY(lock_);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,141 @@
+#include "source/extensions/transport_sockets/tls/session_cache.h"
+
+#include <ctime>
+
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/macros.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+bool ClientSessionCache::setSession(SSL* ssl) {
+  if (single_use_) {
+    // Stored single-use session keys, use write/write locks.
+    absl::WriterMutexLock l(&mu_);
+    if (sessions_.empty()) {
+      return false;
+    }
+    SSL_SESSION* session = sessions_.front().get();
+    SSL_set_session(ssl, session);
+    // Remove single-use session key (TLS 1.3) after first use.
+    if (SSL_SESSION_should_be_single_use(session)) {
+      sessions_.pop_front();
+    }
+    return true;
+  }
+
+  // Never stored single-use session keys, use read/write locks.
+  absl::ReaderMutexLock l(&mu_);
+  if (sessions_.empty()) {
+    return false;
+  }
+  SSL_set_session(ssl, sessions_.front().get());
+  return true;
+}
+
+void ClientSessionCache::addSession(bssl::UniquePtr<SSL_SESSION> session) {
+  // In case we ever store single-use session key (TLS 1.3),
+  // we need to switch to using write/write locks.
+  if (SSL_SESSION_should_be_single_use(session.get())) {
+    single_use_ = true;
+  }
+  absl::WriterMutexLock l(&mu_);
+  // Evict oldest entries.
+  while (sessions_.size() >= max_sessions_) {
+    sessions_.pop_back();
+  }
+  // Add new session key at the front of the queue, so that it's used first.
+  sessions_.push_front(std::move(session));
+}
+
+void ServerSessionCache::addSession(bssl::UniquePtr<SSL_SESSION> session) {
+  unsigned id_length = 0;
+  const uint8_t* id = SSL_SESSION_get_id(session.get(), &id_length);
+  std::string session_id(reinterpret_cast<const char*>(id), id_length);
+
+  absl::MutexLock l(&mu_);
+  auto existing = index_.find(session_id);
+  if (existing != index_.end()) {
+    sessions_.erase(existing->second);
+    index_.erase(existing);
+  }
+  // Like BoringSSL's internal cache, a capacity of zero means unlimited.
+  while (capacity_ > 0 && !sessions_.empty() && sessions_.size() >= capacity_) {
+    index_.erase(sessions_.back().first);
+    sessions_.pop_back();
+  }
+  sessions_.emplace_front(session_id, std::move(session));
+  index_.emplace(std::move(session_id), sessions_.begin());
+}
+
+bssl::UniquePtr<SSL_SESSION> ServerSessionCache::findSession(absl::string_view session_id) {
+  absl::MutexLock l(&mu_);
+  auto it = index_.find(session_id);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  SSL_SESSION* session = it->second->second.get();
+  // BoringSSL only notifies external caches of expired sessions it finds in its internal cache,
+  // which is disabled, so drop them here rather than handing them out to be rejected.
+  if (static_cast<uint64_t>(SSL_SESSION_get_time(session)) + SSL_SESSION_get_timeout(session) <
+      static_cast<uint64_t>(std::time(nullptr))) {
+    sessions_.erase(it->second);
+    index_.erase(it);
+    return nullptr;
+  }
+  sessions_.splice(sessions_.begin(), sessions_, it->second);
+  return bssl::UpRef(it->second->second);
+}
+
+SessionCacheRegistry& SessionCacheRegistry::get() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(SessionCacheRegistry);
+}
+
+template <class T>
+std::shared_ptr<T>
+SessionCacheRegistry::findOrCreate(absl::flat_hash_map<std::string, std::weak_ptr<T>>& caches,
+                                   const std::string& key, size_t size) {
+  auto it = caches.find(key);
+  if (it != caches.end()) {
+    std::shared_ptr<T> existing = it->second.lock();
+    if (existing != nullptr) {
+      return existing;
+    }
+  }
+
+  // Drop caches whose contexts have all gone away; contexts are created rarely enough for this
+  // sweep to be negligible.
+  for (auto entry = caches.begin(); entry != caches.end();) {
+    if (entry->second.expired()) {
+      caches.erase(entry++);
+    } else {
+      ++entry;
+    }
+  }
+  auto cache = std::make_shared<T>(size);
+  caches[key] = cache;
+  return cache;
+}
+
+ClientSessionCacheSharedPtr SessionCacheRegistry::clientCache(const std::string& key,
+                                                              size_t max_sessions) {
+  Thread::LockGuard guard(lock_);
+  // The limit is part of the key, so that contexts only differing in it do not share sessions
+  // under another context's limit.
+  return findOrCreate(client_caches_, absl::StrCat(key, ":", max_sessions), max_sessions);
+}
+
+ServerSessionCacheSharedPtr SessionCacheRegistry::serverCache(const std::string& key,
+                                                              size_t capacity) {
+  Thread::LockGuard guard(lock_);
+  return findOrCreate(server_caches_, key, capacity);
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "source/common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Sessions established by client contexts with one upstream TLS configuration. Every
+ * ClientContextImpl built from an identical configuration shares the same instance, so that
+ * replacing a cluster's TLS context (e.g. on a CDS update or an SDS push of unchanged secrets)
+ * keeps resuming sessions instead of falling back to full handshakes.
+ */
+class ClientSessionCache {
+public:
+  explicit ClientSessionCache(size_t max_sessions) : max_sessions_(max_sessions) {}
+
+  /**
+   * Offers the most recently stored session, which has the highest probability of still being
+   * accepted by the server, for resumption on a new connection. Single-use (TLS 1.3) sessions
+   * are removed once offered.
+   * @param ssl the connection to offer the session on.
+   * @return bool whether a session was offered.
+   */
+  bool setSession(SSL* ssl);
+
+  /**
+   * Stores a new session, evicting the oldest sessions over the configured limit.
+   * @param session the session to store.
+   */
+  void addSession(bssl::UniquePtr<SSL_SESSION> session);
+
+private:
+  const size_t max_sessions_;
+  absl::Mutex mu_;
+  std::deque<bssl::UniquePtr<SSL_SESSION>> sessions_ ABSL_GUARDED_BY(mu_);
+  // Set once a single-use (TLS 1.3) session was stored. From then on offering a session may remove
+  // it, so lookups take the write lock.
+  std::atomic<bool> single_use_{false};
+};
+
+using ClientSessionCacheSharedPtr = std::shared_ptr<ClientSessionCache>;
+
+/**
+ * Stateful (session ID) resumption cache of server contexts with one session ID context and the
+ * same client verification and negotiation settings. This replaces BoringSSL's internal cache,
+ * which is owned by a single SSL_CTX and therefore lost whenever a listener or filter chain update
+ * rebuilds the context.
+ */
+class ServerSessionCache {
+public:
+  explicit ServerSessionCache(size_t capacity) : capacity_(capacity) {}
+
+  /**
+   * Stores a new session, evicting the least recently used sessions over capacity.
+   * @param session the session to store.
+   */
+  void addSession(bssl::UniquePtr<SSL_SESSION> session);
+
+  /**
+   * @param session_id the session ID offered by the client.
+   * @return bssl::UniquePtr<SSL_SESSION> a new reference to the session, or nullptr if it is
+   *         unknown or expired.
+   */
+  bssl::UniquePtr<SSL_SESSION> findSession(absl::string_view session_id);
+
+private:
+  using Entry = std::pair<std::string, bssl::UniquePtr<SSL_SESSION>>;
+
+  const size_t capacity_;
+  absl::Mutex mu_;
+  // Most recently used first.
+  std::list<Entry> sessions_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, std::list<Entry>::iterator> index_ ABSL_GUARDED_BY(mu_);
+};
+
+using ServerSessionCacheSharedPtr = std::shared_ptr<ServerSessionCache>;
+
+/**
+ * Process-wide registry handing out the session caches above. Caches are only weakly referenced
+ * by the registry and live as long as some context uses them.
+ */
+class SessionCacheRegistry {
+public:
+  /**
+   * @return SessionCacheRegistry& the process-wide registry.
+   */
+  static SessionCacheRegistry& get();
+
+  /**
+   * @param key a digest of the client context configuration.
+   * @param max_sessions the maximum number of sessions kept.
+   * @return ClientSessionCacheSharedPtr the cache of contexts with this configuration.
+   */
+  ClientSessionCacheSharedPtr clientCache(const std::string& key, size_t max_sessions);
+
+  /**
+   * @param key a digest of the session ID context and of the server context configuration.
+   * @param capacity the maximum number of sessions kept, used when the cache is created.
+   * @return ServerSessionCacheSharedPtr the cache of contexts with this configuration.
+   */
+  ServerSessionCacheSharedPtr serverCache(const std::string& key, size_t capacity);
+
+private:
+  template <class T>
+  std::shared_ptr<T> findOrCreate(absl::flat_hash_map<std::string, std::weak_ptr<T>>& caches,
+                                  const std::string& key, size_t size)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  Thread::MutexBasicLockable lock_;
+  absl::flat_hash_map<std::string, std::weak_ptr<ClientSessionCache>>
+      client_caches_ ABSL_GUARDED_BY(lock_);
+  absl::flat_hash_map<std::string, std::weak_ptr<ServerSessionCache>>
+      server_caches_ ABSL_GUARDED_BY(lock_);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -28,11 +28,16 @@ namespace Http {
 
 void HttpConnPool::newStream(GenericConnectionPoolCallbacks* callbacks) {
   callbacks_ = callbacks;
+  // Early data may be replayed by an attacker, so only safe requests are sent as early data.
+  stream_options_.can_send_early_data_ =
+      early_data_request_headers_ != nullptr &&
+      Envoy::Http::Utility::isSafeRequest(*early_data_request_headers_,
+                                          callbacks->encodeComplete());
   // It's possible for a reset to happen inline within the newStream() call. In this case, we
   // might get deleted inline as well. Only write the returned handle out if it is not nullptr to
   // deal with this case.
   Envoy::Http::ConnectionPool::Cancellable* handle =
-      pool_data_.value().newStream(callbacks->upstreamToDownstream(), *this);
+      pool_data_.value().newStream(callbacks->upstreamToDownstream(), *this, stream_options_);
   if (handle) {
     conn_pool_stream_handle_ = handle;
   }
@@ -10,7 +10,9 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/logger.h"
 #include "source/common/config/well_known_names.h"
+#include "source/common/http/utility.h"
 #include "source/common/router/upstream_request.h"
+#include "source/common/runtime/runtime_features.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -28,6 +30,10 @@ public:
     ASSERT(!is_connect);
     pool_data_ =
         thread_local_cluster.httpConnPool(route_entry.priority(), downstream_protocol, ctx);
+    if (ctx != nullptr &&
+        Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http3_upstream_early_data")) {
+      early_data_request_headers_ = ctx->downstreamHeaders();
+    }
   }
   ~HttpConnPool() override {
     ASSERT(conn_pool_stream_handle_ == nullptr, "conn_pool_stream_handle not null");
@@ -53,6 +59,9 @@ protected:
   absl::optional<Envoy::Upstream::HttpPoolData> pool_data_{};
   Envoy::Http::ConnectionPool::Cancellable* conn_pool_stream_handle_{};
   Router::GenericConnectionPoolCallbacks* callbacks_{};
+  Envoy::Http::ConnectionPool::StreamOptions stream_options_;
+  // The headers of the request to check for being sent as early data, if that is enabled.
+  const Envoy::Http::RequestHeaderMap* early_data_request_headers_{};
 };
 
 class HttpUpstream : public Router::GenericUpstream, public Envoy::Http::StreamCallbacks {
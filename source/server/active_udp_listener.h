@@ -14,7 +14,9 @@
 namespace Envoy {
 namespace Server {
 
-#define ALL_UDP_LISTENER_STATS(COUNTER) COUNTER(downstream_rx_datagram_dropped)
+#define ALL_UDP_LISTENER_STATS(COUNTER)                                                            \
+  COUNTER(downstream_rx_datagram_dropped)                                                          \
+  COUNTER(downstream_tx_errors)
 
 /**
  * Wrapper struct for UDP listener stats. @see stats_macros.h
@@ -38,6 +40,7 @@ public:
   void onDatagramsDropped(uint32_t dropped) final {
     udp_stats_.downstream_rx_datagram_dropped_.add(dropped);
   }
+  void onSendError(Api::IoError::IoErrorCode) final { udp_stats_.downstream_tx_errors_.inc(); }
 
   // ActiveListenerImplBase
   Network::Listener* listener() override { return udp_listener_.get(); }
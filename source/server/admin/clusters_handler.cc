@@ -48,11 +48,41 @@ Http::Code ClustersHandler::handlerClusters(absl::string_view url,
   Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
   const auto format_value = Utility::formatParam(query_params);
 
+  std::string cursor;
+  uint64_t limit;
+  if (!Utility::pageParams(query_params, response, cursor, limit)) {
+    return Http::Code::BadRequest;
+  }
+
+  // TODO(mattklein123): Add ability to see warming clusters in admin output.
+  auto all_clusters = server_.clusterManager().clusters();
+  std::vector<const Upstream::Cluster*> clusters;
+  if (limit == 0) {
+    clusters.reserve(all_clusters.active_clusters_.size());
+    for (const auto& [name, cluster_ref] : all_clusters.active_clusters_) {
+      UNREFERENCED_PARAMETER(name);
+      clusters.push_back(&cluster_ref.get());
+    }
+  } else {
+    // Only the clusters on the requested page, ordered by name, are rendered.
+    Utility::PageCollector<const Upstream::Cluster*> collector(cursor, limit);
+    for (const auto& [name, cluster_ref] : all_clusters.active_clusters_) {
+      if (collector.accepts(name)) {
+        collector.add(name, &cluster_ref.get());
+      }
+    }
+    std::string next_cursor;
+    for (const auto& entry : collector.finish(next_cursor)) {
+      clusters.push_back(entry.second);
+    }
+    Utility::setNextCursor(response_headers, next_cursor);
+  }
+
   if (format_value.has_value() && format_value.value() == "json") {
-    writeClustersAsJson(response);
+    writeClustersAsJson(clusters, response);
     response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
   } else {
-    writeClustersAsText(response);
+    writeClustersAsText(clusters, response);
   }
 
   return Http::Code::OK;
@@ -105,13 +135,11 @@ void setHealthFlag(Upstream::Host::HealthFlag flag, const Upstream::Host& host,
 }
 
 // TODO(efimki): Add support of text readouts stats.
-void ClustersHandler::writeClustersAsJson(Buffer::Instance& response) {
+void ClustersHandler::writeClustersAsJson(
+    const std::vector<const Upstream::Cluster*>& cluster_list, Buffer::Instance& response) {
   envoy::admin::v3::Clusters clusters;
-  // TODO(mattklein123): Add ability to see warming clusters in admin output.
-  auto all_clusters = server_.clusterManager().clusters();
-  for (const auto& [name, cluster_ref] : all_clusters.active_clusters_) {
-    UNREFERENCED_PARAMETER(name);
-    const Upstream::Cluster& cluster = cluster_ref.get();
+  for (const Upstream::Cluster* cluster_ptr : cluster_list) {
+    const Upstream::Cluster& cluster = *cluster_ptr;
     Upstream::ClusterInfoConstSharedPtr cluster_info = cluster.info();
 
     envoy::admin::v3::ClusterStatus& cluster_status = *clusters.add_cluster_statuses();
@@ -194,12 +222,10 @@ void ClustersHandler::writeClustersAsJson(Buffer::Instance& response) {
 }
 
 // TODO(efimki): Add support of text readouts stats.
-void ClustersHandler::writeClustersAsText(Buffer::Instance& response) {
-  // TODO(mattklein123): Add ability to see warming clusters in admin output.
-  auto all_clusters = server_.clusterManager().clusters();
-  for (const auto& [name, cluster_ref] : all_clusters.active_clusters_) {
-    UNREFERENCED_PARAMETER(name);
-    const Upstream::Cluster& cluster = cluster_ref.get();
+void ClustersHandler::writeClustersAsText(
+    const std::vector<const Upstream::Cluster*>& cluster_list, Buffer::Instance& response) {
+  for (const Upstream::Cluster* cluster_ptr : cluster_list) {
+    const Upstream::Cluster& cluster = *cluster_ptr;
     const std::string& cluster_name = cluster.info()->name();
     response.add(fmt::format("{}::observability_name::{}\n", cluster_name,
                              cluster.info()->observabilityName()));
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
@@ -26,8 +28,10 @@ private:
   void addOutlierInfo(const std::string& cluster_name,
                       const Upstream::Outlier::Detector* outlier_detector,
                       Buffer::Instance& response);
-  void writeClustersAsJson(Buffer::Instance& response);
-  void writeClustersAsText(Buffer::Instance& response);
+  void writeClustersAsJson(const std::vector<const Upstream::Cluster*>& clusters,
+                           Buffer::Instance& response);
+  void writeClustersAsText(const std::vector<const Upstream::Cluster*>& clusters,
+                           Buffer::Instance& response);
 };
 
 } // namespace Server
@@ -9,6 +9,9 @@
 #include "source/server/admin/prometheus_stats.h"
 #include "source/server/admin/utils.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/variant.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -67,6 +70,36 @@ Http::Code StatsHandler::handlerStatsRecentLookupsEnable(absl::string_view,
   return Http::Code::OK;
 }
 
+bool StatsHandler::StatsParams::parse(const Http::Utility::QueryParams& params,
+                                      Buffer::Instance& response) {
+  used_only_ = params.find("usedonly") != params.end();
+  if (!Utility::filterParam(params, response, regex_)) {
+    return false;
+  }
+  prefix_ = Utility::queryParam(params, "prefix").value_or("");
+
+  const absl::optional<std::string> type = Utility::queryParam(params, "type");
+  if (type.has_value()) {
+    static const auto* types = new absl::flat_hash_map<std::string, StatsType>{
+        {"All", StatsType::All},
+        {"TextReadouts", StatsType::TextReadouts},
+        {"Counters", StatsType::Counters},
+        {"Gauges", StatsType::Gauges},
+        {"Histograms", StatsType::Histograms},
+    };
+    const auto it = types->find(type.value());
+    if (it == types->end()) {
+      response.add(fmt::format("Invalid type: \"{}\", expected one of All, TextReadouts, "
+                               "Counters, Gauges, Histograms\n",
+                               type.value()));
+      return false;
+    }
+    type_ = it->second;
+  }
+
+  return Utility::pageParams(params, response, cursor_, limit_);
+}
+
 Http::Code StatsHandler::handlerStats(absl::string_view url,
                                       Http::ResponseHeaderMap& response_headers,
                                       Buffer::Instance& response, AdminStream& admin_stream) {
@@ -74,56 +107,143 @@ Http::Code StatsHandler::handlerStats(absl::string_view url,
     server_.flushStats();
   }
 
-  const Http::Utility::QueryParams params = Http::Utility::parseAndDecodeQueryString(url);
+  const Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
 
-  const bool used_only = params.find("usedonly") != params.end();
-  absl::optional<std::regex> regex;
-  if (!Utility::filterParam(params, response, regex)) {
+  StatsParams params;
+  if (!params.parse(query_params, response)) {
     return Http::Code::BadRequest;
   }
 
+  absl::optional<std::string> format_value = Utility::formatParam(query_params);
+  if (format_value.has_value() && format_value.value() == "prometheus") {
+    return handlerPrometheusStats(url, response_headers, response, admin_stream);
+  }
+  if (format_value.has_value() && format_value.value() != "json") {
+    response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
+    response.add("\n");
+    return Http::Code::NotFound;
+  }
+  const bool json = format_value.has_value();
+
+  if (params.limit_ > 0) {
+    return handlerStatsPage(params, json, response_headers, response);
+  }
+
   std::map<std::string, uint64_t> all_stats;
-  for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
-    if (shouldShowMetric(*counter, used_only, regex)) {
-      all_stats.emplace(counter->name(), counter->value());
+  if (params.showType(StatsType::Counters)) {
+    for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
+      if (shouldShowMetric(*counter, params)) {
+        all_stats.emplace(counter->name(), counter->value());
+      }
     }
   }
 
-  for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
-    if (shouldShowMetric(*gauge, used_only, regex)) {
-      ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
-      all_stats.emplace(gauge->name(), gauge->value());
+  if (params.showType(StatsType::Gauges)) {
+    for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
+      if (shouldShowMetric(*gauge, params)) {
+        ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
+        all_stats.emplace(gauge->name(), gauge->value());
+      }
     }
   }
 
   std::map<std::string, std::string> text_readouts;
-  for (const auto& text_readout : server_.stats().textReadouts()) {
-    if (shouldShowMetric(*text_readout, used_only, regex)) {
-      text_readouts.emplace(text_readout->name(), text_readout->value());
+  if (params.showType(StatsType::TextReadouts)) {
+    for (const auto& text_readout : server_.stats().textReadouts()) {
+      if (shouldShowMetric(*text_readout, params)) {
+        text_readouts.emplace(text_readout->name(), text_readout->value());
+      }
     }
   }
 
-  absl::optional<std::string> format_value = Utility::formatParam(params);
-  if (!format_value.has_value()) {
+  std::vector<Stats::ParentHistogramSharedPtr> histograms;
+  if (params.showType(StatsType::Histograms)) {
+    histograms = server_.stats().histograms();
+  }
+
+  if (!json) {
     // Display plain stats if format query param is not there.
-    statsAsText(all_stats, text_readouts, server_.stats().histograms(), used_only, regex, response);
+    statsAsText(all_stats, text_readouts, histograms, params, response);
     return Http::Code::OK;
   }
 
-  if (format_value.value() == "json") {
-    response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
-    response.add(
-        statsAsJson(all_stats, text_readouts, server_.stats().histograms(), used_only, regex));
-    return Http::Code::OK;
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+  response.add(statsAsJson(all_stats, text_readouts, histograms, params));
+  return Http::Code::OK;
+}
+
+Http::Code StatsHandler::handlerStatsPage(const StatsParams& params, bool json,
+                                          Http::ResponseHeaderMap& response_headers,
+                                          Buffer::Instance& response) {
+  // Select the page across all requested stat types by name, without sorting or copying the
+  // values of stats outside the page. Stats are kept alive by the vectors below while the page is
+  // rendered. Histogram quantile summaries are only computed for histograms on the page.
+  using PageMetric = absl::variant<const Stats::TextReadout*, const Stats::Counter*,
+                                   const Stats::Gauge*, Stats::ParentHistogramSharedPtr>;
+  Utility::PageCollector<PageMetric> collector(params.cursor_, params.limit_);
+
+  const auto collect = [&params, &collector](const auto& metrics, auto to_page_metric) {
+    for (const auto& metric : metrics) {
+      if (!shouldShowMetric(*metric, params)) {
+        continue;
+      }
+      std::string name = metric->name();
+      if (collector.accepts(name)) {
+        collector.add(std::move(name), to_page_metric(metric));
+      }
+    }
+  };
+
+  std::vector<Stats::TextReadoutSharedPtr> text_readouts;
+  if (params.showType(StatsType::TextReadouts)) {
+    text_readouts = server_.stats().textReadouts();
+    collect(text_readouts, [](const Stats::TextReadoutSharedPtr& text_readout) -> PageMetric {
+      return text_readout.get();
+    });
+  }
+  std::vector<Stats::CounterSharedPtr> counters;
+  if (params.showType(StatsType::Counters)) {
+    counters = server_.stats().counters();
+    collect(counters,
+            [](const Stats::CounterSharedPtr& counter) -> PageMetric { return counter.get(); });
+  }
+  std::vector<Stats::GaugeSharedPtr> gauges;
+  if (params.showType(StatsType::Gauges)) {
+    gauges = server_.stats().gauges();
+    collect(gauges, [](const Stats::GaugeSharedPtr& gauge) -> PageMetric { return gauge.get(); });
+  }
+  if (params.showType(StatsType::Histograms)) {
+    collect(server_.stats().histograms(),
+            [](const Stats::ParentHistogramSharedPtr& histogram) -> PageMetric {
+              return histogram;
+            });
   }
 
-  if (format_value.value() == "prometheus") {
-    return handlerPrometheusStats(url, response_headers, response, admin_stream);
+  std::string next_cursor;
+  std::map<std::string, uint64_t> page_stats;
+  std::map<std::string, std::string> page_text_readouts;
+  std::vector<Stats::ParentHistogramSharedPtr> page_histograms;
+  for (auto& [name, metric] : collector.finish(next_cursor)) {
+    if (absl::holds_alternative<const Stats::TextReadout*>(metric)) {
+      page_text_readouts.emplace(name, absl::get<const Stats::TextReadout*>(metric)->value());
+    } else if (absl::holds_alternative<const Stats::Counter*>(metric)) {
+      page_stats.emplace(name, absl::get<const Stats::Counter*>(metric)->value());
+    } else if (absl::holds_alternative<const Stats::Gauge*>(metric)) {
+      page_stats.emplace(name, absl::get<const Stats::Gauge*>(metric)->value());
+    } else {
+      page_histograms.push_back(std::move(absl::get<Stats::ParentHistogramSharedPtr>(metric)));
+    }
   }
+  Utility::setNextCursor(response_headers, next_cursor);
 
-  response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
-  response.add("\n");
-  return Http::Code::NotFound;
+  if (!json) {
+    statsAsText(page_stats, page_text_readouts, page_histograms, params, response);
+    return Http::Code::OK;
+  }
+
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+  response.add(statsAsJson(page_stats, page_text_readouts, page_histograms, params));
+  return Http::Code::OK;
 }
 
 Http::Code StatsHandler::handlerPrometheusStats(absl::string_view path_and_query,
@@ -165,8 +285,7 @@ Http::Code StatsHandler::handlerContention(absl::string_view,
 void StatsHandler::statsAsText(const std::map<std::string, uint64_t>& all_stats,
                                const std::map<std::string, std::string>& text_readouts,
                                const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
-                               bool used_only, const absl::optional<std::regex>& regex,
-                               Buffer::Instance& response) {
+                               const StatsParams& params, Buffer::Instance& response) {
   // Display plain stats if format query param is not there.
   for (const auto& text_readout : text_readouts) {
     response.add(fmt::format("{}: \"{}\"\n", text_readout.first,
@@ -177,7 +296,7 @@ void StatsHandler::statsAsText(const std::map<std::string, uint64_t>& all_stats,
   }
   std::map<std::string, std::string> all_histograms;
   for (const Stats::ParentHistogramSharedPtr& histogram : histograms) {
-    if (shouldShowMetric(*histogram, used_only, regex)) {
+    if (shouldShowMetric(*histogram, params)) {
       auto insert = all_histograms.emplace(histogram->name(), histogram->quantileSummary());
       ASSERT(insert.second); // No duplicates expected.
     }
@@ -191,8 +310,7 @@ std::string
 StatsHandler::statsAsJson(const std::map<std::string, uint64_t>& all_stats,
                           const std::map<std::string, std::string>& text_readouts,
                           const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                          const bool used_only, const absl::optional<std::regex>& regex,
-                          const bool pretty_print) {
+                          const StatsParams& params, const bool pretty_print) {
 
   ProtobufWkt::Struct document;
   std::vector<ProtobufWkt::Value> stats_array;
@@ -220,7 +338,7 @@ StatsHandler::statsAsJson(const std::map<std::string, uint64_t>& all_stats,
 
   bool found_used_histogram = false;
   for (const Stats::ParentHistogramSharedPtr& histogram : all_histograms) {
-    if (shouldShowMetric(*histogram, used_only, regex)) {
+    if (shouldShowMetric(*histogram, params)) {
       if (!found_used_histogram) {
         // It is not possible for the supported quantiles to differ across histograms, so it is ok
         // to send them once.
@@ -9,9 +9,11 @@
 #include "envoy/server/admin.h"
 #include "envoy/server/instance.h"
 
+#include "source/common/http/utility.h"
 #include "source/common/stats/histogram_impl.h"
 #include "source/server/admin/handler_ctx.h"
 
+#include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -48,26 +50,58 @@ public:
                                Buffer::Instance& response, AdminStream&);
 
 private:
+  enum class StatsType { All, TextReadouts, Counters, Gauges, Histograms };
+
+  /**
+   * Filtering and pagination parameters for /stats.
+   */
+  struct StatsParams {
+    bool used_only_{false};
+    absl::optional<std::regex> regex_;
+    std::string prefix_;
+    StatsType type_{StatsType::All};
+    // Only stats whose names sort strictly after the cursor are returned.
+    std::string cursor_;
+    // Maximum number of stats returned per page; 0 disables pagination.
+    uint64_t limit_{0};
+
+    /**
+     * Parses the query parameters, writing any error to `response`.
+     * @return false if the parameters are invalid.
+     */
+    bool parse(const Http::Utility::QueryParams& params, Buffer::Instance& response);
+
+    bool showType(StatsType type) const { return type_ == StatsType::All || type_ == type; }
+  };
+
   template <class StatType>
-  static bool shouldShowMetric(const StatType& metric, const bool used_only,
-                               const absl::optional<std::regex>& regex) {
-    return ((!used_only || metric.used()) &&
-            (!regex.has_value() || std::regex_search(metric.name(), regex.value())));
+  static bool shouldShowMetric(const StatType& metric, const StatsParams& params) {
+    if (params.used_only_ && !metric.used()) {
+      return false;
+    }
+    if (params.prefix_.empty() && !params.regex_.has_value()) {
+      return true;
+    }
+    const std::string name = metric.name();
+    return absl::StartsWith(name, params.prefix_) &&
+           (!params.regex_.has_value() || std::regex_search(name, params.regex_.value()));
   }
 
   friend class AdminStatsTest;
 
+  Http::Code handlerStatsPage(const StatsParams& params, bool json,
+                              Http::ResponseHeaderMap& response_headers,
+                              Buffer::Instance& response);
+
   static std::string statsAsJson(const std::map<std::string, uint64_t>& all_stats,
                                  const std::map<std::string, std::string>& text_readouts,
                                  const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                                 bool used_only, const absl::optional<std::regex>& regex,
-                                 bool pretty_print = false);
+                                 const StatsParams& params, bool pretty_print = false);
 
   void statsAsText(const std::map<std::string, uint64_t>& all_stats,
                    const std::map<std::string, std::string>& text_readouts,
                    const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                   bool used_only, const absl::optional<std::regex>& regex,
-                   Buffer::Instance& response);
+                   const StatsParams& params, Buffer::Instance& response);
 };
 
 } // namespace Server
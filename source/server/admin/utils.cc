@@ -1,8 +1,11 @@
 #include "source/server/admin/utils.h"
 
 #include "source/common/common/enum_to_int.h"
+#include "source/common/common/macros.h"
 #include "source/common/http/headers.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Server {
 namespace Utility {
@@ -68,6 +71,30 @@ absl::optional<std::string> queryParam(const Http::Utility::QueryParams& params,
                                             : absl::nullopt;
 }
 
+// Helper method to get the pagination parameters.
+bool pageParams(const Http::Utility::QueryParams& params, Buffer::Instance& response,
+                std::string& cursor, uint64_t& limit) {
+  cursor = queryParam(params, "cursor").value_or("");
+  limit = 0;
+  const absl::optional<std::string> limit_value = queryParam(params, "limit");
+  if (limit_value.has_value() && (!absl::SimpleAtoi(limit_value.value(), &limit) || limit == 0)) {
+    response.add(fmt::format("Invalid limit: \"{}\", expected a positive integer\n",
+                             limit_value.value()));
+    return false;
+  }
+  return true;
+}
+
+const Http::LowerCaseString& nextCursorHeader() {
+  CONSTRUCT_ON_FIRST_USE(Http::LowerCaseString, "x-envoy-admin-next-cursor");
+}
+
+void setNextCursor(Http::ResponseHeaderMap& response_headers, absl::string_view next_cursor) {
+  if (!next_cursor.empty()) {
+    response_headers.setCopy(nextCursorHeader(), next_cursor);
+  }
+}
+
 } // namespace Utility
 } // namespace Server
 } // namespace Envoy
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <regex>
+#include <string>
+#include <vector>
 
 #include "envoy/admin/v3/server_info.pb.h"
 #include "envoy/init/manager.h"
 
+#include "source/common/common/assert.h"
 #include "source/common/http/codes.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/utility.h"
@@ -26,6 +30,86 @@ absl::optional<std::string> formatParam(const Http::Utility::QueryParams& params
 absl::optional<std::string> queryParam(const Http::Utility::QueryParams& params,
                                        const std::string& key);
 
+/**
+ * Parses the "cursor" and "limit" pagination parameters. A missing limit leaves `limit` at 0,
+ * which disables pagination.
+ * @return false if limit is present but is not a positive integer; an error is written to
+ *         `response` in that case.
+ */
+bool pageParams(const Http::Utility::QueryParams& params, Buffer::Instance& response,
+                std::string& cursor, uint64_t& limit);
+
+/**
+ * Sets the header used to return the cursor of the next page, if there is one.
+ */
+void setNextCursor(Http::ResponseHeaderMap& response_headers, absl::string_view next_cursor);
+
+/**
+ * @return the header carrying the cursor to pass back to obtain the next page of a paginated
+ *         admin response.
+ */
+const Http::LowerCaseString& nextCursorHeader();
+
+/**
+ * Collects one page of entries ordered by name, keeping only the `limit` smallest names sorting
+ * strictly after `cursor` in a bounded max-heap. This costs O(N log limit) per page and never
+ * materializes a sorted copy of the full input. One extra entry is retained to determine whether
+ * a further page exists.
+ */
+template <class T> class PageCollector {
+public:
+  using Entry = std::pair<std::string, T>;
+
+  PageCollector(absl::string_view cursor, uint64_t limit) : cursor_(cursor), limit_(limit) {
+    ASSERT(limit_ > 0);
+  }
+
+  /**
+   * @return whether an entry named `name` would currently be retained. Callers can use this to
+   *         avoid building entries that would be discarded immediately.
+   */
+  bool accepts(absl::string_view name) const {
+    return name > cursor_ && (heap_.size() <= limit_ || name < heap_.front().first);
+  }
+
+  void add(std::string name, T value) {
+    if (!accepts(name)) {
+      return;
+    }
+    heap_.emplace_back(std::move(name), std::move(value));
+    std::push_heap(heap_.begin(), heap_.end(), compare);
+    // The heap is not empty here, and comparing against limit_ + 1 would overflow for the largest
+    // limit.
+    if (heap_.size() - 1 > limit_) {
+      std::pop_heap(heap_.begin(), heap_.end(), compare);
+      heap_.pop_back();
+    }
+  }
+
+  /**
+   * Finalizes the page. The collector must not be used afterwards.
+   * @param next_cursor supplies the cursor for the following page, or is cleared if this is the
+   *        last page.
+   * @return the page entries in ascending name order.
+   */
+  std::vector<Entry> finish(std::string& next_cursor) {
+    std::sort_heap(heap_.begin(), heap_.end(), compare);
+    next_cursor.clear();
+    if (heap_.size() > limit_) {
+      heap_.erase(heap_.begin() + limit_, heap_.end());
+      next_cursor = heap_.back().first;
+    }
+    return std::move(heap_);
+  }
+
+private:
+  static bool compare(const Entry& a, const Entry& b) { return a.first < b.first; }
+
+  const std::string cursor_;
+  const uint64_t limit_;
+  std::vector<Entry> heap_;
+};
+
 } // namespace Utility
 } // namespace Server
 } // namespace Envoy
@@ -224,7 +224,9 @@ void FilterChainManagerImpl::addFilterChains(
         filter_chain_match.source_type(), source_ips, filter_chain_match.source_ports(),
         filter_chain_impl);
 
-    fc_contexts_[*filter_chain] = filter_chain_impl;
+    // Identical filter chain messages have identical matches and were rejected above, so this
+    // is the only time the message is hashed into this manager.
+    fc_contexts_.emplace(*filter_chain, filter_chain_impl);
   }
   convertIPsToTries();
   copyOrRebuildDefaultFilterChain(default_filter_chain, filter_chain_factory_builder,
@@ -507,7 +509,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinatio
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName(
     const ServerNamesMap& server_names_map, const Network::ConnectionSocket& socket) const {
   ASSERT(absl::AsciiStrToLower(socket.requestedServerName()) == socket.requestedServerName());
-  const std::string server_name(socket.requestedServerName());
+  const absl::string_view server_name = socket.requestedServerName();
 
   // Match on exact server name, i.e. "www.example.com" for "www.example.com".
   const auto server_name_exact_match = server_names_map.find(server_name);
@@ -518,7 +520,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
   // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
   size_t pos = server_name.find('.', 1);
   while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
+    const absl::string_view wildcard = server_name.substr(pos);
     const auto server_name_wildcard_match = server_names_map.find(wildcard);
     if (server_name_wildcard_match != server_names_map.end()) {
       return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
@@ -538,7 +540,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForTransportProtocol(
     const TransportProtocolsMap& transport_protocols_map,
     const Network::ConnectionSocket& socket) const {
-  const std::string transport_protocol(socket.detectedTransportProtocol());
+  const absl::string_view transport_protocol = socket.detectedTransportProtocol();
 
   // Match on exact transport protocol, e.g. "tls".
   const auto transport_protocol_match = transport_protocols_map.find(transport_protocol);
@@ -562,28 +564,32 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForApplicatio
   for (const auto& application_protocol : socket.requestedApplicationProtocols()) {
     const auto application_protocol_match = application_protocols_map.find(application_protocol);
     if (application_protocol_match != application_protocols_map.end()) {
-      return findFilterChainForDirectSourceIP(*application_protocol_match->second.second, socket);
+      return findFilterChainForDirectSourceIP(application_protocol_match->second, socket);
     }
   }
 
   // Match on a filter chain without application protocol requirements.
   const auto any_protocol_match = application_protocols_map.find(EMPTY_STRING);
   if (any_protocol_match != application_protocols_map.end()) {
-    return findFilterChainForDirectSourceIP(*any_protocol_match->second.second, socket);
+    return findFilterChainForDirectSourceIP(any_protocol_match->second, socket);
   }
 
   return nullptr;
 }
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDirectSourceIP(
-    const DirectSourceIPsTrie& direct_source_ips_trie,
+    const DirectSourceIPsPair& direct_source_ips_pair,
     const Network::ConnectionSocket& socket) const {
+  if (direct_source_ips_pair.unconditional_filter_chain != nullptr) {
+    return direct_source_ips_pair.unconditional_filter_chain.get();
+  }
+
   auto address = socket.addressProvider().directRemoteAddress();
   if (address->type() != Network::Address::Type::Ip) {
     address = fakeAddress();
   }
 
-  const auto& data = direct_source_ips_trie.getData(address);
+  const auto& data = direct_source_ips_pair.second->getData(address);
   if (!data.empty()) {
     ASSERT(data.size() == 1);
     return findFilterChainForSourceTypes(*data.back(), socket);
@@ -660,6 +666,50 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForSourceIpAn
   return nullptr;
 }
 
+Network::FilterChainSharedPtr FilterChainManagerImpl::findUnconditionalFilterChain(
+    const DirectSourceIPsMap& direct_source_ips_map) {
+  // The catch-all tries only cover the IP families supported by the socket interface, so the
+  // shortcut is only equivalent to a trie lookup when both are supported.
+  if (!Network::SocketInterfaceSingleton::get().ipFamilySupported(AF_INET) ||
+      !Network::SocketInterfaceSingleton::get().ipFamilySupported(AF_INET6)) {
+    return nullptr;
+  }
+  if (direct_source_ips_map.size() != 1) {
+    return nullptr;
+  }
+  const auto direct_source_ip = direct_source_ips_map.find(EMPTY_STRING);
+  if (direct_source_ip == direct_source_ips_map.end()) {
+    return nullptr;
+  }
+
+  const SourceTypesArray& source_types = *direct_source_ip->second;
+  if (!source_types[envoy::config::listener::v3::FilterChainMatch::SAME_IP_OR_LOOPBACK]
+           .first.empty() ||
+      !source_types[envoy::config::listener::v3::FilterChainMatch::EXTERNAL].first.empty()) {
+    return nullptr;
+  }
+  const SourceIPsMap& source_ips_map =
+      source_types[envoy::config::listener::v3::FilterChainMatch::ANY].first;
+  if (source_ips_map.size() != 1) {
+    return nullptr;
+  }
+  const auto source_ip = source_ips_map.find(EMPTY_STRING);
+  if (source_ip == source_ips_map.end()) {
+    return nullptr;
+  }
+
+  // Any source port falls back to the port 0 entry.
+  const SourcePortsMap& source_ports_map = *source_ip->second;
+  if (source_ports_map.size() != 1) {
+    return nullptr;
+  }
+  const auto source_port = source_ports_map.find(0);
+  if (source_port == source_ports_map.end()) {
+    return nullptr;
+  }
+  return source_port->second;
+}
+
 void FilterChainManagerImpl::convertIPsToTries() {
   for (auto& [destination_port, destination_ips_pair] : destination_ports_map_) {
     UNREFERENCED_PARAMETER(destination_port);
@@ -681,7 +731,15 @@ void FilterChainManagerImpl::convertIPsToTries() {
           UNREFERENCED_PARAMETER(transport_protocol);
           for (auto& [application_protocol, direct_source_ips_pair] : application_protocols_map) {
             UNREFERENCED_PARAMETER(application_protocol);
-            auto& [direct_source_ips_map, direct_source_ips_trie] = direct_source_ips_pair;
+            auto& direct_source_ips_map = direct_source_ips_pair.first;
+            // Collapse branches without source conditions, which is the common case for filter
+            // chains that only match on server names, into a direct reference to the filter chain.
+            direct_source_ips_pair.unconditional_filter_chain =
+                findUnconditionalFilterChain(direct_source_ips_map);
+            if (direct_source_ips_pair.unconditional_filter_chain != nullptr) {
+              direct_source_ips_map.clear();
+              continue;
+            }
 
             std::vector<
                 std::pair<SourceTypesArraySharedPtr, std::vector<Network::Address::CidrRange>>>
@@ -693,6 +751,10 @@ void FilterChainManagerImpl::convertIPsToTries() {
                   makeCidrListEntry(direct_source_ip, source_arrays_ptr));
 
               for (auto& [source_ips_map, source_ips_trie] : *source_arrays_ptr) {
+                // Lookups skip source types without entries, so they need no trie.
+                if (source_ips_map.empty()) {
+                  continue;
+                }
                 std::vector<
                     std::pair<SourcePortsMapSharedPtr, std::vector<Network::Address::CidrRange>>>
                     source_ips_list;
@@ -705,7 +767,7 @@ void FilterChainManagerImpl::convertIPsToTries() {
                 source_ips_trie = std::make_unique<SourceIPsTrie>(source_ips_list, true);
               }
             }
-            direct_source_ips_trie =
+            direct_source_ips_pair.second =
                 std::make_unique<DirectSourceIPsTrie>(direct_source_ips_list, true);
           }
         }
@@ -717,7 +779,7 @@ void FilterChainManagerImpl::convertIPsToTries() {
 }
 
 Network::DrainableFilterChainSharedPtr FilterChainManagerImpl::findExistingFilterChain(
-    const envoy::config::listener::v3::FilterChain& filter_chain_message) {
+    const envoy::config::listener::v3::FilterChain& filter_chain_message) const {
   // Origin filter chain manager could be empty if the current is the ancestor.
   const auto* origin = getOriginFilterChainManager();
   if (origin == nullptr) {
@@ -725,8 +787,6 @@ Network::DrainableFilterChainSharedPtr FilterChainManagerImpl::findExistingFilte
   }
   auto iter = origin->fc_contexts_.find(filter_chain_message);
   if (iter != origin->fc_contexts_.end()) {
-    // copy the context to this filter chain manager.
-    fc_contexts_.emplace(filter_chain_message, iter->second);
     return iter->second;
   }
   return nullptr;
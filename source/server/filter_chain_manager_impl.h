@@ -251,6 +251,10 @@ private:
   struct DirectSourceIPsPair {
     DirectSourceIPsMap first;
     DirectSourceIPsTriePtr second;
+    // Set by convertIPsToTries() when no direct source IP, source type, source IP or source port
+    // is configured below this branch, so every connection reaching it matches the same filter
+    // chain. Lookups return it directly and no tries are built for the branch.
+    Network::FilterChainSharedPtr unconditional_filter_chain;
   };
 
   using ApplicationProtocolsMap = absl::flat_hash_map<std::string, DirectSourceIPsPair>;
@@ -334,7 +338,7 @@ private:
   findFilterChainForApplicationProtocols(const ApplicationProtocolsMap& application_protocols_map,
                                          const Network::ConnectionSocket& socket) const;
   const Network::FilterChain*
-  findFilterChainForDirectSourceIP(const DirectSourceIPsTrie& direct_source_ips_trie,
+  findFilterChainForDirectSourceIP(const DirectSourceIPsPair& direct_source_ips_pair,
                                    const Network::ConnectionSocket& socket) const;
   const Network::FilterChain*
   findFilterChainForSourceTypes(const SourceTypesArray& source_types,
@@ -344,10 +348,17 @@ private:
   findFilterChainForSourceIpAndPort(const SourceIPsTrie& source_ips_trie,
                                     const Network::ConnectionSocket& socket) const;
 
-  const FilterChainManagerImpl* getOriginFilterChainManager() { return origin_.value(); }
-  // Duplicate the inherent factory context if any.
-  Network::DrainableFilterChainSharedPtr
-  findExistingFilterChain(const envoy::config::listener::v3::FilterChain& filter_chain_message);
+  // Return the filter chain matched by every connection below a direct source IPs branch, or
+  // nullptr if the branch has any source conditions.
+  static Network::FilterChainSharedPtr
+  findUnconditionalFilterChain(const DirectSourceIPsMap& direct_source_ips_map);
+
+  const FilterChainManagerImpl* getOriginFilterChainManager() const { return origin_.value(); }
+  // Return the filter chain the origin filter chain manager built for the same message, if any, so
+  // that unchanged filter chains, including their transport socket factories, are shared between
+  // listener generations.
+  Network::DrainableFilterChainSharedPtr findExistingFilterChain(
+      const envoy::config::listener::v3::FilterChain& filter_chain_message) const;
 
   // Mapping from filter chain message to filter chain. This is used by LDS response handler to
   // detect the filter chains in the intersection of existing listener and new listener.
@@ -30,6 +30,8 @@
 #include "source/server/listener_manager_impl.h"
 #include "source/server/transport_socket_config_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+
 #ifdef ENVOY_ENABLE_QUIC
 #include "source/common/quic/active_quic_listener.h"
 #include "source/common/quic/udp_gso_batch_writer.h"
@@ -431,6 +433,13 @@ void ListenerImpl::buildUdpListenerFactory(Network::Socket::Type socket_type,
   } else {
     udp_listener_config_->listener_factory_ =
         std::make_unique<Server::ActiveRawUdpListenerFactory>(concurrency);
+    // Datagrams held by the GSO writer are flushed by the listener at the end of each event loop
+    // iteration, so any UDP listener filter can use it.
+    if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_.udp_listener_config().downstream_socket_config(),
+                                        prefer_gso, false) &&
+        Api::OsSysCallsSingleton::get().supportsUdpGso()) {
+      udp_listener_config_->writer_factory_ = std::make_unique<Network::UdpGsoWriterFactory>();
+    }
   }
   udp_listener_config_->listener_worker_router_ =
       std::make_unique<Network::UdpListenerWorkerRouterImpl>(concurrency);
@@ -754,10 +763,19 @@ ListenerImpl::newListenerWithFilterChain(const envoy::config::listener::v3::List
 
 void ListenerImpl::diffFilterChain(const ListenerImpl& another_listener,
                                    std::function<void(Network::DrainableFilterChain&)> callback) {
+  const auto& another_filter_chains =
+      another_listener.filter_chain_manager_.filterChainsByMessage();
+  // Filter chains that did not change were shared with the other listener when it was built, so
+  // identity settles nearly every filter chain without hashing and comparing its message again.
+  absl::flat_hash_set<const Network::DrainableFilterChain*> shared_filter_chains;
+  shared_filter_chains.reserve(another_filter_chains.size());
+  for (const auto& message_and_filter_chain : another_filter_chains) {
+    shared_filter_chains.insert(message_and_filter_chain.second.get());
+  }
   for (const auto& message_and_filter_chain : filter_chain_manager_.filterChainsByMessage()) {
-    if (another_listener.filter_chain_manager_.filterChainsByMessage().find(
-            message_and_filter_chain.first) ==
-        another_listener.filter_chain_manager_.filterChainsByMessage().end()) {
+    if (!shared_filter_chains.contains(message_and_filter_chain.second.get()) &&
+        another_filter_chains.find(message_and_filter_chain.first) ==
+            another_filter_chains.end()) {
       // The filter chain exists in `this` listener but not in the listener passed in.
       callback(*message_and_filter_chain.second);
     }
@@ -766,6 +784,8 @@ void ListenerImpl::diffFilterChain(const ListenerImpl& another_listener,
   // indexed by message.
   if (auto eq = MessageUtil();
       filter_chain_manager_.defaultFilterChainMessage().has_value() &&
+      filter_chain_manager_.defaultFilterChain() !=
+          another_listener.filter_chain_manager_.defaultFilterChain() &&
       (!another_listener.filter_chain_manager_.defaultFilterChainMessage().has_value() ||
        !eq(*another_listener.filter_chain_manager_.defaultFilterChainMessage(),
            *filter_chain_manager_.defaultFilterChainMessage()))) {
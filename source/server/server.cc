@@ -36,6 +36,7 @@
 #include "source/common/local_info/local_info_impl.h"
 #include "source/common/memory/stats.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/network/shared_dns_cache_impl.h"
 #include "source/common/network/socket_interface.h"
 #include "source/common/network/socket_interface_impl.h"
 #include "source/common/network/tcp_listener_impl.h"
@@ -257,10 +258,41 @@ void InstanceImpl::updateServerStats() {
 void InstanceImpl::flushStatsInternal() {
   updateServerStats();
   auto& stats_config = config_.statsConfig();
-  InstanceUtil::flushMetricsToSinks(stats_config.sinks(), stats_store_, timeSource());
+  Stats::HistogramCompletableTimespanImpl main_thread_timer(
+      server_stats_->stats_flush_main_thread_ms_, timeSource());
+  if (stats_flush_thread_ == nullptr) {
+    InstanceUtil::flushMetricsToSinks(stats_config.sinks(), stats_store_, timeSource());
+    main_thread_timer.complete();
+    onStatsFlushComplete();
+    return;
+  }
+
+  // The snapshot is taken on the main thread, which also latches the counters. Sinks that cannot
+  // run off the main thread are flushed inline and the rest are handed to the flush thread. The
+  // flush remains in progress until the flush thread is done with the snapshot, so histograms are
+  // not merged while the flush thread may be reading them.
+  auto snapshot = std::make_shared<MetricSnapshotImpl>(stats_store_, timeSource());
+  StatsFlushThread::SinkList thread_sinks;
+  for (const Stats::SinkPtr& sink : stats_config.sinks()) {
+    if (sink->flushOffMainThread()) {
+      thread_sinks.emplace_back(*sink);
+    } else {
+      sink->flush(*snapshot);
+    }
+  }
+  main_thread_timer.complete();
+  stats_flush_thread_->flush(std::move(snapshot), std::move(thread_sinks),
+                             [this](std::chrono::milliseconds flush_duration) -> void {
+                               server_stats_->stats_flush_thread_ms_.recordValue(
+                                   flush_duration.count());
+                               onStatsFlushComplete();
+                             });
+}
+
+void InstanceImpl::onStatsFlushComplete() {
   // TODO(ramaraochavali): consider adding different flush interval for histograms.
   if (stat_flush_timer_ != nullptr) {
-    stat_flush_timer_->enableTimer(stats_config.flushInterval());
+    stat_flush_timer_->enableTimer(config_.statsConfig().flushInterval());
   }
 
   stats_flush_in_progress_ = false;
@@ -587,6 +619,17 @@ void InstanceImpl::initialize(const Options& options,
     dns_resolver_options.set_use_tcp_for_dns_lookups(bootstrap_.use_tcp_for_dns_lookups());
   }
   dns_resolver_ = dispatcher_->createDnsResolver(resolvers, dns_resolver_options);
+  if (bootstrap_.has_shared_dns_cache()) {
+    // Clusters resolving with the default resolver share its answers through the cache, and so do
+    // the dynamic forward proxy DNS caches which find it in the singleton manager.
+    auto shared_dns_cache = std::make_shared<Network::SharedDnsCacheImpl>(
+        dns_resolver_, time_source_,
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::milliseconds(
+            PROTOBUF_GET_MS_OR_DEFAULT(bootstrap_.shared_dns_cache(), max_ttl, 60000))),
+        stats_store_);
+    Network::SharedDnsCacheImpl::registerSingleton(*singleton_manager_, shared_dns_cache);
+    dns_resolver_ = shared_dns_cache;
+  }
 
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       *admin_, Runtime::LoaderSingleton::get(), stats_store_, thread_local_, dns_resolver_,
@@ -594,6 +637,12 @@ void InstanceImpl::initialize(const Options& options,
       messageValidationContext(), *api_, http_context_, grpc_context_, router_context_,
       access_log_manager_, *singleton_manager_, options_);
 
+  // The stats flush thread must be registered with thread local storage before the configuration
+  // creates the stats sinks, which may allocate thread local slots.
+  if (bootstrap_.stats_flush_on_dedicated_thread()) {
+    stats_flush_thread_ = std::make_unique<StatsFlushThread>(*api_, thread_local_, *dispatcher_);
+  }
+
   // Now the configuration gets parsed. The configuration may start setting
   // thread local data per above. See MainImpl::initialize() for why ConfigImpl
   // is constructed as part of the InstanceImpl and then populated once
@@ -631,6 +680,9 @@ void InstanceImpl::initialize(const Options& options,
     stat_flush_timer_ = dispatcher_->createTimer([this]() -> void { flushStats(); });
     stat_flush_timer_->enableTimer(stats_config.flushInterval());
   }
+  if (stats_flush_thread_ != nullptr) {
+    stats_flush_thread_->start();
+  }
 
   // Now that we are initialized, notify the bootstrap extensions.
   for (auto&& bootstrap_extension : bootstrap_extensions_) {
@@ -851,6 +903,14 @@ void InstanceImpl::terminate() {
     listener_manager_->stopWorkers();
   }
 
+  // Stop the stats flush thread so that the final flush below runs inline. A flush that was in
+  // progress on the thread will not deliver its completion, as the main dispatcher has exited.
+  if (stats_flush_thread_ != nullptr) {
+    stats_flush_thread_->stop();
+    stats_flush_thread_.reset();
+    stats_flush_in_progress_ = false;
+  }
+
   // Only flush if we have not been hot restarted.
   if (stat_flush_timer_) {
     flushStats();
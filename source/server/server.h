@@ -42,6 +42,7 @@
 #include "source/server/listener_hooks.h"
 #include "source/server/listener_manager_impl.h"
 #include "source/server/overload_manager_impl.h"
+#include "source/server/stats_flush_thread.h"
 #include "source/server/worker_impl.h"
 
 #include "absl/container/node_hash_map.h"
@@ -86,7 +87,9 @@ struct ServerCompilationSettingsStats {
   GAUGE(total_connections, Accumulate)                                                             \
   GAUGE(uptime, Accumulate)                                                                        \
   GAUGE(version, NeverImport)                                                                      \
-  HISTOGRAM(initialization_time_ms, Milliseconds)
+  HISTOGRAM(initialization_time_ms, Milliseconds)                                                  \
+  HISTOGRAM(stats_flush_main_thread_ms, Milliseconds)                                              \
+  HISTOGRAM(stats_flush_thread_ms, Milliseconds)
 
 struct ServerStats {
   ALL_SERVER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
@@ -298,6 +301,7 @@ private:
 
   ProtobufTypes::MessagePtr dumpBootstrapConfig();
   void flushStatsInternal();
+  void onStatsFlushComplete();
   void updateServerStats();
   void initialize(const Options& options, Network::Address::InstanceConstSharedPtr local_address,
                   ComponentFactory& component_factory);
@@ -357,6 +361,7 @@ private:
   Configuration::MainImpl config_;
   Network::DnsResolverSharedPtr dns_resolver_;
   Event::TimerPtr stat_flush_timer_;
+  StatsFlushThreadPtr stats_flush_thread_;
   DrainManagerPtr drain_manager_;
   AccessLog::AccessLogManagerImpl access_log_manager_;
   std::unique_ptr<Upstream::ClusterManagerFactory> cluster_manager_factory_;
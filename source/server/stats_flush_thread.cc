@@ -0,0 +1,59 @@
+#include "source/server/stats_flush_thread.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Server {
+
+StatsFlushThread::StatsFlushThread(Api::Api& api, ThreadLocal::Instance& tls,
+                                   Event::Dispatcher& main_thread_dispatcher)
+    : api_(api), tls_(tls), main_thread_dispatcher_(main_thread_dispatcher),
+      dispatcher_(api.allocateDispatcher("stats_flush")) {
+  tls_.registerThread(*dispatcher_, false);
+}
+
+StatsFlushThread::~StatsFlushThread() { stop(); }
+
+void StatsFlushThread::start() {
+  ASSERT(!thread_);
+  // Thread names are limited to 15 characters, see WorkerImpl::start().
+  Thread::Options options{"stats_flush"};
+  thread_ = api_.threadFactory().createThread([this]() -> void { threadRoutine(); }, options);
+}
+
+void StatsFlushThread::stop() {
+  if (thread_) {
+    dispatcher_->exit();
+    thread_->join();
+    thread_.reset();
+  }
+}
+
+void StatsFlushThread::flush(std::shared_ptr<Stats::MetricSnapshot> snapshot, SinkList sinks,
+                             FlushCompleteCb flush_complete) {
+  ASSERT(main_thread_dispatcher_.isThreadSafe());
+  dispatcher_->post([this, snapshot = std::move(snapshot), sinks = std::move(sinks),
+                     flush_complete = std::move(flush_complete)]() mutable -> void {
+    const MonotonicTime start = dispatcher_->timeSource().monotonicTime();
+    for (Stats::Sink& sink : sinks) {
+      sink.flush(*snapshot);
+    }
+    // Release the snapshot before notifying the main thread, which may then mutate the stats.
+    snapshot.reset();
+    const auto flush_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        dispatcher_->timeSource().monotonicTime() - start);
+    main_thread_dispatcher_.post(
+        [flush_complete, flush_duration]() -> void { flush_complete(flush_duration); });
+  });
+}
+
+void StatsFlushThread::threadRoutine() {
+  ENVOY_LOG(debug, "stats flush thread entering dispatch loop");
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ENVOY_LOG(debug, "stats flush thread exited dispatch loop");
+  dispatcher_->shutdown();
+  tls_.shutdownThread();
+}
+
+} // namespace Server
+} // namespace Envoy
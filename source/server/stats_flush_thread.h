@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/stats/sink.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/logger.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Runs stats sink flushes on a dedicated thread with its own dispatcher. The metric snapshot is
+ * taken on the main thread and handed over to this thread, which invokes the sinks and then posts
+ * the completion back to the main thread. The thread is registered with thread local storage so
+ * that sinks keeping per-thread state (e.g. statsd writers) work unchanged.
+ */
+class StatsFlushThread : Logger::Loggable<Logger::Id::main> {
+public:
+  using SinkList = std::vector<std::reference_wrapper<Stats::Sink>>;
+  using FlushCompleteCb = std::function<void(std::chrono::milliseconds flush_duration)>;
+
+  StatsFlushThread(Api::Api& api, ThreadLocal::Instance& tls,
+                   Event::Dispatcher& main_thread_dispatcher);
+  ~StatsFlushThread();
+
+  /**
+   * Starts the flush thread. Flushes requested before this are queued until the thread runs.
+   */
+  void start();
+
+  /**
+   * Stops the flush thread, waiting for an in-progress flush to complete. Completions of flushes
+   * that have not been delivered to the main thread yet are dropped.
+   */
+  void stop();
+
+  /**
+   * Flushes a snapshot to a set of sinks on the flush thread. Must be called on the main thread.
+   * @param snapshot supplies the snapshot, which is released on the flush thread once all sinks
+   *        have been flushed. The stats it references must not be mutated by the caller until
+   *        flush_complete is invoked.
+   * @param sinks supplies the sinks to flush, which must outlive the flush thread.
+   * @param flush_complete is invoked on the main thread with the time spent in the sinks.
+   */
+  void flush(std::shared_ptr<Stats::MetricSnapshot> snapshot, SinkList sinks,
+             FlushCompleteCb flush_complete);
+
+private:
+  void threadRoutine();
+
+  Api::Api& api_;
+  ThreadLocal::Instance& tls_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  Event::DispatcherPtr dispatcher_;
+  Thread::ThreadPtr thread_;
+};
+
+using StatsFlushThreadPtr = std::unique_ptr<StatsFlushThread>;
+
+} // namespace Server
+} // namespace Envoy
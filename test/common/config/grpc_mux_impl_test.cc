@@ -1,3 +1,4 @@
+#include <list>
 #include <memory>
 
 #include "envoy/api/v2/discovery.pb.h"
@@ -6,6 +7,8 @@
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
 #include "source/common/common/empty_string.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/thread.h"
 #include "source/common/config/api_version.h"
 #include "source/common/config/grpc_mux_impl.h"
 #include "source/common/config/protobuf_link_hacks.h"
@@ -25,6 +28,7 @@
 #include "test/test_common/resources.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_time.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -73,6 +77,15 @@ public:
         true);
   }
 
+  void setupWithDecodePool(uint32_t decode_threads) {
+    grpc_mux_ = std::make_unique<GrpcMuxImpl>(
+        local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
+        *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
+            "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
+        envoy::config::core::v3::ApiVersion::AUTO, random_, stats_, rate_limit_settings_, true,
+        std::make_unique<DecodeThreadPool>(Thread::threadFactoryForTest(), decode_threads));
+  }
+
   void expectSendMessage(const std::string& type_url,
                          const std::vector<std::string>& resource_names, const std::string& version,
                          bool first = false, const std::string& nonce = "",
@@ -655,6 +668,196 @@ TEST_F(GrpcMuxImplTest, SingleWatcherWithEmptyUpdates) {
   grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
 }
 
+class GrpcMuxImplDecodePoolTest : public GrpcMuxImplTest {
+public:
+  GrpcMuxImplDecodePoolTest() {
+    // Completions are posted from the decode pool, so run them on the test thread instead.
+    ON_CALL(dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      Thread::LockGuard lock(mutex_);
+      posted_.push_back(std::move(cb));
+      posted_cond_var_.notifyAll();
+    }));
+  }
+
+  // Waits for the decode pool to post a completion and runs it.
+  void runPostedCallback() {
+    Event::PostCb cb;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (posted_.empty()) {
+        posted_cond_var_.wait(mutex_);
+      }
+      cb = std::move(posted_.front());
+      posted_.pop_front();
+    }
+    cb();
+  }
+
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar posted_cond_var_;
+  std::list<Event::PostCb> posted_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Validate that responses decoded on the decode pool are applied in order on the main thread.
+TEST_F(GrpcMuxImplDecodePoolTest, DecodeOnThreadPool) {
+  setupWithDecodePool(2);
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x", "y", "z"}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x", "y", "z"}, "", true);
+  grpc_mux_->start();
+
+  const auto make_response = [&type_url](const std::string& version) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_version_info(version);
+    for (const char* name : {"x", "y", "z"}) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+      load_assignment.set_cluster_name(name);
+      response->add_resources()->PackFrom(load_assignment);
+    }
+    return response;
+  };
+
+  // Neither response is applied until it has been decoded.
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _)).Times(0);
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(make_response("1"));
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(make_response("2"));
+  EXPECT_EQ(2, stats_.gauge("control_plane.decode_pending_responses",
+                            Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+  testing::Mock::VerifyAndClearExpectations(&callbacks_);
+
+  for (const std::string& version : std::vector<std::string>{"1", "2"}) {
+    EXPECT_CALL(callbacks_, onConfigUpdate(_, version))
+        .WillOnce(
+            Invoke([](const std::vector<DecodedResourceRef>& resources, const std::string&) {
+              ASSERT_EQ(3, resources.size());
+              EXPECT_EQ("x", resources[0].get().name());
+              EXPECT_EQ("y", resources[1].get().name());
+              EXPECT_EQ("z", resources[2].get().name());
+            }));
+    expectSendMessage(type_url, {"x", "y", "z"}, version);
+    runPostedCallback();
+  }
+  EXPECT_EQ(0, stats_.gauge("control_plane.decode_pending_responses",
+                            Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+
+  expectSendMessage(type_url, {}, "2");
+}
+
+// Validate that resources failing validation on the decode pool reject the update.
+TEST_F(GrpcMuxImplDecodePoolTest, DecodeErrorOnThreadPool) {
+  setupWithDecodePool(2);
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto foo_sub = grpc_mux_->addWatch(type_url, {}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {}, "", true);
+  grpc_mux_->start();
+
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_version_info("1");
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  response->add_resources()->PackFrom(load_assignment);
+  // The cluster name is required.
+  load_assignment.clear_cluster_name();
+  response->add_resources()->PackFrom(load_assignment);
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _)).Times(0);
+  EXPECT_CALL(callbacks_, onConfigUpdateFailed(ConfigUpdateFailureReason::UpdateRejected, _))
+      .WillOnce(Invoke([](ConfigUpdateFailureReason, const EnvoyException* e) {
+        EXPECT_THAT(e->what(), testing::HasSubstr("ClusterName: value length must be at least"));
+      }));
+  EXPECT_CALL(async_stream_, sendMessageRaw_(_, false));
+  runPostedCallback();
+}
+
+// Validate that a response still being decoded when its stream is reset is dropped instead of
+// being applied and acknowledged with a nonce of the old stream.
+TEST_F(GrpcMuxImplDecodePoolTest, StreamResetDuringDecode) {
+  setupWithDecodePool(2);
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x"}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x"}, "", true);
+  grpc_mux_->start();
+
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_version_info("1");
+  response->set_nonce("stale");
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  response->add_resources()->PackFrom(load_assignment);
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+
+  EXPECT_CALL(callbacks_, onConfigUpdateFailed(ConfigUpdateFailureReason::ConnectionFailure, _));
+  grpc_mux_->grpcStreamForTest().onRemoteClose(Grpc::Status::WellKnownGrpcStatus::Canceled, "");
+  EXPECT_EQ(0, stats_.gauge("control_plane.decode_pending_responses",
+                            Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x"}, "", true);
+  grpc_mux_->grpcStreamForTest().establishNewStream();
+  testing::Mock::VerifyAndClearExpectations(&async_stream_);
+
+  // The decode completes after the new stream is established, and is ignored.
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _)).Times(0);
+  EXPECT_CALL(async_stream_, sendMessageRaw_(_, _)).Times(0);
+  runPostedCallback();
+  testing::Mock::VerifyAndClearExpectations(&async_stream_);
+
+  expectSendMessage(type_url, {}, "");
+}
+
+// Validate that destroying the watch whose decoder a response is being decoded with does not
+// wait for the decode, and that the response is then decoded on the main thread.
+TEST_F(GrpcMuxImplDecodePoolTest, WatchDestroyedDuringDecode) {
+  setupWithDecodePool(2);
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      other_resource_decoder("cluster_name");
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x"}, callbacks_, resource_decoder, {});
+  // The most recent watch is the one responses are decoded with.
+  auto bar_sub = grpc_mux_->addWatch(type_url, {"x"}, callbacks_, other_resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x"}, "", true);
+  grpc_mux_->start();
+
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_version_info("1");
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  response->add_resources()->PackFrom(load_assignment);
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+
+  expectSendMessage(type_url, {"x"}, "");
+  bar_sub.reset();
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1"))
+      .WillOnce(Invoke([](const std::vector<DecodedResourceRef>& resources, const std::string&) {
+        ASSERT_EQ(1, resources.size());
+        EXPECT_EQ("x", resources[0].get().name());
+      }));
+  expectSendMessage(type_url, {"x"}, "1");
+  runPostedCallback();
+
+  expectSendMessage(type_url, {}, "1");
+}
+
 // Exactly one test requires a mock time system to provoke behavior that cannot
 // easily be achieved with a SimulatedTimeSystem.
 class GrpcMuxImplTestWithMockTimeSystem : public GrpcMuxImplTestBase {
@@ -31,8 +31,8 @@ public:
 
 class TestPendingStream : public PendingStream {
 public:
-  TestPendingStream(ConnPoolImplBase& parent, AttachContext& context)
-      : PendingStream(parent), context_(context) {}
+  TestPendingStream(ConnPoolImplBase& parent, AttachContext& context, bool can_send_early_data)
+      : PendingStream(parent, can_send_early_data), context_(context) {}
   AttachContext& context() override { return context_; }
   AttachContext& context_;
 };
@@ -40,8 +40,9 @@ public:
 class TestConnPoolImplBase : public ConnPoolImplBase {
 public:
   using ConnPoolImplBase::ConnPoolImplBase;
-  ConnectionPool::Cancellable* newPendingStream(AttachContext& context) override {
-    auto entry = std::make_unique<TestPendingStream>(*this, context);
+  ConnectionPool::Cancellable* newPendingStream(AttachContext& context,
+                                                bool can_send_early_data) override {
+    auto entry = std::make_unique<TestPendingStream>(*this, context, can_send_early_data);
     return addPendingStream(std::move(entry));
   }
   MOCK_METHOD(ActiveClientPtr, instantiateActiveClient, ());
@@ -107,7 +108,7 @@ TEST_F(ConnPoolImplBaseTest, BasicPreconnect) {
   // On new stream, create 2 connections.
   CHECK_STATE(0 /*active*/, 0 /*pending*/, 0 /*connecting capacity*/);
   EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
-  auto cancelable = pool_.newStream(context_);
+  auto cancelable = pool_.newStream(context_, false);
   CHECK_STATE(0 /*active*/, 1 /*pending*/, 2 /*connecting capacity*/);
 
   cancelable->cancel(ConnectionPool::CancelPolicy::CloseExcess);
@@ -123,13 +124,13 @@ TEST_F(ConnPoolImplBaseTest, PreconnectOnDisconnect) {
 
   // On new stream, create 2 connections.
   EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
-  pool_.newStream(context_);
+  pool_.newStream(context_, false);
   CHECK_STATE(0 /*active*/, 1 /*pending*/, 2 /*connecting capacity*/);
 
   // If a connection fails, existing connections are purged. If a retry causes
   // a new stream, make sure we create the correct number of connections.
   EXPECT_CALL(pool_, onPoolFailure).WillOnce(InvokeWithoutArgs([&]() -> void {
-    pool_.newStream(context_);
+    pool_.newStream(context_, false);
   }));
   EXPECT_CALL(pool_, instantiateActiveClient);
   clients_[0]->close();
@@ -148,7 +149,7 @@ TEST_F(ConnPoolImplBaseTest, NoPreconnectIfUnhealthy) {
 
   // On new stream, create 1 connection.
   EXPECT_CALL(pool_, instantiateActiveClient);
-  auto cancelable = pool_.newStream(context_);
+  auto cancelable = pool_.newStream(context_, false);
   CHECK_STATE(0 /*active*/, 1 /*pending*/, 1 /*connecting capacity*/);
 
   cancelable->cancel(ConnectionPool::CancelPolicy::CloseExcess);
@@ -165,7 +166,7 @@ TEST_F(ConnPoolImplBaseTest, NoPreconnectIfDegraded) {
 
   // On new stream, create 1 connection.
   EXPECT_CALL(pool_, instantiateActiveClient);
-  auto cancelable = pool_.newStream(context_);
+  auto cancelable = pool_.newStream(context_, false);
 
   cancelable->cancel(ConnectionPool::CancelPolicy::CloseExcess);
   pool_.destructAllConnections();
@@ -201,5 +202,71 @@ TEST_F(ConnPoolImplBaseTest, ExplicitPreconnectNotHealthy) {
   EXPECT_FALSE(pool_.maybePreconnect(1));
 }
 
+// Once a connection can send early data, only the streams that may be sent as early data are
+// attached to it, and the others wait for the handshake to complete.
+TEST_F(ConnPoolImplBaseTest, EarlyData) {
+  concurrent_streams_ = 2;
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  EXPECT_NE(nullptr, pool_.newStream(context_, false));
+  EXPECT_NE(nullptr, pool_.newStream(context_, true));
+  CHECK_STATE(0 /*active*/, 2 /*pending*/, 2 /*connecting capacity*/);
+
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[0]->onEvent(Network::ConnectionEvent::ConnectedZeroRtt);
+  EXPECT_EQ(ActiveClient::State::READY_FOR_EARLY_DATA, clients_[0]->state());
+  EXPECT_EQ(1, cluster_->stats_.upstream_cx_connect_with_0_rtt_.value());
+  CHECK_STATE(1 /*active*/, 1 /*pending*/, 1 /*connecting capacity*/);
+
+  // The capacity left on the client sending early data is counted for the waiting stream, so only
+  // another stream needs a new connection.
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  EXPECT_NE(nullptr, pool_.newStream(context_, false));
+  CHECK_STATE(1 /*active*/, 2 /*pending*/, 3 /*connecting capacity*/);
+
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(ActiveClient::State::BUSY, clients_[0]->state());
+  CHECK_STATE(2 /*active*/, 1 /*pending*/, 2 /*connecting capacity*/);
+
+  EXPECT_CALL(pool_, onPoolFailure);
+  pool_.destructAllConnections();
+}
+
+// New streams that may be sent as early data are attached to a connection sending early data.
+TEST_F(ConnPoolImplBaseTest, EarlyDataNewStream) {
+  concurrent_streams_ = 2;
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  EXPECT_NE(nullptr, pool_.newStream(context_, true));
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[0]->onEvent(Network::ConnectionEvent::ConnectedZeroRtt);
+
+  EXPECT_CALL(pool_, onPoolReady);
+  EXPECT_EQ(nullptr, pool_.newStream(context_, true));
+  CHECK_STATE(2 /*active*/, 0 /*pending*/, 0 /*connecting capacity*/);
+
+  // The handshake completing leaves the client in the state matching its streams.
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(ActiveClient::State::BUSY, clients_[0]->state());
+  pool_.destructAllConnections();
+}
+
+// A connection closing before its handshake completes is a connect failure, even if it was
+// sending early data.
+TEST_F(ConnPoolImplBaseTest, EarlyDataConnectFailure) {
+  concurrent_streams_ = 2;
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  pool_.newStream(context_, true);
+  pool_.newStream(context_, false);
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[0]->onEvent(Network::ConnectionEvent::ConnectedZeroRtt);
+
+  // The stream waiting for the handshake is failed.
+  EXPECT_CALL(pool_, onPoolFailure);
+  clients_[0]->close();
+  EXPECT_EQ(1, cluster_->stats_.upstream_cx_connect_fail_.value());
+  CHECK_STATE(1 /*active*/, 0 /*pending*/, 0 /*connecting capacity*/);
+  pool_.destructAllConnections();
+}
+
 } // namespace ConnectionPool
 } // namespace Envoy
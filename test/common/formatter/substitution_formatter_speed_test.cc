@@ -1,5 +1,7 @@
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/formatter/substitution_formatter.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/protobuf/utility.h"
 
 #include "test/common/stream_info/test_util.h"
 #include "test/mocks/http/mocks.h"
@@ -81,6 +83,34 @@ static void BM_AccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_AccessLogFormatter);
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_AccessLogFormatterToBuffer(benchmark::State& state) {
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
+  static const char* LogFormat =
+      "%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT% %START_TIME(%Y/%m/%dT%H:%M:%S%z %s)% "
+      "%REQ(:METHOD)% "
+      "%REQ(X-FORWARDED-PROTO)%://%REQ(:AUTHORITY)%%REQ(X-ENVOY-ORIGINAL-PATH?:PATH)% %PROTOCOL% "
+      "s%RESPONSE_CODE% %BYTES_SENT% %DURATION% %REQ(REFERER)% \"%REQ(USER-AGENT)%\" - - -\n";
+
+  std::unique_ptr<Envoy::Formatter::FormatterImpl> formatter =
+      std::make_unique<Envoy::Formatter::FormatterImpl>(LogFormat, false);
+
+  size_t output_bytes = 0;
+  Http::TestRequestHeaderMapImpl request_headers;
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  std::string body;
+  Buffer::OwnedImpl buffer;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    formatter->formatToBuffer(request_headers, response_headers, response_trailers, *stream_info,
+                              body, buffer);
+    output_bytes += buffer.length();
+    buffer.drain(buffer.length());
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_AccessLogFormatterToBuffer);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_StructAccessLogFormatter(benchmark::State& state) {
   std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
@@ -122,6 +152,29 @@ static void BM_TypedStructAccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_TypedStructAccessLogFormatter);
 
+// Serializes the StructFormatter output through protobuf JSON, for comparison with the direct JSON
+// writer used by JsonFormatterImpl.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StructJsonAccessLogFormatter(benchmark::State& state) {
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
+  std::unique_ptr<Envoy::Formatter::StructFormatter> struct_formatter = makeStructFormatter(false);
+
+  size_t output_bytes = 0;
+  Http::TestRequestHeaderMapImpl request_headers;
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  std::string body;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes += MessageUtil::getJsonStringFromMessageOrDie(
+                        struct_formatter->format(request_headers, response_headers,
+                                                 response_trailers, *stream_info, body),
+                        false, true)
+                        .length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_StructJsonAccessLogFormatter);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_JsonAccessLogFormatter(benchmark::State& state) {
   std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
@@ -7,6 +7,7 @@
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/stream_info/stream_info.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 #include "source/common/common/utility.h"
 #include "source/common/formatter/substitution_formatter.h"
@@ -2609,6 +2610,98 @@ TEST(SubstitutionFormatterTest, JsonFormatterTest) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+TEST(SubstitutionFormatterTest, JsonFormatterOmitEmptyTest) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"present", "value"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    a_missing: '%REQ(nonexistent)%'
+    b_present: '%REQ(present)%'
+    c_missing: '%RESP(nonexistent)%'
+    list:
+    - '%REQ(nonexistent)%'
+    - '%REQ(present)%'
+  )EOF",
+                            key_mapping);
+  JsonFormatterImpl formatter(key_mapping, false, true);
+
+  EXPECT_EQ("{\"b_present\":\"value\",\"list\":[\"value\"]}\n",
+            formatter.format(request_header, response_header, response_trailer, stream_info, body));
+}
+
+TEST(SubstitutionFormatterTest, JsonFormatterTypedAndEscapedTest) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"quoted", "a\"b\\c\td"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  EXPECT_CALL(Const(stream_info), lastDownstreamRxByteReceived())
+      .WillRepeatedly(Return(std::chrono::nanoseconds(5000000)));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    request_duration: '%REQUEST_DURATION%'
+    quoted: '%REQ(quoted)%'
+    multi: '%REQ(quoted)%|%REQ(nonexistent)%'
+    missing: '%REQ(nonexistent)%'
+    nested:
+      list:
+      - '%REQUEST_DURATION%'
+      - plain
+  )EOF",
+                            key_mapping);
+  JsonFormatterImpl formatter(key_mapping, true, false);
+
+  const std::string out_json =
+      formatter.format(request_header, response_header, response_trailer, stream_info, body);
+  EXPECT_EQ("{\"missing\":null,\"multi\":\"a\\\"b\\\\c\\td|-\",\"nested\":{\"list\":[5,"
+            "\"plain\"]},\"quoted\":\"a\\\"b\\\\c\\td\",\"request_duration\":5}\n",
+            out_json);
+
+  // The direct JSON output must parse to the same value as the Struct based path.
+  StructFormatter struct_formatter(key_mapping, true, false);
+  EXPECT_TRUE(TestUtility::jsonStringEqual(
+      out_json, MessageUtil::getJsonStringFromMessageOrDie(
+                    struct_formatter.format(request_header, response_header, response_trailer,
+                                            stream_info, body),
+                    false, true)));
+}
+
+TEST(SubstitutionFormatterTest, CompositeFormatterToBuffer) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  FormatterImpl formatter("[%REQ(first)%] %RESP(missing)% done\n", false);
+  Buffer::OwnedImpl buffer("prefix ");
+  formatter.formatToBuffer(request_header, response_header, response_trailer, stream_info, body,
+                           buffer);
+  formatter.formatToBuffer(request_header, response_header, response_trailer, stream_info, body,
+                           buffer);
+  EXPECT_EQ("prefix [GET] - done\n[GET] - done\n", buffer.toString());
+  EXPECT_EQ("[GET] - done\n", formatter.format(request_header, response_header, response_trailer,
+                                               stream_info, body));
+
+  // Formatters without their own implementation append the formatted line.
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml("first: '%REQ(first)%'", key_mapping);
+  JsonFormatterImpl json_formatter(key_mapping, false, false);
+  const Formatter& json_formatter_interface = json_formatter;
+  Buffer::OwnedImpl json_buffer;
+  json_formatter_interface.formatToBuffer(request_header, response_header, response_trailer,
+                                          stream_info, body, json_buffer);
+  EXPECT_EQ(json_formatter.format(request_header, response_header, response_trailer, stream_info,
+                                  body),
+            json_buffer.toString());
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   StreamInfo::MockStreamInfo stream_info;
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
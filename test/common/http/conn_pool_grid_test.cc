@@ -183,6 +183,25 @@ TEST_F(ConnectivityGridTest, ImmediateSuccess) {
   EXPECT_FALSE(grid_.isHttp3Broken());
 }
 
+// Test that the stream options are passed to the pools, except for early data, which would leave
+// no TCP fallback if the handshake failed.
+TEST_F(ConnectivityGridTest, StreamOptions) {
+  ConnectivityGridForTest::forceCreateNextPool(grid_);
+  ConnectionPool::StreamOptions options;
+  options.can_send_early_data_ = true;
+  EXPECT_CALL(*grid_.first(), newStreamWithOptions(_, _, _))
+      .WillOnce(Invoke([&](ResponseDecoder&, ConnectionPool::Callbacks& callbacks,
+                           const ConnectionPool::StreamOptions& stream_options)
+                           -> ConnectionPool::Cancellable* {
+        EXPECT_FALSE(stream_options.can_send_early_data_);
+        callbacks.onPoolReady(encoder_, host_, info_, absl::nullopt);
+        return nullptr;
+      }));
+
+  EXPECT_CALL(callbacks_.pool_ready_, ready());
+  EXPECT_EQ(grid_.newStreamWithOptions(decoder_, callbacks_, options), nullptr);
+}
+
 // Test the first pool failing and the second connecting.
 TEST_F(ConnectivityGridTest, FailureThenSuccessSerial) {
   EXPECT_EQ(grid_.first(), nullptr);
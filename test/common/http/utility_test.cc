@@ -115,6 +115,26 @@ TEST(HttpUtility, isWebSocketUpgradeRequest) {
       TestRequestHeaderMapImpl{{"connection", "Upgrade"}, {"upgrade", "WebSocket"}}));
 }
 
+TEST(HttpUtility, isSafeRequest) {
+  EXPECT_FALSE(Utility::isSafeRequest(TestRequestHeaderMapImpl{}, true));
+  EXPECT_FALSE(Utility::isSafeRequest(TestRequestHeaderMapImpl{{":method", "POST"}}, true));
+  EXPECT_FALSE(Utility::isSafeRequest(TestRequestHeaderMapImpl{{":method", "PUT"}}, true));
+  EXPECT_FALSE(Utility::isSafeRequest(TestRequestHeaderMapImpl{{":method", "CONNECT"}}, true));
+  EXPECT_FALSE(Utility::isSafeRequest(
+      TestRequestHeaderMapImpl{
+          {":method", "GET"}, {"connection", "upgrade"}, {"upgrade", "websocket"}},
+      true));
+  // Requests with a body are never safe.
+  EXPECT_FALSE(Utility::isSafeRequest(TestRequestHeaderMapImpl{{":method", "GET"}}, false));
+  EXPECT_FALSE(Utility::isSafeRequest(
+      TestRequestHeaderMapImpl{{":method", "GET"}, {"content-length", "5"}}, false));
+
+  EXPECT_TRUE(Utility::isSafeRequest(TestRequestHeaderMapImpl{{":method", "GET"}}, true));
+  EXPECT_TRUE(Utility::isSafeRequest(TestRequestHeaderMapImpl{{":method", "HEAD"}}, true));
+  EXPECT_TRUE(Utility::isSafeRequest(TestRequestHeaderMapImpl{{":method", "OPTIONS"}}, true));
+  EXPECT_TRUE(Utility::isSafeRequest(TestRequestHeaderMapImpl{{":method", "TRACE"}}, true));
+}
+
 TEST(HttpUtility, isUpgrade) {
   EXPECT_FALSE(Utility::isUpgrade(TestRequestHeaderMapImpl{}));
   EXPECT_FALSE(Utility::isUpgrade(TestRequestHeaderMapImpl{{"connection", "upgrade"}}));
@@ -65,6 +65,7 @@ TEST(IoSocketHandleImplTest, TestIoSocketError) {
   IoSocketError error10(123);
   EXPECT_EQ(IoSocketError::IoErrorCode::UnknownError, error10.getErrorCode());
   EXPECT_EQ(errorDetails(123), error10.getErrorDetails());
+  EXPECT_EQ(123, error10.getSystemErrorCode());
 }
 
 TEST(IoSocketHandleImpl, LastRoundTripTimeReturnsEmptyOptionalIfGetSocketFails) {
@@ -98,6 +99,27 @@ TEST(IoSocketHandleImpl, LastRoundTripTimeReturnsRttIfSuccessful) {
   EXPECT_THAT(io_handle.lastRoundTripTime(),
               Eq(std::chrono::duration_cast<std::chrono::milliseconds>(rtt)));
 }
+
+TEST(IoSocketHandleImpl, SendmsgReturnsInvalidArgumentWithUdpSegment) {
+  NiceMock<Envoy::Api::MockOsSysCalls> os_sys_calls;
+  auto os_calls =
+      std::make_unique<Envoy::TestThreadsafeSingletonInjector<Envoy::Api::OsSysCallsImpl>>(
+          &os_sys_calls);
+
+  IoSocketHandleImpl io_handle;
+  const int segment_size = 1200;
+  ASSERT_EQ(0, io_handle.setOption(SOL_UDP, UDP_SEGMENT, &segment_size, sizeof(segment_size)).rc_);
+
+  // The kernel fails GSO sends with segments exceeding the path MTU with EINVAL.
+  EXPECT_CALL(os_sys_calls, sendmsg(_, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_INVAL}));
+  std::string payload(2 * segment_size, 'a');
+  Buffer::RawSlice slice{payload.data(), payload.size()};
+  Address::Ipv4Instance peer("127.0.0.1", 53);
+  Api::IoCallUint64Result result = io_handle.sendmsg(&slice, 1, 0, nullptr, peer);
+  ASSERT_FALSE(result.ok());
+  EXPECT_EQ(SOCKET_ERROR_INVAL, result.err_->getSystemErrorCode());
+}
 } // namespace
 } // namespace Network
 } // namespace Envoy
@@ -0,0 +1,196 @@
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "source/common/network/shared_dns_cache_impl.h"
+#include "source/common/singleton/manager_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+using testing::_;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class SharedDnsCacheImplTest : public testing::Test {
+public:
+  SharedDnsCacheImplTest()
+      : cache_(std::make_shared<SharedDnsCacheImpl>(resolver_, time_system_,
+                                                    std::chrono::seconds(60), store_)) {}
+
+  // Starts a query for the name that is expected to reach the wrapped resolver.
+  ActiveDnsQuery* resolveUpstream(const std::string& name, DnsResolver::ResolveCb callback) {
+    EXPECT_CALL(*resolver_, resolve(name, DnsLookupFamily::V4Only, _))
+        .WillOnce(DoAll(SaveArg<2>(&upstream_cb_), Return(&resolver_->active_query_)));
+    return cache_->resolve(name, DnsLookupFamily::V4Only, std::move(callback));
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "dns.shared_cache." + name)->value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  std::shared_ptr<MockDnsResolver> resolver_{std::make_shared<MockDnsResolver>()};
+  std::shared_ptr<SharedDnsCacheImpl> cache_;
+  DnsResolver::ResolveCb upstream_cb_;
+};
+
+MATCHER_P(DnsResponseTtl, ttl, "") {
+  for (const auto& response : arg) {
+    if (response.ttl_ != ttl) {
+      return false;
+    }
+  }
+  return !arg.empty();
+}
+
+// Concurrent queries for the same name share one upstream query and all get its answer.
+TEST_F(SharedDnsCacheImplTest, CoalescePendingQueries) {
+  testing::MockFunction<void(DnsResolver::ResolutionStatus, std::list<DnsResponse> &&)> cb1, cb2;
+  EXPECT_NE(nullptr, resolveUpstream("foo.com", cb1.AsStdFunction()));
+  EXPECT_NE(nullptr, cache_->resolve("foo.com", DnsLookupFamily::V4Only, cb2.AsStdFunction()));
+  EXPECT_EQ(1, counter("queries"));
+  EXPECT_EQ(1, counter("coalesced_queries"));
+
+  EXPECT_CALL(cb1, Call(DnsResolver::ResolutionStatus::Success, DnsResponseTtl(30s)));
+  EXPECT_CALL(cb2, Call(DnsResolver::ResolutionStatus::Success, DnsResponseTtl(30s)));
+  upstream_cb_(DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"10.0.0.1", "10.0.0.2"}, std::chrono::seconds(30)));
+  EXPECT_EQ(1, TestUtility::findGauge(store_, "dns.shared_cache.cache_entries")->value());
+}
+
+// Cached answers are returned inline with the TTL they have left, until they expire.
+TEST_F(SharedDnsCacheImplTest, CacheHitUntilExpiry) {
+  testing::MockFunction<void(DnsResolver::ResolutionStatus, std::list<DnsResponse> &&)> cb;
+  resolveUpstream("foo.com", cb.AsStdFunction());
+  EXPECT_CALL(cb, Call(DnsResolver::ResolutionStatus::Success, DnsResponseTtl(30s)));
+  upstream_cb_(DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(30)));
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(10500));
+  EXPECT_CALL(cb, Call(DnsResolver::ResolutionStatus::Success, DnsResponseTtl(20s)));
+  EXPECT_EQ(nullptr, cache_->resolve("foo.com", DnsLookupFamily::V4Only, cb.AsStdFunction()));
+  EXPECT_EQ(1, counter("cache_hits"));
+
+  // A different lookup family is a different entry.
+  EXPECT_CALL(*resolver_, resolve("foo.com", DnsLookupFamily::Auto, _))
+      .WillOnce(Return(&resolver_->active_query_));
+  cache_->resolve("foo.com", DnsLookupFamily::Auto, cb.AsStdFunction());
+}
+
+// The max TTL caps how long an answer is cached, and answers with a zero TTL are not cached.
+TEST_F(SharedDnsCacheImplTest, MaxAndZeroTtl) {
+  testing::MockFunction<void(DnsResolver::ResolutionStatus, std::list<DnsResponse> &&)> cb;
+  EXPECT_CALL(cb, Call(_, _)).Times(3);
+
+  resolveUpstream("foo.com", cb.AsStdFunction());
+  upstream_cb_(DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(3600)));
+  time_system_.advanceTimeWait(std::chrono::seconds(60));
+  resolveUpstream("foo.com", cb.AsStdFunction());
+  upstream_cb_(DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(0)));
+  resolveUpstream("foo.com", cb.AsStdFunction());
+  EXPECT_EQ(0, counter("cache_hits"));
+  EXPECT_EQ(3, counter("queries"));
+}
+
+// Failures and empty answers are not cached.
+TEST_F(SharedDnsCacheImplTest, FailureNotCached) {
+  testing::MockFunction<void(DnsResolver::ResolutionStatus, std::list<DnsResponse> &&)> cb;
+  EXPECT_CALL(cb, Call(_, _)).Times(2);
+
+  resolveUpstream("foo.com", cb.AsStdFunction());
+  upstream_cb_(DnsResolver::ResolutionStatus::Failure, {});
+  resolveUpstream("foo.com", cb.AsStdFunction());
+  upstream_cb_(DnsResolver::ResolutionStatus::Success, {});
+  resolveUpstream("foo.com", cb.AsStdFunction());
+  EXPECT_EQ(0, counter("cache_hits"));
+}
+
+// The upstream query is only cancelled with its last waiter.
+TEST_F(SharedDnsCacheImplTest, Cancel) {
+  testing::MockFunction<void(DnsResolver::ResolutionStatus, std::list<DnsResponse> &&)> cb1, cb2;
+  ActiveDnsQuery* query1 = resolveUpstream("foo.com", cb1.AsStdFunction());
+  ActiveDnsQuery* query2 =
+      cache_->resolve("foo.com", DnsLookupFamily::V4Only, cb2.AsStdFunction());
+
+  EXPECT_CALL(resolver_->active_query_, cancel(_)).Times(0);
+  query1->cancel(ActiveDnsQuery::CancelReason::Timeout);
+  EXPECT_CALL(cb2, Call(DnsResolver::ResolutionStatus::Success, _));
+  upstream_cb_(DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(0)));
+
+  query1 = resolveUpstream("foo.com", cb1.AsStdFunction());
+  query2 = cache_->resolve("foo.com", DnsLookupFamily::V4Only, cb2.AsStdFunction());
+  query2->cancel(ActiveDnsQuery::CancelReason::QueryAbandoned);
+  EXPECT_CALL(resolver_->active_query_, cancel(ActiveDnsQuery::CancelReason::Timeout));
+  query1->cancel(ActiveDnsQuery::CancelReason::Timeout);
+
+  // A new query for the name starts another upstream query.
+  resolveUpstream("foo.com", cb1.AsStdFunction());
+  EXPECT_CALL(cb1, Call(DnsResolver::ResolutionStatus::Failure, _));
+  upstream_cb_(DnsResolver::ResolutionStatus::Failure, {});
+  EXPECT_EQ(3, counter("queries"));
+}
+
+// A waiter's callback may cancel the waiters that have not been called yet.
+TEST_F(SharedDnsCacheImplTest, CancelFromCallback) {
+  testing::MockFunction<void(DnsResolver::ResolutionStatus, std::list<DnsResponse> &&)> cb2;
+  ActiveDnsQuery* query2 = nullptr;
+  resolveUpstream("foo.com", [&](DnsResolver::ResolutionStatus, std::list<DnsResponse>&&) {
+    query2->cancel(ActiveDnsQuery::CancelReason::QueryAbandoned);
+  });
+  query2 = cache_->resolve("foo.com", DnsLookupFamily::V4Only, cb2.AsStdFunction());
+
+  EXPECT_CALL(cb2, Call(_, _)).Times(0);
+  EXPECT_CALL(resolver_->active_query_, cancel(_)).Times(0);
+  upstream_cb_(DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(30)));
+}
+
+// The wrapped resolver may complete the query inline.
+TEST_F(SharedDnsCacheImplTest, InlineCompletion) {
+  testing::MockFunction<void(DnsResolver::ResolutionStatus, std::list<DnsResponse> &&)> cb;
+  EXPECT_CALL(*resolver_, resolve("foo.com", DnsLookupFamily::V4Only, _))
+      .WillOnce([](const std::string&, DnsLookupFamily, DnsResolver::ResolveCb callback) {
+        callback(DnsResolver::ResolutionStatus::Success,
+                 TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(30)));
+        return nullptr;
+      });
+  EXPECT_CALL(cb, Call(DnsResolver::ResolutionStatus::Success, DnsResponseTtl(30s))).Times(2);
+  EXPECT_EQ(nullptr, cache_->resolve("foo.com", DnsLookupFamily::V4Only, cb.AsStdFunction()));
+  EXPECT_EQ(nullptr, cache_->resolve("foo.com", DnsLookupFamily::V4Only, cb.AsStdFunction()));
+  EXPECT_EQ(1, counter("cache_hits"));
+}
+
+// Pending upstream queries are cancelled when the cache is destroyed.
+TEST_F(SharedDnsCacheImplTest, DestroyWithPendingQuery) {
+  testing::MockFunction<void(DnsResolver::ResolutionStatus, std::list<DnsResponse> &&)> cb;
+  resolveUpstream("foo.com", cb.AsStdFunction());
+  EXPECT_CALL(resolver_->active_query_, cancel(ActiveDnsQuery::CancelReason::QueryAbandoned));
+  cache_.reset();
+}
+
+TEST_F(SharedDnsCacheImplTest, Singleton) {
+  Singleton::ManagerImpl singleton_manager{Thread::threadFactoryForTest()};
+  EXPECT_EQ(nullptr, SharedDnsCacheImpl::singleton(singleton_manager));
+  SharedDnsCacheImpl::registerSingleton(singleton_manager, cache_);
+  EXPECT_EQ(cache_, SharedDnsCacheImpl::singleton(singleton_manager));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
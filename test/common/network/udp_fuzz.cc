@@ -39,6 +39,7 @@ public:
   void onReadReady() override;
   void onWriteReady(const Network::Socket& socket) override;
   void onReceiveError(Api::IoError::IoErrorCode error_code) override;
+  void onSendError(Api::IoError::IoErrorCode error_code) override;
   void onDataWorker(Network::UdpRecvData&& data) override;
   void post(Network::UdpRecvData&& data) override;
   void onDatagramsDropped(uint32_t dropped) override;
@@ -164,6 +165,9 @@ void FuzzUdpListenerCallbacks::onReceiveError(Api::IoError::IoErrorCode error_co
   }
   UNREFERENCED_PARAMETER(error_code);
 }
+void FuzzUdpListenerCallbacks::onSendError(Api::IoError::IoErrorCode error_code) {
+  UNREFERENCED_PARAMETER(error_code);
+}
 Network::UdpPacketWriter& FuzzUdpListenerCallbacks::udpPacketWriter() {
   return *my_upf_->udp_packet_writer_;
 }
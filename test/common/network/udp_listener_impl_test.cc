@@ -29,6 +29,7 @@
 using testing::_;
 using testing::AtLeast;
 using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -508,6 +509,66 @@ TEST_P(UdpListenerImplTest, SendDataError) {
   EXPECT_DEATH(listener_->send(send_data), "Invalid argument passed in");
 }
 
+/**
+ * Datagrams held by a batching writer are flushed by the listener at the end of the event loop
+ * iteration, without the filters flushing. Without kernel GSO support the writer falls back to
+ * writing datagram by datagram, which this test can't tell apart.
+ */
+TEST_P(UdpListenerImplTest, SendDataWithGsoWriter) {
+  setup();
+  auto* gso_writer = new UdpGsoWriter(server_socket_->ioHandle());
+  udp_packet_writer_.reset(gso_writer);
+  ON_CALL(listener_callbacks_, udpPacketWriter()).WillByDefault(ReturnRef(*udp_packet_writer_));
+
+  Address::InstanceConstSharedPtr send_from_addr = getNonDefaultSourceAddress();
+  const std::vector<std::string> payloads{"segment1", "segment2", "seg3"};
+  for (const auto& payload : payloads) {
+    Buffer::OwnedImpl buffer(payload);
+    UdpSendData send_data{send_from_addr->ip(), *client_.localAddress(), buffer};
+    auto send_result = listener_->send(send_data);
+    EXPECT_TRUE(send_result.ok()) << "send() failed : " << send_result.err_->getErrorDetails();
+    EXPECT_EQ(payload.length(), send_result.rc_);
+    EXPECT_EQ(0, buffer.length());
+  }
+  EXPECT_EQ(3, gso_writer->bufferedDatagrams());
+
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0, gso_writer->bufferedDatagrams());
+  for (const auto& payload : payloads) {
+    UdpRecvData data;
+    client_.recv(data);
+    EXPECT_EQ(payload, data.buffer_->toString());
+    EXPECT_EQ(send_from_addr->asString(), data.addresses_.peer_->asString());
+  }
+}
+
+/**
+ * Errors of the flush the listener performs for a batching writer are reported to the callbacks,
+ * as there is no caller to return them to.
+ */
+TEST_P(UdpListenerImplTest, ReportsErrorOfDeferredFlush) {
+  setup();
+  auto* writer = new NiceMock<MockUdpPacketWriter>();
+  udp_packet_writer_.reset(writer);
+  ON_CALL(listener_callbacks_, udpPacketWriter()).WillByDefault(ReturnRef(*udp_packet_writer_));
+  ON_CALL(*writer, isBatchMode()).WillByDefault(Return(true));
+
+  const std::string payload("hello");
+  EXPECT_CALL(*writer, writePacket(_, _, _))
+      .WillOnce(Return(testing::ByMove(Api::IoCallUint64Result(
+          payload.size(), Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError)))));
+  Buffer::OwnedImpl buffer(payload);
+  UdpSendData send_data{nullptr, *client_.localAddress(), buffer};
+  EXPECT_TRUE(listener_->send(send_data).ok());
+
+  EXPECT_CALL(*writer, flush())
+      .WillOnce(Return(testing::ByMove(Api::IoCallUint64Result(
+          0, Api::IoErrorPtr(new IoSocketError(SOCKET_ERROR_MSG_SIZE),
+                             IoSocketError::deleteIoError)))));
+  EXPECT_CALL(listener_callbacks_, onSendError(Api::IoError::IoErrorCode::MessageTooBig));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
 /**
  * Test that multiple stacked packets of the same size are properly segmented
  * when UDP GRO is enabled on the platform.
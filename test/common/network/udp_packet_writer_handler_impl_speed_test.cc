@@ -0,0 +1,69 @@
+// Datagrams written per second over loopback by the default UDP writer, which issues one sendmsg
+// per datagram, and by the GSO writer, which hands each burst to the kernel in as few sendmsg calls
+// as GSO allows. Datagram sizes are those of DNS queries and of media (RTP/QUIC) packets.
+
+#include <memory>
+#include <string>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/udp_packet_writer_handler_impl.h"
+#include "source/common/network/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+
+// Datagrams written per event loop iteration, e.g. the replies to a burst of reads.
+static constexpr uint32_t BurstSize = 64;
+
+// Args: {gso, datagram size}.
+static void bmUdpWrite(benchmark::State& state) {
+  const bool gso = state.range(0);
+  const std::string payload(state.range(1), 'a');
+  if (gso && !Api::OsSysCallsSingleton::get().supportsUdpGso()) {
+    state.SkipWithError("GSO is not supported by the OS");
+    return;
+  }
+
+  // The receiver never reads. Once its buffer is full the kernel drops the datagrams, after the
+  // whole send path ran.
+  UdpListenSocket receiver(Utility::parseInternetAddress("127.0.0.1"), nullptr, true);
+  UdpListenSocket sender(Utility::parseInternetAddress("127.0.0.1"), nullptr, true);
+  UdpPacketWriterPtr writer;
+  if (gso) {
+    writer = std::make_unique<UdpGsoWriter>(sender.ioHandle());
+  } else {
+    writer = std::make_unique<UdpDefaultWriter>(sender.ioHandle());
+  }
+  const Address::Instance& peer = *receiver.addressProvider().localAddress();
+
+  uint64_t datagrams = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (uint32_t i = 0; i < BurstSize; ++i) {
+      Buffer::OwnedImpl buffer(payload);
+      writer->writePacket(buffer, nullptr, peer);
+      writer->setWritable();
+    }
+    writer->flush();
+    writer->setWritable();
+    datagrams += BurstSize;
+  }
+  state.counters["datagrams"] = benchmark::Counter(datagrams, benchmark::Counter::kIsRate);
+}
+
+static void udpWriteParams(benchmark::internal::Benchmark* b) {
+  for (auto gso : {false, true}) {
+    for (auto size : {100, 1200}) {
+      b->Args({gso, size});
+    }
+  }
+}
+
+BENCHMARK(bmUdpWrite)->Apply(udpWriteParams);
+
+} // namespace Network
+} // namespace Envoy
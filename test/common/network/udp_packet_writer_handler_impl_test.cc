@@ -0,0 +1,250 @@
+#include <cerrno>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/io_socket_error_impl.h"
+#include "source/common/network/udp_packet_writer_handler_impl.h"
+#include "source/common/network/utility.h"
+
+#include "test/mocks/network/io_handle.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class UdpGsoWriterTest : public testing::Test {
+protected:
+  // Records the payload of each sendmsg call.
+  void expectSends(uint32_t times) {
+    EXPECT_CALL(io_handle_, sendmsg(_, _, 0, _, _))
+        .Times(times)
+        .WillRepeatedly(Invoke([this](const Buffer::RawSlice* slices, uint64_t num_slice, int,
+                                      const Address::Ip*, const Address::Instance& peer_address) {
+          std::string payload;
+          for (uint64_t i = 0; i < num_slice; ++i) {
+            payload.append(static_cast<const char*>(slices[i].mem_), slices[i].len_);
+          }
+          sends_.emplace_back(peer_address.asString(), payload);
+          return Api::IoCallUint64Result(
+              payload.size(), Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+        }));
+  }
+
+  void expectSegmentSize(int segment_size, int rc = 0) {
+    EXPECT_CALL(io_handle_, setOption(SOL_UDP, UDP_SEGMENT, _, sizeof(int)))
+        .WillOnce(Invoke([segment_size, rc](int, int, const void* optval, socklen_t) {
+          EXPECT_EQ(segment_size, *static_cast<const int*>(optval));
+          return Api::SysCallIntResult{rc, rc == 0 ? 0 : SOCKET_ERROR_NOT_SUP};
+        }));
+  }
+
+  Api::IoCallUint64Result write(const std::string& payload, const Address::Instance& peer) {
+    Buffer::OwnedImpl buffer(payload);
+    return writer_.writePacket(buffer, nullptr, peer);
+  }
+
+  testing::StrictMock<MockIoHandle> io_handle_;
+  UdpGsoWriter writer_{io_handle_};
+  const Address::InstanceConstSharedPtr peer_{Utility::parseInternetAddressAndPort("1.2.3.4:53")};
+  const Address::InstanceConstSharedPtr other_peer_{
+      Utility::parseInternetAddressAndPort("1.2.3.5:53")};
+  std::vector<std::pair<std::string, std::string>> sends_;
+};
+
+TEST_F(UdpGsoWriterTest, BatchesDatagramsOfOneSize) {
+  EXPECT_TRUE(writer_.isBatchMode());
+  for (const std::string payload : {"aaaa", "bbbb", "cc"}) {
+    auto result = write(payload, *peer_);
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(payload.size(), result.rc_);
+  }
+  EXPECT_EQ(3, writer_.bufferedDatagrams());
+
+  expectSegmentSize(4);
+  expectSends(1);
+  auto result = writer_.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(10, result.rc_);
+  EXPECT_EQ(0, writer_.bufferedDatagrams());
+  ASSERT_EQ(1, sends_.size());
+  EXPECT_EQ("aaaabbbbcc", sends_[0].second);
+
+  // The socket keeps the segment size for the next batch of the same size.
+  write("dddd", *peer_);
+  write("eeee", *peer_);
+  expectSends(1);
+  writer_.flush();
+  EXPECT_EQ("ddddeeee", sends_[1].second);
+
+  // Nothing to flush.
+  result = writer_.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(0, result.rc_);
+}
+
+TEST_F(UdpGsoWriterTest, FlushesWhenDatagramCannotJoinBatch) {
+  write("aaaa", *peer_);
+  // Larger than the segment size.
+  expectSends(1);
+  write("bbbbbb", *peer_);
+  ASSERT_EQ(1, sends_.size());
+  EXPECT_EQ("aaaa", sends_[0].second);
+
+  // Another peer.
+  expectSends(1);
+  write("cccccc", *other_peer_);
+  EXPECT_EQ("bbbbbb", sends_[1].second);
+
+  // After a shorter datagram.
+  write("dd", *other_peer_);
+  expectSegmentSize(6);
+  expectSends(1);
+  write("eeeeee", *other_peer_);
+  EXPECT_EQ("ccccccdd", sends_[2].second);
+  EXPECT_EQ(other_peer_->asString(), sends_[2].first);
+
+  expectSends(1);
+  write("ffffffff", *other_peer_);
+  EXPECT_EQ("eeeeee", sends_[3].second);
+  // A lone datagram larger than the segment size set on the socket needs it cleared, so that it is
+  // not split.
+  expectSegmentSize(0);
+  expectSends(1);
+  writer_.flush();
+  EXPECT_EQ("ffffffff", sends_[4].second);
+}
+
+TEST_F(UdpGsoWriterTest, FlushesFullBatch) {
+  const std::string payload(1200, 'a');
+  // The batch is limited by MaxBatchSize before MaxSegments.
+  const uint32_t batch_size = UdpGsoWriter::MaxBatchSize / payload.size();
+  for (uint32_t i = 0; i < batch_size; ++i) {
+    write(payload, *peer_);
+  }
+  EXPECT_EQ(batch_size, writer_.bufferedDatagrams());
+  expectSegmentSize(1200);
+  expectSends(1);
+  write(payload, *peer_);
+  EXPECT_EQ(1, writer_.bufferedDatagrams());
+  EXPECT_EQ(batch_size * payload.size(), sends_[0].second.size());
+}
+
+TEST_F(UdpGsoWriterTest, WritesDatagramsIndividuallyWithoutGso) {
+  write("aaaa", *peer_);
+  write("bbbb", *peer_);
+  write("cc", *peer_);
+  expectSegmentSize(4, -1);
+  expectSends(3);
+  auto result = writer_.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(10, result.rc_);
+  ASSERT_EQ(3, sends_.size());
+  EXPECT_EQ("aaaa", sends_[0].second);
+  EXPECT_EQ("bbbb", sends_[1].second);
+  EXPECT_EQ("cc", sends_[2].second);
+
+  // GSO is not tried again.
+  write("dddd", *peer_);
+  write("eeee", *peer_);
+  expectSends(2);
+  writer_.flush();
+}
+
+TEST_F(UdpGsoWriterTest, WritesLargeDatagramsOnTheirOwn) {
+  const std::string payload(UdpGsoWriter::MaxSegmentSize + 1, 'a');
+  write(payload, *peer_);
+  expectSends(1);
+  write(payload, *peer_);
+  EXPECT_EQ(1, writer_.bufferedDatagrams());
+  expectSends(1);
+  writer_.flush();
+  ASSERT_EQ(2, sends_.size());
+  EXPECT_EQ(payload, sends_[0].second);
+  EXPECT_EQ(payload, sends_[1].second);
+}
+
+TEST_F(UdpGsoWriterTest, ResendsDatagramsIndividuallyWhenSegmentedSendFails) {
+  write("aaaa", *peer_);
+  write("bbbb", *peer_);
+  write("cc", *peer_);
+  {
+    testing::InSequence s;
+    expectSegmentSize(4);
+    // As returned for a device without checksum offload.
+    EXPECT_CALL(io_handle_, sendmsg(_, _, 0, _, _))
+        .WillOnce(Return(testing::ByMove(Api::IoCallUint64Result(
+            0, Api::IoErrorPtr(new IoSocketError(EIO), IoSocketError::deleteIoError)))));
+    expectSegmentSize(0);
+    expectSends(3);
+  }
+  auto result = writer_.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(10, result.rc_);
+  ASSERT_EQ(3, sends_.size());
+  EXPECT_EQ("aaaa", sends_[0].second);
+  EXPECT_EQ("bbbb", sends_[1].second);
+  EXPECT_EQ("cc", sends_[2].second);
+
+  // GSO is not tried again.
+  write("dddd", *peer_);
+  write("eeee", *peer_);
+  expectSends(2);
+  writer_.flush();
+}
+
+TEST_F(UdpGsoWriterTest, WriteBlocked) {
+  write("aaaa", *peer_);
+  write("bbbb", *peer_);
+  expectSegmentSize(4);
+  EXPECT_CALL(io_handle_, sendmsg(_, _, 0, _, _))
+      .WillOnce(Return(testing::ByMove(
+          Api::IoCallUint64Result(0, Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                                                     IoSocketError::deleteIoError)))));
+  auto result = writer_.flush();
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_TRUE(writer_.isWriteBlocked());
+  // The batch is dropped.
+  EXPECT_EQ(0, writer_.bufferedDatagrams());
+
+  writer_.setWritable();
+  EXPECT_FALSE(writer_.isWriteBlocked());
+}
+
+TEST_F(UdpGsoWriterTest, KeepsDatagramWhenPreviousBatchFails) {
+  write("aaaa", *peer_);
+  EXPECT_CALL(io_handle_, sendmsg(_, _, 0, _, _))
+      .WillOnce(Return(testing::ByMove(Api::IoCallUint64Result(
+          0, Api::IoErrorPtr(new IoSocketError(ECONNREFUSED), IoSocketError::deleteIoError)))));
+  // The datagram which made the writer send the previous batch is not affected by its failure.
+  auto result = write("bbbb", *other_peer_);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(4, result.rc_);
+  EXPECT_EQ(1, writer_.bufferedDatagrams());
+
+  // The failed batch is reported by the next flush, which still writes the datagram.
+  expectSends(1);
+  result = writer_.flush();
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(ECONNREFUSED, result.err_->getSystemErrorCode());
+  ASSERT_EQ(1, sends_.size());
+  EXPECT_EQ("bbbb", sends_[0].second);
+  EXPECT_EQ(other_peer_->asString(), sends_[0].first);
+
+  // It is reported once.
+  write("cccc", *peer_);
+  expectSends(1);
+  EXPECT_TRUE(writer_.flush().ok());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
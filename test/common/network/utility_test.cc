@@ -6,6 +6,7 @@
 #include "envoy/common/exception.h"
 #include "envoy/config/core/v3/address.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/thread.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/io_socket_handle_impl.h"
@@ -18,6 +19,7 @@
 #include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::Return;
@@ -580,7 +582,134 @@ TEST(ResolvedUdpSocketConfig, Warning) {
       ResolvedUdpSocketConfig resolved_config(envoy::config::core::v3::UdpSocketConfig(), true));
 }
 
+TEST(UdpRecvArena, Datagrams) {
+  UdpRecvArena arena(16);
+  Buffer::RawSlice slice = arena.reserve();
+  EXPECT_EQ(16, slice.len_);
+  memcpy(slice.mem_, "helloworld", 10);
+  Buffer::InstancePtr hello = arena.datagram(0, 5);
+  Buffer::InstancePtr world = arena.datagram(5, 5);
+  EXPECT_EQ("hello", hello->toString());
+  EXPECT_EQ("world", world->toString());
+  EXPECT_EQ(1, hello->getRawSlices().size());
+  EXPECT_EQ(0, arena.datagram(10, 0)->length());
+
+  // The block is still referenced by the datagrams, so the next read gets a new one and the
+  // datagrams stay valid.
+  Buffer::RawSlice next = arena.reserve();
+  EXPECT_NE(slice.mem_, next.mem_);
+  EXPECT_EQ(2, arena.blocksAllocated());
+  memcpy(next.mem_, "HELLOWORLD", 10);
+  Buffer::OwnedImpl moved;
+  moved.move(*hello);
+  hello.reset();
+  EXPECT_EQ("hello", moved.toString());
+  EXPECT_EQ("world", world->toString());
+
+  // Released blocks are reused.
+  arena.datagram(0, 5).reset();
+  EXPECT_EQ(next.mem_, arena.reserve().mem_);
+  EXPECT_EQ(2, arena.blocksAllocated());
+}
+
+TEST(UdpRecvArena, DatagramsReleasedOnAnotherThread) {
+  UdpRecvArena arena(16);
+  Buffer::RawSlice slice = arena.reserve();
+  memcpy(slice.mem_, "helloworld", 10);
+  Buffer::InstancePtr hello = arena.datagram(0, 5);
+  Buffer::InstancePtr world = arena.datagram(5, 5);
+
+  // The datagrams are released on another worker, after which the block and its fragments are
+  // reused by the next read.
+  Thread::threadFactoryForTest()
+      .createThread([&hello, &world]() {
+        EXPECT_EQ("helloworld", hello->toString() + world->toString());
+        hello.reset();
+        world.reset();
+      })
+      ->join();
+  EXPECT_EQ(slice.mem_, arena.reserve().mem_);
+  memcpy(slice.mem_, "HELLOWORLD", 10);
+  EXPECT_EQ("HELLO", arena.datagram(0, 5)->toString());
+  EXPECT_EQ(1, arena.blocksAllocated());
+}
+
+TEST(UdpRecvArena, DatagramsOutliveArena) {
+  Buffer::InstancePtr hello;
+  {
+    UdpRecvArena arena(16);
+    memcpy(arena.reserve().mem_, "hello", 5);
+    hello = arena.datagram(0, 5);
+  }
+  EXPECT_EQ("hello", hello->toString());
+}
+
 #ifndef WIN32
+// Records the batches of packets passed by readFromSocket().
+class BatchPacketProcessor : public UdpPacketProcessor {
+public:
+  // UdpPacketProcessor
+  void processPacket(Address::InstanceConstSharedPtr, Address::InstanceConstSharedPtr,
+                     Buffer::InstancePtr buffer, MonotonicTime) override {
+    batches_.push_back({buffer->toString()});
+  }
+  void processPackets(absl::Span<UdpRecvData> packets) override {
+    std::vector<std::string> batch;
+    for (const UdpRecvData& packet : packets) {
+      EXPECT_NE(nullptr, packet.addresses_.peer_);
+      batch.push_back(packet.buffer_->toString());
+    }
+    batches_.push_back(batch);
+  }
+  void onDatagramsDropped(uint32_t) override {}
+  uint64_t maxDatagramSize() const override { return DEFAULT_UDP_MAX_DATAGRAM_SIZE; }
+  size_t numPacketsExpectedPerEventLoop() const override { return 1; }
+
+  std::vector<std::vector<std::string>> batches_;
+};
+
+TEST(NetworkUtility, ReadFromSocketBatch) {
+  auto version = TestEnvironment::getIpVersionsForTest()[0];
+  auto kernel_version = version == Network::Address::IpVersion::v4 ? AF_INET : AF_INET6;
+  int fd = socket(kernel_version, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+  ASSERT_NE(fd, 0);
+  sockaddr_storage storage;
+  auto& sin = reinterpret_cast<sockaddr_in&>(storage);
+  sin.sin_family = kernel_version;
+  sin.sin_port = 0;
+  EXPECT_EQ(1,
+            inet_pton(kernel_version, Network::Test::getLoopbackAddressUrlString(version).c_str(),
+                      &sin.sin_addr));
+  ASSERT_EQ(0, bind(fd, reinterpret_cast<sockaddr*>(&storage), sizeof(storage)));
+  socklen_t storage_len = sizeof(storage);
+  ASSERT_EQ(0, getsockname(fd, reinterpret_cast<sockaddr*>(&storage), &storage_len));
+
+  IoSocketHandleImpl handle(fd);
+  if (!handle.supportsMmsg()) {
+    return;
+  }
+  for (absl::string_view payload : {"a", "bb", "ccc"}) {
+    EXPECT_EQ(payload.size(), sendto(fd, payload.data(), payload.size(), 0,
+                                     reinterpret_cast<sockaddr*>(&storage), sizeof(storage)));
+  }
+
+  // The packets of one recvmmsg read are passed as one batch.
+  BatchPacketProcessor processor;
+  UdpRecvArena arena(NUM_DATAGRAMS_PER_RECEIVE * processor.maxDatagramSize());
+  auto address = Network::Test::getCanonicalLoopbackAddress(version);
+  MonotonicTime time(std::chrono::seconds(0));
+  Api::IoCallUint64Result result =
+      Utility::readFromSocket(handle, *address, processor, time, false, nullptr, &arena);
+  EXPECT_EQ(3, result.rc_);
+  ASSERT_EQ(1, processor.batches_.size());
+  EXPECT_THAT(processor.batches_[0], testing::ElementsAre("a", "bb", "ccc"));
+
+  // The packets have been released, so the next read reuses the block.
+  result = Utility::readFromSocket(handle, *address, processor, time, false, nullptr, &arena);
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(1, arena.blocksAllocated());
+}
+
 TEST(PacketLoss, LossTest) {
   // Create and bind a UDP socket.
   auto version = TestEnvironment::getIpVersionsForTest()[0];
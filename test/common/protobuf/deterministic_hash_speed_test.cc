@@ -0,0 +1,114 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+#include "envoy/config/listener/v3/listener.pb.h"
+#include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/tls.pb.h"
+
+#include "source/common/protobuf/utility.h"
+
+#include "test/test_common/test_runtime.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+// A cluster with an inline load assignment of the given number of endpoints, each carrying
+// metadata, and a TLS transport socket packed in an Any.
+envoy::config::cluster::v3::Cluster makeCluster(int num_endpoints) {
+  envoy::config::cluster::v3::Cluster cluster;
+  cluster.set_name("benchmark_cluster");
+  cluster.set_type(envoy::config::cluster::v3::Cluster::STATIC);
+  cluster.mutable_connect_timeout()->set_seconds(5);
+  auto* load_assignment = cluster.mutable_load_assignment();
+  load_assignment->set_cluster_name("benchmark_cluster");
+  auto* locality_endpoints = load_assignment->add_endpoints();
+  for (int i = 0; i < num_endpoints; ++i) {
+    auto* lb_endpoint = locality_endpoints->add_lb_endpoints();
+    auto* address = lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+    address->set_address(absl::StrCat("10.0.", i / 256, ".", i % 256));
+    address->set_port_value(8080);
+    auto& fields = *(*lb_endpoint->mutable_metadata()->mutable_filter_metadata())["envoy.lb"]
+                        .mutable_fields();
+    fields["version"].set_string_value(absl::StrCat("v", i % 3));
+    fields["zone"].set_string_value(absl::StrCat("zone", i % 5));
+  }
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  tls_context.set_sni("benchmark.example.com");
+  tls_context.mutable_common_tls_context()->add_alpn_protocols("h2");
+  cluster.mutable_transport_socket()->set_name("envoy.transport_sockets.tls");
+  cluster.mutable_transport_socket()->mutable_typed_config()->PackFrom(tls_context);
+  return cluster;
+}
+
+// A listener with the given number of filter chains, each with an HTTP connection manager packed
+// in an Any that carries an inline route configuration.
+envoy::config::listener::v3::Listener makeListener(int num_filter_chains) {
+  envoy::config::listener::v3::Listener listener;
+  listener.set_name("benchmark_listener");
+  listener.mutable_address()->mutable_socket_address()->set_address("0.0.0.0");
+  listener.mutable_address()->mutable_socket_address()->set_port_value(443);
+  for (int i = 0; i < num_filter_chains; ++i) {
+    auto* filter_chain = listener.add_filter_chains();
+    filter_chain->mutable_filter_chain_match()->add_server_names(
+        absl::StrCat("host", i, ".example.com"));
+    envoy::extensions::filters::network::http_connection_manager::v3::HttpConnectionManager hcm;
+    hcm.set_stat_prefix(absl::StrCat("ingress_", i));
+    auto* route_config = hcm.mutable_route_config();
+    for (int j = 0; j < 10; ++j) {
+      auto* virtual_host = route_config->add_virtual_hosts();
+      virtual_host->set_name(absl::StrCat("vhost_", i, "_", j));
+      virtual_host->add_domains(absl::StrCat("service", j, ".host", i, ".example.com"));
+      auto* route = virtual_host->add_routes();
+      route->mutable_match()->set_prefix("/");
+      route->mutable_route()->set_cluster(absl::StrCat("cluster_", j));
+    }
+    hcm.add_http_filters()->set_name("envoy.filters.http.router");
+    auto* filter = filter_chain->add_filters();
+    filter->set_name("envoy.filters.network.http_connection_manager");
+    filter->mutable_typed_config()->PackFrom(hcm);
+  }
+  return listener;
+}
+
+// Hashes a message with MessageUtil::hash(). state.range(1) selects the implementation: 0 for
+// the Protobuf::TextFormat based hash and 1 for DeterministicProtoHash.
+void hashMessage(benchmark::State& state, const Protobuf::Message& message) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.deterministic_proto_hash",
+        state.range(1) == 0 ? "false" : "true"}});
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(MessageUtil::hash(message));
+  }
+}
+
+} // namespace
+
+static void bmHashCluster(benchmark::State& state) {
+  hashMessage(state, makeCluster(state.range(0)));
+}
+BENCHMARK(bmHashCluster)
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->ArgNames({"endpoints", "deterministic"})
+    ->Unit(benchmark::kMicrosecond);
+
+static void bmHashListener(benchmark::State& state) {
+  hashMessage(state, makeListener(state.range(0)));
+}
+BENCHMARK(bmHashListener)
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->ArgNames({"filter_chains", "deterministic"})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace Envoy
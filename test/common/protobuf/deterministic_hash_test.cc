@@ -0,0 +1,90 @@
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/core/v3/base.pb.h"
+
+#include "source/common/common/base64.h"
+#include "source/common/protobuf/deterministic_hash.h"
+#include "source/common/protobuf/protobuf.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace DeterministicProtoHash {
+namespace {
+
+TEST(DeterministicProtoHashTest, EqualMessagesHashEqual) {
+  envoy::config::cluster::v3::Cluster a;
+  a.set_name("foo");
+  a.mutable_connect_timeout()->set_seconds(1);
+  a.add_dns_resolvers()->mutable_socket_address()->set_address("1.2.3.4");
+  envoy::config::cluster::v3::Cluster b = a;
+  EXPECT_EQ(hash(a), hash(b));
+
+  b.set_name("bar");
+  EXPECT_NE(hash(a), hash(b));
+}
+
+TEST(DeterministicProtoHashTest, FieldsAreDistinguished) {
+  envoy::config::core::v3::Locality a;
+  a.set_region("foo");
+  envoy::config::core::v3::Locality b;
+  b.set_zone("foo");
+  EXPECT_NE(hash(a), hash(b));
+  EXPECT_NE(hash(a), hash(envoy::config::core::v3::Locality()));
+}
+
+TEST(DeterministicProtoHashTest, RepeatedFieldOrderMatters) {
+  ProtobufWkt::ListValue a;
+  a.add_values()->set_string_value("foo");
+  a.add_values()->set_string_value("bar");
+  ProtobufWkt::ListValue b;
+  b.add_values()->set_string_value("bar");
+  b.add_values()->set_string_value("foo");
+  EXPECT_NE(hash(a), hash(b));
+}
+
+TEST(DeterministicProtoHashTest, MapOrderIsIgnored) {
+  ProtobufWkt::Struct a;
+  ProtobufWkt::Struct b;
+  for (int i = 0; i < 100; ++i) {
+    (*a.mutable_fields())[absl::StrCat("key", i)].set_number_value(i);
+    (*b.mutable_fields())[absl::StrCat("key", 99 - i)].set_number_value(99 - i);
+  }
+  EXPECT_EQ(hash(a), hash(b));
+
+  (*b.mutable_fields())["key1"].set_number_value(2);
+  EXPECT_NE(hash(a), hash(b));
+}
+
+TEST(DeterministicProtoHashTest, AnyIsUnpacked) {
+  ProtobufWkt::Struct s;
+  (*s.mutable_fields())["ab"].set_string_value("fgh");
+  (*s.mutable_fields())["cde"].set_string_value("ij");
+
+  // Both serializations of the map are equivalent.
+  ProtobufWkt::Any a1;
+  a1.PackFrom(s);
+  ProtobufWkt::Any a2 = a1;
+  a1.set_value(Base64::decode("CgsKA2NkZRIEGgJpagoLCgJhYhIFGgNmZ2g="));
+  a2.set_value(Base64::decode("CgsKAmFiEgUaA2ZnaAoLCgNjZGUSBBoCaWo="));
+  EXPECT_NE(a1.value(), a2.value());
+  EXPECT_EQ(hash(a1), hash(a2));
+
+  // The type URL is part of the hash.
+  EXPECT_NE(hash(s), hash(a1));
+}
+
+TEST(DeterministicProtoHashTest, UnknownAnyTypeIsHashedAsBytes) {
+  ProtobufWkt::Any a;
+  a.set_type_url("type.googleapis.com/unknown.Type");
+  a.set_value("foo");
+  ProtobufWkt::Any b = a;
+  EXPECT_EQ(hash(a), hash(b));
+
+  b.set_value("bar");
+  EXPECT_NE(hash(a), hash(b));
+}
+
+} // namespace
+} // namespace DeterministicProtoHash
+} // namespace Envoy
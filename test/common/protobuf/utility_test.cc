@@ -16,6 +16,7 @@
 
 #include "source/common/common/base64.h"
 #include "source/common/config/api_version.h"
+#include "source/common/protobuf/deterministic_hash.h"
 #include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/protobuf/utility.h"
@@ -184,6 +185,23 @@ TEST_F(ProtobufUtilityTest, MessageUtilHash) {
   EXPECT_NE(MessageUtil::hash(s), MessageUtil::hash(a1));
 }
 
+TEST_F(ProtobufUtilityTest, MessageUtilHashTextFormat) {
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.deterministic_proto_hash", "false"}});
+  ProtobufWkt::Struct s;
+  (*s.mutable_fields())["ab"].set_string_value("fgh");
+  (*s.mutable_fields())["cde"].set_string_value("ij");
+
+  ProtobufWkt::Any a1;
+  a1.PackFrom(s);
+  ProtobufWkt::Any a2 = a1;
+  a2.set_value(Base64::decode("CgsKA2NkZRIEGgJpagoLCgJhYhIFGgNmZ2g="));
+
+  EXPECT_EQ(MessageUtil::hash(a1), MessageUtil::hash(a2));
+  EXPECT_NE(MessageUtil::hash(s), MessageUtil::hash(a1));
+  EXPECT_NE(DeterministicProtoHash::hash(a1), MessageUtil::hash(a1));
+}
+
 TEST_F(ProtobufUtilityTest, MessageUtilHashAndEqualToIgnoreOriginalTypeField) {
   ProtobufWkt::Struct s;
   (*s.mutable_fields())["ab"].set_string_value("fgh");
@@ -1195,6 +1213,80 @@ TEST_F(ProtobufUtilityTest, MessageUtilLoadYamlDouble) {
   EXPECT_DOUBLE_EQ(1.0, v.value());
 }
 
+// Writing YAML straight to JSON must produce exactly what the YAML -> Value -> JSON path does.
+TEST_F(ProtobufUtilityTest, MessageUtilLoadYamlDirectJsonMatchesValue) {
+  const std::string yaml = R"EOF(
+node:
+  id: node1
+  metadata:
+    big: 9223372036854775807
+    negative: -3
+    hex: 0x10
+    flag: yes
+    quoted: !!str 42
+    empty: ~
+    list: [1, two, 3.5]
+  user_agent_name: envoy
+  user_agent_name: last_wins
+  !ignore anchors: &anchor
+    seconds: 1
+static_resources:
+  clusters:
+  - name: cluster_0
+    connect_timeout: 0.25s
+    lb_policy: round_robin
+    per_connection_buffer_limit_bytes: 4294967295
+    typed_extension_protocol_options:
+      envoy.test:
+        "@type": type.googleapis.com/google.protobuf.Duration
+        value: 1.5s
+stats_flush_interval: 5s
+)EOF";
+
+  envoy::config::bootstrap::v3::Bootstrap direct;
+  MessageUtil::loadFromYaml(yaml, direct, ProtobufMessage::getStrictValidationVisitor());
+
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.stream_yaml_to_proto", "false"}});
+  envoy::config::bootstrap::v3::Bootstrap from_value;
+  MessageUtil::loadFromYaml(yaml, from_value, ProtobufMessage::getStrictValidationVisitor());
+
+  EXPECT_THAT(direct, ProtoEq(from_value));
+  EXPECT_EQ("last_wins", direct.node().user_agent_name());
+  EXPECT_EQ(envoy::config::cluster::v3::Cluster::ROUND_ROBIN,
+            direct.static_resources().clusters(0).lb_policy());
+}
+
+// Both paths parse the same JSON, so errors read the same either way.
+TEST_F(ProtobufUtilityTest, MessageUtilLoadYamlDirectJsonErrors) {
+  const std::string bad_value = "node: { id: [1, 2] }";
+  const std::string unknown_field = "node: { id: node1, foo: bar }";
+
+  ProtobufMessage::ValidationVisitor& visitor = ProtobufMessage::getStrictValidationVisitor();
+  std::string direct_bad_value;
+  std::string direct_unknown_field;
+  envoy::config::bootstrap::v3::Bootstrap bootstrap;
+  try {
+    MessageUtil::loadFromYaml(bad_value, bootstrap, visitor);
+  } catch (const EnvoyException& e) {
+    direct_bad_value = e.what();
+  }
+  try {
+    MessageUtil::loadFromYaml(unknown_field, bootstrap, visitor);
+  } catch (const EnvoyException& e) {
+    direct_unknown_field = e.what();
+  }
+  EXPECT_THAT(direct_bad_value, testing::HasSubstr("Unable to parse JSON as proto"));
+  EXPECT_THAT(direct_unknown_field, testing::HasSubstr("foo"));
+
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.stream_yaml_to_proto", "false"}});
+  EXPECT_THROW_WITH_MESSAGE(MessageUtil::loadFromYaml(bad_value, bootstrap, visitor),
+                            EnvoyException, direct_bad_value);
+  EXPECT_THROW_WITH_MESSAGE(MessageUtil::loadFromYaml(unknown_field, bootstrap, visitor),
+                            EnvoyException, direct_unknown_field);
+}
+
 TEST_F(ProtobufUtilityTest, ValueUtilLoadFromYamlScalar) {
   EXPECT_EQ(ValueUtil::loadFromYaml("null").ShortDebugString(), "null_value: NULL_VALUE");
   EXPECT_EQ(ValueUtil::loadFromYaml("true").ShortDebugString(), "bool_value: true");
@@ -0,0 +1,71 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/tls.pb.h"
+
+#include "source/common/protobuf/message_validator_impl.h"
+#include "source/common/protobuf/utility.h"
+
+#include "test/test_common/test_runtime.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+// YAML for a bootstrap with the given number of static clusters, each with a few endpoints and a
+// TLS transport socket packed in an Any.
+std::string makeBootstrapYaml(int num_clusters) {
+  envoy::config::bootstrap::v3::Bootstrap bootstrap;
+  bootstrap.mutable_node()->set_id("benchmark_node");
+  for (int i = 0; i < num_clusters; ++i) {
+    auto* cluster = bootstrap.mutable_static_resources()->add_clusters();
+    cluster->set_name(absl::StrCat("cluster_", i));
+    cluster->set_type(envoy::config::cluster::v3::Cluster::STRICT_DNS);
+    cluster->mutable_connect_timeout()->set_nanos(250000000);
+    auto* load_assignment = cluster->mutable_load_assignment();
+    load_assignment->set_cluster_name(cluster->name());
+    auto* locality_endpoints = load_assignment->add_endpoints();
+    for (int j = 0; j < 4; ++j) {
+      auto* address = locality_endpoints->add_lb_endpoints()
+                          ->mutable_endpoint()
+                          ->mutable_address()
+                          ->mutable_socket_address();
+      address->set_address(absl::StrCat("backend", j, ".service", i, ".example.com"));
+      address->set_port_value(443);
+    }
+    envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+    tls_context.set_sni(absl::StrCat("service", i, ".example.com"));
+    tls_context.mutable_common_tls_context()->add_alpn_protocols("h2");
+    cluster->mutable_transport_socket()->set_name("envoy.transport_sockets.tls");
+    cluster->mutable_transport_socket()->mutable_typed_config()->PackFrom(tls_context);
+  }
+  return MessageUtil::getYamlStringFromMessage(bootstrap);
+}
+
+} // namespace
+
+// Loads a bootstrap from YAML. state.range(1) selects how the YAML becomes JSON: 0 through a
+// ProtobufWkt::Value and the JSON printer, 1 by writing the JSON text directly.
+static void bmLoadBootstrapFromYaml(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.stream_yaml_to_proto", state.range(1) == 0 ? "false" : "true"}});
+  const std::string yaml = makeBootstrapYaml(state.range(0));
+  for (auto _ : state) { // NOLINT
+    envoy::config::bootstrap::v3::Bootstrap bootstrap;
+    MessageUtil::loadFromYaml(yaml, bootstrap, ProtobufMessage::getStrictValidationVisitor());
+    benchmark::DoNotOptimize(bootstrap);
+  }
+}
+BENCHMARK(bmLoadBootstrapFromYaml)
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->ArgNames({"clusters", "direct_json"})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace Envoy
@@ -0,0 +1,143 @@
+// Datagrams delivered per second to a SO_REUSEPORT group of QUIC listen sockets, one per worker,
+// for many connections. With kernel routing the BPF program of ActiveQuicListenerFactory picks the
+// socket from the connection ID, otherwise the kernel picks it from the 4-tuple. The
+// "forwarded_ratio" counter is the fraction of datagrams that reached a socket other than the one
+// of the worker owning the connection, which ActiveQuicListener would forward to that worker. The
+// "lost" counter is the number of datagrams the kernel dropped.
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/listener/v3/quic_config.pb.h"
+
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/socket_option_factory.h"
+#include "source/common/quic/active_quic_listener.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/network_utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+constexpr uint32_t Workers = 4;
+constexpr uint32_t Clients = 64;
+constexpr uint32_t PacketSize = 64;
+// The number of datagrams in flight before the sockets are drained, small enough to fit in the
+// default socket receive buffers.
+constexpr uint32_t BatchSize = 64;
+// How long the sockets are drained for before the datagrams of a batch that were not received are
+// counted as lost.
+constexpr std::chrono::milliseconds DrainTimeout(1000);
+
+// A short header packet for the connection, with the connection ID starting at the 2nd byte.
+std::string shortHeaderPacket(uint32_t connection) {
+  std::string packet(PacketSize, '\0');
+  packet[0] = 0x40;
+  // Spread the connection ID prefixes over the whole range.
+  const uint64_t connection_id = (connection + 1) * 0x9e3779b97f4a7c15;
+  for (size_t i = 0; i < sizeof(connection_id); ++i) {
+    packet[1 + i] = static_cast<char>(connection_id >> (8 * (7 - i)));
+  }
+  return packet;
+}
+
+// The worker owning the connection of the packet. Mirrors ActiveQuicListener::destination().
+uint32_t owningWorker(absl::string_view packet) {
+  uint32_t connection_id_snippet;
+  memcpy(&connection_id_snippet, packet.data() + 1, sizeof(connection_id_snippet));
+  return ntohl(connection_id_snippet) % Workers;
+}
+
+} // namespace
+
+// Args: {kernel_routing, connections}.
+static void bmQuicReusePortRouting(::benchmark::State& state) {
+  const bool kernel_routing = state.range(0);
+  const uint32_t connections = Envoy::benchmark::skipExpensiveBenchmarks() ? 100 : state.range(1);
+
+  Stats::IsolatedStoreImpl store;
+  QuicStatNames quic_stat_names(store.symbolTable());
+  ActiveQuicListenerFactory factory(envoy::config::listener::v3::QuicProtocolOptions(), Workers,
+                                    quic_stat_names);
+  auto options = std::make_shared<Network::Socket::Options>();
+  Network::Socket::appendOptions(options, Network::SocketOptionFactory::buildReusePortOptions());
+  if (kernel_routing) {
+    Network::Socket::appendOptions(options, factory.socketOptions());
+  }
+
+  // The sockets join the group in the order of the workers, as the listen sockets of a listener do.
+  const Network::Address::IpVersion version = TestEnvironment::getIpVersionsForTest()[0];
+  std::vector<Network::SocketPtr> sockets;
+  Network::Address::InstanceConstSharedPtr address =
+      Network::Test::getCanonicalLoopbackAddress(version);
+  for (uint32_t i = 0; i < Workers; ++i) {
+    sockets.push_back(std::make_unique<Network::UdpListenSocket>(address, options, true));
+    address = sockets.back()->addressProvider().localAddress();
+    const bool applied = Network::Socket::applyOptions(
+        options, *sockets.back(), envoy::config::core::v3::SocketOption::STATE_BOUND);
+    RELEASE_ASSERT(applied, "failed to apply the bound socket options");
+  }
+
+  std::vector<std::unique_ptr<Network::Test::UdpSyncPeer>> clients;
+  for (uint32_t i = 0; i < Clients; ++i) {
+    clients.push_back(std::make_unique<Network::Test::UdpSyncPeer>(version));
+  }
+  std::vector<std::string> packets;
+  packets.reserve(connections);
+  for (uint32_t i = 0; i < connections; ++i) {
+    packets.push_back(shortHeaderPacket(i));
+  }
+
+  uint64_t delivered = 0;
+  uint64_t forwarded = 0;
+  uint64_t lost = 0;
+  uint32_t next = 0;
+  char buffer[PacketSize];
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (uint32_t i = 0; i < BatchSize; ++i) {
+      clients[(next + i) % Clients]->write(packets[(next + i) % connections], *address);
+    }
+
+    // Drain the sockets until the whole batch has been received, or until the datagrams still
+    // missing can be assumed to have been dropped.
+    uint32_t received = 0;
+    const auto deadline = std::chrono::steady_clock::now() + DrainTimeout;
+    while (received < BatchSize && std::chrono::steady_clock::now() < deadline) {
+      for (uint32_t worker = 0; worker < Workers; ++worker) {
+        while (sockets[worker]->ioHandle().recv(buffer, sizeof(buffer), 0).ok()) {
+          ++received;
+          forwarded += owningWorker(absl::string_view(buffer, sizeof(buffer))) != worker;
+        }
+      }
+    }
+    delivered += received;
+    lost += BatchSize - received;
+    next = (next + BatchSize) % connections;
+  }
+  state.counters["datagrams"] = ::benchmark::Counter(delivered, ::benchmark::Counter::kIsRate);
+  state.counters["forwarded_ratio"] =
+      delivered > 0 ? static_cast<double>(forwarded) / delivered : 0;
+  state.counters["lost"] = lost;
+}
+
+static void quicReusePortRoutingParams(::benchmark::internal::Benchmark* b) {
+  for (auto kernel_routing : {false, true}) {
+    for (auto connections : {1000, 100000}) {
+      b->Args({kernel_routing, connections});
+    }
+  }
+}
+
+BENCHMARK(bmQuicReusePortRouting)->Apply(quicReusePortRoutingParams);
+
+} // namespace Quic
+} // namespace Envoy
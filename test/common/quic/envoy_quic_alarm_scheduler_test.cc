@@ -0,0 +1,303 @@
+#include "source/common/quic/envoy_quic_alarm_factory.h"
+#include "source/common/quic/envoy_quic_alarm_scheduler.h"
+#include "source/common/quic/platform/envoy_quic_clock.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using Envoy::Event::Dispatcher;
+using quic::QuicTime;
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+class TestDelegate : public quic::QuicAlarm::Delegate {
+public:
+  explicit TestDelegate(std::function<void()> on_alarm = nullptr) : on_alarm_(on_alarm) {}
+
+  // quic::QuicAlarm::Delegate
+  void OnAlarm() override {
+    ++fired_;
+    if (on_alarm_) {
+      on_alarm_();
+    }
+  }
+
+  uint32_t fired() const { return fired_; }
+
+private:
+  std::function<void()> on_alarm_;
+  uint32_t fired_{0};
+};
+
+class EnvoyQuicAlarmSchedulerTest : public ::testing::Test {
+public:
+  EnvoyQuicAlarmSchedulerTest()
+      : api_(Api::createApiForTest(time_system_)),
+        dispatcher_(api_->allocateDispatcher("test_thread")), clock_(*dispatcher_) {
+    scheduler_ = std::make_unique<EnvoyQuicAlarmScheduler>(
+        *dispatcher_, clock_, EnvoyQuicAlarmScheduler::generateStats(store_, "scheduler"));
+    alarm_factory_ =
+        std::make_unique<EnvoyQuicAlarmFactory>(*dispatcher_, clock_, scheduler_.get());
+  }
+
+  void advanceMsAndLoop(int64_t delay_ms) {
+    time_system_.advanceTimeAndRun(std::chrono::milliseconds(delay_ms), *dispatcher_,
+                                   Dispatcher::RunType::NonBlock);
+  }
+
+  void advanceUsAndLoop(int64_t delay_us) {
+    time_system_.advanceTimeAndRun(std::chrono::microseconds(delay_us), *dispatcher_,
+                                   Dispatcher::RunType::NonBlock);
+  }
+
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> createAlarm(TestDelegate* delegate) {
+    return alarm_factory_->CreateAlarm(
+        quic::QuicArenaScopedPtr<quic::QuicAlarm::Delegate>(delegate), &arena_);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counterFromString("scheduler." + name).value();
+  }
+
+  uint64_t gauge(const std::string& name) {
+    return store_.gaugeFromString("scheduler." + name, Stats::Gauge::ImportMode::Accumulate)
+        .value();
+  }
+
+protected:
+  Event::SimulatedTimeSystemHelper time_system_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  EnvoyQuicClock clock_;
+  Stats::IsolatedStoreImpl store_;
+  std::unique_ptr<EnvoyQuicAlarmScheduler> scheduler_;
+  std::unique_ptr<EnvoyQuicAlarmFactory> alarm_factory_;
+  quic::QuicConnectionArena arena_;
+};
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, FireAtDeadlineInBatch) {
+  std::vector<TestDelegate*> delegates;
+  std::vector<quic::QuicArenaScopedPtr<quic::QuicAlarm>> alarms;
+  for (int i = 0; i < 3; ++i) {
+    delegates.push_back(new TestDelegate());
+    alarms.push_back(createAlarm(delegates.back()));
+    alarms.back()->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(10));
+  }
+  auto late_delegate = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> late_alarm = createAlarm(late_delegate);
+  late_alarm->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(20));
+  EXPECT_EQ(4, scheduler_->pendingAlarms());
+
+  advanceMsAndLoop(9);
+  for (auto* delegate : delegates) {
+    EXPECT_EQ(0, delegate->fired());
+  }
+  advanceMsAndLoop(1);
+  for (auto* delegate : delegates) {
+    EXPECT_EQ(1, delegate->fired());
+  }
+  EXPECT_EQ(0, late_delegate->fired());
+  EXPECT_EQ(1, scheduler_->pendingAlarms());
+  EXPECT_EQ(3, counter("alarms_fired"));
+  EXPECT_EQ(1, counter("wakeups"));
+  EXPECT_EQ(1, gauge("alarms_pending"));
+
+  advanceMsAndLoop(10);
+  EXPECT_EQ(1, late_delegate->fired());
+  EXPECT_EQ(0, scheduler_->pendingAlarms());
+  EXPECT_EQ(4, counter("alarms_fired"));
+  EXPECT_EQ(2, counter("wakeups"));
+}
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, FireAtExactDeadline) {
+  auto unowned_delegate = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm = createAlarm(unowned_delegate);
+  alarm->Set(clock_.Now() + QuicTime::Delta::FromMicroseconds(4500));
+
+  advanceUsAndLoop(4499);
+  EXPECT_EQ(0, unowned_delegate->fired());
+  advanceUsAndLoop(1);
+  EXPECT_EQ(1, unowned_delegate->fired());
+}
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, FireDeadlinesWithinTickSeparately) {
+  // Start on a tick boundary so that both deadlines are in the same tick.
+  const int64_t now_us = (clock_.Now() - QuicTime::Zero()).ToMicroseconds();
+  advanceUsAndLoop(EnvoyQuicAlarmScheduler::TickMicroseconds -
+                   now_us % EnvoyQuicAlarmScheduler::TickMicroseconds);
+  auto unowned_delegate1 = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm1 = createAlarm(unowned_delegate1);
+  alarm1->Set(clock_.Now() + QuicTime::Delta::FromMicroseconds(2700));
+  auto unowned_delegate2 = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm2 = createAlarm(unowned_delegate2);
+  alarm2->Set(clock_.Now() + QuicTime::Delta::FromMicroseconds(2200));
+
+  advanceUsAndLoop(2200);
+  EXPECT_EQ(0, unowned_delegate1->fired());
+  EXPECT_EQ(1, unowned_delegate2->fired());
+  EXPECT_EQ(1, scheduler_->pendingAlarms());
+  advanceUsAndLoop(499);
+  EXPECT_EQ(0, unowned_delegate1->fired());
+  advanceUsAndLoop(1);
+  EXPECT_EQ(1, unowned_delegate1->fired());
+  EXPECT_EQ(0, scheduler_->pendingAlarms());
+  EXPECT_EQ(2, counter("wakeups"));
+}
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, FireManyDeadlinesWithinTickInOrder) {
+  // Start on a tick boundary so that all the deadlines are in the same tick.
+  const int64_t now_us = (clock_.Now() - QuicTime::Zero()).ToMicroseconds();
+  advanceUsAndLoop(EnvoyQuicAlarmScheduler::TickMicroseconds -
+                   now_us % EnvoyQuicAlarmScheduler::TickMicroseconds);
+  std::vector<TestDelegate*> delegates;
+  std::vector<quic::QuicArenaScopedPtr<quic::QuicAlarm>> alarms;
+  // Set the alarms in the reverse order of their deadlines, 10us apart.
+  for (int i = 99; i >= 0; --i) {
+    delegates.insert(delegates.begin(), new TestDelegate());
+    alarms.push_back(createAlarm(delegates.front()));
+    alarms.back()->Set(clock_.Now() + QuicTime::Delta::FromMicroseconds(5000 + 10 * i));
+  }
+
+  advanceUsAndLoop(5000);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(1, delegates[i]->fired());
+    if (i < 99) {
+      EXPECT_EQ(0, delegates[i + 1]->fired());
+      advanceUsAndLoop(10);
+    }
+  }
+  EXPECT_EQ(0, scheduler_->pendingAlarms());
+  EXPECT_EQ(100, counter("wakeups"));
+}
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, CancelEarliestDeadlineOfTick) {
+  // Start on a tick boundary so that both deadlines are in the same tick.
+  const int64_t now_us = (clock_.Now() - QuicTime::Zero()).ToMicroseconds();
+  advanceUsAndLoop(EnvoyQuicAlarmScheduler::TickMicroseconds -
+                   now_us % EnvoyQuicAlarmScheduler::TickMicroseconds);
+  auto unowned_delegate1 = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm1 = createAlarm(unowned_delegate1);
+  alarm1->Set(clock_.Now() + QuicTime::Delta::FromMicroseconds(5200));
+  auto unowned_delegate2 = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm2 = createAlarm(unowned_delegate2);
+  alarm2->Set(clock_.Now() + QuicTime::Delta::FromMicroseconds(5700));
+  alarm1->Cancel();
+
+  // The timer wakes up at the cancelled deadline, and is re-armed for the remaining one.
+  advanceUsAndLoop(5200);
+  EXPECT_EQ(0, unowned_delegate2->fired());
+  EXPECT_EQ(1, counter("wakeups"));
+  advanceUsAndLoop(499);
+  EXPECT_EQ(0, unowned_delegate2->fired());
+  advanceUsAndLoop(1);
+  EXPECT_EQ(0, unowned_delegate1->fired());
+  EXPECT_EQ(1, unowned_delegate2->fired());
+  EXPECT_EQ(2, counter("wakeups"));
+}
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, CancelAndUpdate) {
+  auto unowned_delegate1 = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm1 = createAlarm(unowned_delegate1);
+  alarm1->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(10));
+  auto unowned_delegate2 = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm2 = createAlarm(unowned_delegate2);
+  alarm2->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(10));
+
+  alarm1->Cancel();
+  EXPECT_FALSE(alarm1->IsSet());
+  alarm2->Update(clock_.Now() + QuicTime::Delta::FromMilliseconds(5), QuicTime::Delta::Zero());
+  EXPECT_EQ(1, scheduler_->pendingAlarms());
+
+  advanceMsAndLoop(5);
+  EXPECT_EQ(1, unowned_delegate2->fired());
+  advanceMsAndLoop(5);
+  EXPECT_EQ(0, unowned_delegate1->fired());
+  EXPECT_EQ(1, unowned_delegate2->fired());
+  EXPECT_EQ(0, scheduler_->pendingAlarms());
+}
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, DeadlineBeyondWheel) {
+  auto unowned_delegate1 = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm1 = createAlarm(unowned_delegate1);
+  alarm1->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(3000));
+  auto unowned_delegate2 = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm2 = createAlarm(unowned_delegate2);
+  alarm2->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(5000));
+  auto unowned_delegate3 = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm3 = createAlarm(unowned_delegate3);
+  alarm3->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(100));
+
+  advanceMsAndLoop(100);
+  EXPECT_EQ(1, unowned_delegate3->fired());
+  advanceMsAndLoop(2899);
+  EXPECT_EQ(0, unowned_delegate1->fired());
+  advanceMsAndLoop(1);
+  EXPECT_EQ(1, unowned_delegate1->fired());
+  EXPECT_EQ(0, unowned_delegate2->fired());
+  advanceMsAndLoop(2000);
+  EXPECT_EQ(1, unowned_delegate2->fired());
+  EXPECT_EQ(0, scheduler_->pendingAlarms());
+}
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, PastDeadlineFiresInNextLoop) {
+  auto unowned_delegate = new TestDelegate();
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm = createAlarm(unowned_delegate);
+  alarm->Set(clock_.Now() - QuicTime::Delta::FromMilliseconds(1));
+  EXPECT_EQ(0, unowned_delegate->fired());
+  advanceUsAndLoop(1);
+  EXPECT_EQ(1, unowned_delegate->fired());
+}
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, ChangeOtherAlarmsWhileFiring) {
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm1;
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm2;
+  quic::QuicArenaScopedPtr<quic::QuicAlarm> alarm3;
+  // Whichever of alarm1 and alarm2 fires first deletes the other one and re-arms alarm3, which are
+  // due in the same batch.
+  auto unowned_delegate1 = new TestDelegate([&]() {
+    alarm2.reset();
+    alarm3->Update(clock_.Now() + QuicTime::Delta::FromMilliseconds(1), QuicTime::Delta::Zero());
+  });
+  auto unowned_delegate2 = new TestDelegate([&]() {
+    alarm1.reset();
+    alarm3->Update(clock_.Now() + QuicTime::Delta::FromMilliseconds(1), QuicTime::Delta::Zero());
+  });
+  auto unowned_delegate3 = new TestDelegate();
+  alarm1 = createAlarm(unowned_delegate1);
+  alarm2 = createAlarm(unowned_delegate2);
+  alarm3 = createAlarm(unowned_delegate3);
+  alarm1->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(10));
+  alarm2->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(10));
+  alarm3->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(10));
+
+  advanceMsAndLoop(10);
+  EXPECT_TRUE(alarm1.get() == nullptr || alarm2.get() == nullptr);
+  EXPECT_EQ(0, unowned_delegate3->fired());
+  EXPECT_EQ(1, scheduler_->pendingAlarms());
+  advanceMsAndLoop(1);
+  EXPECT_EQ(1, unowned_delegate3->fired());
+  EXPECT_EQ(0, scheduler_->pendingAlarms());
+}
+
+TEST_F(EnvoyQuicAlarmSchedulerTest, CreateUnownedAlarm) {
+  auto unowned_delegate = new TestDelegate();
+  quic::QuicAlarm* alarm = alarm_factory_->CreateAlarm(unowned_delegate);
+  alarm->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(10));
+  advanceMsAndLoop(10);
+  EXPECT_EQ(1, unowned_delegate->fired());
+  alarm->Set(clock_.Now() + QuicTime::Delta::FromMilliseconds(10));
+  // Deleting a set alarm cancels it.
+  delete alarm;
+  EXPECT_EQ(0, scheduler_->pendingAlarms());
+  advanceMsAndLoop(10);
+}
+
+} // namespace
+} // namespace Quic
+} // namespace Envoy
@@ -0,0 +1,160 @@
+// Alarm updates per second for many QUIC connections on one dispatcher, with either one timer per
+// alarm or the alarms of all the connections scheduled by an EnvoyQuicAlarmScheduler. Each
+// connection keeps one alarm set a few milliseconds ahead, like the retransmission and ack alarms
+// that are pushed back on every packet, and the event loop runs between batches of updates. A
+// second benchmark measures the alarms firing when their deadlines are spread inside a single tick
+// of the scheduler's wheel.
+
+#include <memory>
+#include <vector>
+
+#include "source/common/quic/envoy_quic_alarm_factory.h"
+#include "source/common/quic/envoy_quic_alarm_scheduler.h"
+#include "source/common/quic/platform/envoy_quic_clock.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+// The number of alarm updates between runs of the event loop.
+constexpr uint32_t BatchSize = 64;
+
+class CountingDelegate : public quic::QuicAlarm::Delegate {
+public:
+  explicit CountingDelegate(uint64_t& fired) : fired_(fired) {}
+
+  // quic::QuicAlarm::Delegate
+  void OnAlarm() override { ++fired_; }
+
+private:
+  uint64_t& fired_;
+};
+
+} // namespace
+
+// Args: {scheduler, connections}.
+static void bmQuicAlarmUpdates(::benchmark::State& state) {
+  const bool use_scheduler = state.range(0);
+  const uint32_t connections = Envoy::benchmark::skipExpensiveBenchmarks() ? 100 : state.range(1);
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  EnvoyQuicClock clock(*dispatcher);
+  Stats::IsolatedStoreImpl store;
+  std::unique_ptr<EnvoyQuicAlarmScheduler> scheduler;
+  if (use_scheduler) {
+    scheduler = std::make_unique<EnvoyQuicAlarmScheduler>(
+        *dispatcher, clock, EnvoyQuicAlarmScheduler::generateStats(store, "scheduler"));
+  }
+  EnvoyQuicAlarmFactory alarm_factory(*dispatcher, clock, scheduler.get());
+
+  uint64_t fired = 0;
+  std::vector<quic::QuicArenaScopedPtr<quic::QuicAlarm>> alarms;
+  alarms.reserve(connections);
+  for (uint32_t i = 0; i < connections; ++i) {
+    alarms.push_back(alarm_factory.CreateAlarm(
+        quic::QuicArenaScopedPtr<quic::QuicAlarm::Delegate>(new CountingDelegate(fired)),
+        nullptr));
+  }
+
+  uint64_t updates = 0;
+  uint32_t next = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (uint32_t i = 0; i < BatchSize; ++i) {
+      // Spread the deadlines between 1 and 100ms from now. As packets are processed, the time
+      // read for each update moves on, so the deadlines are also spread inside the ticks.
+      alarms[next]->Update(clock.Now() +
+                               quic::QuicTime::Delta::FromMilliseconds(1 + (updates + i) % 100),
+                           quic::QuicTime::Delta::Zero());
+      next = (next + 1) % connections;
+    }
+    updates += BatchSize;
+    dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  state.counters["updates"] = ::benchmark::Counter(updates, ::benchmark::Counter::kIsRate);
+  state.counters["fired"] = ::benchmark::Counter(fired, ::benchmark::Counter::kIsRate);
+
+  // The alarms must be destroyed before the scheduler.
+  alarms.clear();
+}
+
+static void quicAlarmUpdatesParams(::benchmark::internal::Benchmark* b) {
+  for (auto use_scheduler : {false, true}) {
+    for (auto connections : {1000, 10000, 100000}) {
+      b->Args({use_scheduler, connections});
+    }
+  }
+}
+
+BENCHMARK(bmQuicAlarmUpdates)->Apply(quicAlarmUpdatesParams);
+
+// Args: {scheduler, alarms}.
+static void bmQuicAlarmsWithinTick(::benchmark::State& state) {
+  const bool use_scheduler = state.range(0);
+  const uint32_t alarm_count = state.range(1);
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  EnvoyQuicClock clock(*dispatcher);
+  Stats::IsolatedStoreImpl store;
+  std::unique_ptr<EnvoyQuicAlarmScheduler> scheduler;
+  if (use_scheduler) {
+    scheduler = std::make_unique<EnvoyQuicAlarmScheduler>(
+        *dispatcher, clock, EnvoyQuicAlarmScheduler::generateStats(store, "scheduler"));
+  }
+  EnvoyQuicAlarmFactory alarm_factory(*dispatcher, clock, scheduler.get());
+
+  uint64_t fired = 0;
+  std::vector<quic::QuicArenaScopedPtr<quic::QuicAlarm>> alarms;
+  alarms.reserve(alarm_count);
+  for (uint32_t i = 0; i < alarm_count; ++i) {
+    alarms.push_back(alarm_factory.CreateAlarm(
+        quic::QuicArenaScopedPtr<quic::QuicAlarm::Delegate>(new CountingDelegate(fired)),
+        nullptr));
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    // Spread the deadlines over the whole of the tick starting 2ms from now, in reverse order, and
+    // run the event loop until they have all fired.
+    const int64_t now_us = (clock.Now() - quic::QuicTime::Zero()).ToMicroseconds();
+    const quic::QuicTime tick_start =
+        quic::QuicTime::Zero() +
+        quic::QuicTime::Delta::FromMicroseconds(
+            (now_us / EnvoyQuicAlarmScheduler::TickMicroseconds + 2) *
+            EnvoyQuicAlarmScheduler::TickMicroseconds);
+    for (uint32_t i = 0; i < alarm_count; ++i) {
+      alarms[i]->Set(tick_start + quic::QuicTime::Delta::FromMicroseconds(
+                                      (alarm_count - 1 - i) *
+                                      EnvoyQuicAlarmScheduler::TickMicroseconds / alarm_count));
+    }
+    const uint64_t expected = fired + alarm_count;
+    while (fired < expected) {
+      dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+  state.counters["fired"] = ::benchmark::Counter(fired, ::benchmark::Counter::kIsRate);
+
+  // The alarms must be destroyed before the scheduler.
+  alarms.clear();
+}
+
+static void quicAlarmsWithinTickParams(::benchmark::internal::Benchmark* b) {
+  for (auto use_scheduler : {false, true}) {
+    for (auto alarm_count : {10, 100, 1000}) {
+      b->Args({use_scheduler, alarm_count});
+    }
+  }
+}
+
+BENCHMARK(bmQuicAlarmsWithinTick)->Apply(quicAlarmsWithinTickParams);
+
+} // namespace Quic
+} // namespace Envoy
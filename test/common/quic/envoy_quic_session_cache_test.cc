@@ -338,5 +338,26 @@ TEST_F(EnvoyQuicSessionCacheTest, Expiration) {
   EXPECT_EQ(1u, cache_.size());
 }
 
+// Sessions inserted through one handle of a shared cache can be resumed through another, which
+// outlives the cache's owner.
+TEST_F(EnvoyQuicSessionCacheTest, SharedCacheHandles) {
+  auto shared_cache = std::make_shared<SharedEnvoyQuicSessionCache>(time_source_);
+  std::unique_ptr<quic::SessionCache> handle1 = shared_cache->createHandle();
+  std::unique_ptr<quic::SessionCache> handle2 = shared_cache->createHandle();
+  bssl::UniquePtr<SSL_SESSION> session = makeSession();
+  SSL_SESSION* unowned = session.get();
+  quic::QuicServerId id1("a.com", 443);
+
+  handle1->Insert(id1, std::move(session), *params_, nullptr);
+  EXPECT_EQ(1u, shared_cache->size());
+  shared_cache.reset();
+
+  std::unique_ptr<quic::QuicResumptionState> resumption_state =
+      handle2->Lookup(id1, ssl_ctx_.get());
+  ASSERT_NE(resumption_state, nullptr);
+  EXPECT_EQ(unowned, resumption_state->tls_session.get());
+  EXPECT_EQ(nullptr, handle1->Lookup(id1, ssl_ctx_.get()));
+}
+
 } // namespace Quic
 } // namespace Envoy
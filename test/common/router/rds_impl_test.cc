@@ -1052,6 +1052,140 @@ TEST_F(RouteConfigProviderManagerImplTest, OnConfigUpdateWrongSize) {
       EnvoyException, "Unexpected RDS resource length: 2");
 }
 
+// Static providers with identical route configurations share the same Config.
+TEST_F(RouteConfigProviderManagerImplTest, StaticConfigsAreShared) {
+  const auto route_config = parseRouteConfigurationFromV3Yaml(R"EOF(
+name: foo
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: baz }
+)EOF");
+  auto other_route_config = route_config;
+  other_route_config.set_name("other");
+  server_factory_context_.cluster_manager_.initializeClusters({"baz"}, {});
+
+  RouteConfigProviderPtr provider1 =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          route_config, OptionalHttpFilters(), server_factory_context_, validation_visitor_);
+  RouteConfigProviderPtr provider2 =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          route_config, OptionalHttpFilters(), server_factory_context_, validation_visitor_);
+  RouteConfigProviderPtr provider3 =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          route_config, OptionalHttpFilters({"filter.optional"}), server_factory_context_,
+          validation_visitor_);
+  RouteConfigProviderPtr provider4 =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          other_route_config, OptionalHttpFilters(), server_factory_context_,
+          validation_visitor_);
+
+  EXPECT_EQ(provider1->config(), provider2->config());
+  EXPECT_EQ(&provider1->configInfo()->config_, &provider2->configInfo()->config_);
+  EXPECT_NE(provider1->config(), provider3->config());
+  EXPECT_NE(provider1->config(), provider4->config());
+  EXPECT_EQ("other", provider4->config()->name());
+
+  // The shared config outlives the provider that created it.
+  const ConfigConstSharedPtr config = provider1->config();
+  provider1.reset();
+  EXPECT_EQ(config, provider2->config());
+  provider2.reset();
+
+  RouteConfigProviderPtr provider5 =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          route_config, OptionalHttpFilters(), server_factory_context_, validation_visitor_);
+  EXPECT_NE(config, provider5->config());
+  UniversalStringMatcher universal_name_matcher;
+  EXPECT_EQ(3UL, route_config_provider_manager_->dumpRouteConfigs(universal_name_matcher)
+                     ->static_route_configs()
+                     .size());
+}
+
+// RDS updates reuse the virtual hosts whose configuration is unchanged.
+TEST_F(RouteConfigProviderManagerImplTest, UnchangedVirtualHostsAreReused) {
+  setup();
+  EXPECT_CALL(*server_factory_context_.cluster_manager_.subscription_factory_.subscription_,
+              start(_));
+  outer_init_manager_.initialize(init_watcher_);
+  EXPECT_CALL(init_watcher_, ready());
+
+  const std::string route_config_yaml = R"EOF(
+name: foo_route_config
+{}
+virtual_hosts:
+  - name: foo
+    domains: ["foo.com"]
+    routes:
+      - match: {{ prefix: "/" }}
+        route: {{ cluster: foo }}
+  - name: bar
+    domains: ["bar.com"]
+    routes:
+      - match: {{ prefix: "/" }}
+        route: {{ cluster: {} }}
+)EOF";
+  const auto update = [this, &route_config_yaml](const std::string& common_config,
+                                                 const std::string& bar_cluster) {
+    const auto route_config = parseRouteConfigurationFromV3Yaml(
+        fmt::format(route_config_yaml, common_config, bar_cluster));
+    const auto decoded_resources = TestUtility::decodeResources({route_config});
+    rds_callbacks_->onConfigUpdate(decoded_resources.refvec_, bar_cluster);
+  };
+  const auto route = [](const ConfigConstSharedPtr& config, const std::string& host) {
+    Http::TestRequestHeaderMapImpl headers{
+        {":authority", host}, {":path", "/"}, {":method", "GET"}, {"x-forwarded-proto", "http"}};
+    NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+    return config->route(headers, stream_info, 0)->routeEntry();
+  };
+
+  update("", "bar1");
+  // Keep the configs alive, so that the addresses of their virtual hosts are not reused.
+  const ConfigConstSharedPtr config1 = provider_->config();
+
+  update("", "bar2");
+  const ConfigConstSharedPtr config2 = provider_->config();
+  EXPECT_EQ(&route(config1, "foo.com")->virtualHost(), &route(config2, "foo.com")->virtualHost());
+  EXPECT_NE(&route(config1, "bar.com")->virtualHost(), &route(config2, "bar.com")->virtualHost());
+  EXPECT_EQ("bar2", route(config2, "bar.com")->clusterName());
+
+  // Virtual hosts are not reused when the configuration they share changes.
+  update("most_specific_header_mutations_wins: true", "bar2");
+  const ConfigConstSharedPtr config3 = provider_->config();
+  EXPECT_NE(&route(config2, "foo.com")->virtualHost(), &route(config3, "foo.com")->virtualHost());
+  EXPECT_TRUE(
+      route(config3, "foo.com")->virtualHost().routeConfig().mostSpecificHeaderMutationsWins());
+}
+
+// Static route configurations are looked up by a hash, so a shared one is only used when its
+// content and build parameters are equal to the requested ones.
+TEST_F(RouteConfigProviderManagerImplTest, StaticConfigMatchesComparesContent) {
+  const auto route_config = parseRouteConfigurationFromV3Yaml(R"EOF(
+name: foo
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: baz }
+)EOF");
+  auto other_route_config = route_config;
+  other_route_config.mutable_virtual_hosts(0)->set_name("other");
+  NiceMock<ProtobufMessage::MockValidationVisitor> other_validation_visitor;
+
+  const StaticRouteConfig static_config{route_config, OptionalHttpFilters(), validation_visitor_,
+                                        nullptr};
+  EXPECT_TRUE(static_config.matches(route_config, OptionalHttpFilters(), validation_visitor_));
+  EXPECT_FALSE(
+      static_config.matches(other_route_config, OptionalHttpFilters(), validation_visitor_));
+  EXPECT_FALSE(static_config.matches(route_config, OptionalHttpFilters({"filter.optional"}),
+                                     validation_visitor_));
+  EXPECT_FALSE(
+      static_config.matches(route_config, OptionalHttpFilters(), other_validation_visitor));
+}
+
 // Regression test for https://github.com/envoyproxy/envoy/issues/7939
 TEST_F(RouteConfigProviderManagerImplTest, ConfigDumpAfterConfigRejected) {
   UniversalStringMatcher universal_name_matcher;
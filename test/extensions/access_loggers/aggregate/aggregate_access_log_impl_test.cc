@@ -0,0 +1,175 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "envoy/config/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/aggregate/v3/aggregate.pb.h"
+
+#include "source/common/access_log/access_log_impl.h"
+#include "source/common/protobuf/utility.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/match.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Aggregate {
+namespace {
+
+class AggregateAccessLogTest : public testing::Test {
+public:
+  void initialize(const std::string& yaml) {
+    envoy::extensions::access_loggers::aggregate::v3::AggregateAccessLog aggregate_config;
+    TestUtility::loadFromYaml(yaml, aggregate_config);
+    envoy::config::accesslog::v3::AccessLog config;
+    config.set_name("envoy.access_loggers.aggregate");
+    config.mutable_typed_config()->PackFrom(aggregate_config);
+
+    Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File,
+                                          aggregate_config.path()};
+    EXPECT_CALL(context_.access_log_manager_, createAccessLog(file_info)).WillOnce(Return(file_));
+    ON_CALL(*file_, write(_)).WillByDefault(Invoke([this](absl::string_view data) {
+      ASSERT_TRUE(absl::EndsWith(data, "\n"));
+      ProtobufWkt::Struct line;
+      MessageUtil::loadFromJson(std::string(data), line);
+      lines_.push_back(line);
+    }));
+
+    timer_ = new NiceMock<Event::MockTimer>(&context_.dispatcher_);
+    logger_ = AccessLog::AccessLogFactory::fromProto(config, context_);
+  }
+
+  void log(uint32_t response_code, std::chrono::milliseconds duration) {
+    stream_info_.response_code_ = response_code;
+    stream_info_.end_time_ = duration;
+    logger_->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+  }
+
+  // Flushes the logger and returns the fields of the written entries keyed by their "code" field.
+  using Fields = Protobuf::Map<std::string, ProtobufWkt::Value>;
+  std::map<std::string, Fields> flush() {
+    lines_.clear();
+    timer_->invokeCallback();
+    std::map<std::string, Fields> entries;
+    for (const auto& line : lines_) {
+      const Fields& fields = line.fields();
+      entries[fields.contains("overflow") ? "overflow" : fields.at("code").string_value()] = fields;
+    }
+    return entries;
+  }
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> context_;
+  std::shared_ptr<NiceMock<AccessLog::MockAccessLogFile>> file_{
+      std::make_shared<NiceMock<AccessLog::MockAccessLogFile>>()};
+  Event::MockTimer* timer_{};
+  AccessLog::InstanceSharedPtr logger_;
+  std::vector<ProtobufWkt::Struct> lines_;
+  Http::TestRequestHeaderMapImpl request_headers_{{":method", "GET"}, {":path", "/"}};
+  Http::TestResponseHeaderMapImpl response_headers_;
+  Http::TestResponseTrailerMapImpl response_trailers_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+};
+
+TEST_F(AggregateAccessLogTest, GroupsAndQuantiles) {
+  initialize(R"EOF(
+path: /dev/null
+keys:
+  code: "%RESPONSE_CODE%"
+  method: "%REQ(:METHOD)%"
+duration_quantiles: [0.5, 0.999]
+)EOF");
+
+  for (int i = 1; i <= 100; i++) {
+    log(200, std::chrono::milliseconds(i));
+  }
+  log(503, std::chrono::milliseconds(1000));
+
+  auto entries = flush();
+  ASSERT_EQ(2, entries.size());
+
+  const Fields& ok = entries["200"];
+  EXPECT_EQ("GET", ok.at("method").string_value());
+  EXPECT_EQ(100, ok.at("count").number_value());
+  const Fields& durations = ok.at("duration_ms").struct_value().fields();
+  EXPECT_NEAR(50, durations.at("p50").number_value(), 2);
+  EXPECT_NEAR(100, durations.at("p99.9").number_value(), 2);
+
+  EXPECT_EQ(1, entries["503"].at("count").number_value());
+
+  // Aggregates are reset after each flush.
+  log(200, std::chrono::milliseconds(5));
+  entries = flush();
+  ASSERT_EQ(1, entries.size());
+  EXPECT_EQ(1, entries["200"].at("count").number_value());
+
+  // Nothing is written for an interval without requests.
+  EXPECT_TRUE(flush().empty());
+}
+
+TEST_F(AggregateAccessLogTest, Overflow) {
+  initialize(R"EOF(
+path: /dev/null
+keys:
+  code: "%RESPONSE_CODE%"
+max_groups: 2
+)EOF");
+
+  log(200, std::chrono::milliseconds(1));
+  log(404, std::chrono::milliseconds(1));
+  log(500, std::chrono::milliseconds(1));
+  log(503, std::chrono::milliseconds(1));
+  log(200, std::chrono::milliseconds(1));
+
+  auto entries = flush();
+  ASSERT_EQ(3, entries.size());
+  EXPECT_EQ(2, entries["200"].at("count").number_value());
+  EXPECT_EQ(1, entries["404"].at("count").number_value());
+  EXPECT_EQ(2, entries["overflow"].at("count").number_value());
+  EXPECT_FALSE(entries["overflow"].contains("code"));
+}
+
+TEST_F(AggregateAccessLogTest, RequestWithoutDuration) {
+  initialize(R"EOF(
+path: /dev/null
+keys:
+  code: "%RESPONSE_CODE%"
+)EOF");
+
+  stream_info_.response_code_ = 200;
+  stream_info_.end_time_.reset();
+  logger_->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+
+  auto entries = flush();
+  ASSERT_EQ(1, entries.size());
+  EXPECT_EQ(1, entries["200"].at("count").number_value());
+  EXPECT_FALSE(entries["200"].contains("duration_ms"));
+}
+
+TEST_F(AggregateAccessLogTest, InvalidConfig) {
+  envoy::extensions::access_loggers::aggregate::v3::AggregateAccessLog aggregate_config;
+  aggregate_config.set_path("/dev/null");
+  envoy::config::accesslog::v3::AccessLog config;
+  config.set_name("envoy.access_loggers.aggregate");
+  config.mutable_typed_config()->PackFrom(aggregate_config);
+  // At least one key is required.
+  EXPECT_THROW(AccessLog::AccessLogFactory::fromProto(config, context_), ProtoValidationException);
+}
+
+} // namespace
+} // namespace Aggregate
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -52,13 +52,14 @@ class MockGrpcAccessLoggerImpl
 public:
   MockGrpcAccessLoggerImpl(const Grpc::RawAsyncClientSharedPtr& client,
                            std::chrono::milliseconds buffer_flush_interval_msec,
-                           uint64_t max_buffer_size_bytes, Event::Dispatcher& dispatcher,
+                           uint64_t max_buffer_size_bytes,
+                           uint64_t max_pending_buffer_size_bytes, Event::Dispatcher& dispatcher,
                            Stats::Scope& scope, std::string access_log_prefix,
                            const Protobuf::MethodDescriptor& service_method,
                            envoy::config::core::v3::ApiVersion transport_api_version)
       : GrpcAccessLogger(std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes,
-                         dispatcher, scope, access_log_prefix, service_method,
-                         transport_api_version) {}
+                         max_pending_buffer_size_bytes, dispatcher, scope, access_log_prefix,
+                         service_method, transport_api_version) {}
 
   int numInits() const { return num_inits_; }
 
@@ -117,12 +118,18 @@ public:
   }
 
   void initLogger(std::chrono::milliseconds buffer_flush_interval_msec, size_t buffer_size_bytes) {
+    initLogger(buffer_flush_interval_msec, buffer_size_bytes,
+               buffer_size_bytes > 0 ? buffer_size_bytes : 16384);
+  }
+
+  void initLogger(std::chrono::milliseconds buffer_flush_interval_msec, size_t buffer_size_bytes,
+                  size_t max_pending_buffer_size_bytes) {
     timer_ = new Event::MockTimer(&dispatcher_);
     EXPECT_CALL(*timer_, enableTimer(buffer_flush_interval_msec, _));
     logger_ = std::make_unique<MockGrpcAccessLoggerImpl>(
         Grpc::RawAsyncClientPtr{async_client_}, buffer_flush_interval_msec, buffer_size_bytes,
-        dispatcher_, stats_store_, "mock_access_log_prefix.", mockMethodDescriptor(),
-        TRANSPORT_API_VERSION);
+        max_pending_buffer_size_bytes, dispatcher_, stats_store_, "mock_access_log_prefix.",
+        mockMethodDescriptor(), TRANSPORT_API_VERSION);
   }
 
   void expectStreamStart(MockAccessLogStream& stream, AccessLogCallbacks** callbacks_to_set) {
@@ -176,8 +183,7 @@ TEST_F(GrpcAccessLogTest, BasicFlow) {
   expectFlushedLogEntriesCount(stream, MOCK_TCP_LOG_FIELD_NAME, 1);
   logger_->log(ProtobufWkt::Empty());
   EXPECT_EQ(2, logger_->numClears());
-  // TCP logging doesn't change the logs_written counter.
-  EXPECT_EQ(1,
+  EXPECT_EQ(2,
             TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
 
   // Verify that sending an empty response message doesn't do anything bad.
@@ -195,7 +201,7 @@ TEST_F(GrpcAccessLogTest, BasicFlow) {
   EXPECT_EQ(3, logger_->numClears());
   EXPECT_EQ(0,
             TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
-  EXPECT_EQ(2,
+  EXPECT_EQ(3,
             TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
 }
 
@@ -246,6 +252,46 @@ TEST_F(GrpcAccessLogTest, WatermarksOverrun) {
             TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
 }
 
+// Test that entries buffered while the stream is backed up are bounded even with batching
+// disabled, and that both HTTP and TCP entries beyond the limit are dropped.
+TEST_F(GrpcAccessLogTest, PendingBufferLimit) {
+  InSequence s;
+  const size_t entry_size = mockHttpEntry().ByteSizeLong();
+  initLogger(FlushInterval, 0, 2 * entry_size);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+
+  // The stream is backed up, so both entries stay buffered.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).Times(2).WillRepeatedly(Return(true));
+  logger_->log(mockHttpEntry());
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(2,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+  EXPECT_EQ(0,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
+
+  // The limit is reached, so new entries are dropped after a failed flush attempt.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).Times(2).WillRepeatedly(Return(true));
+  EXPECT_CALL(stream, sendMessageRaw_(_, _)).Times(0);
+  logger_->log(ProtobufWkt::Empty());
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(0, logger_->numClears());
+  EXPECT_EQ(2,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+  EXPECT_EQ(2,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
+
+  // Once the stream drains, the buffered entries are sent and logging resumes.
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 2);
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 1);
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(2, logger_->numClears());
+  EXPECT_EQ(3,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+}
+
 // Test that stream failure is handled correctly.
 TEST_F(GrpcAccessLogTest, StreamFailure) {
   initLogger(FlushInterval, 0);
@@ -327,10 +373,12 @@ private:
   createLogger(const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config,
                envoy::config::core::v3::ApiVersion, const Grpc::RawAsyncClientSharedPtr& client,
                std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-               Event::Dispatcher& dispatcher, Stats::Scope& scope) override {
+               uint64_t max_pending_buffer_size_bytes, Event::Dispatcher& dispatcher,
+               Stats::Scope& scope) override {
     return std::make_shared<MockGrpcAccessLoggerImpl>(
-        std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes, dispatcher, scope,
-        "mock_access_log_prefix.", mockMethodDescriptor(), config.transport_api_version());
+        std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes,
+        max_pending_buffer_size_bytes, dispatcher, scope, "mock_access_log_prefix.",
+        mockMethodDescriptor(), config.transport_api_version());
   }
 };
 
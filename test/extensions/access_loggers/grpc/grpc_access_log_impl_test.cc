@@ -26,6 +26,7 @@ namespace {
 
 constexpr std::chrono::milliseconds FlushInterval(10);
 constexpr int BUFFER_SIZE_BYTES = 0;
+constexpr int MAX_PENDING_BUFFER_SIZE_BYTES = 16384;
 
 // A helper test class to mock and intercept GrpcAccessLoggerImpl streams.
 class GrpcAccessLoggerImplTestHelper {
@@ -72,7 +73,8 @@ public:
     EXPECT_CALL(*timer_, enableTimer(_, _));
     logger_ = std::make_unique<GrpcAccessLoggerImpl>(
         Grpc::RawAsyncClientPtr{async_client_}, "test_log_name", FlushInterval, BUFFER_SIZE_BYTES,
-        dispatcher_, local_info_, stats_store_, envoy::config::core::v3::ApiVersion::AUTO);
+        MAX_PENDING_BUFFER_SIZE_BYTES, dispatcher_, local_info_, stats_store_,
+        envoy::config::core::v3::ApiVersion::AUTO);
   }
 
   Grpc::MockAsyncClient* async_client_;
@@ -7,6 +7,7 @@
 #include "source/extensions/access_loggers/grpc/http_grpc_access_log_impl.h"
 
 #include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -58,6 +59,20 @@ TEST_F(HttpGrpcAccessLogConfigTest, Ok) {
   EXPECT_NE(nullptr, dynamic_cast<HttpGrpcAccessLog*>(instance.get()));
 }
 
+// A zero pending buffer limit would drop every entry, so it is rejected.
+TEST(HttpGrpcAccessLogConfigValidationTest, RejectZeroMaxPendingBufferSize) {
+  envoy::extensions::access_loggers::grpc::v3::HttpGrpcAccessLogConfig config;
+  auto* common_config = config.mutable_common_config();
+  common_config->set_log_name("foo");
+  common_config->mutable_grpc_service()->mutable_envoy_grpc()->set_cluster_name("bar");
+  common_config->mutable_max_pending_buffer_size_bytes()->set_value(0);
+  EXPECT_THROW_WITH_REGEX(TestUtility::validate(config), ProtoValidationException,
+                          "MaxPendingBufferSizeBytes: value must be greater than 0");
+
+  common_config->mutable_max_pending_buffer_size_bytes()->set_value(1);
+  TestUtility::validate(config);
+}
+
 } // namespace
 } // namespace HttpGrpc
 } // namespace AccessLoggers
@@ -30,6 +30,7 @@ namespace {
 
 constexpr std::chrono::milliseconds FlushInterval(10);
 constexpr int BUFFER_SIZE_BYTES = 0;
+constexpr int MAX_PENDING_BUFFER_SIZE_BYTES = 16384;
 const std::string ZONE_NAME = "zone_name";
 const std::string CLUSTER_NAME = "cluster_name";
 const std::string NODE_NAME = "node_name";
@@ -81,7 +82,8 @@ public:
     EXPECT_CALL(*timer_, enableTimer(_, _));
     logger_ = std::make_unique<GrpcAccessLoggerImpl>(
         Grpc::RawAsyncClientPtr{async_client_}, "test_log_name", FlushInterval, BUFFER_SIZE_BYTES,
-        dispatcher_, local_info_, stats_store_, envoy::config::core::v3::ApiVersion::V3);
+        MAX_PENDING_BUFFER_SIZE_BYTES, dispatcher_, local_info_, stats_store_,
+        envoy::config::core::v3::ApiVersion::V3);
   }
 
   Grpc::MockAsyncClient* async_client_;
@@ -0,0 +1,160 @@
+// Host insertion and lookup throughput of the dynamic forward proxy DNS cache with many hosts.
+// The resolver answers inline, so insertion measures the cache's own bookkeeping.
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
+
+#include "source/common/common/random_generator.h"
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace DynamicForwardProxy {
+namespace {
+
+class InlineDnsResolver : public Network::DnsResolver {
+public:
+  // Network::DnsResolver
+  Network::ActiveDnsQuery* resolve(const std::string&, Network::DnsLookupFamily,
+                                   ResolveCb callback) override {
+    std::list<Network::DnsResponse> response;
+    response.emplace_back(address_, std::chrono::seconds(60));
+    callback(ResolutionStatus::Success, std::move(response));
+    return nullptr;
+  }
+
+private:
+  const Network::Address::InstanceConstSharedPtr address_{
+      Network::Utility::parseInternetAddress("10.0.0.1")};
+};
+
+class NullLoadDnsCacheEntryCallbacks : public DnsCache::LoadDnsCacheEntryCallbacks {
+public:
+  // DnsCache::LoadDnsCacheEntryCallbacks
+  void onLoadDnsCacheComplete(const DnsHostInfoSharedPtr&) override {}
+};
+
+class DnsCacheBenchmark {
+public:
+  DnsCacheBenchmark(uint32_t hosts)
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {
+    hosts_.reserve(hosts);
+    for (uint32_t i = 0; i < hosts; ++i) {
+      hosts_.push_back(fmt::format("host{}.example.com", i));
+    }
+    envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig config;
+    config.set_name("bench");
+    config.mutable_max_hosts()->set_value(hosts);
+    cache_ = std::make_unique<DnsCacheImpl>(*dispatcher_, tls_, random_, loader_, store_, config,
+                                            std::make_shared<InlineDnsResolver>());
+  }
+
+  // Loads all the hosts, which are resolved on the next dispatcher run.
+  void load() {
+    std::vector<DnsCache::LoadDnsCacheEntryHandlePtr> handles;
+    handles.reserve(hosts_.size());
+    for (const std::string& host : hosts_) {
+      handles.push_back(cache_->loadDnsCacheEntry(host, 443, callbacks_).handle_);
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Random::RandomGeneratorImpl random_;
+  NiceMock<Runtime::MockLoader> loader_;
+  Stats::IsolatedStoreImpl store_;
+  NullLoadDnsCacheEntryCallbacks callbacks_;
+  std::vector<std::string> hosts_;
+  std::unique_ptr<DnsCacheImpl> cache_;
+};
+
+uint32_t hostsToLoad(::benchmark::State& state) {
+  // If we've been instructed to skip expensive tests, only load a few hosts.
+  return Envoy::benchmark::skipExpensiveBenchmarks() ? 100 : state.range(0);
+}
+
+} // namespace
+
+// Args: {hosts}.
+static void bmDnsCacheInsert(::benchmark::State& state) {
+  const uint32_t hosts = hostsToLoad(state);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    auto bench = std::make_unique<DnsCacheBenchmark>(hosts);
+    state.ResumeTiming();
+
+    bench->load();
+
+    state.PauseTiming();
+    bench.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * hosts);
+}
+BENCHMARK(bmDnsCacheInsert)->Arg(100000)->Arg(200000)->Unit(::benchmark::kMillisecond);
+
+// Args: {hosts}.
+static void bmDnsCacheLoadHit(::benchmark::State& state) {
+  DnsCacheBenchmark bench(hostsToLoad(state));
+  bench.load();
+
+  size_t next = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    auto result = bench.cache_->loadDnsCacheEntry(bench.hosts_[next], 443, bench.callbacks_);
+    RELEASE_ASSERT(result.status_ == DnsCache::LoadDnsCacheEntryStatus::InCache, "cache miss");
+    next = (next + 1) % bench.hosts_.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bmDnsCacheLoadHit)->Arg(100000)->Arg(200000);
+
+// Lookups from several threads, while the main thread is idle. Each thread walks the hosts from a
+// different offset.
+// Args: {hosts}.
+static void bmDnsCacheGetHostConcurrent(::benchmark::State& state) {
+  static std::unique_ptr<DnsCacheBenchmark> bench;
+  if (state.thread_index == 0) {
+    bench = std::make_unique<DnsCacheBenchmark>(hostsToLoad(state));
+    bench->load();
+  }
+
+  // The cache is only used inside the loop, which all the threads enter once it is built.
+  const size_t hosts = hostsToLoad(state);
+  size_t next = (state.thread_index * 7919) % hosts;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    ::benchmark::DoNotOptimize(bench->cache_->getHost(bench->hosts_[next]));
+    next = (next + 1) % hosts;
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index == 0) {
+    bench.reset();
+  }
+}
+BENCHMARK(bmDnsCacheGetHostConcurrent)->Arg(100000)->Arg(200000)->ThreadRange(1, 8);
+
+} // namespace DynamicForwardProxy
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -17,6 +17,7 @@
 
 using testing::DoAll;
 using testing::InSequence;
+using testing::Invoke;
 using testing::Return;
 using testing::SaveArg;
 
@@ -43,8 +44,8 @@ public:
     EXPECT_CALL(dispatcher_, isThreadSafe).WillRepeatedly(Return(true));
 
     EXPECT_CALL(dispatcher_, createDnsResolver(_, _)).WillOnce(Return(resolver_));
-    dns_cache_ =
-        std::make_unique<DnsCacheImpl>(dispatcher_, tls_, random_, loader_, store_, config_);
+    dns_cache_ = std::make_unique<DnsCacheImpl>(dispatcher_, tls_, random_, loader_, store_,
+                                                config_, nullptr);
     update_callbacks_handle_ = dns_cache_->addUpdateCallbacks(update_callbacks_);
   }
 
@@ -820,6 +821,41 @@ TEST_F(DnsCacheImplTest, MaxHostOverflow) {
   EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
 }
 
+// The hosts limit and the host map cover all the hosts, whichever shard they are stored in.
+TEST_F(DnsCacheImplTest, MaxHostOverflowManyHosts) {
+  const uint32_t max_hosts = 64;
+  initialize({} /* preresolve_hostnames */, max_hosts);
+
+  EXPECT_CALL(*resolver_, resolve(_, _, _))
+      .Times(max_hosts)
+      .WillRepeatedly(Invoke([](const std::string&, Network::DnsLookupFamily,
+                                Network::DnsResolver::ResolveCb callback) {
+        callback(Network::DnsResolver::ResolutionStatus::Success,
+                 TestUtility::makeDnsResponse({"10.0.0.1"}));
+        return nullptr;
+      }));
+  EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate(_, _)).Times(max_hosts);
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  for (uint32_t i = 0; i < max_hosts; ++i) {
+    const std::string host = fmt::format("host{}.com", i);
+    EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading,
+              dns_cache_->loadDnsCacheEntry(host, 80, callbacks).status_);
+    EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::InCache,
+              dns_cache_->loadDnsCacheEntry(host, 80, callbacks).status_);
+  }
+  checkStats(max_hosts /* attempt */, max_hosts /* success */, 0 /* failure */,
+             max_hosts /* address changed */, max_hosts /* added */, 0 /* removed */,
+             max_hosts /* num hosts */);
+
+  uint32_t hosts = 0;
+  dns_cache_->iterateHostMap([&](absl::string_view, const DnsHostInfoSharedPtr&) { ++hosts; });
+  EXPECT_EQ(max_hosts, hosts);
+
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Overflow,
+            dns_cache_->loadDnsCacheEntry("overflow.com", 80, callbacks).status_);
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
+}
+
 TEST_F(DnsCacheImplTest, CircuitBreakersNotInvoked) {
   initialize();
 
@@ -842,7 +878,7 @@ TEST_F(DnsCacheImplTest, UseTcpForDnsLookupsOptionSetDeprecatedField) {
   envoy::config::core::v3::DnsResolverOptions dns_resolver_options;
   EXPECT_CALL(dispatcher_, createDnsResolver(_, _))
       .WillOnce(DoAll(SaveArg<1>(&dns_resolver_options), Return(resolver_)));
-  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_);
+  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_, nullptr);
   // `true` here means dns_resolver_options.use_tcp_for_dns_lookups is set to true.
   EXPECT_EQ(true, dns_resolver_options.use_tcp_for_dns_lookups());
 }
@@ -855,7 +891,7 @@ TEST_F(DnsCacheImplTest, UseTcpForDnsLookupsOptionSet) {
   envoy::config::core::v3::DnsResolverOptions dns_resolver_options;
   EXPECT_CALL(dispatcher_, createDnsResolver(_, _))
       .WillOnce(DoAll(SaveArg<1>(&dns_resolver_options), Return(resolver_)));
-  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_);
+  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_, nullptr);
   // `true` here means dns_resolver_options.use_tcp_for_dns_lookups is set to true.
   EXPECT_EQ(true, dns_resolver_options.use_tcp_for_dns_lookups());
 }
@@ -868,7 +904,7 @@ TEST_F(DnsCacheImplTest, NoDefaultSearchDomainOptionSet) {
   envoy::config::core::v3::DnsResolverOptions dns_resolver_options;
   EXPECT_CALL(dispatcher_, createDnsResolver(_, _))
       .WillOnce(DoAll(SaveArg<1>(&dns_resolver_options), Return(resolver_)));
-  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_);
+  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_, nullptr);
   // `true` here means dns_resolver_options.no_default_search_domain is set to true.
   EXPECT_EQ(true, dns_resolver_options.no_default_search_domain());
 }
@@ -878,7 +914,7 @@ TEST_F(DnsCacheImplTest, UseTcpForDnsLookupsOptionUnSet) {
   envoy::config::core::v3::DnsResolverOptions dns_resolver_options;
   EXPECT_CALL(dispatcher_, createDnsResolver(_, _))
       .WillOnce(DoAll(SaveArg<1>(&dns_resolver_options), Return(resolver_)));
-  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_);
+  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_, nullptr);
   // `false` here means dns_resolver_options.use_tcp_for_dns_lookups is set to false.
   EXPECT_EQ(false, dns_resolver_options.use_tcp_for_dns_lookups());
 }
@@ -888,7 +924,7 @@ TEST_F(DnsCacheImplTest, NoDefaultSearchDomainOptionUnSet) {
   envoy::config::core::v3::DnsResolverOptions dns_resolver_options;
   EXPECT_CALL(dispatcher_, createDnsResolver(_, _))
       .WillOnce(DoAll(SaveArg<1>(&dns_resolver_options), Return(resolver_)));
-  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_);
+  DnsCacheImpl dns_cache_(dispatcher_, tls_, random_, loader_, store_, config_, nullptr);
   // `false` here means dns_resolver_options.no_default_search_domain is set to false.
   EXPECT_EQ(false, dns_resolver_options.no_default_search_domain());
 }
@@ -900,7 +936,7 @@ TEST(DnsCacheManagerImplTest, LoadViaConfig) {
   NiceMock<Random::MockRandomGenerator> random;
   NiceMock<Runtime::MockLoader> loader;
   Stats::IsolatedStoreImpl store;
-  DnsCacheManagerImpl cache_manager(dispatcher, tls, random, loader, store);
+  DnsCacheManagerImpl cache_manager(dispatcher, tls, random, loader, store, nullptr);
 
   envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig config1;
   config1.set_name("foo");
@@ -937,7 +973,7 @@ TEST(DnsCacheConfigOptionsTest, EmtpyDnsResolutionConfig) {
   std::vector<Network::Address::InstanceConstSharedPtr> expected_empty_dns_resolvers;
   EXPECT_CALL(dispatcher, createDnsResolver(expected_empty_dns_resolvers, _))
       .WillOnce(Return(resolver));
-  DnsCacheImpl dns_cache_(dispatcher, tls, random, loader, store, config);
+  DnsCacheImpl dns_cache_(dispatcher, tls, random, loader, store, config, nullptr);
 }
 
 TEST(DnsCacheConfigOptionsTest, NonEmptyDnsResolutionConfig) {
@@ -959,7 +995,35 @@ TEST(DnsCacheConfigOptionsTest, NonEmptyDnsResolutionConfig) {
   EXPECT_CALL(dispatcher,
               createDnsResolver(CustomDnsResolversSizeEquals(expected_dns_resolvers), _))
       .WillOnce(Return(resolver));
-  DnsCacheImpl dns_cache_(dispatcher, tls, random, loader, store, config);
+  DnsCacheImpl dns_cache_(dispatcher, tls, random, loader, store, config, nullptr);
+}
+
+// Without a custom resolver config the shared resolver is used instead of creating one.
+TEST(DnsCacheConfigOptionsTest, SharedResolver) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  std::shared_ptr<Network::MockDnsResolver> shared_resolver{
+      std::make_shared<Network::MockDnsResolver>()};
+  envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig config;
+  EXPECT_CALL(dispatcher, createDnsResolver(_, _)).Times(0);
+  EXPECT_EQ(shared_resolver, DnsCacheImpl::selectDnsResolver(config, dispatcher, shared_resolver));
+}
+
+TEST(DnsCacheConfigOptionsTest, SharedResolverIgnoredWithCustomConfig) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  std::shared_ptr<Network::MockDnsResolver> shared_resolver{
+      std::make_shared<Network::MockDnsResolver>()};
+  std::shared_ptr<Network::MockDnsResolver> resolver{std::make_shared<Network::MockDnsResolver>()};
+  EXPECT_CALL(dispatcher, createDnsResolver(_, _)).Times(2).WillRepeatedly(Return(resolver));
+
+  envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig config;
+  config.mutable_dns_resolution_config()
+      ->mutable_dns_resolver_options()
+      ->set_no_default_search_domain(true);
+  EXPECT_EQ(resolver, DnsCacheImpl::selectDnsResolver(config, dispatcher, shared_resolver));
+
+  config.clear_dns_resolution_config();
+  config.set_use_tcp_for_dns_lookups(true);
+  EXPECT_EQ(resolver, DnsCacheImpl::selectDnsResolver(config, dispatcher, shared_resolver));
 }
 
 // Note: this test is done here, rather than a TYPED_TEST_SUITE in
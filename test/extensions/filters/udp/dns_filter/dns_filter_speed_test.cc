@@ -0,0 +1,188 @@
+// Queries answered per second for names forwarded to the external resolvers, with and without the
+// response cache. The external resolver is a DNS server on a loopback UDP socket served by the
+// same dispatcher, so that uncached queries include the resolver client and the network path,
+// though not the latency of a remote resolver.
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/filters/udp/dns_filter/v3alpha/dns_filter.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/udp/dns_filter/dns_filter.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/listener_factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "dns_filter_test_utils.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+
+// A DNS server answering every query with a single A record.
+class LocalDnsServer : public Network::UdpPacketProcessor {
+public:
+  explicit LocalDnsServer(Event::Dispatcher& dispatcher)
+      : socket_(Network::Utility::parseInternetAddress("127.0.0.1"), nullptr, true),
+        time_source_(dispatcher.timeSource()) {
+    socket_.ioHandle().initializeFileEvent(
+        dispatcher, [this](uint32_t) { onReadReady(); }, Event::PlatformDefaultTriggerType,
+        Event::FileReadyType::Read);
+  }
+
+  const Network::Address::InstanceConstSharedPtr& address() const {
+    return socket_.addressProvider().localAddress();
+  }
+
+  // Network::UdpPacketProcessor
+  void processPacket(Network::Address::InstanceConstSharedPtr,
+                     Network::Address::InstanceConstSharedPtr peer_address,
+                     Buffer::InstancePtr buffer, MonotonicTime) override {
+    // Keep the header and question of the query, dropping any additional records.
+    std::string answer = buffer->toString();
+    size_t offset = 12;
+    while (offset < answer.size() && answer[offset] != 0) {
+      offset += static_cast<uint8_t>(answer[offset]) + 1;
+    }
+    offset += 5;
+    if (offset > answer.size()) {
+      return;
+    }
+    answer.resize(offset);
+    // Flags: response, recursion desired and available, no error. One answer and no authority or
+    // additional records.
+    answer.replace(2, 10, std::string("\x81\x80\x00\x01\x00\x01\x00\x00\x00\x00", 10));
+    // The queried name, as a pointer to the question, with type A, class IN, a TTL of 300 seconds
+    // and the address 10.0.0.1.
+    answer.append(std::string(
+        "\xc0\x0c\x00\x01\x00\x01\x00\x00\x01\x2c\x00\x04\x0a\x00\x00\x01", 16));
+    Buffer::OwnedImpl response(answer);
+    Network::Utility::writeToSocket(socket_.ioHandle(), response, nullptr, *peer_address);
+  }
+  void onDatagramsDropped(uint32_t) override {}
+  uint64_t maxDatagramSize() const override { return Network::DEFAULT_UDP_MAX_DATAGRAM_SIZE; }
+  size_t numPacketsExpectedPerEventLoop() const override {
+    return Network::MAX_NUM_PACKETS_PER_EVENT_LOOP;
+  }
+
+private:
+  void onReadReady() {
+    uint32_t packets_dropped = 0;
+    Network::Utility::readPacketsFromSocket(socket_.ioHandle(), *address(), *this, time_source_,
+                                            false, packets_dropped);
+  }
+
+  Network::UdpListenSocket socket_;
+  TimeSource& time_source_;
+};
+
+// Args: {cache, names}.
+static void bmDnsFilterExternalQueries(benchmark::State& state) {
+  const bool cache = state.range(0);
+  const uint32_t names = state.range(1);
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  Stats::IsolatedStoreImpl stats_store;
+  NiceMock<Server::Configuration::MockListenerFactoryContext> context;
+  ON_CALL(context, scope()).WillByDefault(ReturnRef(stats_store));
+  ON_CALL(context, api()).WillByDefault(ReturnRef(*api));
+  LocalDnsServer server(*dispatcher);
+
+  NiceMock<Network::MockUdpReadFilterCallbacks> callbacks;
+  ON_CALL(callbacks, udpListener()).WillByDefault(ReturnRef(callbacks.udp_listener_));
+  ON_CALL(callbacks.udp_listener_, dispatcher()).WillByDefault(ReturnRef(*dispatcher));
+  uint64_t answered = 0;
+  ON_CALL(callbacks.udp_listener_, send(_))
+      .WillByDefault(Invoke([&answered](const Network::UdpSendData& send_data) {
+        ++answered;
+        auto result = Api::ioCallUint64ResultNoError();
+        result.rc_ = send_data.buffer_.length();
+        send_data.buffer_.drain(result.rc_);
+        return result;
+      }));
+
+  envoy::extensions::filters::udp::dns_filter::v3alpha::DnsFilterConfig config;
+  config.set_stat_prefix("bench");
+  auto* client_config = config.mutable_client_config();
+  client_config->mutable_max_pending_lookups()->set_value(1);
+  auto* resolver = client_config->mutable_dns_resolution_config()->add_resolvers();
+  resolver->mutable_socket_address()->set_address("127.0.0.1");
+  resolver->mutable_socket_address()->set_port_value(server.address()->ip()->port());
+  if (cache) {
+    client_config->mutable_response_cache();
+  }
+  config.mutable_server_config()->mutable_inline_dns_table();
+  auto filter_config = std::make_shared<DnsFilterEnvoyConfig>(context, config);
+  DnsFilter filter(callbacks, filter_config);
+
+  std::vector<std::string> queries;
+  queries.reserve(names);
+  for (uint32_t i = 0; i < names; ++i) {
+    queries.push_back(Utils::buildQueryForDomain(fmt::format("www.domain{}.com", i),
+                                                 DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN));
+  }
+
+  const Network::Address::InstanceConstSharedPtr local =
+      Network::Utility::parseInternetAddressAndPort("127.0.0.1:53");
+  const Network::Address::InstanceConstSharedPtr peer =
+      Network::Utility::parseInternetAddressAndPort("10.0.0.2:1000");
+  // Each query is answered before the next one is sent, as with a single pending lookup.
+  auto query = [&](uint32_t name) {
+    Network::UdpRecvData data;
+    data.addresses_.local_ = local;
+    data.addresses_.peer_ = peer;
+    data.buffer_ = std::make_unique<Buffer::OwnedImpl>(queries[name]);
+    const uint64_t expected = answered + 1;
+    filter.onData(data);
+    while (answered < expected) {
+      dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  };
+
+  // Fill the cache before measuring.
+  for (uint32_t i = 0; i < names; ++i) {
+    query(i);
+  }
+  RELEASE_ASSERT(filter_config->stats().external_a_record_answers_.value() == names,
+                 "failed to resolve all names");
+
+  const uint64_t answered_before = answered;
+  uint32_t next = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    query(next);
+    next = (next + 1) % names;
+  }
+  state.counters["queries"] =
+      benchmark::Counter(answered - answered_before, benchmark::Counter::kIsRate);
+}
+
+static void dnsFilterExternalQueriesParams(benchmark::internal::Benchmark* b) {
+  for (auto cache : {false, true}) {
+    for (auto names : {100, 10000}) {
+      b->Args({cache, names});
+    }
+  }
+}
+
+BENCHMARK(bmDnsFilterExternalQueries)->Apply(dnsFilterExternalQueriesParams);
+
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
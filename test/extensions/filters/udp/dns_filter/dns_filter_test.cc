@@ -199,6 +199,33 @@ server_config:
             - "10.0.0.1"
 )EOF";
 
+  const std::string forward_query_cache_config = R"EOF(
+stat_prefix: "my_prefix"
+client_config:
+  resolver_timeout: 1s
+  dns_resolution_config:
+    resolvers:
+    - socket_address:
+        address: "1.1.1.1"
+        port_value: 53
+  max_pending_lookups: 1
+  response_cache:
+    max_entries: 1
+    max_ttl: 60s
+    negative_ttl: 10s
+    prefetch_threshold:
+      value: 50
+server_config:
+  inline_dns_table:
+    external_retry_count: 0
+    virtual_domains:
+      - name: "www.foo1.com"
+        endpoint:
+          address_list:
+            address:
+            - "10.0.0.1"
+)EOF";
+
   const std::string external_dns_table_config = R"EOF(
 stat_prefix: "my_prefix"
 client_config:
@@ -1038,6 +1065,219 @@ TEST_F(DnsFilterTest, ExternalResolutionExceedMaxPendingLookups) {
   EXPECT_EQ(1, config_->stats().unanswered_queries_.value());
 }
 
+TEST_F(DnsFilterTest, ExternalResolutionCached) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  const std::string expected_address("130.207.244.251");
+  const std::string domain("www.foobaz.com");
+  setup(forward_query_cache_config);
+
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+
+  // The answer is cached for the TTL returned by the resolver, capped by max_ttl.
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({expected_address}, std::chrono::seconds(120)));
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  ASSERT_EQ(1, query_ctx_->answers_.size());
+  EXPECT_EQ(std::chrono::seconds(60), query_ctx_->answers_.begin()->second->ttl_);
+
+  // The same query is answered from the cache, with the TTL left.
+  simTime().advanceTimeWait(std::chrono::seconds(20));
+  sendQueryFromClient("10.0.0.2:1000", query);
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, query_ctx_->getQueryResponseCode());
+  ASSERT_EQ(1, query_ctx_->answers_.size());
+  std::list<std::string> expected{expected_address};
+  Utils::verifyAddress(expected, query_ctx_->answers_.begin()->second);
+  EXPECT_EQ(std::chrono::seconds(40), query_ctx_->answers_.begin()->second->ttl_);
+
+  // Once expired, the name is resolved again.
+  simTime().advanceTimeWait(std::chrono::seconds(40));
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve(domain, _, _)).WillOnce(Return(&resolver_->active_query_));
+  sendQueryFromClient("10.0.0.1:1000", query);
+
+  EXPECT_EQ(3, config_->stats().downstream_rx_queries_.value());
+  EXPECT_EQ(1, config_->stats().externally_resolved_queries_.value());
+  EXPECT_EQ(1, config_->stats().cache_hits_.value());
+  EXPECT_EQ(0, config_->stats().cache_prefetches_.value());
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
+TEST_F(DnsFilterTest, ExternalResolutionNegativeCached) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  const std::string domain("www.foobaz.com");
+  setup(forward_query_cache_config);
+
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Success, TestUtility::makeDnsResponse({}));
+
+  // The negative answer is cached for negative_ttl.
+  simTime().advanceTimeWait(std::chrono::seconds(5));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  EXPECT_TRUE(query_ctx_->parse_status_);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NAME_ERROR, query_ctx_->getQueryResponseCode());
+  EXPECT_EQ(0, query_ctx_->answers_.size());
+  EXPECT_EQ(1, config_->stats().cache_negative_hits_.value());
+  EXPECT_EQ(2, config_->stats().unanswered_queries_.value());
+
+  simTime().advanceTimeWait(std::chrono::seconds(5));
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve(domain, _, _)).WillOnce(Return(&resolver_->active_query_));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_EQ(1, config_->stats().cache_negative_hits_.value());
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
+TEST_F(DnsFilterTest, ExternalResolutionFailureNotCached) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  const std::string domain("www.foobaz.com");
+  setup(forward_query_cache_config);
+
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Failure, TestUtility::makeDnsResponse({}));
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NAME_ERROR, query_ctx_->getQueryResponseCode());
+
+  // A failed resolution, such as one from an unreachable resolver, is not served from the cache.
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve(domain, _, _)).WillOnce(Return(&resolver_->active_query_));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_EQ(0, config_->stats().cache_negative_hits_.value());
+  EXPECT_EQ(0, config_->stats().cache_hits_.value());
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
+TEST_F(DnsFilterTest, ExternalResolutionTimeoutNotCached) {
+  auto timeout_timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  const std::string domain("www.foobaz.com");
+  setup(forward_query_cache_config);
+
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  EXPECT_CALL(*resolver_, resolve(domain, _, _)).WillOnce(Return(&resolver_->active_query_));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  simTime().advanceTimeWait(std::chrono::milliseconds(1500));
+  timeout_timer->invokeCallback();
+
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve(domain, _, _)).WillOnce(Return(&resolver_->active_query_));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_EQ(0, config_->stats().cache_negative_hits_.value());
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
+TEST_F(DnsFilterTest, ExternalResolutionCachePrefetch) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  const std::string domain("www.foobaz.com");
+  setup(forward_query_cache_config);
+
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({"130.207.244.251"}, std::chrono::seconds(10)));
+
+  // Less than half of the TTL is left, so the answer is refreshed in the background. The client
+  // is answered from the cache meanwhile, and the refresh is only started once.
+  simTime().advanceTimeWait(std::chrono::seconds(6));
+  Network::DnsResolver::ResolveCb prefetch_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, Network::DnsLookupFamily::V4Only, _))
+      .WillOnce(DoAll(SaveArg<2>(&prefetch_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  sendQueryFromClient("10.0.0.1:1000", query);
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  ASSERT_EQ(1, query_ctx_->answers_.size());
+  EXPECT_EQ(std::chrono::seconds(4), query_ctx_->answers_.begin()->second->ttl_);
+  EXPECT_EQ(1, config_->stats().cache_prefetches_.value());
+
+  prefetch_cb(Network::DnsResolver::ResolutionStatus::Success,
+              TestUtility::makeDnsResponse({"130.207.244.252"}, std::chrono::seconds(10)));
+
+  // The refreshed answer outlives the original one.
+  simTime().advanceTimeWait(std::chrono::seconds(3));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  ASSERT_EQ(1, query_ctx_->answers_.size());
+  std::list<std::string> expected{"130.207.244.252"};
+  Utils::verifyAddress(expected, query_ctx_->answers_.begin()->second);
+  EXPECT_EQ(std::chrono::seconds(7), query_ctx_->answers_.begin()->second->ttl_);
+  EXPECT_EQ(3, config_->stats().cache_hits_.value());
+  EXPECT_EQ(1, config_->stats().externally_resolved_queries_.value());
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
+TEST_F(DnsFilterTest, ExternalResolutionCacheEviction) {
+  const std::string domain1("www.foobaz.com");
+  const std::string domain2("www.foobar.com");
+  setup(forward_query_cache_config);
+
+  const std::string query1 =
+      Utils::buildQueryForDomain(domain1, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  const std::string query2 =
+      Utils::buildQueryForDomain(domain2, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+
+  // The cache holds a single answer, so the second one evicts the first.
+  for (const auto& [domain, query] : {std::make_pair(domain1, query1),
+                                      std::make_pair(domain2, query2)}) {
+    new NiceMock<Event::MockTimer>(&dispatcher_);
+    Network::DnsResolver::ResolveCb resolve_cb;
+    EXPECT_CALL(*resolver_, resolve(domain, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+    sendQueryFromClient("10.0.0.1:1000", query);
+    resolve_cb(Network::DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"130.207.244.251"}, std::chrono::seconds(60)));
+  }
+  EXPECT_EQ(1, config_->stats().cache_evictions_.value());
+
+  sendQueryFromClient("10.0.0.1:1000", query2);
+  EXPECT_EQ(1, config_->stats().cache_hits_.value());
+
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve(domain1, _, _)).WillOnce(Return(&resolver_->active_query_));
+  sendQueryFromClient("10.0.0.1:1000", query1);
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
 TEST_F(DnsFilterTest, ConsumeExternalJsonTableTest) {
   InSequence s;
 
@@ -1710,6 +1950,66 @@ TEST_F(DnsFilterTest, InvalidNameLabelTest) {
   EXPECT_EQ(0, query_ctx_->answers_.size());
 }
 
+TEST_F(DnsFilterTest, InvalidNamePointerLoopTest) {
+  InSequence s;
+
+  setup(forward_query_off_config);
+  // In this buffer the query name is a compression pointer to itself. The filter must not follow
+  // it in a loop.
+  constexpr char dns_request[] = {
+      0x36, 0x71,   // Transaction ID
+      0x01, 0x20,   // Flags
+      0x00, 0x01,   // Questions
+      0x00, 0x00,   // Answers
+      0x00, 0x00,   // Authority RRs
+      0x00, 0x00,   // Additional RRs
+      '\xc0', 0x0c, // Pointer to the query record
+      0x00, 0x01,   // Query Type - A
+      0x00, 0x01,   // Query Class - IN
+  };
+
+  constexpr size_t count = sizeof(dns_request) / sizeof(dns_request[0]);
+  const std::string query = Utils::buildQueryFromBytes(dns_request, count);
+
+  sendQueryFromClient("10.0.0.1:1000", query);
+
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  EXPECT_FALSE(query_ctx_->parse_status_);
+  EXPECT_EQ(DNS_RESPONSE_CODE_FORMAT_ERROR, query_ctx_->getQueryResponseCode());
+  EXPECT_EQ(1, config_->stats().downstream_rx_invalid_queries_.value());
+}
+
+TEST_F(DnsFilterTest, EscapedNameLabelTest) {
+  InSequence s;
+
+  // Periods and unprintable characters within a label are escaped in the parsed name
+  constexpr char dns_request[] = {
+      0x36, 0x72,                               // Transaction ID
+      0x01, 0x20,                               // Flags
+      0x00, 0x01,                               // Questions
+      0x00, 0x00,                               // Answers
+      0x00, 0x00,                               // Authority RRs
+      0x00, 0x00,                               // Additional RRs
+      0x04, 0x61, 0x2e, 0x62, 0x07, 0x03, 0x63, // Query record for
+      0x6f, 0x6d, 0x00,                         // a\.b\007.com
+      0x00, 0x01,                               // Query Type - A
+      0x00, 0x01,                               // Query Class - IN
+  };
+
+  constexpr size_t count = sizeof(dns_request) / sizeof(dns_request[0]);
+
+  Network::UdpRecvData data{};
+  data.addresses_.peer_ = Network::Utility::parseInternetAddressAndPort("10.0.0.1:1000");
+  data.addresses_.local_ = listener_address_;
+  data.buffer_ = std::make_unique<Buffer::OwnedImpl>(dns_request, count);
+  data.receive_time_ = MonotonicTime(std::chrono::seconds(0));
+
+  query_ctx_ = response_parser_->createQueryContext(data, counters_);
+  EXPECT_TRUE(query_ctx_->parse_status_);
+  ASSERT_EQ(1, query_ctx_->queries_.size());
+  EXPECT_EQ("a\\.b\\007.com", query_ctx_->queries_.front()->name_);
+}
+
 TEST_F(DnsFilterTest, NotImplementedQueryTest) {
   InSequence s;
 
@@ -0,0 +1,90 @@
+// Queries parsed and responses serialized per second by the DNS filter's message parser. Responses
+// are built for A queries with up to the number of answers the filter returns.
+
+#include <memory>
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/random_generator.h"
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/udp/dns_filter/dns_parser.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "dns_filter_test_utils.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+
+class DnsParserBenchmark {
+public:
+  DnsParserBenchmark()
+      : api_(Api::createApiForTest()),
+        histogram_(store_.histogramFromString("latency", Stats::Histogram::Unit::Milliseconds)),
+        counters_(store_.counterFromString("underflow"), store_.counterFromString("overflow"),
+                  store_.counterFromString("failure")),
+        parser_(true, api_->timeSource(), 0, random_, histogram_),
+        query_(Utils::buildQueryForDomain("www.subdomain.domain.com", DNS_RECORD_TYPE_A,
+                                          DNS_RECORD_CLASS_IN, 1)) {}
+
+  DnsQueryContextPtr parse() {
+    Network::UdpRecvData data;
+    data.addresses_.local_ = local_;
+    data.addresses_.peer_ = peer_;
+    data.buffer_ = std::make_unique<Buffer::OwnedImpl>(query_);
+    return parser_.createQueryContext(data, counters_);
+  }
+
+  Api::ApiPtr api_;
+  Stats::IsolatedStoreImpl store_;
+  Random::RandomGeneratorImpl random_;
+  Stats::Histogram& histogram_;
+  DnsParserCounters counters_;
+  DnsMessageParser parser_;
+  const std::string query_;
+  const Network::Address::InstanceConstSharedPtr local_{
+      Network::Utility::parseInternetAddressAndPort("127.0.0.1:53")};
+  const Network::Address::InstanceConstSharedPtr peer_{
+      Network::Utility::parseInternetAddressAndPort("10.0.0.1:1000")};
+};
+
+static void bmDnsParseQuery(benchmark::State& state) {
+  DnsParserBenchmark bench;
+  RELEASE_ASSERT(bench.parse()->parse_status_, "failed to parse query");
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    benchmark::DoNotOptimize(bench.parse());
+  }
+}
+BENCHMARK(bmDnsParseQuery);
+
+// Args: {answers}.
+static void bmDnsBuildResponse(benchmark::State& state) {
+  DnsParserBenchmark bench;
+  DnsQueryContextPtr context = bench.parse();
+  RELEASE_ASSERT(context->parse_status_, "failed to parse query");
+  const auto& query = *context->queries_.front();
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    bench.parser_.storeDnsAnswerRecord(
+        context, query, std::chrono::seconds(300),
+        Network::Utility::parseInternetAddress(fmt::format("10.0.0.{}", i + 1)));
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::OwnedImpl response;
+    bench.parser_.buildResponseBuffer(context, response);
+    benchmark::DoNotOptimize(response.length());
+  }
+}
+BENCHMARK(bmDnsBuildResponse)->Arg(1)->Arg(8);
+
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,125 @@
+// Datagrams proxied per second from many concurrent downstream flows, with a session per flow that
+// is either an ActiveSession or a session in the shared upstream sockets flow table. Both hold an
+// upstream socket per flow, but flow table sessions have no idle timer of their own and are expired
+// in least recently used order by a single timer.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/udp/udp_proxy/udp_proxy_filter.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/mocks/upstream/host.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace UdpProxy {
+
+// Args: {shared sockets, flows}.
+static void bmUdpProxyFlows(benchmark::State& state) {
+  const bool shared = state.range(0);
+  const uint32_t flows = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && flows > 512) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  Stats::IsolatedStoreImpl stats_store;
+
+  // The upstream never reads. Once its buffer is full the kernel drops the datagrams, after the
+  // whole send path ran.
+  Network::UdpListenSocket upstream(Network::Utility::parseInternetAddress("127.0.0.1"), nullptr,
+                                    true);
+  NiceMock<Upstream::MockClusterManager> cluster_manager;
+  cluster_manager.initializeThreadLocalClusters({"fake_cluster"});
+  auto& host = *cluster_manager.thread_local_cluster_.lb_.host_;
+  EXPECT_CALL(host, address()).WillRepeatedly(Return(upstream.addressProvider().localAddress()));
+  EXPECT_CALL(host, health()).WillRepeatedly(Return(Upstream::Host::Health::Healthy));
+  // Allow a session per flow.
+  cluster_manager.thread_local_cluster_.cluster_.info_->resetResourceManager(flows, 0, 0, 0, 0);
+
+  NiceMock<Network::MockUdpReadFilterCallbacks> callbacks;
+  ON_CALL(callbacks, udpListener()).WillByDefault(ReturnRef(callbacks.udp_listener_));
+  ON_CALL(callbacks.udp_listener_, dispatcher()).WillByDefault(ReturnRef(*dispatcher));
+
+  envoy::extensions::filters::udp::udp_proxy::v3::UdpProxyConfig config;
+  config.set_stat_prefix("bench");
+  config.set_cluster("fake_cluster");
+  if (shared) {
+    config.mutable_shared_upstream_sockets()->mutable_max_sockets_per_host()->set_value(flows);
+  }
+  auto filter_config = std::make_shared<UdpProxyFilterConfig>(cluster_manager, api->timeSource(),
+                                                              stats_store, config);
+  UdpProxyFilter filter(callbacks, filter_config);
+
+  const Network::Address::InstanceConstSharedPtr local =
+      Network::Utility::parseInternetAddressAndPort("127.0.0.1:53");
+  std::vector<Network::Address::InstanceConstSharedPtr> peers;
+  peers.reserve(flows);
+  for (uint32_t i = 0; i < flows; ++i) {
+    peers.push_back(std::make_shared<Network::Address::Ipv4Instance>(
+        fmt::format("10.{}.{}.{}", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff), 1000));
+  }
+
+  const std::string payload(100, 'a');
+  auto send = [&](uint32_t flow) {
+    Network::UdpRecvData data;
+    data.addresses_.local_ = local;
+    data.addresses_.peer_ = peers[flow];
+    data.buffer_ = std::make_unique<Buffer::OwnedImpl>(payload);
+    data.receive_time_ = api->timeSource().monotonicTime();
+    filter.onData(data);
+  };
+
+  // Open all the flows before measuring.
+  for (uint32_t i = 0; i < flows; ++i) {
+    send(i);
+  }
+  RELEASE_ASSERT(filter_config->stats().downstream_sess_active_.value() == flows,
+                 "failed to open all flows");
+
+  uint64_t datagrams = 0;
+  uint32_t next = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    send(next);
+    next = (next + 1) % flows;
+    ++datagrams;
+  }
+  state.counters["datagrams"] = benchmark::Counter(datagrams, benchmark::Counter::kIsRate);
+}
+
+static void udpProxyFlowsParams(benchmark::internal::Benchmark* b) {
+  for (auto shared : {false, true}) {
+    for (auto flows : {512, 8192}) {
+      b->Args({shared, flows});
+    }
+  }
+}
+
+BENCHMARK(bmUdpProxyFlows)->Apply(udpProxyFlowsParams);
+
+} // namespace UdpProxy
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -72,7 +72,10 @@ public:
 
     void expectWriteToUpstream(const std::string& data, int sys_errno = 0,
                                const Network::Address::Ip* local_ip = nullptr) {
-      EXPECT_CALL(*idle_timer_, enableTimer(parent_.config_->sessionTimeout(), nullptr));
+      // Sessions in the flow table have no idle timer.
+      if (idle_timer_ != nullptr) {
+        EXPECT_CALL(*idle_timer_, enableTimer(parent_.config_->sessionTimeout(), nullptr));
+      }
       EXPECT_CALL(*socket_->io_handle_, sendmsg(_, 1, 0, _, _))
           .WillOnce(Invoke(
               [this, data, local_ip, sys_errno](
@@ -99,7 +102,9 @@ public:
 
     void recvDataFromUpstream(const std::string& data, int recv_sys_errno = 0,
                               int send_sys_errno = 0) {
-      EXPECT_CALL(*idle_timer_, enableTimer(parent_.config_->sessionTimeout(), nullptr));
+      if (idle_timer_ != nullptr) {
+        EXPECT_CALL(*idle_timer_, enableTimer(parent_.config_->sessionTimeout(), nullptr));
+      }
 
       if (parent_.expect_gro_) {
         EXPECT_CALL(*socket_->io_handle_, supportsUdpGro());
@@ -127,9 +132,10 @@ public:
       if (recv_sys_errno == 0) {
         // Send the datagram downstream.
         EXPECT_CALL(parent_.callbacks_.udp_listener_, send(_))
-            .WillOnce(Invoke([data, send_sys_errno](
-                                 const Network::UdpSendData& send_data) -> Api::IoCallUint64Result {
-              // TODO(mattklein123): Verify peer/local address.
+            .WillOnce(Invoke([this, data, send_sys_errno](const Network::UdpSendData& send_data)
+                                 -> Api::IoCallUint64Result {
+              // TODO(mattklein123): Verify local address.
+              last_downstream_peer_ = send_data.peer_address_.asString();
               EXPECT_EQ(send_data.buffer_.toString(), data);
               if (send_sys_errno == 0) {
                 send_data.buffer_.drain(send_data.buffer_.length());
@@ -156,6 +162,7 @@ public:
     NiceMock<Network::MockSocket>* socket_;
     std::map<int, std::map<int, int>> sock_opts_;
     Event::FileReadyCb file_event_cb_;
+    std::string last_downstream_peer_;
   };
 
   UdpProxyFilterTest()
@@ -194,19 +201,30 @@ public:
   }
 
   void recvDataFromDownstream(const std::string& peer_address, const std::string& local_address,
-                              const std::string& buffer) {
+                              const std::string& buffer,
+                              MonotonicTime receive_time = MonotonicTime(std::chrono::seconds(0))) {
     Network::UdpRecvData data;
     data.addresses_.peer_ = Network::Utility::parseInternetAddressAndPort(peer_address);
     data.addresses_.local_ = Network::Utility::parseInternetAddressAndPort(local_address);
     data.buffer_ = std::make_unique<Buffer::OwnedImpl>(buffer);
-    data.receive_time_ = MonotonicTime(std::chrono::seconds(0));
+    data.receive_time_ = receive_time;
     filter_->onData(data);
   }
 
   void expectSessionCreate(const Network::Address::InstanceConstSharedPtr& address) {
     test_sessions_.emplace_back(*this, address);
+    test_sessions_.back().idle_timer_ = new Event::MockTimer(&callbacks_.udp_listener_.dispatcher_);
+    expectSocketCreate();
+  }
+
+  // With shared upstream sockets, a TestSession stands for a session in the flow table.
+  void expectFlowSocketCreate(const Network::Address::InstanceConstSharedPtr& address) {
+    test_sessions_.emplace_back(*this, address);
+    expectSocketCreate();
+  }
+
+  void expectSocketCreate() {
     TestSession& new_session = test_sessions_.back();
-    new_session.idle_timer_ = new Event::MockTimer(&callbacks_.udp_listener_.dispatcher_);
     EXPECT_CALL(*filter_, createSocket(_))
         .WillOnce(Return(ByMove(Network::SocketPtr{test_sessions_.back().socket_})));
     EXPECT_CALL(
@@ -442,6 +460,165 @@ cluster: fake_cluster
                    ->value());
 }
 
+// With GSO, datagrams written upstream are sent together at the end of the event loop iteration.
+TEST_F(UdpProxyFilterTest, GsoBatchesUpstreamWrites) {
+  EXPECT_CALL(os_sys_calls_, supportsUdpGso()).WillRepeatedly(Return(true));
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+upstream_socket_config:
+  prefer_gro: false
+  prefer_gso: true
+  )EOF",
+        true, false);
+
+  expectSessionCreate(upstream_address_);
+  auto* flush_cb = new Event::MockSchedulableCallback(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(config_->sessionTimeout(), nullptr))
+      .Times(2);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, sendmsg(_, _, _, _, _)).Times(0);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "world");
+  EXPECT_TRUE(flush_cb->enabled_);
+  checkTransferStats(10 /*rx_bytes*/, 2 /*rx_datagrams*/, 0 /*tx_bytes*/, 0 /*tx_datagrams*/);
+
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, setOption(SOL_UDP, UDP_SEGMENT, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, sendmsg(_, _, 0, nullptr, _))
+      .WillOnce(Invoke([this](const Buffer::RawSlice* slices, uint64_t num_slice, int,
+                              const Network::Address::Ip*,
+                              const Network::Address::Instance& peer_address) {
+        std::string payload;
+        for (uint64_t i = 0; i < num_slice; ++i) {
+          payload.append(static_cast<const char*>(slices[i].mem_), slices[i].len_);
+        }
+        EXPECT_EQ("helloworld", payload);
+        EXPECT_EQ(*upstream_address_, peer_address);
+        return makeNoError(payload.size());
+      }));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(2, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_datagrams")
+                   ->value());
+  EXPECT_EQ(10, cluster_manager_.thread_local_cluster_.cluster_.info_->stats_
+                    .upstream_cx_tx_bytes_total_.value());
+}
+
+// Sessions in the flow table have sockets of their own, so every reply reaches its client, and are
+// expired by the expiry timer in the order they went idle.
+TEST_F(UdpProxyFilterTest, SharedUpstreamSocket) {
+  auto* expiry_timer = new Event::MockTimer(&callbacks_.udp_listener_.dispatcher_);
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+shared_upstream_sockets:
+  max_sockets_per_host: 2
+  )EOF");
+
+  expectFlowSocketCreate(upstream_address_);
+  EXPECT_CALL(*expiry_timer, enableTimer(config_->sessionTimeout(), nullptr));
+  test_sessions_[0].expectWriteToUpstream("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  expectFlowSocketCreate(upstream_address_);
+  test_sessions_[1].expectWriteToUpstream("hello2");
+  recvDataFromDownstream("10.0.0.3:1000", "10.0.0.2:80", "hello2");
+  EXPECT_EQ(2, config_->stats().downstream_sess_total_.value());
+  EXPECT_EQ(2, config_->stats().downstream_sess_active_.value());
+  test_sessions_[1].recvDataFromUpstream("world2");
+  EXPECT_EQ("10.0.0.3:1000", test_sessions_[1].last_downstream_peer_);
+  test_sessions_[0].recvDataFromUpstream("world");
+  EXPECT_EQ("10.0.0.1:1000", test_sessions_[0].last_downstream_peer_);
+  checkTransferStats(11 /*rx_bytes*/, 2 /*rx_datagrams*/, 11 /*tx_bytes*/, 2 /*tx_datagrams*/);
+
+  // The first session is used again later, so the second one expires first, and the timer is
+  // re-armed for the first one alone.
+  test_sessions_[0].expectWriteToUpstream("hello3");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello3",
+                         MonotonicTime(std::chrono::seconds(30)));
+  EXPECT_CALL(time_system_, monotonicTime())
+      .WillRepeatedly(Return(MonotonicTime(config_->sessionTimeout())));
+  EXPECT_CALL(*expiry_timer, enableTimer(std::chrono::milliseconds(30000), nullptr));
+  expiry_timer->invokeCallback();
+  EXPECT_EQ(1, config_->stats().idle_timeout_.value());
+  EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
+
+  EXPECT_CALL(time_system_, monotonicTime())
+      .WillRepeatedly(
+          Return(MonotonicTime(config_->sessionTimeout() + std::chrono::seconds(30))));
+  EXPECT_CALL(*expiry_timer, enableTimer(_, _)).Times(0);
+  expiry_timer->invokeCallback();
+  EXPECT_EQ(2, config_->stats().idle_timeout_.value());
+  EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
+
+  // The sockets were closed with their sessions, so that late replies to the expired sessions
+  // can't reach a new one, which gets a new socket.
+  EXPECT_CALL(*expiry_timer, enableTimer(_, nullptr));
+  expectFlowSocketCreate(upstream_address_);
+  test_sessions_[2].expectWriteToUpstream("hello4");
+  recvDataFromDownstream("10.0.0.3:1000", "10.0.0.2:80", "hello4");
+  test_sessions_[2].recvDataFromUpstream("world4");
+  EXPECT_EQ("10.0.0.3:1000", test_sessions_[2].last_downstream_peer_);
+  EXPECT_EQ(3, config_->stats().downstream_sess_total_.value());
+  EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
+}
+
+// Once a host has max_sockets_per_host sessions in the flow table, further sessions get an idle
+// timer of their own, and the replies of every session are still forwarded.
+TEST_F(UdpProxyFilterTest, SharedUpstreamSocketLimit) {
+  auto* expiry_timer = new Event::MockTimer(&callbacks_.udp_listener_.dispatcher_);
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+shared_upstream_sockets:
+  max_sockets_per_host: 1
+  )EOF");
+
+  EXPECT_CALL(*expiry_timer, enableTimer(config_->sessionTimeout(), nullptr));
+  expectFlowSocketCreate(upstream_address_);
+  test_sessions_[0].expectWriteToUpstream("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  expectSessionCreate(upstream_address_);
+  test_sessions_[1].expectWriteToUpstream("hello2");
+  recvDataFromDownstream("10.0.0.3:1000", "10.0.0.2:80", "hello2");
+  EXPECT_EQ(2, config_->stats().downstream_sess_total_.value());
+  EXPECT_EQ(2, config_->stats().downstream_sess_active_.value());
+
+  test_sessions_[0].recvDataFromUpstream("world");
+  EXPECT_EQ("10.0.0.1:1000", test_sessions_[0].last_downstream_peer_);
+  test_sessions_[1].recvDataFromUpstream("world2");
+  EXPECT_EQ("10.0.0.3:1000", test_sessions_[1].last_downstream_peer_);
+  test_sessions_[0].expectWriteToUpstream("hello3");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello3");
+  test_sessions_[1].expectWriteToUpstream("hello4");
+  recvDataFromDownstream("10.0.0.3:1000", "10.0.0.2:80", "hello4");
+  test_sessions_[0].recvDataFromUpstream("world3");
+  EXPECT_EQ("10.0.0.1:1000", test_sessions_[0].last_downstream_peer_);
+
+  // Removing the host removes its sessions and sockets.
+  cluster_manager_.thread_local_cluster_.cluster_.priority_set_.runUpdateCallbacks(
+      0, {}, {cluster_manager_.thread_local_cluster_.lb_.host_});
+  EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
+  expectFlowSocketCreate(upstream_address_);
+  test_sessions_[2].expectWriteToUpstream("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_EQ(3, config_->stats().downstream_sess_total_.value());
+  EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
+}
+
+TEST_F(UdpProxyFilterTest, SharedUpstreamSocketsWithOriginalSrcIp) {
+  auto config = R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+use_original_src_ip: true
+shared_upstream_sockets: {}
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(
+      setup(config), EnvoyException,
+      "Shared upstream sockets can't be used together with use_original_src_ip.");
+}
+
 // No upstream host handling.
 TEST_F(UdpProxyFilterTest, NoUpstreamHost) {
   InSequence s;
@@ -0,0 +1,172 @@
+// Handshake rate of a single worker serving many concurrent TLS handshakes, with the server's
+// private key operations performed inline (as without a private key provider) or on the offload
+// provider's crypto threads, one at a time or in batches.
+
+#include <memory>
+#include <vector>
+
+#include "envoy/extensions/private_key_providers/offload/v3alpha/offload.pb.h"
+
+#include "source/extensions/private_key_providers/offload/crypto_thread_pool.h"
+#include "source/extensions/private_key_providers/offload/offload_private_key_provider.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+
+namespace {
+
+std::string testDataPath(const std::string& file) {
+  return TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + file);
+}
+
+class NoopCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  // The benchmark loop retries all pending handshakes anyway.
+  void onPrivateKeyMethodComplete() override {}
+};
+
+struct Handshake {
+  Handshake(SSL_CTX* client_ctx, SSL_CTX* server_ctx)
+      : client_(SSL_new(client_ctx)), server_(SSL_new(server_ctx)) {
+    BIO* client_bio;
+    BIO* server_bio;
+    RELEASE_ASSERT(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0), "BIO_new_bio_pair");
+    SSL_set_bio(client_.get(), client_bio, client_bio);
+    SSL_set_bio(server_.get(), server_bio, server_bio);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+  }
+
+  // @return bool whether both sides finished the handshake.
+  bool step() {
+    const int client_result = SSL_do_handshake(client_.get());
+    const int server_result = SSL_do_handshake(server_.get());
+    if (client_result == 1 && server_result == 1) {
+      return true;
+    }
+    for (const auto& [ssl, result] : {std::make_pair(client_.get(), client_result),
+                                      std::make_pair(server_.get(), server_result)}) {
+      const int error = SSL_get_error(ssl, result);
+      RELEASE_ASSERT(error == SSL_ERROR_NONE || error == SSL_ERROR_WANT_READ ||
+                         error == SSL_ERROR_WANT_WRITE ||
+                         error == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION,
+                     "unexpected handshake error");
+    }
+    return false;
+  }
+
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+  bool done_{};
+};
+
+} // namespace
+
+// Args: {ecdsa, offload, concurrent handshakes, crypto threads, batch size}.
+static void bmHandshakes(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("offload_handshake_benchmark", &error));
+  TestEnvironment::setRunfiles(runfiles.get());
+
+  const bool ecdsa = state.range(0);
+  const bool offload = state.range(1);
+  const uint32_t concurrency = state.range(2);
+  const uint32_t thread_count = state.range(3);
+  const uint32_t batch_size = state.range(4);
+  const std::string cert = ecdsa ? "selfsigned_ecdsa_p256_cert.pem" : "selfsigned_cert.pem";
+  const std::string key = ecdsa ? "selfsigned_ecdsa_p256_key.pem" : "selfsigned_key.pem";
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  NoopCallbacks callbacks;
+
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  RELEASE_ASSERT(SSL_CTX_use_certificate_file(server_ctx.get(), testDataPath(cert).c_str(),
+                                              SSL_FILETYPE_PEM) > 0,
+                 "SSL_CTX_use_certificate_file");
+  // Every iteration must pay for a full handshake.
+  SSL_CTX_set_session_cache_mode(server_ctx.get(), SSL_SESS_CACHE_OFF);
+  SSL_CTX_set_num_tickets(server_ctx.get(), 0);
+
+  std::shared_ptr<OffloadPrivateKeyMethodProvider> provider;
+  if (offload) {
+    envoy::extensions::private_key_providers::offload::v3alpha::OffloadPrivateKeyMethodConfig
+        config;
+    config.mutable_private_key()->set_filename(testDataPath(key));
+    config.mutable_thread_count()->set_value(thread_count);
+    config.mutable_max_batch_size()->set_value(batch_size);
+    provider = std::make_shared<OffloadPrivateKeyMethodProvider>(
+        config, *api, std::make_shared<CryptoThreadPoolRegistry>(api->threadFactory()));
+    SSL_CTX_set_private_key_method(server_ctx.get(),
+                                   provider->getBoringSslPrivateKeyMethod().get());
+  } else {
+    RELEASE_ASSERT(SSL_CTX_use_PrivateKey_file(server_ctx.get(), testDataPath(key).c_str(),
+                                               SSL_FILETYPE_PEM) > 0,
+                   "SSL_CTX_use_PrivateKey_file");
+  }
+
+  uint64_t handshakes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    std::vector<std::unique_ptr<Handshake>> pending;
+    for (uint32_t i = 0; i < concurrency; ++i) {
+      pending.push_back(std::make_unique<Handshake>(client_ctx.get(), server_ctx.get()));
+      if (provider != nullptr) {
+        provider->registerPrivateKeyMethod(pending.back()->server_.get(), callbacks, *dispatcher);
+      }
+    }
+
+    // Drive the handshakes like a worker's event loop: progress whatever can progress, then pick
+    // up the results posted by the crypto threads.
+    uint32_t remaining = concurrency;
+    while (remaining > 0) {
+      for (auto& handshake : pending) {
+        if (!handshake->done_ && handshake->step()) {
+          handshake->done_ = true;
+          --remaining;
+        }
+      }
+      dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    }
+
+    if (provider != nullptr) {
+      for (auto& handshake : pending) {
+        provider->unregisterPrivateKeyMethod(handshake->server_.get());
+      }
+    }
+    handshakes += concurrency;
+  }
+  state.counters["handshakes"] = benchmark::Counter(handshakes, benchmark::Counter::kIsRate);
+}
+
+static void handshakeParams(benchmark::internal::Benchmark* b) {
+  for (auto ecdsa : {false, true}) {
+    for (auto concurrency : {1, 64}) {
+      b->Args({ecdsa, false, concurrency, 0, 0});
+      for (auto thread_count : {1, 4}) {
+        for (auto batch_size : {1, 16}) {
+          b->Args({ecdsa, true, concurrency, thread_count, batch_size});
+        }
+      }
+    }
+  }
+}
+
+BENCHMARK(bmHandshakes)->Apply(handshakeParams)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
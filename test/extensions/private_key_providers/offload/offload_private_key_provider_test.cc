@@ -0,0 +1,441 @@
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/private_key_providers/offload/v3alpha/offload.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/common.pb.h"
+#include "envoy/registry/registry.h"
+#include "envoy/ssl/private_key/private_key_config.h"
+
+#include "source/common/singleton/manager_impl.h"
+#include "source/extensions/private_key_providers/offload/crypto_thread_pool.h"
+#include "source/extensions/private_key_providers/offload/offload_private_key_provider.h"
+
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/evp.h"
+#include "openssl/rsa.h"
+#include "openssl/ssl.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+namespace {
+
+class MockPrivateKeyConnectionCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  MOCK_METHOD(void, onPrivateKeyMethodComplete, ());
+};
+
+class OffloadPrivateKeyProviderTest : public testing::Test {
+protected:
+  OffloadPrivateKeyProviderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        registry_(std::make_shared<CryptoThreadPoolRegistry>(api_->threadFactory())) {}
+
+  using Config =
+      envoy::extensions::private_key_providers::offload::v3alpha::OffloadPrivateKeyMethodConfig;
+
+  Config createConfig(const std::string& key_file) {
+    Config config;
+    config.mutable_private_key()->set_filename(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + key_file));
+    config.mutable_thread_count()->set_value(2);
+    return config;
+  }
+
+  std::shared_ptr<OffloadPrivateKeyMethodProvider> createProvider(const Config& config) {
+    return std::make_shared<OffloadPrivateKeyMethodProvider>(config, *api_, registry_);
+  }
+
+  std::shared_ptr<OffloadPrivateKeyMethodProvider> createProvider(const std::string& key_file) {
+    return createProvider(createConfig(key_file));
+  }
+
+  ssl_private_key_result_t sign(OffloadPrivateKeyMethodProvider& provider, SSL* ssl,
+                                std::vector<uint8_t>& out, size_t& out_len) {
+    return provider.getBoringSslPrivateKeyMethod()->sign(
+        ssl, out.data(), &out_len, out.size(), SSL_SIGN_ECDSA_SECP256R1_SHA256,
+        reinterpret_cast<const uint8_t*>(input_.data()), input_.size());
+  }
+
+  bssl::UniquePtr<SSL> createSsl(OffloadPrivateKeyMethodProvider& provider) {
+    bssl::UniquePtr<SSL> ssl(SSL_new(ctx_.get()));
+    provider.registerPrivateKeyMethod(ssl.get(), callbacks_, *dispatcher_);
+    return ssl;
+  }
+
+  // Runs the dispatcher until the provider reports the pending operation as done.
+  void waitForCompletion() {
+    EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).WillOnce(Invoke([this]() {
+      dispatcher_->exit();
+    }));
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  }
+
+  bool verify(EVP_PKEY* key, uint16_t signature_algorithm, const std::vector<uint8_t>& signature) {
+    bssl::ScopedEVP_MD_CTX ctx;
+    EVP_PKEY_CTX* pctx;
+    if (!EVP_DigestVerifyInit(ctx.get(), &pctx,
+                              SSL_get_signature_algorithm_digest(signature_algorithm), nullptr,
+                              key)) {
+      return false;
+    }
+    if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+        (!EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) ||
+         !EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1))) {
+      return false;
+    }
+    return EVP_DigestVerify(ctx.get(), signature.data(), signature.size(),
+                            reinterpret_cast<const uint8_t*>(input_.data()), input_.size());
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  CryptoThreadPoolRegistrySharedPtr registry_;
+  NiceMock<MockPrivateKeyConnectionCallbacks> callbacks_;
+  bssl::UniquePtr<SSL_CTX> ctx_{SSL_CTX_new(TLS_method())};
+  const std::string input_{"handshake transcript"};
+};
+
+TEST_F(OffloadPrivateKeyProviderTest, SignsEcdsaOnCryptoThread) {
+  auto provider = createProvider("selfsigned_ecdsa_p256_key.pem");
+  bssl::UniquePtr<SSL> ssl = createSsl(*provider);
+  auto method = provider->getBoringSslPrivateKeyMethod();
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry,
+            method->sign(ssl.get(), out.data(), &out_len, out.size(),
+                         SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                         reinterpret_cast<const uint8_t*>(input_.data()), input_.size()));
+  waitForCompletion();
+  EXPECT_EQ(ssl_private_key_success, method->complete(ssl.get(), out.data(), &out_len, out.size()));
+  out.resize(out_len);
+  EXPECT_TRUE(verify(provider->key().get(), SSL_SIGN_ECDSA_SECP256R1_SHA256, out));
+
+  provider->unregisterPrivateKeyMethod(ssl.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, SignsRsaPssOnCryptoThread) {
+  auto provider = createProvider("selfsigned_key.pem");
+  bssl::UniquePtr<SSL> ssl = createSsl(*provider);
+  auto method = provider->getBoringSslPrivateKeyMethod();
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry,
+            method->sign(ssl.get(), out.data(), &out_len, out.size(), SSL_SIGN_RSA_PSS_RSAE_SHA256,
+                         reinterpret_cast<const uint8_t*>(input_.data()), input_.size()));
+  // Not done until the completion was delivered on the dispatcher.
+  EXPECT_EQ(ssl_private_key_retry, method->complete(ssl.get(), out.data(), &out_len, out.size()));
+  waitForCompletion();
+  EXPECT_EQ(ssl_private_key_success, method->complete(ssl.get(), out.data(), &out_len, out.size()));
+  out.resize(out_len);
+  EXPECT_TRUE(verify(provider->key().get(), SSL_SIGN_RSA_PSS_RSAE_SHA256, out));
+
+  provider->unregisterPrivateKeyMethod(ssl.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, DecryptsRsaOnCryptoThread) {
+  auto provider = createProvider("selfsigned_key.pem");
+  bssl::UniquePtr<SSL> ssl = createSsl(*provider);
+  auto method = provider->getBoringSslPrivateKeyMethod();
+
+  RSA* rsa = EVP_PKEY_get0_RSA(provider->key().get());
+  // A leading zero keeps the raw plaintext below the modulus.
+  std::vector<uint8_t> plaintext(RSA_size(rsa), 'a');
+  plaintext[0] = 0;
+  std::vector<uint8_t> ciphertext(RSA_size(rsa));
+  size_t ciphertext_len = 0;
+  ASSERT_TRUE(RSA_encrypt(rsa, &ciphertext_len, ciphertext.data(), ciphertext.size(),
+                          plaintext.data(), plaintext.size(), RSA_NO_PADDING));
+
+  std::vector<uint8_t> out(RSA_size(rsa));
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry, method->decrypt(ssl.get(), out.data(), &out_len, out.size(),
+                                                   ciphertext.data(), ciphertext_len));
+  waitForCompletion();
+  EXPECT_EQ(ssl_private_key_success, method->complete(ssl.get(), out.data(), &out_len, out.size()));
+  out.resize(out_len);
+  EXPECT_EQ(plaintext, out);
+
+  provider->unregisterPrivateKeyMethod(ssl.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, SignsInlineOverPendingLimit) {
+  Config config = createConfig("selfsigned_ecdsa_p256_key.pem");
+  config.mutable_max_pending_operations()->set_value(1);
+  auto provider = createProvider(config);
+  bssl::UniquePtr<SSL> first = createSsl(*provider);
+  bssl::UniquePtr<SSL> second = createSsl(*provider);
+  auto method = provider->getBoringSslPrivateKeyMethod();
+
+  // Keep both crypto threads busy, so that the first operation stays queued.
+  absl::Notification unblock;
+  CryptoThreadPoolSharedPtr pool = registry_->pool(2);
+  for (uint32_t i = 0; i < pool->concurrency(); ++i) {
+    pool->post([&unblock]() { unblock.WaitForNotification(); });
+  }
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry,
+            method->sign(first.get(), out.data(), &out_len, out.size(),
+                         SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                         reinterpret_cast<const uint8_t*>(input_.data()), input_.size()));
+  EXPECT_EQ(ssl_private_key_success,
+            method->sign(second.get(), out.data(), &out_len, out.size(),
+                         SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                         reinterpret_cast<const uint8_t*>(input_.data()), input_.size()));
+  out.resize(out_len);
+  EXPECT_TRUE(verify(provider->key().get(), SSL_SIGN_ECDSA_SECP256R1_SHA256, out));
+
+  unblock.Notify();
+  waitForCompletion();
+  out.resize(1024);
+  EXPECT_EQ(ssl_private_key_success,
+            method->complete(first.get(), out.data(), &out_len, out.size()));
+
+  provider->unregisterPrivateKeyMethod(first.get());
+  provider->unregisterPrivateKeyMethod(second.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, RunsFullBatches) {
+  Config config = createConfig("selfsigned_ecdsa_p256_key.pem");
+  config.mutable_max_batch_size()->set_value(2);
+  // Long enough for the test to time out should the full batch not be handed over right away.
+  config.mutable_max_batch_delay()->set_seconds(1);
+  auto provider = createProvider(config);
+  bssl::UniquePtr<SSL> first = createSsl(*provider);
+  bssl::UniquePtr<SSL> second = createSsl(*provider);
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry, sign(*provider, first.get(), out, out_len));
+  EXPECT_EQ(ssl_private_key_retry, sign(*provider, second.get(), out, out_len));
+
+  uint32_t completions = 0;
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(2).WillRepeatedly(Invoke([&]() {
+    if (++completions == 2) {
+      dispatcher_->exit();
+    }
+  }));
+  const MonotonicTime start = api_->timeSource().monotonicTime();
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_LT(api_->timeSource().monotonicTime() - start, std::chrono::seconds(1));
+
+  for (SSL* ssl : {first.get(), second.get()}) {
+    out.resize(1024);
+    EXPECT_EQ(ssl_private_key_success, provider->getBoringSslPrivateKeyMethod()->complete(
+                                           ssl, out.data(), &out_len, out.size()));
+    out.resize(out_len);
+    EXPECT_TRUE(verify(provider->key().get(), SSL_SIGN_ECDSA_SECP256R1_SHA256, out));
+  }
+
+  provider->unregisterPrivateKeyMethod(first.get());
+  provider->unregisterPrivateKeyMethod(second.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, RunsPartialBatchAfterDelay) {
+  Config config = createConfig("selfsigned_ecdsa_p256_key.pem");
+  config.mutable_max_batch_size()->set_value(8);
+  config.mutable_max_batch_delay()->set_nanos(1000000);
+  auto provider = createProvider(config);
+  bssl::UniquePtr<SSL> ssl = createSsl(*provider);
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry, sign(*provider, ssl.get(), out, out_len));
+  waitForCompletion();
+  EXPECT_EQ(ssl_private_key_success, provider->getBoringSslPrivateKeyMethod()->complete(
+                                         ssl.get(), out.data(), &out_len, out.size()));
+
+  provider->unregisterPrivateKeyMethod(ssl.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, RunsEachPartialBatchAfterDelay) {
+  Config config = createConfig("selfsigned_ecdsa_p256_key.pem");
+  config.mutable_max_batch_size()->set_value(8);
+  config.mutable_max_batch_delay()->set_nanos(1000000);
+  auto provider = createProvider(config);
+  bssl::UniquePtr<SSL> first = createSsl(*provider);
+  bssl::UniquePtr<SSL> second = createSsl(*provider);
+
+  // Keep both crypto threads busy. The partial batch is handed over by the connection's timer
+  // anyway, and is run once a thread frees up.
+  absl::Notification unblock;
+  CryptoThreadPoolSharedPtr pool = registry_->pool(2);
+  for (uint32_t i = 0; i < pool->concurrency(); ++i) {
+    pool->post([&unblock]() { unblock.WaitForNotification(); });
+  }
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry, sign(*provider, first.get(), out, out_len));
+  // Wait out the delay of the first batch, so that the second operation opens a new batch.
+  Event::TimerPtr timer = dispatcher_->createTimer([this]() { dispatcher_->exit(); });
+  timer->enableTimer(std::chrono::milliseconds(50));
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(ssl_private_key_retry, sign(*provider, second.get(), out, out_len));
+
+  uint32_t completions = 0;
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(2).WillRepeatedly(Invoke([&]() {
+    if (++completions == 2) {
+      dispatcher_->exit();
+    }
+  }));
+  timer = dispatcher_->createTimer([&unblock]() { unblock.Notify(); });
+  timer->enableTimer(std::chrono::milliseconds(10));
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+
+  for (SSL* ssl : {first.get(), second.get()}) {
+    out.resize(1024);
+    EXPECT_EQ(ssl_private_key_success, provider->getBoringSslPrivateKeyMethod()->complete(
+                                           ssl, out.data(), &out_len, out.size()));
+  }
+
+  provider->unregisterPrivateKeyMethod(first.get());
+  provider->unregisterPrivateKeyMethod(second.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, ConnectionGoingAwayHandsOverItsBatch) {
+  Config config = createConfig("selfsigned_ecdsa_p256_key.pem");
+  config.mutable_max_batch_size()->set_value(8);
+  config.mutable_max_batch_delay()->set_seconds(1);
+  auto provider = createProvider(config);
+  bssl::UniquePtr<SSL> first = createSsl(*provider);
+  bssl::UniquePtr<SSL> second = createSsl(*provider);
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry, sign(*provider, first.get(), out, out_len));
+  EXPECT_EQ(ssl_private_key_retry, sign(*provider, second.get(), out, out_len));
+  // The first connection opened the batch and goes away before its delay passed.
+  const MonotonicTime start = api_->timeSource().monotonicTime();
+  provider->unregisterPrivateKeyMethod(first.get());
+
+  waitForCompletion();
+  EXPECT_LT(api_->timeSource().monotonicTime() - start, std::chrono::seconds(1));
+  EXPECT_EQ(ssl_private_key_success, provider->getBoringSslPrivateKeyMethod()->complete(
+                                         second.get(), out.data(), &out_len, out.size()));
+
+  provider->unregisterPrivateKeyMethod(second.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, RejectsSignatureAlgorithmOfOtherKeyType) {
+  auto provider = createProvider("selfsigned_ecdsa_p256_key.pem");
+  bssl::UniquePtr<SSL> ssl = createSsl(*provider);
+  auto method = provider->getBoringSslPrivateKeyMethod();
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_failure,
+            method->sign(ssl.get(), out.data(), &out_len, out.size(), SSL_SIGN_RSA_PSS_RSAE_SHA256,
+                         reinterpret_cast<const uint8_t*>(input_.data()), input_.size()));
+  EXPECT_EQ(ssl_private_key_failure, method->decrypt(ssl.get(), out.data(), &out_len, out.size(),
+                                                     out.data(), 32));
+
+  provider->unregisterPrivateKeyMethod(ssl.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, DropsCompletionOfClosedConnection) {
+  auto provider = createProvider("selfsigned_key.pem");
+  bssl::UniquePtr<SSL> ssl = createSsl(*provider);
+  auto method = provider->getBoringSslPrivateKeyMethod();
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry,
+            method->sign(ssl.get(), out.data(), &out_len, out.size(), SSL_SIGN_RSA_PSS_RSAE_SHA256,
+                         reinterpret_cast<const uint8_t*>(input_.data()), input_.size()));
+  provider->unregisterPrivateKeyMethod(ssl.get());
+
+  // Releasing the last provider joins the pool's threads, so the operation has finished.
+  provider.reset();
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(0);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, ServesRsaAndEcdsaCertificatesOnOneConnection) {
+  auto rsa_provider = createProvider("selfsigned_key.pem");
+  auto ecdsa_provider = createProvider("selfsigned_ecdsa_p256_key.pem");
+  bssl::UniquePtr<SSL> ssl = createSsl(*rsa_provider);
+  ecdsa_provider->registerPrivateKeyMethod(ssl.get(), callbacks_, *dispatcher_);
+  EXPECT_THROW_WITH_MESSAGE(
+      rsa_provider->registerPrivateKeyMethod(ssl.get(), callbacks_, *dispatcher_), EnvoyException,
+      "Can't distinguish between two offload private key providers with the same key type on one "
+      "connection.");
+
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry,
+            ecdsa_provider->getBoringSslPrivateKeyMethod()->sign(
+                ssl.get(), out.data(), &out_len, out.size(), SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                reinterpret_cast<const uint8_t*>(input_.data()), input_.size()));
+  waitForCompletion();
+  EXPECT_EQ(ssl_private_key_success, ecdsa_provider->getBoringSslPrivateKeyMethod()->complete(
+                                         ssl.get(), out.data(), &out_len, out.size()));
+  out.resize(out_len);
+  EXPECT_TRUE(verify(ecdsa_provider->key().get(), SSL_SIGN_ECDSA_SECP256R1_SHA256, out));
+
+  rsa_provider->unregisterPrivateKeyMethod(ssl.get());
+  ecdsa_provider->unregisterPrivateKeyMethod(ssl.get());
+}
+
+TEST_F(OffloadPrivateKeyProviderTest, RejectsInvalidKey) {
+  EXPECT_THROW_WITH_MESSAGE(createProvider("not_a_crl.crl"), EnvoyException,
+                            "Failed to load private key for the offload private key provider.");
+}
+
+TEST(CryptoThreadPoolRegistryTest, SharesPoolsByConcurrency) {
+  Api::ApiPtr api = Api::createApiForTest();
+  CryptoThreadPoolRegistry registry(api->threadFactory());
+  CryptoThreadPoolSharedPtr pool = registry.pool(2);
+  EXPECT_EQ(2, pool->concurrency());
+  EXPECT_EQ(pool, registry.pool(2));
+  EXPECT_NE(pool, registry.pool(1));
+}
+
+TEST(OffloadPrivateKeyMethodFactoryTest, CreatesProviderFromConfig) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Singleton::ManagerImpl singleton_manager{Thread::threadFactoryForTest()};
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  ON_CALL(factory_context, singletonManager()).WillByDefault(ReturnRef(singleton_manager));
+
+  envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider config;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(R"EOF(
+    provider_name: offload
+    typed_config:
+      "@type": type.googleapis.com/envoy.extensions.private_key_providers.offload.v3alpha.OffloadPrivateKeyMethodConfig
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+      thread_count: 1
+  )EOF"),
+                            config);
+
+  auto* factory =
+      Registry::FactoryRegistry<Ssl::PrivateKeyMethodProviderInstanceFactory>::getFactory(
+          "offload");
+  ASSERT_NE(nullptr, factory);
+  Ssl::PrivateKeyMethodProviderSharedPtr provider =
+      factory->createPrivateKeyMethodProviderInstance(config, factory_context);
+  ASSERT_NE(nullptr, provider);
+  EXPECT_NE(nullptr, provider->getBoringSslPrivateKeyMethod());
+}
+
+} // namespace
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
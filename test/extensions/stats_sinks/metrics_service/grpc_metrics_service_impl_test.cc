@@ -4,6 +4,7 @@
 #include "source/extensions/stat_sinks/metrics_service/grpc_metrics_service_impl.h"
 
 #include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/stats/mocks.h"
@@ -17,6 +18,8 @@ using testing::_;
 using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Extensions {
@@ -147,6 +150,37 @@ TEST_F(MetricsServiceSinkTest, CheckSendCall) {
   sink.flush(snapshot_);
 }
 
+// Test that metrics built off the main thread are sent on the main thread.
+TEST_F(MetricsServiceSinkTest, SendOnMainThread) {
+  NiceMock<Event::MockDispatcher> main_thread_dispatcher;
+  MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
+                     envoy::service::metrics::v3::StreamMetricsResponse>
+      sink(streamer_, false, false, &main_thread_dispatcher);
+  EXPECT_TRUE(sink.flushOffMainThread());
+
+  addCounterToSnapshot("test_counter", 1, 1);
+  addGaugeToSnapshot("test_gauge", 1);
+
+  // Flushed off the main thread, the metrics are posted to it.
+  std::function<void()> post_cb;
+  EXPECT_CALL(main_thread_dispatcher, isThreadSafe()).WillOnce(Return(false));
+  EXPECT_CALL(main_thread_dispatcher, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  EXPECT_CALL(*streamer_, send(_)).Times(0);
+  sink.flush(snapshot_);
+  testing::Mock::VerifyAndClearExpectations(streamer_.get());
+
+  EXPECT_CALL(*streamer_, send(_)).WillOnce(Invoke([](MetricsPtr&& metrics) {
+    EXPECT_EQ(2, metrics->size());
+  }));
+  post_cb();
+
+  // Flushed on the main thread, the metrics are sent inline.
+  EXPECT_CALL(main_thread_dispatcher, isThreadSafe()).WillOnce(Return(true));
+  EXPECT_CALL(main_thread_dispatcher, post(_)).Times(0);
+  EXPECT_CALL(*streamer_, send(_));
+  sink.flush(snapshot_);
+}
+
 TEST_F(MetricsServiceSinkTest, CheckStatsCount) {
   MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
                      envoy::service::metrics::v3::StreamMetricsResponse>
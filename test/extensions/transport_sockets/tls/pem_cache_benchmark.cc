@@ -0,0 +1,79 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "source/common/common/assert.h"
+#include "source/common/memory/stats.h"
+#include "source/extensions/transport_sockets/tls/pem_cache.h"
+
+#include "test/test_common/environment.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/pem.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+static X509InfoListSharedPtr parseUncached(const std::string& pem) {
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), pem.size()));
+  return X509InfoListSharedPtr(bssl::UniquePtr<STACK_OF(X509_INFO)>(
+      PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr)));
+}
+
+// Builds state.range(0) SSL_CTXs trusting the same CA bundle, the way DefaultCertValidator
+// populates their X509_STOREs. With state.range(1) set the bundle comes from PemCache, otherwise
+// every context parses its own copy as it used to.
+static void bmTrustStoresSharingCaBundle(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("pem_cache_benchmark", &error));
+  TestEnvironment::setRunfiles(runfiles.get());
+  const std::string ca_certificates = TestEnvironment::readFileToStringForTest(
+      TestEnvironment::substitute("{{ test_rundir }}/test/extensions/transport_sockets/tls/"
+                                  "test_data/ca_certificates.pem"));
+  const uint64_t num_contexts = state.range(0);
+  const bool shared = state.range(1) != 0;
+
+  for (auto _ : state) {
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    std::vector<bssl::UniquePtr<SSL_CTX>> contexts;
+    std::vector<X509InfoListSharedPtr> lists;
+    for (uint64_t i = 0; i < num_contexts; ++i) {
+      X509InfoListSharedPtr list =
+          shared ? PemCache::get().x509InfoList(ca_certificates) : parseUncached(ca_certificates);
+      RELEASE_ASSERT(list != nullptr, "");
+      contexts.emplace_back(SSL_CTX_new(TLS_method()));
+      X509_STORE* store = SSL_CTX_get_cert_store(contexts.back().get());
+      for (const X509_INFO* item : list.get()) {
+        if (item->x509) {
+          X509_STORE_add_cert(store, item->x509);
+        }
+      }
+      if (shared) {
+        lists.push_back(std::move(list));
+      }
+    }
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory"] = end_mem - start_mem;
+    state.counters["memory_per_context"] = (end_mem - start_mem) / num_contexts;
+  }
+}
+BENCHMARK(bmTrustStoresSharingCaBundle)
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
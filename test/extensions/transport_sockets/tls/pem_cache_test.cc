@@ -0,0 +1,78 @@
+#include <string>
+
+#include "source/extensions/transport_sockets/tls/pem_cache.h"
+
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+std::string readTestData(const std::string& file) {
+  return TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + file));
+}
+
+TEST(PemCacheTest, SharesParsedCertificateBundles) {
+  const std::string ca_certificates = readTestData("ca_certificates.pem");
+  const size_t initial_size = PemCache::get().size();
+
+  X509InfoListSharedPtr first = PemCache::get().x509InfoList(ca_certificates);
+  ASSERT_NE(nullptr, first);
+  EXPECT_EQ(2, sk_X509_INFO_num(first.get()));
+  EXPECT_EQ(first, PemCache::get().x509InfoList(ca_certificates));
+  EXPECT_EQ(initial_size + 1, PemCache::get().size());
+
+  X509InfoListSharedPtr other = PemCache::get().x509InfoList(readTestData("ca_cert.pem"));
+  ASSERT_NE(nullptr, other);
+  EXPECT_NE(first, other);
+  EXPECT_EQ(initial_size + 2, PemCache::get().size());
+
+  // Once the last holder goes away the entry is gone, and the next lookup parses afresh.
+  first.reset();
+  EXPECT_EQ(initial_size + 1, PemCache::get().size());
+  first = PemCache::get().x509InfoList(ca_certificates);
+  ASSERT_NE(nullptr, first);
+  EXPECT_EQ(initial_size + 2, PemCache::get().size());
+}
+
+TEST(PemCacheTest, DoesNotCacheParseFailures) {
+  const size_t initial_size = PemCache::get().size();
+  ERR_clear_error();
+  EXPECT_EQ(nullptr, PemCache::get().x509InfoList(readTestData("not_a_crl.crl")));
+  EXPECT_EQ(initial_size, PemCache::get().size());
+  // The cause is left for the caller to report.
+  EXPECT_NE(0, ERR_peek_last_error());
+  ERR_clear_error();
+}
+
+TEST(PemCacheTest, SharesPrivateKeys) {
+  const std::string key = readTestData("san_dns_key.pem");
+  PrivateKeySharedPtr first = PemCache::get().privateKey(key, "");
+  ASSERT_NE(nullptr, first);
+  EXPECT_EQ(first, PemCache::get().privateKey(key, ""));
+  EXPECT_NE(first, PemCache::get().privateKey(readTestData("san_dns2_key.pem"), ""));
+}
+
+TEST(PemCacheTest, PasswordIsPartOfTheKey) {
+  const std::string key = readTestData("password_protected_key.pem");
+  PrivateKeySharedPtr key_with_password = PemCache::get().privateKey(key, "p4ssw0rd");
+  ASSERT_NE(nullptr, key_with_password);
+  EXPECT_EQ(key_with_password, PemCache::get().privateKey(key, "p4ssw0rd"));
+
+  ERR_clear_error();
+  EXPECT_EQ(nullptr, PemCache::get().privateKey(key, "WrongPassword"));
+  EXPECT_EQ(nullptr, PemCache::get().privateKey(key, ""));
+  ERR_clear_error();
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,85 @@
+#include <ctime>
+#include <string>
+
+#include "source/extensions/transport_sockets/tls/session_cache.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class SessionCacheTest : public testing::Test {
+protected:
+  bssl::UniquePtr<SSL_SESSION> newSession(const std::string& id, uint32_t timeout = 300) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ctx_.get()));
+    EXPECT_EQ(1, SSL_SESSION_set1_id(session.get(), reinterpret_cast<const uint8_t*>(id.data()),
+                                     id.size()));
+    SSL_SESSION_set_time(session.get(), std::time(nullptr));
+    SSL_SESSION_set_timeout(session.get(), timeout);
+    return session;
+  }
+
+  bssl::UniquePtr<SSL_CTX> ctx_{SSL_CTX_new(TLS_method())};
+};
+
+TEST_F(SessionCacheTest, ClientOffersMostRecentSession) {
+  ClientSessionCache cache(2);
+  bssl::UniquePtr<SSL> ssl(SSL_new(ctx_.get()));
+  EXPECT_FALSE(cache.setSession(ssl.get()));
+
+  bssl::UniquePtr<SSL_SESSION> first = newSession("first");
+  bssl::UniquePtr<SSL_SESSION> second = newSession("second");
+  SSL_SESSION* second_ptr = second.get();
+  cache.addSession(std::move(first));
+  cache.addSession(std::move(second));
+
+  EXPECT_TRUE(cache.setSession(ssl.get()));
+  EXPECT_EQ(second_ptr, SSL_get_session(ssl.get()));
+}
+
+TEST_F(SessionCacheTest, ServerFindsAndEvictsSessions) {
+  ServerSessionCache cache(2);
+  EXPECT_EQ(nullptr, cache.findSession("a"));
+
+  cache.addSession(newSession("a"));
+  cache.addSession(newSession("b"));
+  // Looking up "a" makes "b" the least recently used session.
+  EXPECT_NE(nullptr, cache.findSession("a"));
+  cache.addSession(newSession("c"));
+
+  EXPECT_NE(nullptr, cache.findSession("a"));
+  EXPECT_EQ(nullptr, cache.findSession("b"));
+  EXPECT_NE(nullptr, cache.findSession("c"));
+}
+
+TEST_F(SessionCacheTest, ServerDropsExpiredSessions) {
+  ServerSessionCache cache(0);
+  bssl::UniquePtr<SSL_SESSION> expired = newSession("expired", 1);
+  SSL_SESSION_set_time(expired.get(), std::time(nullptr) - 10);
+  cache.addSession(std::move(expired));
+  cache.addSession(newSession("live"));
+
+  EXPECT_EQ(nullptr, cache.findSession("expired"));
+  EXPECT_NE(nullptr, cache.findSession("live"));
+}
+
+TEST_F(SessionCacheTest, RegistrySharesCachesByKey) {
+  ClientSessionCacheSharedPtr client = SessionCacheRegistry::get().clientCache("config", 1);
+  EXPECT_EQ(client, SessionCacheRegistry::get().clientCache("config", 1));
+  EXPECT_NE(client, SessionCacheRegistry::get().clientCache("config", 2));
+  EXPECT_NE(client, SessionCacheRegistry::get().clientCache("other", 1));
+
+  ServerSessionCacheSharedPtr server = SessionCacheRegistry::get().serverCache("context", 10);
+  EXPECT_EQ(server, SessionCacheRegistry::get().serverCache("context", 10));
+  EXPECT_NE(server, SessionCacheRegistry::get().serverCache("other", 10));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -200,6 +200,10 @@ AssertionResult IntegrationCodecClient::waitForDisconnect(std::chrono::milliseco
 }
 
 void IntegrationCodecClient::ConnectionCallbacks::onEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::ConnectedZeroRtt) {
+    // Requests are only sent once the handshake is done.
+    return;
+  }
   parent_.last_connection_event_ = event;
   if (event == Network::ConnectionEvent::Connected) {
     parent_.connected_ = true;
@@ -283,6 +283,105 @@ TEST_P(QuicHttpIntegrationTest, ZeroRtt) {
   }
 }
 
+TEST_P(QuicHttpIntegrationTest, UpstreamZeroRtt) {
+  if (GetParam().second != QuicVersionType::Iquic) {
+    // The upstream connections only use IETF QUIC versions.
+    return;
+  }
+  config_helper_.addRuntimeOverride("envoy.reloadable_features.http3_upstream_early_data", "true");
+  setUpstreamProtocol(Http::CodecType::HTTP3);
+  initialize();
+  codec_client_ = makeHttpConnection(makeClientConnection((lookupPort("http"))));
+
+  // The first upstream connection gets a session ticket.
+  auto response1 = codec_client_->makeHeaderOnlyRequest(default_request_headers_);
+  waitForNextUpstreamRequest(0);
+  upstream_request_->encodeHeaders(default_response_headers_, true);
+  ASSERT_TRUE(response1->waitForEndStream());
+  ASSERT_TRUE(fake_upstream_connection_->close());
+  ASSERT_TRUE(fake_upstream_connection_->waitForDisconnect());
+  fake_upstream_connection_.reset();
+  test_server_->waitForGaugeEq("cluster.cluster_0.upstream_cx_active", 0);
+
+  // The next upstream connection resumes the session, and the GET request is sent as early data.
+  auto response2 = codec_client_->makeHeaderOnlyRequest(default_request_headers_);
+  waitForNextUpstreamRequest(0);
+  upstream_request_->encodeHeaders(default_response_headers_, true);
+  ASSERT_TRUE(response2->waitForEndStream());
+  EXPECT_EQ("200", response2->headers().getStatusValue());
+  EXPECT_EQ(1u, test_server_->counter("cluster.cluster_0.upstream_cx_connect_with_0_rtt")->value());
+  EXPECT_TRUE(fake_upstream_connection_
+                  ->executeOnDispatcher([](Network::Connection& connection) {
+                    EXPECT_TRUE(quic::test::QuicSessionPeer::GetMutableCryptoStream(
+                                    &dynamic_cast<quic::QuicSession&>(connection))
+                                    ->EarlyDataAccepted());
+                  }));
+  ASSERT_TRUE(fake_upstream_connection_->close());
+  ASSERT_TRUE(fake_upstream_connection_->waitForDisconnect());
+  fake_upstream_connection_.reset();
+  test_server_->waitForGaugeEq("cluster.cluster_0.upstream_cx_active", 0);
+
+  // A request with a body waits for the handshake of the resumed connection to complete.
+  auto response3 = codec_client_->makeRequestWithBody(
+      Http::TestRequestHeaderMapImpl{{":method", "POST"},
+                                     {":path", "/test/long/url"},
+                                     {":scheme", "http"},
+                                     {":authority", "host"}},
+      10);
+  waitForNextUpstreamRequest(0);
+  EXPECT_EQ(10u, upstream_request_->bodyLength());
+  upstream_request_->encodeHeaders(default_response_headers_, true);
+  ASSERT_TRUE(response3->waitForEndStream());
+  EXPECT_EQ("200", response3->headers().getStatusValue());
+  EXPECT_EQ(2u, test_server_->counter("cluster.cluster_0.upstream_cx_connect_with_0_rtt")->value());
+  codec_client_->close();
+}
+
+// Latency of the first request on a new upstream connection, with a full handshake and with a
+// resumed session sending the request as early data, against the in-process fake upstream. The
+// times are recorded as test properties rather than checked, as they depend on the machine.
+TEST_P(QuicHttpIntegrationTest, UpstreamZeroRttFirstRequestLatency) {
+  if (GetParam().second != QuicVersionType::Iquic) {
+    // The upstream connections only use IETF QUIC versions.
+    return;
+  }
+  config_helper_.addRuntimeOverride("envoy.reloadable_features.http3_upstream_early_data", "true");
+  setUpstreamProtocol(Http::CodecType::HTTP3);
+  initialize();
+  codec_client_ = makeHttpConnection(makeClientConnection((lookupPort("http"))));
+
+  // Sends a request needing a new upstream connection, and closes the connection once answered.
+  auto first_request_latency = [this]() {
+    const MonotonicTime start = timeSystem().monotonicTime();
+    auto response = codec_client_->makeHeaderOnlyRequest(default_request_headers_);
+    waitForNextUpstreamRequest(0);
+    upstream_request_->encodeHeaders(default_response_headers_, true);
+    EXPECT_TRUE(response->waitForEndStream());
+    const MonotonicTime end = timeSystem().monotonicTime();
+    EXPECT_EQ("200", response->headers().getStatusValue());
+    EXPECT_TRUE(fake_upstream_connection_->close());
+    EXPECT_TRUE(fake_upstream_connection_->waitForDisconnect());
+    fake_upstream_connection_.reset();
+    test_server_->waitForGaugeEq("cluster.cluster_0.upstream_cx_active", 0);
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+  };
+
+  // Only the first connection has no session to resume.
+  const std::chrono::microseconds full_handshake = first_request_latency();
+  constexpr uint32_t ResumedConnections = 10;
+  std::chrono::microseconds resumed = std::chrono::microseconds::max();
+  for (uint32_t i = 0; i < ResumedConnections; ++i) {
+    resumed = std::min(resumed, first_request_latency());
+  }
+  EXPECT_EQ(ResumedConnections,
+            test_server_->counter("cluster.cluster_0.upstream_cx_connect_with_0_rtt")->value());
+  RecordProperty("full_handshake_us", static_cast<int>(full_handshake.count()));
+  RecordProperty("resumed_early_data_min_us", static_cast<int>(resumed.count()));
+  ENVOY_LOG_MISC(info, "first request latency: full handshake {}us, resumed with early data {}us",
+                 full_handshake.count(), resumed.count());
+  codec_client_->close();
+}
+
 // Ensure multiple quic connections work, regardless of platform BPF support
 TEST_P(QuicHttpIntegrationTest, MultipleQuicConnectionsDefaultMode) {
   testMultipleQuicConnections();
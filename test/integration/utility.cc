@@ -104,6 +104,8 @@ public:
     } else if (event == Network::ConnectionEvent::RemoteClose) {
       // If the peer closes the connection, no need to wait anymore.
       dispatcher_.exit();
+    } else if (event == Network::ConnectionEvent::ConnectedZeroRtt) {
+      // Keep waiting for the handshake to finish.
     } else {
       if (!connected_) {
         // Before handshake gets established, any connection failure should exit the loop. I.e. a
@@ -12,6 +12,11 @@ namespace AccessLog {
 MockAccessLogFile::MockAccessLogFile() = default;
 MockAccessLogFile::~MockAccessLogFile() = default;
 
+void MockAccessLogFile::write(Buffer::Instance& data) {
+  write(data.toString());
+  data.drain(data.length());
+}
+
 MockFilter::MockFilter() = default;
 MockFilter::~MockFilter() = default;
 
@@ -17,6 +17,8 @@ public:
 
   // AccessLog::AccessLogFile
   MOCK_METHOD(void, write, (absl::string_view data));
+  // Forwards the buffer content to the string_view write() so tests can match on it.
+  void write(Buffer::Instance& data) override;
   MOCK_METHOD(void, reopen, ());
   MOCK_METHOD(void, flush, ());
 };
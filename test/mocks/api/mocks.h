@@ -105,6 +105,7 @@ public:
   MOCK_METHOD(SysCallBoolResult, socketTcpInfo, (os_fd_t sockfd, EnvoyTcpInfo* tcp_info));
   MOCK_METHOD(bool, supportsMmsg, (), (const));
   MOCK_METHOD(bool, supportsUdpGro, (), (const));
+  MOCK_METHOD(bool, supportsUdpGso, (), (const));
   MOCK_METHOD(bool, supportsIpTransparent, (), (const));
 
   // Map from (sockfd,level,optname) to boolean socket option.
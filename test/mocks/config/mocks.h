@@ -41,6 +41,9 @@ public:
   ~MockOpaqueResourceDecoder() override;
 
   MOCK_METHOD(ProtobufTypes::MessagePtr, decodeResource, (const ProtobufWkt::Any& resource));
+  MOCK_METHOD(ProtobufTypes::MessagePtr, decodeResourceConcurrently,
+              (const ProtobufWkt::Any& resource));
+  MOCK_METHOD(void, checkUnexpectedFields, (const Protobuf::Message& resource));
   MOCK_METHOD(std::string, resourceName, (const Protobuf::Message& resource));
 };
 
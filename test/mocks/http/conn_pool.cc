@@ -1,5 +1,8 @@
 #include "test/mocks/http/conn_pool.h"
 
+using testing::_;
+using testing::Invoke;
+
 namespace Envoy {
 namespace Http {
 namespace ConnectionPool {
@@ -7,6 +10,11 @@ namespace ConnectionPool {
 MockInstance::MockInstance()
     : host_{std::make_shared<testing::NiceMock<Upstream::MockHostDescription>>()} {
   ON_CALL(*this, host()).WillByDefault(Return(host_));
+  ON_CALL(*this, newStreamWithOptions(_, _, _))
+      .WillByDefault(Invoke([this](ResponseDecoder& response_decoder, Callbacks& callbacks,
+                                   const StreamOptions&) -> Cancellable* {
+        return newStream(response_decoder, callbacks);
+      }));
 }
 MockInstance::~MockInstance() = default;
 
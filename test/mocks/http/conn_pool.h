@@ -33,6 +33,9 @@ public:
   MOCK_METHOD(void, drainConnections, ());
   MOCK_METHOD(bool, hasActiveConnections, (), (const));
   MOCK_METHOD(Cancellable*, newStream, (ResponseDecoder & response_decoder, Callbacks& callbacks));
+  MOCK_METHOD(Cancellable*, newStreamWithOptions,
+              (ResponseDecoder & response_decoder, Callbacks& callbacks,
+               const StreamOptions& options));
   MOCK_METHOD(bool, maybePreconnect, (float));
   MOCK_METHOD(Upstream::HostDescriptionConstSharedPtr, host, (), (const));
   MOCK_METHOD(absl::string_view, protocolDescription, (), (const));
@@ -277,6 +277,7 @@ public:
 
   MOCK_METHOD(void, flush, (MetricSnapshot & snapshot));
   MOCK_METHOD(void, onHistogramComplete, (const Histogram& histogram, uint64_t value));
+  MOCK_METHOD(bool, flushOffMainThread, (), (const));
 };
 
 class MockStore : public TestUtil::TestStore {
@@ -1,5 +1,7 @@
 #include "envoy/admin/v3/clusters.pb.h"
 
+#include "source/server/admin/utils.h"
+
 #include "test/server/admin/admin_instance.h"
 
 using testing::Return;
@@ -237,5 +239,49 @@ fake_cluster::1.2.3.4:80::local_origin_success_rate::93.2
   EXPECT_EQ(expected_text, response2.toString());
 }
 
+TEST_P(AdminInstanceTest, ClustersPaginated) {
+  Upstream::ClusterManager::ClusterInfoMaps cluster_maps;
+  ON_CALL(server_.cluster_manager_, clusters()).WillByDefault(ReturnPointee(&cluster_maps));
+
+  NiceMock<Upstream::MockClusterMockPrioritySet> cluster_a;
+  cluster_a.info_->name_ = "cluster_a";
+  cluster_maps.active_clusters_.emplace(cluster_a.info_->name_, cluster_a);
+  NiceMock<Upstream::MockClusterMockPrioritySet> cluster_b;
+  cluster_b.info_->name_ = "cluster_b";
+  cluster_maps.active_clusters_.emplace(cluster_b.info_->name_, cluster_b);
+  NiceMock<Upstream::MockClusterMockPrioritySet> cluster_c;
+  cluster_c.info_->name_ = "cluster_c";
+  cluster_maps.active_clusters_.emplace(cluster_c.info_->name_, cluster_c);
+
+  {
+    Buffer::OwnedImpl response;
+    Http::TestResponseHeaderMapImpl header_map;
+    EXPECT_EQ(Http::Code::OK,
+              getCallback("/clusters?format=json&limit=2", header_map, response));
+    envoy::admin::v3::Clusters output_proto;
+    TestUtility::loadFromJson(response.toString(), output_proto);
+    ASSERT_EQ(2, output_proto.cluster_statuses_size());
+    EXPECT_EQ("cluster_a", output_proto.cluster_statuses(0).name());
+    EXPECT_EQ("cluster_b", output_proto.cluster_statuses(1).name());
+    EXPECT_EQ("cluster_b", header_map.get_(Utility::nextCursorHeader()));
+  }
+  {
+    Buffer::OwnedImpl response;
+    Http::TestResponseHeaderMapImpl header_map;
+    EXPECT_EQ(Http::Code::OK, getCallback("/clusters?format=json&limit=2&cursor=cluster_b",
+                                          header_map, response));
+    envoy::admin::v3::Clusters output_proto;
+    TestUtility::loadFromJson(response.toString(), output_proto);
+    ASSERT_EQ(1, output_proto.cluster_statuses_size());
+    EXPECT_EQ("cluster_c", output_proto.cluster_statuses(0).name());
+    EXPECT_FALSE(header_map.has(Utility::nextCursorHeader().get()));
+  }
+  {
+    Buffer::OwnedImpl response;
+    Http::TestResponseHeaderMapImpl header_map;
+    EXPECT_EQ(Http::Code::BadRequest, getCallback("/clusters?limit=abc", header_map, response));
+  }
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include "source/common/stats/thread_local_store.h"
 #include "source/server/admin/stats_handler.h"
+#include "source/server/admin/utils.h"
 
 #include "test/mocks/server/admin_stream.h"
 #include "test/mocks/server/instance.h"
@@ -30,7 +31,10 @@ public:
                      std::map<std::string, std::string>& all_text_readouts,
                      const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
                      const bool used_only, const absl::optional<std::regex> regex = absl::nullopt) {
-    return StatsHandler::statsAsJson(all_stats, all_text_readouts, all_histograms, used_only, regex,
+    StatsHandler::StatsParams params;
+    params.used_only_ = used_only;
+    params.regex_ = regex;
+    return StatsHandler::statsAsJson(all_stats, all_text_readouts, all_histograms, params,
                                      true /*pretty_print*/);
   }
 
@@ -117,6 +121,84 @@ TEST_P(AdminStatsTest, HandlerStatsPlainText) {
   shutdownThreading();
 }
 
+TEST_P(AdminStatsTest, HandlerStatsPaginated) {
+  Configuration::MockStatsConfig stats_config;
+  EXPECT_CALL(stats_config, flushOnAdmin()).WillRepeatedly(testing::Return(false));
+  MockInstance instance;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+  EXPECT_CALL(instance, stats()).WillRepeatedly(testing::ReturnRef(*store_));
+  EXPECT_CALL(instance, statsConfig()).WillRepeatedly(testing::ReturnRef(stats_config));
+  StatsHandler handler(instance);
+  MockAdminStream admin_stream;
+
+  store_->counterFromString("a.c1").add(1);
+  store_->counterFromString("a.c2").add(2);
+  store_->gaugeFromString("a.g1", Stats::Gauge::ImportMode::Accumulate).set(3);
+  store_->textReadoutFromString("a.t1").set("text");
+  store_->counterFromString("b.c1").add(4);
+
+  const auto get_page = [&](const std::string& url, std::string& next_cursor) {
+    Http::TestResponseHeaderMapImpl response_headers;
+    Buffer::OwnedImpl data;
+    EXPECT_EQ(Http::Code::OK, handler.handlerStats(url, response_headers, data, admin_stream));
+    next_cursor = response_headers.get_(Utility::nextCursorHeader());
+    return data.toString();
+  };
+
+  std::string next_cursor;
+  EXPECT_EQ("a.c1: 1\n"
+            "a.c2: 2\n",
+            get_page("/stats?limit=2", next_cursor));
+  EXPECT_EQ("a.c2", next_cursor);
+  EXPECT_EQ("a.t1: \"text\"\n"
+            "a.g1: 3\n",
+            get_page("/stats?limit=2&cursor=a.c2", next_cursor));
+  EXPECT_EQ("a.t1", next_cursor);
+  EXPECT_EQ("b.c1: 4\n", get_page("/stats?limit=2&cursor=a.t1", next_cursor));
+  EXPECT_EQ("", next_cursor);
+
+  // Type and prefix filters are applied before pagination.
+  EXPECT_EQ("a.c2: 2\n"
+            "b.c1: 4\n",
+            get_page("/stats?limit=5&type=Counters&cursor=a.c1", next_cursor));
+  EXPECT_EQ("", next_cursor);
+  EXPECT_EQ("a.g1: 3\n", get_page("/stats?type=Gauges&prefix=a.", next_cursor));
+  EXPECT_EQ("b.c1: 4\n", get_page("/stats?prefix=b.", next_cursor));
+
+  // The largest limit returns every stat in one page.
+  EXPECT_EQ("a.c1: 1\n"
+            "a.c2: 2\n"
+            "b.c1: 4\n",
+            get_page("/stats?limit=18446744073709551615&type=Counters", next_cursor));
+  EXPECT_EQ("", next_cursor);
+
+  shutdownThreading();
+}
+
+TEST_P(AdminStatsTest, HandlerStatsInvalidPageParams) {
+  Configuration::MockStatsConfig stats_config;
+  EXPECT_CALL(stats_config, flushOnAdmin()).WillRepeatedly(testing::Return(false));
+  MockInstance instance;
+  EXPECT_CALL(instance, stats()).WillRepeatedly(testing::ReturnRef(*store_));
+  EXPECT_CALL(instance, statsConfig()).WillRepeatedly(testing::ReturnRef(stats_config));
+  StatsHandler handler(instance);
+  MockAdminStream admin_stream;
+  Http::TestResponseHeaderMapImpl response_headers;
+
+  {
+    Buffer::OwnedImpl data;
+    EXPECT_EQ(Http::Code::BadRequest,
+              handler.handlerStats("/stats?limit=0", response_headers, data, admin_stream));
+    EXPECT_EQ("Invalid limit: \"0\", expected a positive integer\n", data.toString());
+  }
+  {
+    Buffer::OwnedImpl data;
+    EXPECT_EQ(Http::Code::BadRequest,
+              handler.handlerStats("/stats?type=Timers", response_headers, data, admin_stream));
+    EXPECT_THAT(data.toString(), StartsWith("Invalid type: \"Timers\""));
+  }
+}
+
 TEST_P(AdminStatsTest, HandlerStatsJson) {
   const std::string url = "/stats?format=json";
   Http::TestResponseHeaderMapImpl response_headers;
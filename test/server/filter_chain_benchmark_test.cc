@@ -180,6 +180,11 @@ const char YamlSingleDstPortBottom[] = R"EOF(
           session_ticket_keys:
             keys:
             - filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ticket_key_a")EOF";
+const char YamlServerNameChainTop[] = R"EOF(
+    - filter_chain_match:
+        server_names: )EOF";
+const char YamlServerNameChainBottom[] = R"EOF(
+        transport_protocol: "tls")EOF";
 } // namespace
 
 class FilterChainBenchmarkFixture : public ::benchmark::Fixture {
@@ -198,6 +203,23 @@ public:
     filter_chains_ = listener_config_.filter_chains();
   }
 
+  // One filter chain per tenant server name, as used by listeners terminating TLS for many
+  // tenants.
+  void initializeServerNames(::benchmark::State& state) {
+    int64_t input_size = state.range(0);
+    std::vector<std::string> server_name_chains;
+    server_name_chains.reserve(input_size);
+    for (int i = 0; i < input_size; i++) {
+      server_name_chains.push_back(absl::StrCat(YamlServerNameChainTop, "tenant", i,
+                                                ".example.com", YamlServerNameChainBottom));
+    }
+    listener_yaml_config_ = TestEnvironment::substitute(
+        absl::StrCat(YamlHeader, absl::StrJoin(server_name_chains, "")),
+        Network::Address::IpVersion::v4);
+    TestUtility::loadFromYaml(listener_yaml_config_, listener_config_);
+    filter_chains_ = listener_config_.filter_chains();
+  }
+
   Envoy::Thread::MutexBasicLockable lock_;
   Logger::Context logging_state_{spdlog::level::warn, Logger::Logger::DEFAULT_LOG_FORMAT, lock_,
                                  false};
@@ -255,6 +277,55 @@ BENCHMARK_DEFINE_F(FilterChainBenchmarkFixture, FilterChainFindTest)
     }
   }
 }
+// NOLINTNEXTLINE(readability-redundant-member-init)
+BENCHMARK_DEFINE_F(FilterChainBenchmarkFixture, FilterChainManagerServerNamesBuildTest)
+(::benchmark::State& state) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 64) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  initializeServerNames(state);
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  for (auto _ : state) {
+    FilterChainManagerImpl filter_chain_manager{
+        std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), factory_context,
+        init_manager_};
+    filter_chain_manager.addFilterChains(filter_chains_, nullptr, dummy_builder_,
+                                         filter_chain_manager);
+  }
+}
+
+BENCHMARK_DEFINE_F(FilterChainBenchmarkFixture, FilterChainServerNamesFindTest)
+(::benchmark::State& state) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 64) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  initializeServerNames(state);
+  std::vector<MockConnectionSocket> sockets;
+  sockets.reserve(state.range(0));
+  for (int i = 0; i < state.range(0); i++) {
+    sockets.push_back(std::move(*MockConnectionSocket::createMockConnectionSocket(
+        1234, "127.0.0.1", absl::StrCat("tenant", i, ".example.com"), "tls", {}, "8.8.8.8",
+        111)));
+  }
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  FilterChainManagerImpl filter_chain_manager{
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), factory_context,
+      init_manager_};
+
+  filter_chain_manager.addFilterChains(filter_chains_, nullptr, dummy_builder_,
+                                       filter_chain_manager);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (int i = 0; i < state.range(0); i++) {
+      benchmark::DoNotOptimize(filter_chain_manager.findFilterChain(sockets[i]));
+    }
+  }
+}
+
 BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainManagerBuildTest)
     ->Ranges({
         // scale of the chains
@@ -268,6 +339,19 @@ BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainFindTest)
     })
     ->Unit(::benchmark::kMillisecond);
 
+BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainManagerServerNamesBuildTest)
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024)
+    ->Arg(10000)
+    ->Unit(::benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainServerNamesFindTest)
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024)
+    ->Arg(10000)
+    ->Unit(::benchmark::kMillisecond);
+
 /*
 clang-format off
 
@@ -180,6 +180,43 @@ TEST_F(FilterChainManagerImplTest, FilterChainUseFallbackIfNoFilterChainMatches)
   EXPECT_EQ(fallback_filter_chain, build_out_fallback_filter_chain_.get());
 }
 
+// Server name branches without source conditions resolve directly to their filter chain, while
+// branches with source conditions still consult them.
+TEST_F(FilterChainManagerImplTest, ServerNameChainsWithAndWithoutSourceConditions) {
+  std::vector<envoy::config::listener::v3::FilterChain> filter_chain_messages(
+      3, filter_chain_template_);
+  filter_chain_messages[0].mutable_filter_chain_match()->add_server_names("tenant0.example.com");
+  filter_chain_messages[1].mutable_filter_chain_match()->add_server_names("tenant1.example.com");
+  filter_chain_messages[1].mutable_filter_chain_match()->add_source_ports(555);
+  filter_chain_messages[2].mutable_filter_chain_match()->add_server_names("*.example.com");
+
+  std::vector<std::shared_ptr<Network::MockFilterChain>> filter_chains{
+      std::make_shared<Network::MockFilterChain>(), std::make_shared<Network::MockFilterChain>(),
+      std::make_shared<Network::MockFilterChain>()};
+  EXPECT_CALL(filter_chain_factory_builder_, buildFilterChain(_, _))
+      .WillOnce(Return(filter_chains[0]))
+      .WillOnce(Return(filter_chains[1]))
+      .WillOnce(Return(filter_chains[2]));
+  filter_chain_manager_.addFilterChains(
+      std::vector<const envoy::config::listener::v3::FilterChain*>{
+          &filter_chain_messages[0], &filter_chain_messages[1], &filter_chain_messages[2]},
+      nullptr, filter_chain_factory_builder_, filter_chain_manager_);
+
+  EXPECT_EQ(filter_chains[0].get(), findFilterChainHelper(10000, "127.0.0.1", "tenant0.example.com",
+                                                          "tls", {}, "8.8.8.8", 111));
+  EXPECT_EQ(filter_chains[0].get(),
+            findFilterChainHelper(10000, "127.0.0.1", "tenant0.example.com", "raw_buffer", {},
+                                  "/tmp/test.sock", 0));
+  EXPECT_EQ(filter_chains[1].get(), findFilterChainHelper(10000, "127.0.0.1", "tenant1.example.com",
+                                                          "tls", {}, "8.8.8.8", 555));
+  EXPECT_EQ(nullptr, findFilterChainHelper(10000, "127.0.0.1", "tenant1.example.com", "tls", {},
+                                           "8.8.8.8", 111));
+  EXPECT_EQ(filter_chains[2].get(), findFilterChainHelper(10000, "127.0.0.1", "other.example.com",
+                                                          "tls", {}, "8.8.8.8", 111));
+  EXPECT_EQ(nullptr,
+            findFilterChainHelper(10000, "127.0.0.1", "example.org", "tls", {}, "8.8.8.8", 111));
+}
+
 TEST_F(FilterChainManagerImplTest, LookupFilterChainContextByFilterChainMessage) {
   std::vector<envoy::config::listener::v3::FilterChain> filter_chain_messages;
 
@@ -225,6 +262,40 @@ TEST_F(FilterChainManagerImplTest, DuplicateContextsAreNotBuilt) {
       nullptr, filter_chain_factory_builder_, new_filter_chain_manager);
 }
 
+TEST_F(FilterChainManagerImplTest, UnchangedFilterChainsAreShared) {
+  std::vector<envoy::config::listener::v3::FilterChain> filter_chain_messages;
+  for (int i = 0; i < 2; i++) {
+    envoy::config::listener::v3::FilterChain new_filter_chain = filter_chain_template_;
+    new_filter_chain.set_name(absl::StrCat("filter_chain_", i));
+    new_filter_chain.mutable_filter_chain_match()->mutable_destination_port()->set_value(10000 + i);
+    filter_chain_messages.push_back(std::move(new_filter_chain));
+  }
+  EXPECT_CALL(filter_chain_factory_builder_, buildFilterChain(_, _))
+      .WillOnce(Return(build_out_filter_chain_))
+      .WillOnce(Return(build_out_fallback_filter_chain_));
+  addSingleFilterChainHelper(filter_chain_messages[0], &fallback_filter_chain_);
+
+  FilterChainManagerImpl new_filter_chain_manager{
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), parent_context_,
+      init_manager_, filter_chain_manager_};
+  // Only the added filter chain is built; the unchanged one and the default are shared.
+  EXPECT_CALL(filter_chain_factory_builder_, buildFilterChain(_, _))
+      .WillOnce(Return(std::make_shared<Network::MockFilterChain>()));
+  new_filter_chain_manager.addFilterChains(
+      std::vector<const envoy::config::listener::v3::FilterChain*>{&filter_chain_messages[0],
+                                                                   &filter_chain_messages[1]},
+      &fallback_filter_chain_, filter_chain_factory_builder_, new_filter_chain_manager);
+
+  const auto& old_filter_chains = filter_chain_manager_.filterChainsByMessage();
+  const auto& new_filter_chains = new_filter_chain_manager.filterChainsByMessage();
+  ASSERT_EQ(1, old_filter_chains.size());
+  ASSERT_EQ(2, new_filter_chains.size());
+  EXPECT_EQ(build_out_filter_chain_, old_filter_chains.at(filter_chain_messages[0]));
+  EXPECT_EQ(build_out_filter_chain_, new_filter_chains.at(filter_chain_messages[0]));
+  EXPECT_NE(build_out_filter_chain_, new_filter_chains.at(filter_chain_messages[1]));
+  EXPECT_EQ(build_out_fallback_filter_chain_, new_filter_chain_manager.defaultFilterChain());
+}
+
 TEST_F(FilterChainManagerImplTest, CreatedFilterChainFactoryContextHasIndependentDrainClose) {
   std::vector<envoy::config::listener::v3::FilterChain> filter_chain_messages;
   for (int i = 0; i < 3; i++) {
@@ -286,27 +286,47 @@ protected:
   ServerInstanceImplTest() { version_ = GetParam(); }
 };
 
-// Custom StatsSink that just increments a counter when flush is called.
+// Custom StatsSink that just increments a counter when flush is called, and another one when it is
+// flushed off the main thread.
 class CustomStatsSink : public Stats::Sink {
 public:
-  CustomStatsSink(Stats::Scope& scope) : stats_flushed_(scope.counterFromString("stats.flushed")) {}
+  CustomStatsSink(Stats::Scope& scope, Event::Dispatcher& main_thread_dispatcher,
+                  bool flush_off_main_thread)
+      : stats_flushed_(scope.counterFromString("stats.flushed")),
+        stats_flushed_off_main_thread_(
+            scope.counterFromString("stats.flushed_off_main_thread")),
+        main_thread_dispatcher_(main_thread_dispatcher),
+        flush_off_main_thread_(flush_off_main_thread) {}
 
   // Stats::Sink
-  void flush(Stats::MetricSnapshot&) override { stats_flushed_.inc(); }
+  void flush(Stats::MetricSnapshot&) override {
+    if (!main_thread_dispatcher_.isThreadSafe()) {
+      stats_flushed_off_main_thread_.inc();
+    }
+    stats_flushed_.inc();
+  }
 
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+  bool flushOffMainThread() const override { return flush_off_main_thread_; }
 
 private:
   Stats::Counter& stats_flushed_;
+  Stats::Counter& stats_flushed_off_main_thread_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  const bool flush_off_main_thread_;
 };
 
 // Custom StatsSinkFactory that creates CustomStatsSink.
 class CustomStatsSinkFactory : public Server::Configuration::StatsSinkFactory {
 public:
+  CustomStatsSinkFactory(bool flush_off_main_thread = false)
+      : flush_off_main_thread_(flush_off_main_thread) {}
+
   // StatsSinkFactory
   Stats::SinkPtr createStatsSink(const Protobuf::Message&,
                                  Server::Configuration::ServerFactoryContext& server) override {
-    return std::make_unique<CustomStatsSink>(server.scope());
+    return std::make_unique<CustomStatsSink>(server.scope(), server.dispatcher(),
+                                             flush_off_main_thread_);
   }
 
   ProtobufTypes::MessagePtr createEmptyConfigProto() override {
@@ -316,6 +336,9 @@ public:
   }
 
   std::string name() const override { return "envoy.custom_stats_sink"; }
+
+private:
+  const bool flush_off_main_thread_;
 };
 
 // CustomListenerHooks is used for synchronization between test thread and server thread.
@@ -352,6 +375,24 @@ TEST_P(ServerInstanceImplTest, StatsFlushWhenServerIsStillInitializing) {
   server_thread->join();
 }
 
+// Validates that sinks which support it are flushed on the stats flush thread.
+TEST_P(ServerInstanceImplTest, StatsFlushOnDedicatedThread) {
+  CustomStatsSinkFactory factory(true);
+  Registry::InjectFactory<Server::Configuration::StatsSinkFactory> registered(factory);
+
+  auto server_thread = startTestServer(
+      "test/server/test_data/server/stats_sink_dedicated_thread_bootstrap.yaml", true);
+
+  TestUtility::waitForCounterEq(stats_store_, "stats.flushed", 1, time_system_);
+  EXPECT_EQ(1L, TestUtility::findCounter(stats_store_, "stats.flushed_off_main_thread")->value());
+  // The flush timer is only re-enabled once the flush thread has completed the previous flush.
+  TestUtility::waitForCounterEq(stats_store_, "stats.flushed", 2, time_system_);
+  EXPECT_EQ(2L, TestUtility::findCounter(stats_store_, "stats.flushed_off_main_thread")->value());
+
+  server_->dispatcher().post([&] { server_->shutdown(); });
+  server_thread->join();
+}
+
 // Validates that the "server.version" is updated with stats_server_version_override from bootstrap.
 TEST_P(ServerInstanceImplTest, ProxyVersionOveridesFromBootstrap) {
   auto server_thread =
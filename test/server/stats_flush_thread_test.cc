@@ -0,0 +1,64 @@
+#include <thread>
+
+#include "source/common/api/api_impl.h"
+#include "source/server/stats_flush_thread.h"
+
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class StatsFlushThreadTest : public testing::Test {
+public:
+  StatsFlushThreadTest()
+      : api_(Api::createApiForTest()), main_dispatcher_(api_->allocateDispatcher("main_thread")),
+        flush_thread_(*api_, tls_, *main_dispatcher_) {}
+
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr main_dispatcher_;
+  StatsFlushThread flush_thread_;
+};
+
+TEST_F(StatsFlushThreadTest, FlushesOnDedicatedThread) {
+  const std::thread::id main_thread_id = std::this_thread::get_id();
+  NiceMock<Stats::MockSink> sink1;
+  NiceMock<Stats::MockSink> sink2;
+  auto snapshot = std::make_shared<NiceMock<Stats::MockMetricSnapshot>>();
+  std::weak_ptr<Stats::MetricSnapshot> weak_snapshot = snapshot;
+
+  for (Stats::MockSink* sink : {&sink1, &sink2}) {
+    EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([main_thread_id](Stats::MetricSnapshot&) {
+      EXPECT_NE(main_thread_id, std::this_thread::get_id());
+    }));
+  }
+
+  flush_thread_.start();
+  bool completed = false;
+  flush_thread_.flush(std::move(snapshot), {sink1, sink2},
+                      [&](std::chrono::milliseconds) -> void {
+                        EXPECT_EQ(main_thread_id, std::this_thread::get_id());
+                        // The snapshot is released before the main thread is notified.
+                        EXPECT_TRUE(weak_snapshot.expired());
+                        completed = true;
+                        main_dispatcher_->exit();
+                      });
+  main_dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_TRUE(completed);
+  flush_thread_.stop();
+}
+
+TEST_F(StatsFlushThreadTest, StopWithoutStart) { flush_thread_.stop(); }
+
+} // namespace
+} // namespace Server
+} // namespace Envoy